@@ -14,6 +14,8 @@ typedef struct {
     float imag;
 } SingleComplex;
 
+#include "acc_simd.h"
+
 #if SIZEOF_INT == BLAS_SIZE
 #define BLAS_INT int
 #elif SIZEOF_LONG == BLAS_SIZE
@@ -127,6 +129,11 @@ static inline void _acc(
             IADD_SCALE_##WHICH(iterator[m], value[m], calc_scale);          \
         }                                                                   \
     } else
+#if COMEX_ACC_SIMD
+    if (_acc_simd(op, bytes, dst, src, scale)) {
+        return;
+    }
+#endif
 #if HAVE_BLAS
     ACC_BLAS(COMEX_ACC_DBL, double, D)
     ACC_BLAS(COMEX_ACC_FLT, float, S)
@@ -0,0 +1,324 @@
+#ifndef _COMEX_COMMON_ACC_SIMD_H_
+#define _COMEX_COMMON_ACC_SIMD_H_
+
+/* Vectorized accumulate kernels, dst[i] += scale * src[i].
+ *
+ * Every kernel is compiled for several x86 instruction sets using target
+ * attributes, and the widest one supported by the running CPU is picked the
+ * first time an accumulate happens. The AVX-512 targets imply FMA, so unless
+ * built with -ffp-contract=off those results may differ from the scalar
+ * IADD_SCALE_* loops in acc.h in the last bit.
+ *
+ * Define COMEX_DISABLE_ACC_SIMD to compile these out, or set the
+ * environment variable COMEX_ACC_SIMD=0 to disable them at runtime. */
+
+#if !defined(COMEX_DISABLE_ACC_SIMD) \
+    && (defined(__x86_64__) || defined(__i386__)) \
+    && !defined(__INTEL_COMPILER) && !defined(__PGI) \
+    && (defined(__clang__) \
+        || (defined(__GNUC__) \
+            && (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+#define COMEX_ACC_SIMD 1
+#else
+#define COMEX_ACC_SIMD 0
+#endif
+
+#if COMEX_ACC_SIMD
+
+#include <stdlib.h>
+#include <immintrin.h>
+
+#define ACC_SIMD_NONE   0
+#define ACC_SIMD_AVX2   1
+#define ACC_SIMD_AVX512 2
+
+#define ACC_SIMD_TAIL(C_TYPE)                                               \
+    for (; m < n; ++m) {                                                    \
+        dst[m] += src[m] * scale;                                           \
+    }
+
+/* ------------------------------------------------------------------ AVX2 */
+
+__attribute__((target("avx2")))
+static inline void _acc_simd_dbl_avx2(const int n,
+        double * const restrict dst, const double * const restrict src,
+        const double scale)
+{
+    int m = 0;
+    const __m256d vscale = _mm256_set1_pd(scale);
+    for (; m+8 <= n; m += 8) {
+        __m256d d0 = _mm256_loadu_pd(dst+m);
+        __m256d d1 = _mm256_loadu_pd(dst+m+4);
+        __m256d s0 = _mm256_loadu_pd(src+m);
+        __m256d s1 = _mm256_loadu_pd(src+m+4);
+        _mm256_storeu_pd(dst+m,   _mm256_add_pd(d0, _mm256_mul_pd(s0, vscale)));
+        _mm256_storeu_pd(dst+m+4, _mm256_add_pd(d1, _mm256_mul_pd(s1, vscale)));
+    }
+    ACC_SIMD_TAIL(double)
+}
+
+__attribute__((target("avx2")))
+static inline void _acc_simd_flt_avx2(const int n,
+        float * const restrict dst, const float * const restrict src,
+        const float scale)
+{
+    int m = 0;
+    const __m256 vscale = _mm256_set1_ps(scale);
+    for (; m+16 <= n; m += 16) {
+        __m256 d0 = _mm256_loadu_ps(dst+m);
+        __m256 d1 = _mm256_loadu_ps(dst+m+8);
+        __m256 s0 = _mm256_loadu_ps(src+m);
+        __m256 s1 = _mm256_loadu_ps(src+m+8);
+        _mm256_storeu_ps(dst+m,   _mm256_add_ps(d0, _mm256_mul_ps(s0, vscale)));
+        _mm256_storeu_ps(dst+m+8, _mm256_add_ps(d1, _mm256_mul_ps(s1, vscale)));
+    }
+    ACC_SIMD_TAIL(float)
+}
+
+__attribute__((target("avx2")))
+static inline void _acc_simd_int_avx2(const int n,
+        int * const restrict dst, const int * const restrict src,
+        const int scale)
+{
+    int m = 0;
+    const __m256i vscale = _mm256_set1_epi32(scale);
+    for (; m+8 <= n; m += 8) {
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst+m));
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src+m));
+        _mm256_storeu_si256((__m256i*)(dst+m),
+                _mm256_add_epi32(d, _mm256_mullo_epi32(s, vscale)));
+    }
+    ACC_SIMD_TAIL(int)
+}
+
+/* there is no packed 64-bit multiply before AVX-512DQ; only the common
+ * unit scale is vectorized */
+__attribute__((target("avx2")))
+static inline void _acc_simd_lng_avx2(const int n,
+        long * const restrict dst, const long * const restrict src,
+        const long scale)
+{
+    int m = 0;
+    if (8 == sizeof(long) && 1 == scale) {
+        for (; m+4 <= n; m += 4) {
+            __m256i d = _mm256_loadu_si256((const __m256i*)(dst+m));
+            __m256i s = _mm256_loadu_si256((const __m256i*)(src+m));
+            _mm256_storeu_si256((__m256i*)(dst+m), _mm256_add_epi64(d, s));
+        }
+    }
+    ACC_SIMD_TAIL(long)
+}
+
+/* complex: (sr,si)*(xr,xi) = (xr*sr - xi*si, xi*sr + xr*si), i.e. addsub
+ * of x*sr and swap(x)*si */
+__attribute__((target("avx2")))
+static inline void _acc_simd_dcp_avx2(const int n,
+        DoubleComplex * const restrict dst,
+        const DoubleComplex * const restrict src,
+        const DoubleComplex scale)
+{
+    int m = 0;
+    double * const restrict d = (double*)dst;
+    const double * const restrict s = (const double*)src;
+    const __m256d vreal = _mm256_set1_pd(scale.real);
+    const __m256d vimag = _mm256_set1_pd(scale.imag);
+    for (; m+2 <= n; m += 2) {
+        __m256d x = _mm256_loadu_pd(s+2*m);
+        __m256d y = _mm256_loadu_pd(d+2*m);
+        __m256d a = _mm256_mul_pd(x, vreal);
+        __m256d b = _mm256_mul_pd(_mm256_permute_pd(x, 0x5), vimag);
+        _mm256_storeu_pd(d+2*m, _mm256_add_pd(y, _mm256_addsub_pd(a, b)));
+    }
+    for (; m < n; ++m) {
+        dst[m].real += (src[m].real*scale.real) - (src[m].imag*scale.imag);
+        dst[m].imag += (src[m].real*scale.imag) + (src[m].imag*scale.real);
+    }
+}
+
+__attribute__((target("avx2")))
+static inline void _acc_simd_cpl_avx2(const int n,
+        SingleComplex * const restrict dst,
+        const SingleComplex * const restrict src,
+        const SingleComplex scale)
+{
+    int m = 0;
+    float * const restrict d = (float*)dst;
+    const float * const restrict s = (const float*)src;
+    const __m256 vreal = _mm256_set1_ps(scale.real);
+    const __m256 vimag = _mm256_set1_ps(scale.imag);
+    for (; m+4 <= n; m += 4) {
+        __m256 x = _mm256_loadu_ps(s+2*m);
+        __m256 y = _mm256_loadu_ps(d+2*m);
+        __m256 a = _mm256_mul_ps(x, vreal);
+        __m256 b = _mm256_mul_ps(_mm256_permute_ps(x, 0xB1), vimag);
+        _mm256_storeu_ps(d+2*m, _mm256_add_ps(y, _mm256_addsub_ps(a, b)));
+    }
+    for (; m < n; ++m) {
+        dst[m].real += (src[m].real*scale.real) - (src[m].imag*scale.imag);
+        dst[m].imag += (src[m].real*scale.imag) + (src[m].imag*scale.real);
+    }
+}
+
+/* --------------------------------------------------------------- AVX-512 */
+
+__attribute__((target("avx512f")))
+static inline void _acc_simd_dbl_avx512(const int n,
+        double * const restrict dst, const double * const restrict src,
+        const double scale)
+{
+    int m = 0;
+    const __m512d vscale = _mm512_set1_pd(scale);
+    for (; m+16 <= n; m += 16) {
+        __m512d d0 = _mm512_loadu_pd(dst+m);
+        __m512d d1 = _mm512_loadu_pd(dst+m+8);
+        __m512d s0 = _mm512_loadu_pd(src+m);
+        __m512d s1 = _mm512_loadu_pd(src+m+8);
+        _mm512_storeu_pd(dst+m,   _mm512_add_pd(d0, _mm512_mul_pd(s0, vscale)));
+        _mm512_storeu_pd(dst+m+8, _mm512_add_pd(d1, _mm512_mul_pd(s1, vscale)));
+    }
+    /* masked tail */
+    for (; m < n; m += 8) {
+        const __mmask8 k = (n-m >= 8) ? 0xFF : (__mmask8)((1u<<(n-m))-1);
+        __m512d d = _mm512_maskz_loadu_pd(k, dst+m);
+        __m512d s = _mm512_maskz_loadu_pd(k, src+m);
+        _mm512_mask_storeu_pd(dst+m, k, _mm512_add_pd(d, _mm512_mul_pd(s, vscale)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static inline void _acc_simd_flt_avx512(const int n,
+        float * const restrict dst, const float * const restrict src,
+        const float scale)
+{
+    int m = 0;
+    const __m512 vscale = _mm512_set1_ps(scale);
+    for (; m+32 <= n; m += 32) {
+        __m512 d0 = _mm512_loadu_ps(dst+m);
+        __m512 d1 = _mm512_loadu_ps(dst+m+16);
+        __m512 s0 = _mm512_loadu_ps(src+m);
+        __m512 s1 = _mm512_loadu_ps(src+m+16);
+        _mm512_storeu_ps(dst+m,    _mm512_add_ps(d0, _mm512_mul_ps(s0, vscale)));
+        _mm512_storeu_ps(dst+m+16, _mm512_add_ps(d1, _mm512_mul_ps(s1, vscale)));
+    }
+    /* masked tail */
+    for (; m < n; m += 16) {
+        const __mmask16 k = (n-m >= 16) ? 0xFFFF : (__mmask16)((1u<<(n-m))-1);
+        __m512 d = _mm512_maskz_loadu_ps(k, dst+m);
+        __m512 s = _mm512_maskz_loadu_ps(k, src+m);
+        _mm512_mask_storeu_ps(dst+m, k, _mm512_add_ps(d, _mm512_mul_ps(s, vscale)));
+    }
+}
+
+__attribute__((target("avx512f")))
+static inline void _acc_simd_int_avx512(const int n,
+        int * const restrict dst, const int * const restrict src,
+        const int scale)
+{
+    int m = 0;
+    const __m512i vscale = _mm512_set1_epi32(scale);
+    for (; m+16 <= n; m += 16) {
+        __m512i d = _mm512_loadu_si512((const void*)(dst+m));
+        __m512i s = _mm512_loadu_si512((const void*)(src+m));
+        _mm512_storeu_si512((void*)(dst+m),
+                _mm512_add_epi32(d, _mm512_mullo_epi32(s, vscale)));
+    }
+    ACC_SIMD_TAIL(int)
+}
+
+__attribute__((target("avx512f")))
+static inline void _acc_simd_lng_avx512(const int n,
+        long * const restrict dst, const long * const restrict src,
+        const long scale)
+{
+    int m = 0;
+    if (8 == sizeof(long) && 1 == scale) {
+        for (; m+8 <= n; m += 8) {
+            __m512i d = _mm512_loadu_si512((const void*)(dst+m));
+            __m512i s = _mm512_loadu_si512((const void*)(src+m));
+            _mm512_storeu_si512((void*)(dst+m), _mm512_add_epi64(d, s));
+        }
+    }
+    ACC_SIMD_TAIL(long)
+}
+
+#undef ACC_SIMD_TAIL
+
+/* ------------------------------------------------------------- dispatch */
+
+static inline int _acc_simd_level(void)
+{
+    static int level = -1;
+
+    if (level < 0) {
+        const char *value = getenv("COMEX_ACC_SIMD");
+        __builtin_cpu_init();
+        if (NULL != value && 0 == atoi(value)) {
+            level = ACC_SIMD_NONE;
+        }
+        else if (__builtin_cpu_supports("avx512f")) {
+            level = ACC_SIMD_AVX512;
+        }
+        else if (__builtin_cpu_supports("avx2")) {
+            level = ACC_SIMD_AVX2;
+        }
+        else {
+            level = ACC_SIMD_NONE;
+        }
+    }
+
+    return level;
+}
+
+/* returns 0 if no vector kernel applies and the caller must accumulate */
+static inline int _acc_simd(
+        const int op,
+        const int bytes,
+        void * const restrict dst,
+        const void * const restrict src,
+        const void * const restrict scale)
+{
+    const int level = _acc_simd_level();
+
+    if (ACC_SIMD_NONE == level) {
+        return 0;
+    }
+
+#define ACC_SIMD(COMEX_TYPE, C_TYPE, NAME)                                  \
+    if (op == COMEX_TYPE) {                                                 \
+        const int n = bytes/sizeof(C_TYPE);                                 \
+        const C_TYPE calc_scale = *(const C_TYPE * const restrict)scale;    \
+        if (ACC_SIMD_AVX512 == level) {                                     \
+            _acc_simd_##NAME##_avx512(n, (C_TYPE*)dst, (const C_TYPE*)src,  \
+                    calc_scale);                                            \
+        }                                                                   \
+        else {                                                              \
+            _acc_simd_##NAME##_avx2(n, (C_TYPE*)dst, (const C_TYPE*)src,    \
+                    calc_scale);                                            \
+        }                                                                   \
+        return 1;                                                           \
+    } else
+    /* the complex kernels need addsub, which AVX-512F lacks */
+#define ACC_SIMD_CPL(COMEX_TYPE, C_TYPE, NAME)                              \
+    if (op == COMEX_TYPE) {                                                 \
+        const int n = bytes/sizeof(C_TYPE);                                 \
+        const C_TYPE calc_scale = *(const C_TYPE * const restrict)scale;    \
+        _acc_simd_##NAME##_avx2(n, (C_TYPE*)dst, (const C_TYPE*)src,        \
+                calc_scale);                                                \
+        return 1;                                                           \
+    } else
+    ACC_SIMD(COMEX_ACC_DBL, double, dbl)
+    ACC_SIMD(COMEX_ACC_FLT, float, flt)
+    ACC_SIMD(COMEX_ACC_INT, int, int)
+    ACC_SIMD(COMEX_ACC_LNG, long, lng)
+    ACC_SIMD_CPL(COMEX_ACC_DCP, DoubleComplex, dcp)
+    ACC_SIMD_CPL(COMEX_ACC_CPL, SingleComplex, cpl)
+    {
+        return 0;
+    }
+#undef ACC_SIMD
+#undef ACC_SIMD_CPL
+}
+
+#endif /* COMEX_ACC_SIMD */
+
+#endif /* _COMEX_COMMON_ACC_SIMD_H_ */
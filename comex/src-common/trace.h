@@ -0,0 +1,155 @@
+#ifndef COMEX_TRACE_H_
+#define COMEX_TRACE_H_
+
+/* Timeline of the ComEx operations of a process, in Chrome trace format.
+ *
+ * When COMEX_TRACE is set in the environment, each traced operation is
+ * recorded as one event with its start time, duration, target process and
+ * size in bytes, in a ring buffer of COMEX_TRACE_EVENTS events (default
+ * 65536). Once the buffer is full the oldest events are overwritten. At
+ * finalize the events are written to <COMEX_TRACE>.comex.<pid>.json, which
+ * chrome://tracing and Perfetto load directly; tools/ga_trace_merge.py
+ * combines the files of all processes and those written by the GA call
+ * wrappers into one timeline.
+ *
+ * Timestamps come from CLOCK_REALTIME so that the events of processes on
+ * different nodes line up as well as the clocks of the nodes agree.
+ *
+ * The state is static, so a backend includes this header in one file only.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define COMEX_TRACE_DEFAULT_EVENTS 65536
+#define COMEX_TRACE_TID 1           /**< GA calls use thread 0 */
+
+typedef struct {
+    const char *name;               /**< static string */
+    long long start;                /**< ns */
+    long long dur;                  /**< ns */
+    int proc;                       /**< target process, -1 if none */
+    long bytes;
+} comex_trace_event_t;
+
+static comex_trace_event_t *comex_trace_ring = NULL;
+static long comex_trace_size = 0;
+static long long comex_trace_count = 0; /**< including overwritten events */
+static int comex_trace_pid = 0;
+static char comex_trace_label[64];
+
+
+static inline long long comex_trace_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+
+/* start tracing if COMEX_TRACE is set; the events of this process are shown
+ * as process pid of the timeline, named label */
+static inline void comex_trace_init(int pid, const char *label)
+{
+    char *val = NULL;
+
+    if (NULL == getenv("COMEX_TRACE") || NULL != comex_trace_ring) {
+        return;
+    }
+    val = getenv("COMEX_TRACE_EVENTS");
+    comex_trace_size = val ? atol(val) : COMEX_TRACE_DEFAULT_EVENTS;
+    if (comex_trace_size <= 0) {
+        return;
+    }
+    comex_trace_ring = (comex_trace_event_t*)malloc(
+            sizeof(comex_trace_event_t)*comex_trace_size);
+    if (NULL == comex_trace_ring) {
+        fprintf(stderr, "[%d] comex trace: cannot allocate %ld events\n",
+                pid, comex_trace_size);
+        return;
+    }
+    comex_trace_count = 0;
+    comex_trace_pid = pid;
+    snprintf(comex_trace_label, sizeof(comex_trace_label), "%s", label);
+}
+
+
+/* start time of an event, 0 if tracing is off */
+static inline long long comex_trace_begin(void)
+{
+    return NULL != comex_trace_ring ? comex_trace_now() : 0;
+}
+
+
+static inline void comex_trace_end(
+        const char *name, long long start, int proc, long bytes)
+{
+    comex_trace_event_t *event = NULL;
+
+    if (NULL == comex_trace_ring) {
+        return;
+    }
+    event = &comex_trace_ring[comex_trace_count++ % comex_trace_size];
+    event->name = name;
+    event->start = start;
+    event->dur = comex_trace_now() - start;
+    event->proc = proc;
+    event->bytes = bytes;
+}
+
+
+/* write the recorded events and stop tracing */
+static inline void comex_trace_finalize(void)
+{
+    char fname[1024];
+    FILE *fp = NULL;
+    long long i = 0;
+    long long first = 0;
+
+    if (NULL == comex_trace_ring) {
+        return;
+    }
+    snprintf(fname, sizeof(fname), "%.1000s.comex.%d.json",
+            getenv("COMEX_TRACE"), comex_trace_pid);
+    fp = fopen(fname, "w");
+    if (NULL == fp) {
+        fprintf(stderr, "[%d] comex trace: cannot open %s\n",
+                comex_trace_pid, fname);
+    }
+    else {
+        fprintf(fp, "{\"traceEvents\":[\n");
+        fprintf(fp, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":0,\"args\":{\"name\":\"%s\"}},\n",
+                comex_trace_pid, comex_trace_label);
+        fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%d,"
+                "\"tid\":%d,\"args\":{\"name\":\"ComEx\"}}",
+                comex_trace_pid, COMEX_TRACE_TID);
+        if (comex_trace_count > comex_trace_size) {
+            first = comex_trace_count - comex_trace_size;
+            fprintf(fp, ",\n{\"name\":\"process_labels\",\"ph\":\"M\","
+                    "\"pid\":%d,\"tid\":0,\"args\":{\"labels\":"
+                    "\"%lld ComEx events dropped\"}}",
+                    comex_trace_pid, first);
+        }
+        for (i = first; i < comex_trace_count; ++i) {
+            comex_trace_event_t *event =
+                &comex_trace_ring[i % comex_trace_size];
+            fprintf(fp, ",\n{\"name\":\"%s\",\"cat\":\"comex\",\"ph\":\"X\","
+                    "\"pid\":%d,\"tid\":%d,\"ts\":%lld.%03lld,"
+                    "\"dur\":%lld.%03lld,\"args\":{\"proc\":%d,"
+                    "\"bytes\":%ld}}",
+                    event->name, comex_trace_pid, COMEX_TRACE_TID,
+                    event->start/1000, event->start%1000,
+                    event->dur/1000, event->dur%1000,
+                    event->proc, event->bytes);
+        }
+        fprintf(fp, "\n],\"displayTimeUnit\":\"ns\"}\n");
+        fclose(fp);
+    }
+    free(comex_trace_ring);
+    comex_trace_ring = NULL;
+}
+
+#endif /* COMEX_TRACE_H_ */
@@ -61,6 +61,7 @@ typedef enum {
     OP_LOCK,
     OP_UNLOCK,
     OP_QUIT,
+    OP_MULTI,
 } op_t;
 
 
@@ -130,6 +131,15 @@ static int nb_count_recv_processed = 0;
 
 static char *static_acc_buffer = NULL;
 
+static int coalesce_enabled = ENABLE_COALESCE;
+static int COMEX_COALESCE_BUFFER_SIZE = 0;
+static int COMEX_COALESCE_THRESHOLD = 0;
+static char **coalesce_buffer = NULL;   /* pending OP_MULTI payload per proc */
+static int *coalesce_length = NULL;     /* bytes used in coalesce_buffer */
+
+/* sub-operations of an OP_MULTI payload start on 8-byte boundaries */
+#define COALESCE_ALIGN(n) (((n)+7) & ~7)
+
 #if PAUSE_ON_ERROR
 static int AR_caught_sig=0;
 static int AR_caught_sigsegv=0;
@@ -178,6 +188,7 @@ STATIC void _mutex_create_handler(header_t *header, int proc);
 STATIC void _mutex_destroy_handler(header_t *header, int proc);
 STATIC void _lock_handler(header_t *header, int proc);
 STATIC void _unlock_handler(header_t *header, int proc);
+STATIC void _multi_handler(header_t *header, int proc);
 
 /* worker functions */
 STATIC void nb_send_common(void *buf, int count, int dest, nb_t *nb, int need_free);
@@ -225,6 +236,11 @@ STATIC void nb_accv(int datatype, void *scale,
         comex_giov_t *iov, int iov_len, int proc, nb_t *nb);
 STATIC void nb_accv_packed(int datatype, void *scale,
         comex_giov_t *iov, int proc, nb_t *nb);
+STATIC int _coalesce_check(int proc, int extra_bytes);
+STATIC void _coalesce_append(header_t *header,
+        void *scale, int scale_size, void *src, nb_t *nb);
+STATIC void _coalesce_flush(int proc, nb_t *nb);
+STATIC void _coalesce_flush_all(void);
 
 /* other functions */
 STATIC int packed_size(int *src_stride, int *count, int stride_levels);
@@ -271,6 +287,21 @@ int comex_init()
             nb_max_outstanding = atoi(value);
         }
         COMEX_ASSERT(nb_max_outstanding > 0);
+
+        coalesce_enabled = ENABLE_COALESCE; /* default */
+        if ((value = getenv("COMEX_ENABLE_COALESCE")) != NULL) {
+            coalesce_enabled = atoi(value);
+        }
+
+        COMEX_COALESCE_BUFFER_SIZE = COMEX_COALESCE_BUFFER_SIZE_DEFAULT; /* default */
+        if ((value = getenv("COMEX_COALESCE_BUFFER_SIZE")) != NULL) {
+            COMEX_COALESCE_BUFFER_SIZE = atoi(value);
+        }
+
+        COMEX_COALESCE_THRESHOLD = COMEX_COALESCE_THRESHOLD_DEFAULT; /* default */
+        if ((value = getenv("COMEX_COALESCE_THRESHOLD")) != NULL) {
+            COMEX_COALESCE_THRESHOLD = atoi(value);
+        }
     }
 
     /* groups */
@@ -330,6 +361,19 @@ int comex_init()
         fence_array[i] = 0;
     }
 
+    if (coalesce_enabled) {
+        COMEX_ASSERT(COMEX_COALESCE_BUFFER_SIZE
+                >= COALESCE_ALIGN(COMEX_COALESCE_THRESHOLD));
+        coalesce_buffer = malloc(sizeof(char*) * g_state.size);
+        COMEX_ASSERT(coalesce_buffer);
+        coalesce_length = malloc(sizeof(int) * g_state.size);
+        COMEX_ASSERT(coalesce_length);
+        for (i = 0; i < g_state.size; ++i) {
+            coalesce_buffer[i] = NULL;
+            coalesce_length[i] = 0;
+        }
+    }
+
 #if DEBUG
     printf("[%d] comex_init() before barrier\n", g_state.rank);
 #endif
@@ -385,6 +429,8 @@ int comex_initialized()
 
 int comex_finalize()
 {
+    int i = 0;
+
 #if DEBUG
     printf("[%d] comex_finalize()\n", g_state.rank);
 #endif
@@ -394,6 +440,9 @@ int comex_finalize()
         return COMEX_SUCCESS;
     }
 
+    /* batched requests must reach their targets before the servers quit */
+    comex_wait_all(COMEX_GROUP_WORLD);
+
     comex_barrier(COMEX_GROUP_WORLD);
 
     initialized = 0;
@@ -424,6 +473,16 @@ int comex_finalize()
 
     free(fence_array);
 
+    if (NULL != coalesce_buffer) {
+        for (i = 0; i < g_state.size; ++i) {
+            COMEX_ASSERT(NULL == coalesce_buffer[i]);
+        }
+        free(coalesce_buffer);
+        free(coalesce_length);
+        coalesce_buffer = NULL;
+        coalesce_length = NULL;
+    }
+
     MPI_Barrier(g_state.comm);
 
     /* destroy the groups */
@@ -958,6 +1017,7 @@ int comex_test(comex_request_t* hdl, int *status)
 
 int comex_wait_all(comex_group_t group)
 {
+    _coalesce_flush_all();
     nb_wait_all();
 
     return COMEX_SUCCESS;
@@ -1629,6 +1689,9 @@ static void* _progress_server(void *arg)
             case OP_QUIT:
                 running = 0;
                 break;
+            case OP_MULTI:
+                _multi_handler(header, source);
+                break;
             default:
                 printf("[%d] header operation not recognized: %d\n",
                         g_state.rank, header->operation);
@@ -1643,6 +1706,55 @@ static void* _progress_server(void *arg)
 }
 
 
+/* receive a batch built by _coalesce_append() and execute each put or acc */
+STATIC void _multi_handler(header_t *header, int proc)
+{
+    char *buffer = NULL;
+    char *op = NULL;
+    char *end = NULL;
+
+#if DEBUG
+    printf("[%d] _multi_handler proc=%d len=%d\n",
+            g_state.rank, proc, header->length);
+#endif
+
+    if ((unsigned)header->length > COMEX_STATIC_BUFFER_SIZE) {
+        buffer = malloc(header->length);
+        COMEX_ASSERT(buffer);
+    }
+    else {
+        buffer = static_acc_buffer;
+    }
+
+    server_recv(buffer, header->length, proc);
+
+    op = buffer;
+    end = buffer + header->length;
+    while (op < end) {
+        header_t *sub = (header_t*)op;
+        char *payload = op + sizeof(header_t);
+        size_t sizeof_scale = 0;
+
+        if (OP_PUT == sub->operation) {
+            (void)memcpy(sub->remote_address, payload, sub->length);
+        }
+        else {
+            sizeof_scale = get_scale_size(sub->operation);
+            pthread_mutex_lock(&mutex);
+            _acc(get_acc_type(sub->operation), sub->length,
+                    sub->remote_address, payload+sizeof_scale, payload);
+            pthread_mutex_unlock(&mutex);
+        }
+        op += COALESCE_ALIGN(sizeof(header_t) + sizeof_scale + sub->length);
+    }
+    COMEX_ASSERT(op == end);
+
+    if ((unsigned)header->length > COMEX_STATIC_BUFFER_SIZE) {
+        free(buffer);
+    }
+}
+
+
 STATIC void _put_handler(header_t *header, int proc)
 {
     int retval = 0;
@@ -2613,6 +2725,11 @@ STATIC void nb_send_common(void *buf, int count, int dest, nb_t *nb, int need_fr
 
     COMEX_ASSERT(NULL != nb);
 
+    /* keep batched requests to dest ordered before this one */
+    if (NULL != coalesce_buffer && NULL != coalesce_buffer[dest]) {
+        _coalesce_flush(dest, nb);
+    }
+
     nb->send_size += 1;
     nb_count_event += 1;
     nb_count_send += 1;
@@ -2638,6 +2755,91 @@ STATIC void nb_send_common(void *buf, int count, int dest, nb_t *nb, int need_fr
 }
 
 
+/* whether a small put or acc to proc should be batched into an OP_MULTI */
+STATIC int _coalesce_check(int proc, int extra_bytes)
+{
+    return NULL != coalesce_buffer
+        && (((int)sizeof(header_t))+extra_bytes) <= COMEX_COALESCE_THRESHOLD;
+}
+
+
+/* copy one put or acc request into the pending OP_MULTI for its target */
+STATIC void _coalesce_append(header_t *header,
+        void *scale, int scale_size, void *src, nb_t *nb)
+{
+    int proc = header->rank;
+    int size = COALESCE_ALIGN(sizeof(header_t) + scale_size + header->length);
+    char *op = NULL;
+
+    if (NULL != coalesce_buffer[proc]
+            && coalesce_length[proc] + size > COMEX_COALESCE_BUFFER_SIZE) {
+        _coalesce_flush(proc, nb);
+    }
+
+    if (NULL == coalesce_buffer[proc]) {
+        coalesce_buffer[proc] = malloc(COMEX_COALESCE_BUFFER_SIZE);
+        COMEX_ASSERT(coalesce_buffer[proc]);
+        coalesce_length[proc] = 0;
+    }
+
+    op = coalesce_buffer[proc] + coalesce_length[proc];
+    (void)memcpy(op, header, sizeof(header_t));
+    (void)memcpy(op+sizeof(header_t), scale, scale_size);
+    (void)memcpy(op+sizeof(header_t)+scale_size, src, header->length);
+    coalesce_length[proc] += size;
+}
+
+
+/* send the pending OP_MULTI to proc, if any, as part of nb */
+STATIC void _coalesce_flush(int proc, nb_t *nb)
+{
+    char *buffer = NULL;
+    int length = 0;
+    header_t *header = NULL;
+
+    if (NULL == coalesce_buffer || NULL == coalesce_buffer[proc]) {
+        return;
+    }
+
+    /* detach first; nb_send_header() comes back through here */
+    buffer = coalesce_buffer[proc];
+    length = coalesce_length[proc];
+    header = malloc(sizeof(header_t));
+    COMEX_ASSERT(header);
+    header->operation = OP_MULTI;
+    header->remote_address = NULL;
+    header->local_address = NULL;
+    header->rank = proc;
+    header->length = length;
+    coalesce_buffer[proc] = NULL;
+    coalesce_length[proc] = 0;
+
+    /* header and payload are freed separately once each send completes */
+    nb_send_header(header, sizeof(header_t), proc, nb);
+    nb_send_common(buffer, length, proc, nb, 1);
+}
+
+
+STATIC void _coalesce_flush_all(void)
+{
+    nb_t *nb = NULL;
+    int i = 0;
+
+    if (NULL == coalesce_buffer) {
+        return;
+    }
+
+    for (i=0; i<g_state.size; ++i) {
+        if (NULL != coalesce_buffer[i]) {
+            if (NULL == nb) {
+                nb = nb_wait_for_handle();
+            }
+            _coalesce_flush(i, nb);
+        }
+    }
+}
+
+
 STATIC void nb_send_header(void *buf, int count, int dest, nb_t *nb)
 {
 #if DEBUG
@@ -3012,6 +3214,19 @@ STATIC void nb_put(void *src, void *dst, int bytes, int proc, nb_t *nb)
     }
 #endif
 
+    if (_coalesce_check(proc, bytes)) {
+        header_t header;
+
+        fence_array[proc] = 1;
+        header.operation = OP_PUT;
+        header.remote_address = dst;
+        header.local_address = src;
+        header.rank = proc;
+        header.length = bytes;
+        _coalesce_append(&header, NULL, 0, src, nb);
+        return;
+    }
+
     {
         header_t *header = NULL;
 
@@ -3128,6 +3343,18 @@ STATIC void nb_acc(int datatype, void *scale,
         /* only fence on the master */
         fence_array[proc] = 1;
 
+        if (_coalesce_check(proc, scale_size+bytes)) {
+            header_t small;
+
+            small.operation = operation;
+            small.remote_address = dst;
+            small.local_address = src;
+            small.rank = proc;
+            small.length = bytes;
+            _coalesce_append(&small, scale, scale_size, src, nb);
+            return;
+        }
+
         header = malloc(sizeof(header_t));
         COMEX_ASSERT(header);
         header->operation = operation;
@@ -7,6 +7,8 @@
 #define COMEX_MAX_STRIDE_LEVEL 8
 #define COMEX_TAG 27624
 #define COMEX_STATIC_BUFFER_SIZE (2u*1048576u)
+#define COMEX_COALESCE_BUFFER_SIZE_DEFAULT 65536
+#define COMEX_COALESCE_THRESHOLD_DEFAULT 1024
 #define UNLOCKED -1
 
 /* performance or correctness related settings */
@@ -21,6 +23,7 @@
 #define ENABLE_PUT_IOV 1
 #define ENABLE_GET_IOV 1
 #define ENABLE_ACC_IOV 1
+#define ENABLE_COALESCE 0
 
 #define DEBUG 0
 #define DEBUG_VERBOSE 0
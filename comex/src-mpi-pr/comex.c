@@ -29,7 +29,9 @@
 #include "comex_impl.h"
 #include "groups.h"
 #include "reg_cache.h"
+#include "shm_queue.h"
 #include "acc.h"
+#include "trace.h"
 
 #define PAUSE_ON_ERROR 0
 #define STATIC static inline
@@ -79,9 +81,52 @@ typedef enum {
     OP_QUIT,
     OP_MALLOC,
     OP_FREE,
+    OP_MULTI,
     OP_NULL
 } op_t;
 
+/* names of the handlers of each operation, for the trace */
+static const char *op_name[] = {
+    "_put_handler",
+    "_put_packed_handler",
+    "_put_datatype_handler",
+    "_put_iov_handler",
+    "_get_handler",
+    "_get_packed_handler",
+    "_get_datatype_handler",
+    "_get_iov_handler",
+    "_acc_handler",
+    "_acc_handler",
+    "_acc_handler",
+    "_acc_handler",
+    "_acc_handler",
+    "_acc_handler",
+    "_acc_packed_handler",
+    "_acc_packed_handler",
+    "_acc_packed_handler",
+    "_acc_packed_handler",
+    "_acc_packed_handler",
+    "_acc_packed_handler",
+    "_acc_iov_handler",
+    "_acc_iov_handler",
+    "_acc_iov_handler",
+    "_acc_iov_handler",
+    "_acc_iov_handler",
+    "_acc_iov_handler",
+    "_fence_handler",
+    "_fetch_and_add_handler",
+    "_swap_handler",
+    "_mutex_create_handler",
+    "_mutex_destroy_handler",
+    "_lock_handler",
+    "_unlock_handler",
+    "quit",
+    "_malloc_handler",
+    "_free_handler",
+    "_multi_handler",
+    "null",
+};
+
 
 typedef struct {
     op_t operation;
@@ -175,6 +220,20 @@ static int COMEX_GET_DATATYPE_THRESHOLD = 8192;
 static int COMEX_ENABLE_PUT_IOV = ENABLE_PUT_IOV;
 static int COMEX_ENABLE_GET_IOV = ENABLE_GET_IOV;
 static int COMEX_ENABLE_ACC_IOV = ENABLE_ACC_IOV;
+static int COMEX_ENABLE_SHM_QUEUE = ENABLE_SHM_QUEUE;
+
+static char *shm_queue_name = NULL;      /* local request queue name */
+static shm_queue_t *my_shm_queue = NULL; /* (workers) my queue to my master */
+static shm_queue_t **shm_queues = NULL;  /* (masters) queues of SMP workers */
+
+static int COMEX_ENABLE_COALESCE = ENABLE_COALESCE;
+static int COMEX_COALESCE_BUFFER_SIZE = 0;
+static int COMEX_COALESCE_THRESHOLD = 0;
+static char **coalesce_buffer = NULL;    /* pending OP_MULTI per master */
+static int *coalesce_length = NULL;      /* bytes used in coalesce_buffer */
+
+/* sub-operations of an OP_MULTI message start on 8-byte boundaries */
+#define COALESCE_ALIGN(n) (((n)+7) & ~7)
 
 #if USE_SICM
 static sicm_device_list devices = {0};
@@ -235,6 +294,9 @@ STATIC void _lock_handler(header_t *header, int proc);
 STATIC void _unlock_handler(header_t *header, int proc);
 STATIC void _malloc_handler(header_t *header, char *payload, int proc);
 STATIC void _free_handler(header_t *header, char *payload, int proc);
+STATIC void _shm_queue_progress(void);
+STATIC void _inline_handler(header_t *header, char *payload);
+STATIC void _multi_handler(header_t *header, char *payload, int proc);
 
 /* worker functions */
 STATIC void nb_send_common(void *buf, int count, int dest, nb_t *nb, int need_free);
@@ -292,9 +354,17 @@ STATIC void nb_accv_packed(int datatype, void *scale,
         comex_giov_t *iov, int proc, nb_t *nb);
 STATIC void _fence_master(int master_rank);
 STATIC int _eager_check(int extra_bytes);
+STATIC int _shm_queue_check(int proc, int extra_bytes);
+STATIC void _shm_queue_drain(void);
+STATIC int _coalesce_check(int proc, int extra_bytes);
+STATIC void _coalesce_append(header_t *header,
+        void *scale, int scale_size, void *src, nb_t *nb);
+STATIC void _coalesce_flush(int master_rank, nb_t *nb);
+STATIC void _coalesce_flush_all(void);
 
 /* other functions */
 STATIC int _packed_size(int *src_stride, int *count, int stride_levels);
+STATIC long _iov_bytes(comex_giov_t *iov, int iov_len);
 STATIC char* pack(char *src, int *src_stride,
                 int *count, int stride_levels, int *size);
 STATIC void unpack(char *packed_buffer,
@@ -309,6 +379,8 @@ STATIC int _smallest_world_rank_with_same_hostid(comex_igroup_t *group);
 STATIC int _largest_world_rank_with_same_hostid(comex_igroup_t *igroup);
 STATIC void _malloc_semaphore(void);
 STATIC void _free_semaphore(void);
+STATIC void _malloc_shm_queue(void);
+STATIC void _free_shm_queue(void);
 STATIC void* _shm_create(const char *name, size_t size);
 STATIC void* _shm_attach(const char *name, size_t size);
 #if USE_SICM
@@ -342,6 +414,18 @@ int comex_init()
     /* groups */
     comex_group_init();
 
+    /* the progress servers are traced as processes of their own */
+    {
+        char label[64];
+        if (_is_master()) {
+            snprintf(label, sizeof(label), "progress server %d", g_state.rank);
+        }
+        else {
+            snprintf(label, sizeof(label), "rank %d", group_list->rank);
+        }
+        comex_trace_init(g_state.rank, label);
+    }
+
     /* env vars */
     {
         char *value = NULL;
@@ -461,6 +545,30 @@ int comex_init()
             COMEX_ENABLE_ACC_IOV = atoi(value);
         }
 
+        COMEX_ENABLE_SHM_QUEUE = ENABLE_SHM_QUEUE; /* default */
+        value = getenv("COMEX_ENABLE_SHM_QUEUE");
+        if (NULL != value) {
+            COMEX_ENABLE_SHM_QUEUE = atoi(value);
+        }
+
+        COMEX_ENABLE_COALESCE = ENABLE_COALESCE; /* default */
+        value = getenv("COMEX_ENABLE_COALESCE");
+        if (NULL != value) {
+            COMEX_ENABLE_COALESCE = atoi(value);
+        }
+
+        COMEX_COALESCE_BUFFER_SIZE = COMEX_COALESCE_BUFFER_SIZE_DEFAULT; /* default */
+        value = getenv("COMEX_COALESCE_BUFFER_SIZE");
+        if (NULL != value) {
+            COMEX_COALESCE_BUFFER_SIZE = atoi(value);
+        }
+
+        COMEX_COALESCE_THRESHOLD = COMEX_COALESCE_THRESHOLD_DEFAULT; /* default */
+        value = getenv("COMEX_COALESCE_THRESHOLD");
+        if (NULL != value) {
+            COMEX_COALESCE_THRESHOLD = atoi(value);
+        }
+
         max_message_size = INT_MAX; /* default */
         value = getenv("COMEX_MAX_MESSAGE_SIZE");
         if (NULL != value) {
@@ -489,6 +597,10 @@ int comex_init()
             printf("COMEX_ENABLE_PUT_IOV=%d\n", COMEX_ENABLE_PUT_IOV);
             printf("COMEX_ENABLE_GET_IOV=%d\n", COMEX_ENABLE_GET_IOV);
             printf("COMEX_ENABLE_ACC_IOV=%d\n", COMEX_ENABLE_ACC_IOV);
+            printf("COMEX_ENABLE_SHM_QUEUE=%d\n", COMEX_ENABLE_SHM_QUEUE);
+            printf("COMEX_ENABLE_COALESCE=%d\n", COMEX_ENABLE_COALESCE);
+            printf("COMEX_COALESCE_BUFFER_SIZE=%d\n", COMEX_COALESCE_BUFFER_SIZE);
+            printf("COMEX_COALESCE_THRESHOLD=%d\n", COMEX_COALESCE_THRESHOLD);
             fflush(stdout);
         }
 #endif
@@ -537,6 +649,10 @@ int comex_init()
 
     _malloc_semaphore();
 
+    if (COMEX_ENABLE_SHM_QUEUE) {
+        _malloc_shm_queue();
+    }
+
 #if DEBUG
     fprintf(stderr, "[%d] comex_init() before progress server\n", g_state.rank);
 #endif
@@ -572,6 +688,19 @@ int comex_init()
         fence_array[i] = 0;
     }
 
+    if (COMEX_ENABLE_COALESCE) {
+        COMEX_ASSERT(COMEX_COALESCE_BUFFER_SIZE >= (int)sizeof(header_t)
+                + COALESCE_ALIGN(COMEX_COALESCE_THRESHOLD));
+        coalesce_buffer = malloc(sizeof(char*) * g_state.size);
+        COMEX_ASSERT(coalesce_buffer);
+        coalesce_length = malloc(sizeof(int) * g_state.size);
+        COMEX_ASSERT(coalesce_length);
+        for (i = 0; i < g_state.size; ++i) {
+            coalesce_buffer[i] = NULL;
+            coalesce_length[i] = 0;
+        }
+    }
+
 #if DEBUG
     fprintf(stderr, "[%d] comex_init() before barrier\n", g_state.rank);
 #endif
@@ -619,6 +748,8 @@ int comex_initialized()
 
 int comex_finalize()
 {
+    int i = 0;
+
 #if DEBUG
     fprintf(stderr, "[%d] comex_finalize()\n", g_state.rank);
 #endif
@@ -628,6 +759,9 @@ int comex_finalize()
         return COMEX_SUCCESS;
     }
 
+    /* batched requests must reach their targets before the servers quit */
+    comex_wait_all(COMEX_GROUP_WORLD);
+
     comex_barrier(COMEX_GROUP_WORLD);
 
     initialized = 0;
@@ -661,8 +795,22 @@ int comex_finalize()
 
     free(fence_array);
 
+    if (NULL != coalesce_buffer) {
+        for (i = 0; i < g_state.size; ++i) {
+            COMEX_ASSERT(NULL == coalesce_buffer[i]);
+        }
+        free(coalesce_buffer);
+        free(coalesce_length);
+        coalesce_buffer = NULL;
+        coalesce_length = NULL;
+    }
+
     MPI_Barrier(g_state.comm);
 
+    if (COMEX_ENABLE_SHM_QUEUE) {
+        _free_shm_queue();
+    }
+
     /* reg_cache */
     reg_cache_destroy(g_state.size);
 
@@ -683,6 +831,8 @@ int comex_finalize()
     fclose(comex_trace_file);
 #endif
 
+    comex_trace_finalize();
+
     return COMEX_SUCCESS;
 }
 
@@ -709,6 +859,7 @@ int comex_put(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -719,6 +870,8 @@ int comex_put(
     nb_put(src, dst, bytes, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_put", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -730,6 +883,7 @@ int comex_get(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -740,6 +894,8 @@ int comex_get(
     nb_get(src, dst, bytes, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_get", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -752,6 +908,7 @@ int comex_acc(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -762,6 +919,8 @@ int comex_acc(
     nb_acc(datatype, scale, src, dst, bytes, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_acc", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -775,6 +934,7 @@ int comex_puts(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -785,6 +945,9 @@ int comex_puts(
     nb_puts(src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_puts", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -798,6 +961,7 @@ int comex_gets(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -808,6 +972,9 @@ int comex_gets(
     nb_gets(src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_gets", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -822,6 +989,7 @@ int comex_accs(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -833,6 +1001,9 @@ int comex_accs(
             src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_accs", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -844,6 +1015,7 @@ int comex_putv(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -854,6 +1026,9 @@ int comex_putv(
     nb_putv(iov, iov_len, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_putv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -865,6 +1040,7 @@ int comex_getv(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -875,6 +1051,9 @@ int comex_getv(
     nb_getv(iov, iov_len, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_getv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -887,6 +1066,7 @@ int comex_accv(
     nb_t *nb = NULL;
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
 
@@ -897,6 +1077,9 @@ int comex_accv(
     nb_accv(datatype, scale, iov, iov_len, world_proc, nb);
     nb_wait_for_all(nb);
 
+    comex_trace_end("comex_accv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -907,12 +1090,16 @@ int comex_fence_all(comex_group_t group)
     int count_before = 0;
     int count_after = 0;
     nb_t *nb = NULL;
+    long long trace_start = comex_trace_begin();
 
 #if DEBUG
     fprintf(stderr, "[%d] comex_fence_all(group=%d)\n", g_state.rank, group);
 #endif
     /* NOTE: We always fence on the world group */
 
+    /* requests queued in shared memory are complete once consumed */
+    _shm_queue_drain();
+
     /* count how many fence messagse to send */
     for (p=0; p<g_state.size; ++p) {
         if (fence_array[p]) {
@@ -927,6 +1114,7 @@ int comex_fence_all(comex_group_t group)
 
     /* check for no outstanding put/get requests */
     if (0 == count_before) {
+        comex_trace_end("comex_fence_all", trace_start, -1, 0);
         return COMEX_SUCCESS;
     }
 
@@ -980,6 +1168,8 @@ int comex_fence_all(comex_group_t group)
 
     COMEX_ASSERT(count_before == count_after);
 
+    comex_trace_end("comex_fence_all", trace_start, -1, 0);
+
     return COMEX_SUCCESS;
 }
 
@@ -990,12 +1180,120 @@ STATIC int _eager_check(int extra_bytes)
 }
 
 
+/* whether a request to proc may bypass MPI using my shared memory queue */
+STATIC int _shm_queue_check(int proc, int extra_bytes)
+{
+    return NULL != my_shm_queue
+        && g_state.master[proc] == g_state.master[g_state.rank]
+        && (((int)sizeof(header_t))+extra_bytes) <= COMEX_SHM_QUEUE_SLOT_SIZE;
+}
+
+
+/* wait until the progress rank has consumed all of my queued requests */
+STATIC void _shm_queue_drain(void)
+{
+    if (NULL != my_shm_queue) {
+        shm_queue_drain(my_shm_queue);
+    }
+}
+
+
+/* whether a small put or acc to proc should be batched into an OP_MULTI */
+STATIC int _coalesce_check(int proc, int extra_bytes)
+{
+    /* node-local requests take the SMP paths or my shared memory queue and
+     * must not be reordered with respect to those */
+    return NULL != coalesce_buffer
+        && g_state.master[proc] != g_state.master[g_state.rank]
+        && (((int)sizeof(header_t))+extra_bytes) <= COMEX_COALESCE_THRESHOLD;
+}
+
+
+/* copy one put or acc request into the pending OP_MULTI of its master */
+STATIC void _coalesce_append(header_t *header,
+        void *scale, int scale_size, void *src, nb_t *nb)
+{
+    int master_rank = g_state.master[header->rank];
+    int size = COALESCE_ALIGN(sizeof(header_t) + scale_size + header->length);
+    char *op = NULL;
+
+    if (NULL != coalesce_buffer[master_rank]
+            && coalesce_length[master_rank] + size > COMEX_COALESCE_BUFFER_SIZE) {
+        _coalesce_flush(master_rank, nb);
+    }
+
+    if (NULL == coalesce_buffer[master_rank]) {
+        coalesce_buffer[master_rank] = malloc(COMEX_COALESCE_BUFFER_SIZE);
+        COMEX_ASSERT(coalesce_buffer[master_rank]);
+        coalesce_length[master_rank] = sizeof(header_t);
+    }
+
+    op = coalesce_buffer[master_rank] + coalesce_length[master_rank];
+    (void)memcpy(op, header, sizeof(header_t));
+    (void)memcpy(op+sizeof(header_t), scale, scale_size);
+    (void)memcpy(op+sizeof(header_t)+scale_size, src, header->length);
+    coalesce_length[master_rank] += size;
+}
+
+
+/* send the pending OP_MULTI to master_rank, if any, as part of nb */
+STATIC void _coalesce_flush(int master_rank, nb_t *nb)
+{
+    char *message = NULL;
+    int message_size = 0;
+    header_t *header = NULL;
+
+    if (NULL == coalesce_buffer || NULL == coalesce_buffer[master_rank]) {
+        return;
+    }
+
+    /* detach first; nb_send_header() comes back through here */
+    message = coalesce_buffer[master_rank];
+    message_size = coalesce_length[master_rank];
+    coalesce_buffer[master_rank] = NULL;
+    coalesce_length[master_rank] = 0;
+
+    header = (header_t*)message;
+    MAYBE_MEMSET(header, 0, sizeof(header_t));
+    header->operation = OP_MULTI;
+    header->remote_address = NULL;
+    header->local_address = NULL;
+    header->rank = master_rank;
+    header->length = message_size - sizeof(header_t);
+    nb_send_header(message, message_size, master_rank, nb);
+}
+
+
+STATIC void _coalesce_flush_all(void)
+{
+    nb_t *nb = NULL;
+    int i = 0;
+
+    if (NULL == coalesce_buffer) {
+        return;
+    }
+
+    for (i=0; i<g_state.size; ++i) {
+        if (NULL != coalesce_buffer[i]) {
+            if (NULL == nb) {
+                nb = nb_wait_for_handle();
+            }
+            _coalesce_flush(i, nb);
+        }
+    }
+}
+
+
 STATIC void _fence_master(int master_rank)
 {
 #if DEBUG
     printf("[%d] _fence_master(master=%d)\n", g_state.rank, master_rank);
 #endif
 
+    if (master_rank == g_state.master[g_state.rank]) {
+        _shm_queue_drain();
+    }
+
     if (fence_array[master_rank]) {
         header_t *header = NULL;
         nb_t *nb = NULL;
@@ -1026,6 +1324,7 @@ int comex_fence_proc(int proc, comex_group_t group)
     int world_rank = -1;
     int master_rank = -1;
     comex_igroup_t *igroup = NULL;
+    long long trace_start = comex_trace_begin();
 
 #if DEBUG
     printf("[%d] comex_fence_proc(proc=%d, group=%d)\n",
@@ -1039,6 +1338,8 @@ int comex_fence_proc(int proc, comex_group_t group)
 
     _fence_master(master_rank);
 
+    comex_trace_end("comex_fence_proc", trace_start, world_rank, 0);
+
     return COMEX_SUCCESS;
 }
 
@@ -1048,6 +1349,7 @@ int comex_barrier(comex_group_t group)
 {
     int status = 0;
     MPI_Comm comm = MPI_COMM_NULL;
+    long long trace_start = comex_trace_begin();
 
 #if DEBUG
     static int count=-1;
@@ -1060,6 +1362,8 @@ int comex_barrier(comex_group_t group)
     COMEX_ASSERT(COMEX_SUCCESS == status);
     MPI_Barrier(comm);
 
+    comex_trace_end("comex_barrier", trace_start, -1, 0);
+
     return COMEX_SUCCESS;
 }
 
@@ -1094,6 +1398,19 @@ STATIC int _packed_size(int *src_stride, int *count, int stride_levels)
 }
 
 
+STATIC long _iov_bytes(comex_giov_t *iov, int iov_len)
+{
+    long bytes = 0;
+    int i = 0;
+
+    for (i=0; i<iov_len; ++i) {
+        bytes += (long)iov[i].count * iov[i].bytes;
+    }
+
+    return bytes;
+}
+
+
 STATIC char* pack(
         char *src, int *src_stride, int *count, int stride_levels, int *size)
 {
@@ -1365,6 +1682,7 @@ int comex_wait(comex_request_t* hdl)
 {
     int index = 0;
     nb_t *nb = NULL;
+    long long trace_start = comex_trace_begin();
 
     COMEX_ASSERT(NULL != hdl);
 
@@ -1382,6 +1700,8 @@ int comex_wait(comex_request_t* hdl)
 
     nb->in_use = 0;
 
+    comex_trace_end("comex_wait", trace_start, -1, 0);
+
     return COMEX_SUCCESS;
 }
 
@@ -1419,8 +1739,13 @@ int comex_test(comex_request_t* hdl, int *status)
 
 int comex_wait_all(comex_group_t group)
 {
+    long long trace_start = comex_trace_begin();
+
+    _coalesce_flush_all();
     nb_wait_all();
 
+    comex_trace_end("comex_wait_all", trace_start, -1, 0);
+
     return COMEX_SUCCESS;
 }
 
@@ -1434,6 +1759,7 @@ int comex_nbput(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1449,6 +1775,8 @@ int comex_nbput(
 
     nb_put(src, dst, bytes, world_proc, nb);
 
+    comex_trace_end("comex_nbput", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -1462,6 +1790,7 @@ int comex_nbget(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1477,6 +1806,8 @@ int comex_nbget(
 
     nb_get(src, dst, bytes, world_proc, nb);
 
+    comex_trace_end("comex_nbget", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -1491,6 +1822,7 @@ int comex_nbacc(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1506,6 +1838,8 @@ int comex_nbacc(
 
     nb_acc(datatype, scale, src, dst, bytes, world_proc, nb);
 
+    comex_trace_end("comex_nbacc", trace_start, world_proc, bytes);
+
     return COMEX_SUCCESS;
 }
 
@@ -1521,6 +1855,7 @@ int comex_nbputs(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1536,6 +1871,9 @@ int comex_nbputs(
 
     nb_puts(src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
 
+    comex_trace_end("comex_nbputs", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -1551,6 +1889,7 @@ int comex_nbgets(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1566,6 +1905,9 @@ int comex_nbgets(
 
     nb_gets(src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
 
+    comex_trace_end("comex_nbgets", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -1582,6 +1924,7 @@ int comex_nbaccs(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1598,6 +1941,9 @@ int comex_nbaccs(
     nb_accs(datatype, scale,
             src, src_stride, dst, dst_stride, count, stride_levels, world_proc, nb);
 
+    comex_trace_end("comex_nbaccs", trace_start, world_proc,
+            _packed_size(src_stride, count, stride_levels));
+
     return COMEX_SUCCESS;
 }
 
@@ -1611,6 +1957,7 @@ int comex_nbputv(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1626,6 +1973,9 @@ int comex_nbputv(
 
     nb_putv(iov, iov_len, world_proc, nb);
 
+    comex_trace_end("comex_nbputv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -1639,6 +1989,7 @@ int comex_nbgetv(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1654,6 +2005,9 @@ int comex_nbgetv(
 
     nb_getv(iov, iov_len, world_proc, nb);
 
+    comex_trace_end("comex_nbgetv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -1668,6 +2022,7 @@ int comex_nbaccv(
     int world_proc = -1;
     comex_igroup_t *igroup = NULL;
     comex_request_t _hdl = 0;
+    long long trace_start = comex_trace_begin();
 
     nb = nb_wait_for_handle();
     _hdl = nb_get_handle_index();
@@ -1683,6 +2038,9 @@ int comex_nbaccv(
 
     nb_accv(datatype, scale, iov, iov_len, world_proc, nb);
 
+    comex_trace_end("comex_nbaccv", trace_start, world_proc,
+            _iov_bytes(iov, iov_len));
+
     return COMEX_SUCCESS;
 }
 
@@ -1737,6 +2095,40 @@ int comex_rmw(
         default: COMEX_ASSERT(0);
     }
 
+    if (_shm_queue_check(world_rank, length)) {
+        /* rmw on SMP node via my shared memory queue */
+        unsigned long ticket = 0;
+        char *slot = NULL;
+
+        if (fence_array[master_rank]) {
+            _fence_master(master_rank);
+        }
+
+        slot = shm_queue_reserve(my_shm_queue, &ticket);
+        header = (header_t*)slot;
+        header->operation = op;
+        header->remote_address = prem;
+        header->local_address = ploc;
+        header->rank = world_rank;
+        header->length = length;
+        switch (comex_op) {
+            case COMEX_FETCH_AND_ADD:
+            case COMEX_SWAP:
+                (void)memcpy(slot+sizeof(header_t), &payload_int, length);
+                break;
+            case COMEX_FETCH_AND_ADD_LONG:
+            case COMEX_SWAP_LONG:
+                (void)memcpy(slot+sizeof(header_t), &payload_long, length);
+                break;
+            default: COMEX_ASSERT(0);
+        }
+        shm_queue_post(my_shm_queue);
+        shm_queue_wait(my_shm_queue, ticket);
+        (void)memcpy(ploc, slot+sizeof(header_t), length);
+
+        return COMEX_SUCCESS;
+    }
+
     /* create and prepare the header */
     message = malloc(sizeof(header_t) + length);
     COMEX_ASSERT(message);
@@ -2276,6 +2668,107 @@ void _free_semaphore()
 }
 
 
+/* one request queue per worker process, attached by its master */
+void _malloc_shm_queue()
+{
+    char *names = NULL;
+    int status = 0;
+    MPI_Datatype shm_name_type;
+    int i = 0;
+
+#if DEBUG
+    fprintf(stderr, "[%d] _malloc_shm_queue()\n", g_state.rank);
+#endif
+
+    status = MPI_Type_contiguous(SHM_NAME_SIZE, MPI_CHAR, &shm_name_type);
+    COMEX_ASSERT(MPI_SUCCESS == status);
+    status = MPI_Type_commit(&shm_name_type);
+    COMEX_ASSERT(MPI_SUCCESS == status);
+
+    names = (char*)malloc(sizeof(char) * SHM_NAME_SIZE * g_state.size);
+    COMEX_ASSERT(names);
+    (void)memset(names, 0, sizeof(char) * SHM_NAME_SIZE * g_state.size);
+
+    /* masters only consume, so they do not create a queue */
+    if (!_is_master()) {
+        shm_queue_name = _generate_shm_name(g_state.rank);
+        COMEX_ASSERT(shm_queue_name);
+        my_shm_queue = _shm_create(shm_queue_name, sizeof(shm_queue_t));
+        shm_queue_init(my_shm_queue);
+        (void)memcpy(&names[SHM_NAME_SIZE*g_state.rank],
+                shm_queue_name, SHM_NAME_SIZE);
+    }
+
+    /* exchange names */
+    status = MPI_Allgather(MPI_IN_PLACE, 1, shm_name_type,
+            names, 1, shm_name_type, g_state.comm);
+    COMEX_ASSERT(MPI_SUCCESS == status);
+
+    /* masters attach to the queues of the workers they serve */
+    if (_is_master()) {
+        shm_queues = (shm_queue_t**)malloc(sizeof(shm_queue_t*) * g_state.size);
+        COMEX_ASSERT(shm_queues);
+        for (i=0; i<g_state.size; ++i) {
+            if (g_state.rank != i && g_state.master[i] == g_state.rank) {
+                shm_queues[i] = _shm_attach(
+                        &names[SHM_NAME_SIZE*i], sizeof(shm_queue_t));
+                COMEX_ASSERT(shm_queues[i]);
+            }
+            else {
+                shm_queues[i] = NULL;
+            }
+        }
+    }
+
+    free(names);
+
+    status = MPI_Type_free(&shm_name_type);
+    COMEX_ASSERT(MPI_SUCCESS == status);
+}
+
+
+void _free_shm_queue()
+{
+    int i;
+    int retval;
+
+#if DEBUG
+    fprintf(stderr, "[%d] _free_shm_queue()\n", g_state.rank);
+#endif
+
+    if (NULL != my_shm_queue) {
+        retval = munmap(my_shm_queue, sizeof(shm_queue_t));
+        if (-1 == retval) {
+            perror("_free_shm_queue: munmap");
+            comex_error("_free_shm_queue: munmap", retval);
+        }
+        retval = shm_unlink(shm_queue_name);
+        if (-1 == retval) {
+            perror("_free_shm_queue: shm_unlink");
+            comex_error("_free_shm_queue: shm_unlink", retval);
+        }
+        my_shm_queue = NULL;
+    }
+
+    if (NULL != shm_queues) {
+        for (i=0; i<g_state.size; ++i) {
+            if (NULL != shm_queues[i]) {
+                retval = munmap(shm_queues[i], sizeof(shm_queue_t));
+                if (-1 == retval) {
+                    perror("_free_shm_queue: munmap");
+                    comex_error("_free_shm_queue: munmap", retval);
+                }
+            }
+        }
+        free(shm_queues);
+        shm_queues = NULL;
+    }
+
+    free(shm_queue_name);
+    shm_queue_name = NULL;
+}
+
+
 int comex_free(void *ptr, comex_group_t group)
 {
     comex_igroup_t *igroup = NULL;
@@ -2483,6 +2976,11 @@ STATIC void _progress_server()
     if (static_header_buffer_size < eager_threshold) {
         static_header_buffer_size = eager_threshold;
     }
+    /* or to receive a whole batch of coalesced requests */
+    if (COMEX_ENABLE_COALESCE
+            && static_header_buffer_size < COMEX_COALESCE_BUFFER_SIZE) {
+        static_header_buffer_size = COMEX_COALESCE_BUFFER_SIZE;
+    }
 
     /* initialize shared buffers */
     static_header_buffer = (char*)malloc(sizeof(char)*static_header_buffer_size);
@@ -2497,9 +2995,28 @@ STATIC void _progress_server()
         char *payload = NULL;
         header_t *header = NULL;
         MPI_Status recv_status;
-
-        MPI_Recv(static_header_buffer, static_header_buffer_size, MPI_CHAR,
-                MPI_ANY_SOURCE, COMEX_TAG, g_state.comm, &recv_status);
+        op_t operation = OP_NULL;
+        int op_length = 0;
+        long long trace_start = 0;
+
+        if (NULL != shm_queues) {
+            /* poll the SMP request queues while waiting for a header; the
+             * receive must not stay posted while a handler is running since
+             * handlers receive their own payloads */
+            MPI_Request recv_request;
+            int flag = 0;
+            MPI_Irecv(static_header_buffer, static_header_buffer_size,
+                    MPI_CHAR, MPI_ANY_SOURCE, COMEX_TAG, g_state.comm,
+                    &recv_request);
+            while (!flag) {
+                _shm_queue_progress();
+                MPI_Test(&recv_request, &flag, &recv_status);
+            }
+        }
+        else {
+            MPI_Recv(static_header_buffer, static_header_buffer_size, MPI_CHAR,
+                    MPI_ANY_SOURCE, COMEX_TAG, g_state.comm, &recv_status);
+        }
         MPI_Get_count(&recv_status, MPI_CHAR, &length);
         source = recv_status.MPI_SOURCE;
 #   if DEBUG
@@ -2508,6 +3025,10 @@ STATIC void _progress_server()
 #   endif
         header = (header_t*)static_header_buffer;
         payload = static_header_buffer + sizeof(header_t);
+        /* handlers may reuse the header buffer */
+        operation = header->operation;
+        op_length = header->length;
+        trace_start = comex_trace_begin();
         /* dispatch message handler */
         switch (header->operation) {
             case OP_PUT:
@@ -2588,11 +3109,15 @@ STATIC void _progress_server()
             case OP_FREE:
                 _free_handler(header, payload, source);
                 break;
+            case OP_MULTI:
+                _multi_handler(header, payload, source);
+                break;
             default:
                 fprintf(stderr, "[%d] header operation not recognized: %d\n",
                         g_state.rank, header->operation);
                 COMEX_ASSERT(0);
         }
+        comex_trace_end(op_name[operation], trace_start, source, op_length);
     }
 
     initialized = 0;
@@ -2602,6 +3127,10 @@ STATIC void _progress_server()
 
     _free_semaphore();
 
+    if (COMEX_ENABLE_SHM_QUEUE) {
+        _free_shm_queue();
+    }
+
     free(mutexes);
     free(lq_heads);
 
@@ -2623,12 +3152,190 @@ STATIC void _progress_server()
     fclose(comex_trace_file);
 #endif
 
+    comex_trace_finalize();
+
     // assume this is the end of a user's application
     MPI_Finalize();
     exit(EXIT_SUCCESS);
 }
 
 
+/* service every request currently posted to the SMP request queues */
+STATIC void _shm_queue_progress(void)
+{
+    int i = 0;
+
+    for (i=0; i<g_state.size; ++i) {
+        shm_queue_t *queue = shm_queues[i];
+        int count = 0;
+        char *slot = NULL;
+
+        if (NULL == queue) {
+            continue;
+        }
+        /* bounded so that MPI traffic is not starved */
+        while (count < COMEX_SHM_QUEUE_DEPTH
+                && NULL != (slot = shm_queue_peek(queue))) {
+            header_t *header = (header_t*)slot;
+            int length = header->length;
+            long long trace_start = comex_trace_begin();
+            _inline_handler(header, slot+sizeof(header_t));
+            comex_trace_end("_inline_handler", trace_start, i, length);
+            shm_queue_pop(queue);
+            ++count;
+        }
+    }
+}
+
+
+/* replies, if any, are written back into the payload */
+STATIC void _inline_handler(header_t *header, char *payload)
+{
+    reg_entry_t *reg_entry = NULL;
+    void *mapped_offset = NULL;
+
+#if DEBUG
+    fprintf(stderr, "[%d] _inline_handler op=%d rem=%p rank=%d len=%d\n",
+            g_state.rank,
+            header->operation,
+            header->remote_address,
+            header->rank,
+            header->length);
+#endif
+
+    reg_entry = reg_cache_find(
+            header->rank, header->remote_address, header->length);
+    COMEX_ASSERT(reg_entry);
+    mapped_offset = _get_offset_memory(reg_entry, header->remote_address);
+
+    switch (header->operation) {
+        case OP_PUT:
+            (void)memcpy(mapped_offset, payload, header->length);
+            break;
+        case OP_GET:
+            (void)memcpy(payload, mapped_offset, header->length);
+            break;
+        case OP_ACC_INT:
+        case OP_ACC_DBL:
+        case OP_ACC_FLT:
+        case OP_ACC_CPL:
+        case OP_ACC_DCP:
+        case OP_ACC_LNG:
+            {
+                int acc_type = 0;
+                int sizeof_scale = 0;
+                switch (header->operation) {
+                    case OP_ACC_INT:
+                        acc_type = COMEX_ACC_INT;
+                        sizeof_scale = sizeof(int);
+                        break;
+                    case OP_ACC_DBL:
+                        acc_type = COMEX_ACC_DBL;
+                        sizeof_scale = sizeof(double);
+                        break;
+                    case OP_ACC_FLT:
+                        acc_type = COMEX_ACC_FLT;
+                        sizeof_scale = sizeof(float);
+                        break;
+                    case OP_ACC_LNG:
+                        acc_type = COMEX_ACC_LNG;
+                        sizeof_scale = sizeof(long);
+                        break;
+                    case OP_ACC_CPL:
+                        acc_type = COMEX_ACC_CPL;
+                        sizeof_scale = sizeof(SingleComplex);
+                        break;
+                    case OP_ACC_DCP:
+                        acc_type = COMEX_ACC_DCP;
+                        sizeof_scale = sizeof(DoubleComplex);
+                        break;
+                    default: COMEX_ASSERT(0);
+                }
+                if (COMEX_ENABLE_ACC_SELF || COMEX_ENABLE_ACC_SMP) {
+                    sem_wait(semaphores[header->rank]);
+                    _acc(acc_type, header->length, mapped_offset,
+                            payload+sizeof_scale, payload);
+                    sem_post(semaphores[header->rank]);
+                }
+                else {
+                    _acc(acc_type, header->length, mapped_offset,
+                            payload+sizeof_scale, payload);
+                }
+            }
+            break;
+        case OP_FETCH_AND_ADD:
+            if (sizeof(int) == header->length) {
+                int value = *((int*)mapped_offset); /* "fetch" */
+                *((int*)mapped_offset) += *((int*)payload); /* "add" */
+                *((int*)payload) = value;
+            }
+            else if (sizeof(long) == header->length) {
+                long value = *((long*)mapped_offset); /* "fetch" */
+                *((long*)mapped_offset) += *((long*)payload); /* "add" */
+                *((long*)payload) = value;
+            }
+            else {
+                COMEX_ASSERT(0);
+            }
+            break;
+        case OP_SWAP:
+            if (sizeof(int) == header->length) {
+                int value = *((int*)mapped_offset); /* "fetch" */
+                *((int*)mapped_offset) = *((int*)payload); /* "swap" */
+                *((int*)payload) = value;
+            }
+            else if (sizeof(long) == header->length) {
+                long value = *((long*)mapped_offset); /* "fetch" */
+                *((long*)mapped_offset) = *((long*)payload); /* "swap" */
+                *((long*)payload) = value;
+            }
+            else {
+                COMEX_ASSERT(0);
+            }
+            break;
+        default:
+            fprintf(stderr, "[%d] queued operation not recognized: %d\n",
+                    g_state.rank, header->operation);
+            COMEX_ASSERT(0);
+    }
+}
+
+
+/* execute each put or acc batched by _coalesce_append() */
+STATIC void _multi_handler(header_t *header, char *payload, int proc)
+{
+    char *op = payload;
+    char *end = payload + header->length;
+
+#if DEBUG
+    fprintf(stderr, "[%d] _multi_handler proc=%d len=%d\n",
+            g_state.rank, proc, header->length);
+#endif
+
+    while (op < end) {
+        header_t *sub = (header_t*)op;
+        int scale_size = 0;
+
+        switch (sub->operation) {
+            case OP_PUT:            scale_size = 0; break;
+            case OP_ACC_INT:        scale_size = sizeof(int); break;
+            case OP_ACC_DBL:        scale_size = sizeof(double); break;
+            case OP_ACC_FLT:        scale_size = sizeof(float); break;
+            case OP_ACC_LNG:        scale_size = sizeof(long); break;
+            case OP_ACC_CPL:        scale_size = sizeof(SingleComplex); break;
+            case OP_ACC_DCP:        scale_size = sizeof(DoubleComplex); break;
+            default:
+                fprintf(stderr, "[%d] batched operation not recognized: %d\n",
+                        g_state.rank, sub->operation);
+                COMEX_ASSERT(0);
+        }
+        _inline_handler(sub, op+sizeof(header_t));
+        op += COALESCE_ALIGN(sizeof(header_t) + scale_size + sub->length);
+    }
+    COMEX_ASSERT(op == end);
+}
+
+
 STATIC void _put_handler(header_t *header, char *payload, int proc)
 {
     reg_entry_t *reg_entry = NULL;
@@ -4213,6 +4920,16 @@ STATIC void nb_send_common(void *buf, int count, int dest, nb_t *nb, int need_fr
 
     COMEX_ASSERT(NULL != nb);
 
+    /* keep queued requests ordered before MPI requests to my master */
+    if (dest == g_state.master[g_state.rank]) {
+        _shm_queue_drain();
+    }
+
+    /* likewise for batched requests to dest */
+    if (NULL != coalesce_buffer && NULL != coalesce_buffer[dest]) {
+        _coalesce_flush(dest, nb);
+    }
+
     nb->send_size += 1;
     nb_count_event += 1;
     nb_count_send += 1;
@@ -4651,6 +5368,7 @@ STATIC void nb_put(void *src, void *dst, int bytes, int proc, nb_t *nb)
     if (COMEX_ENABLE_PUT_SELF) {
         /* put to self */
         if (g_state.rank == proc) {
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4665,6 +5383,7 @@ STATIC void nb_put(void *src, void *dst, int bytes, int proc, nb_t *nb)
             reg_entry_t *reg_entry = NULL;
             void *mapped_offset = NULL;
 
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4677,6 +5396,43 @@ STATIC void nb_put(void *src, void *dst, int bytes, int proc, nb_t *nb)
         }
     }
 
+    if (_shm_queue_check(proc, bytes)) {
+        /* put to SMP node via my shared memory queue */
+        unsigned long ticket = 0;
+        char *slot = NULL;
+        header_t *header = NULL;
+
+        if (fence_array[g_state.master[proc]]) {
+            _fence_master(g_state.master[proc]);
+        }
+
+        slot = shm_queue_reserve(my_shm_queue, &ticket);
+        header = (header_t*)slot;
+        header->operation = OP_PUT;
+        header->remote_address = dst;
+        header->local_address = src;
+        header->rank = proc;
+        header->length = bytes;
+        (void)memcpy(slot+sizeof(header_t), src, bytes);
+        shm_queue_post(my_shm_queue);
+        return;
+    }
+
+    if (_coalesce_check(proc, bytes)) {
+        /* small put to another node, batched per master */
+        header_t header;
+
+        MAYBE_MEMSET(&header, 0, sizeof(header_t));
+        header.operation = OP_PUT;
+        header.remote_address = dst;
+        header.local_address = src;
+        header.rank = proc;
+        header.length = bytes;
+        fence_array[g_state.master[proc]] = 1;
+        _coalesce_append(&header, NULL, 0, src, nb);
+        return;
+    }
+
     {
         char *message = NULL;
         int message_size = 0;
@@ -4733,6 +5489,7 @@ STATIC void nb_get(void *src, void *dst, int bytes, int proc, nb_t *nb)
     if (COMEX_ENABLE_GET_SELF) {
         /* get from self */
         if (g_state.rank == proc) {
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4747,6 +5504,7 @@ STATIC void nb_get(void *src, void *dst, int bytes, int proc, nb_t *nb)
             reg_entry_t *reg_entry = NULL;
             void *mapped_offset = NULL;
 
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4759,6 +5517,29 @@ STATIC void nb_get(void *src, void *dst, int bytes, int proc, nb_t *nb)
         }
     }
 
+    if (_shm_queue_check(proc, bytes)) {
+        /* get from SMP node via my shared memory queue */
+        unsigned long ticket = 0;
+        char *slot = NULL;
+        header_t *header = NULL;
+
+        if (fence_array[g_state.master[proc]]) {
+            _fence_master(g_state.master[proc]);
+        }
+
+        slot = shm_queue_reserve(my_shm_queue, &ticket);
+        header = (header_t*)slot;
+        header->operation = OP_GET;
+        header->remote_address = src;
+        header->local_address = dst;
+        header->rank = proc;
+        header->length = bytes;
+        shm_queue_post(my_shm_queue);
+        shm_queue_wait(my_shm_queue, ticket);
+        (void)memcpy(dst, slot+sizeof(header_t), bytes);
+        return;
+    }
+
     {
         header_t *header = NULL;
         int master_rank = -1;
@@ -4802,6 +5583,7 @@ STATIC void nb_acc(int datatype, void *scale,
     if (COMEX_ENABLE_ACC_SELF) {
         /* acc to self */
         if (g_state.rank == proc) {
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4818,6 +5600,7 @@ STATIC void nb_acc(int datatype, void *scale,
             reg_entry_t *reg_entry = NULL;
             void *mapped_offset = NULL;
 
+            _shm_queue_drain();
             if (fence_array[g_state.master[proc]]) {
                 _fence_master(g_state.master[proc]);
             }
@@ -4872,9 +5655,45 @@ STATIC void nb_acc(int datatype, void *scale,
 
         master_rank = g_state.master[proc];
 
+        if (_shm_queue_check(proc, scale_size+bytes)) {
+            /* acc to SMP node via my shared memory queue */
+            unsigned long ticket = 0;
+            char *slot = NULL;
+
+            if (fence_array[master_rank]) {
+                _fence_master(master_rank);
+            }
+
+            slot = shm_queue_reserve(my_shm_queue, &ticket);
+            header = (header_t*)slot;
+            header->operation = operation;
+            header->remote_address = dst;
+            header->local_address = src;
+            header->rank = proc;
+            header->length = bytes;
+            (void)memcpy(slot+sizeof(header_t), scale, scale_size);
+            (void)memcpy(slot+sizeof(header_t)+scale_size, src, bytes);
+            shm_queue_post(my_shm_queue);
+            return;
+        }
+
         /* only fence on the master */
         fence_array[master_rank] = 1;
 
+        if (_coalesce_check(proc, scale_size+bytes)) {
+            /* small acc to another node, batched per master */
+            header_t small;
+
+            MAYBE_MEMSET(&small, 0, sizeof(header_t));
+            small.operation = operation;
+            small.remote_address = dst;
+            small.local_address = src;
+            small.rank = proc;
+            small.length = bytes;
+            _coalesce_append(&small, scale, scale_size, src, nb);
+            return;
+        }
+
         if (use_eager) {
             message_size = sizeof(header_t) + scale_size + bytes;
         }
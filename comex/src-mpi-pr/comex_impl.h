@@ -12,6 +12,10 @@
 #define COMEX_TAG 27624
 #define COMEX_STATIC_BUFFER_SIZE (2u*1048576u)
 #define SHM_NAME_SIZE 31
+#define COMEX_SHM_QUEUE_SLOT_SIZE 256
+#define COMEX_SHM_QUEUE_DEPTH 64 /* must be a power of two */
+#define COMEX_COALESCE_BUFFER_SIZE_DEFAULT 65536
+#define COMEX_COALESCE_THRESHOLD_DEFAULT 1024
 #define UNLOCKED -1
 
 /* performance or correctness related settings */
@@ -38,6 +42,8 @@
 #define ENABLE_PUT_IOV 1
 #define ENABLE_GET_IOV 1
 #define ENABLE_ACC_IOV 1
+#define ENABLE_SHM_QUEUE 1
+#define ENABLE_COALESCE 0
 
 #define DEBUG 0
 #define DEBUG_VERBOSE 0
@@ -0,0 +1,160 @@
+/**
+ * Lock-free shared memory request queue.
+ *
+ * Each user rank owns one queue which is drained by the progress rank of its
+ * SMP node.  There is exactly one producer and one consumer per queue, so
+ * the only synchronization needed is a full memory barrier between writing
+ * a slot and publishing its ticket (and vice versa for the consumer).
+ */
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* C headers */
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* 3rd party headers */
+#include <mpi.h>
+
+/* our headers */
+#include "comex.h"
+#include "comex_impl.h"
+#include "shm_queue.h"
+
+#define STATIC static inline
+
+#define SHM_QUEUE_BARRIER() __sync_synchronize()
+
+
+/**
+ * Initializes an empty queue.  Only called by the producer, before the
+ * name of the shared memory segment is handed to the consumer.
+ *
+ * @param[in] queue the queue
+ */
+void shm_queue_init(shm_queue_t *queue)
+{
+    COMEX_ASSERT(NULL != queue);
+    COMEX_ASSERT(0 == (COMEX_SHM_QUEUE_DEPTH & (COMEX_SHM_QUEUE_DEPTH-1)));
+
+    queue->head = 0;
+    queue->tail = 0;
+    SHM_QUEUE_BARRIER();
+}
+
+
+/**
+ * Returns the next free slot, spinning while the queue is full.
+ *
+ * The slot is not visible to the consumer until shm_queue_post() is called.
+ *
+ * @param[in] queue the queue
+ * @param[out] ticket ticket of the reserved slot, see shm_queue_wait()
+ *
+ * @return pointer to COMEX_SHM_QUEUE_SLOT_SIZE bytes of slot data
+ */
+char *shm_queue_reserve(shm_queue_t *queue, unsigned long *ticket)
+{
+    unsigned long head = 0;
+
+    COMEX_ASSERT(NULL != queue);
+    COMEX_ASSERT(NULL != ticket);
+
+    head = queue->head;
+    while (head - queue->tail >= COMEX_SHM_QUEUE_DEPTH) {
+        /* full, wait for the progress rank to catch up */
+    }
+    SHM_QUEUE_BARRIER();
+
+    *ticket = head;
+    return queue->slots[head & (COMEX_SHM_QUEUE_DEPTH-1)].data;
+}
+
+
+/**
+ * Publishes the slot most recently returned by shm_queue_reserve().
+ *
+ * @param[in] queue the queue
+ */
+void shm_queue_post(shm_queue_t *queue)
+{
+    COMEX_ASSERT(NULL != queue);
+
+    SHM_QUEUE_BARRIER();
+    queue->head = queue->head + 1;
+}
+
+
+/**
+ * Spins until the consumer has completed the given ticket.  On return any
+ * reply written into the slot by the consumer is visible.
+ *
+ * @param[in] queue the queue
+ * @param[in] ticket ticket returned by shm_queue_reserve()
+ */
+void shm_queue_wait(shm_queue_t *queue, unsigned long ticket)
+{
+    COMEX_ASSERT(NULL != queue);
+
+    while (queue->tail <= ticket) {
+        /* spin */
+    }
+    SHM_QUEUE_BARRIER();
+}
+
+
+/**
+ * Spins until every posted slot has been completed by the consumer.
+ *
+ * @param[in] queue the queue
+ */
+void shm_queue_drain(shm_queue_t *queue)
+{
+    COMEX_ASSERT(NULL != queue);
+
+    while (queue->tail != queue->head) {
+        /* spin */
+    }
+    SHM_QUEUE_BARRIER();
+}
+
+
+/**
+ * Returns the oldest posted slot, or NULL if the queue is empty.
+ *
+ * @param[in] queue the queue
+ *
+ * @return pointer to the slot data or NULL
+ */
+char *shm_queue_peek(shm_queue_t *queue)
+{
+    unsigned long tail = 0;
+
+    COMEX_ASSERT(NULL != queue);
+
+    tail = queue->tail;
+    if (tail == queue->head) {
+        return NULL;
+    }
+    SHM_QUEUE_BARRIER();
+
+    return queue->slots[tail & (COMEX_SHM_QUEUE_DEPTH-1)].data;
+}
+
+
+/**
+ * Completes the slot most recently returned by shm_queue_peek(), handing it
+ * (and any reply written into it) back to the producer.
+ *
+ * @param[in] queue the queue
+ */
+void shm_queue_pop(shm_queue_t *queue)
+{
+    COMEX_ASSERT(NULL != queue);
+
+    SHM_QUEUE_BARRIER();
+    queue->tail = queue->tail + 1;
+}
@@ -0,0 +1,44 @@
+#ifndef _SHM_QUEUE_H_
+#define _SHM_QUEUE_H_
+
+#include <stddef.h>
+
+#define SHM_QUEUE_CACHE_LINE 64
+
+/**
+ * One fixed-size request slot; holds a header plus a small inline payload.
+ * Requests that expect a reply (get, rmw) have it written back in place.
+ */
+typedef struct _shm_slot_t {
+    char data[COMEX_SHM_QUEUE_SLOT_SIZE];
+} shm_slot_t;
+
+/**
+ * Single-producer, single-consumer ring living in posix shared memory.
+ *
+ * The producer is the user rank that created the segment, the consumer is
+ * the progress rank of the same SMP node. The head and tail tickets only
+ * ever increase and live on separate cache lines.
+ */
+typedef struct _shm_queue_t {
+    volatile unsigned long head;    /**< next ticket to post (producer) */
+    char pad0[SHM_QUEUE_CACHE_LINE - sizeof(unsigned long)];
+    volatile unsigned long tail;    /**< next ticket to complete (consumer) */
+    char pad1[SHM_QUEUE_CACHE_LINE - sizeof(unsigned long)];
+    shm_slot_t slots[COMEX_SHM_QUEUE_DEPTH];
+} shm_queue_t;
+
+/* functions
+ *
+ * documentation is in the *.c file
+ */
+
+void shm_queue_init(shm_queue_t *queue);
+char *shm_queue_reserve(shm_queue_t *queue, unsigned long *ticket);
+void shm_queue_post(shm_queue_t *queue);
+void shm_queue_wait(shm_queue_t *queue, unsigned long ticket);
+void shm_queue_drain(shm_queue_t *queue);
+char *shm_queue_peek(shm_queue_t *queue);
+void shm_queue_pop(shm_queue_t *queue);
+
+#endif /* _SHM_QUEUE_H_ */
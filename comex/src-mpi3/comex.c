@@ -23,7 +23,6 @@
 
 /*
 #define USE_PRIOR_MPI_WIN_FLUSH
-#define USE_POST_MPI_WIN_FLUSH
 */
 
 /*
@@ -33,13 +32,17 @@
 
 #define USE_MPI_REQUESTS
 /*
-#define USE_MPI_FLUSH_LOCAL
 #define USE_MPI_WIN_ALLOC
 */
 
-#ifdef USE_MPI_FLUSH_LOCAL
-#define USE_MPI_REQUESTS
-#endif
+/* How individual request-based operations are completed, selected at runtime
+ * with COMEX_RMA_COMPLETION. Remote completion of puts and accumulates is
+ * otherwise deferred to comex_fence_*() and comex_wait_all(). */
+typedef enum {
+  RMA_REQUEST,      /* MPI_Rput/Rget/Raccumulate + MPI_Wait (default) */
+  RMA_FLUSH_LOCAL,  /* plain RMA + MPI_Win_flush_local */
+  RMA_FLUSH         /* as RMA_REQUEST, plus MPI_Win_flush on every op */
+} rma_completion_t;
 
 /* exported state */
 local_state l_state;
@@ -47,10 +50,14 @@ local_state l_state;
 /* static state */
 static int  initialized=0;  /* for comex_initialized(), 0=false */
 static char skip_lock=0;    /* don't acquire or release lock */
+static int  win_per_group=0; /* sub-allocate from one dynamic window per group */
+static rma_completion_t rma_completion=RMA_REQUEST;
+static int  dirty_count=0;  /* sum of the dirty counts of all groups */
 
 /* static function declarations */
 static void acquire_remote_lock(int proc);
 static void release_remote_lock(int proc);
+static MPI_Win get_group_win(comex_group_t group, comex_igroup_t *igroup);
 static inline void acc(
         int datatype, int count, void *get_buf,
         void *src_ptr, long src_idx, void *scale);
@@ -71,11 +78,7 @@ typedef struct {
   MPI_Datatype src_type;
   MPI_Datatype dst_type;
   int active;
-#ifdef USE_MPI_FLUSH_LOCAL
-  int remote_proc;
-#else
   int remote_proc;
-#endif
 } nb_t;
 
 static nb_t **nb_list = NULL;
@@ -109,12 +112,31 @@ void get_nb_request(comex_request_t *handle, nb_t **req)
      * handle as available. This is NOT thread safe */
     *handle = nb_full_count;
     comex_wait(handle);
+    *req = nb_list[*handle];
     nb_full_count++;
     nb_full_count = nb_full_count%nb_max_outstanding;
   }
 }
 #endif
 
+/**
+ * Record that a put or accumulate to world rank proc has been issued in a
+ * window of igroup and not yet completed at the target by
+ * comex_fence_proc() or comex_wait_all().
+ */
+static inline void mark_dirty(comex_igroup_t *igroup, int proc)
+{
+  if (NULL == igroup->dirty) {
+    igroup->dirty = (char*)calloc(l_state.size, sizeof(char));
+    COMEX_ASSERT(igroup->dirty);
+  }
+  if (!igroup->dirty[proc]) {
+    igroup->dirty[proc] = 1;
+    igroup->dirty_count++;
+    dirty_count++;
+  }
+}
+
 /**
  * Utility function to catch and translate MPI errors. Returns silently if
  * no error detected.
@@ -131,6 +153,57 @@ void translate_mpi_error(int ierr, const char* location)
   fprintf(stderr,"p[%d] MPI_Error: %s\n",l_state.rank,err_string);
 }
 
+/**
+ * Complete at world rank proc the puts and accumulates issued in the windows
+ * of igroup.
+ */
+static void flush_proc(comex_igroup_t *igroup, int proc)
+{
+  win_link_t *curr_win;
+  int lproc, ierr;
+
+  ierr = MPI_Group_translate_ranks(group_list->group, 1, &proc,
+      igroup->group, &lproc);
+  translate_mpi_error(ierr,"flush_proc:MPI_Group_translate_ranks");
+  curr_win = igroup->win_list;
+  while (curr_win != NULL) {
+    ierr = MPI_Win_flush(lproc, curr_win->win);
+    translate_mpi_error(ierr,"flush_proc:MPI_Win_flush");
+    curr_win = curr_win->next;
+  }
+  if (igroup->dirty != NULL && igroup->dirty[proc]) {
+    igroup->dirty[proc] = 0;
+    igroup->dirty_count--;
+    dirty_count--;
+  }
+}
+
+/**
+ * Complete all puts and accumulates issued in the windows of igroup.
+ */
+static void flush_all(comex_igroup_t *igroup)
+{
+  win_link_t *curr_win;
+  int ierr;
+
+  curr_win = igroup->win_list;
+  while (curr_win != NULL) {
+#ifdef USE_MPI_REQUESTS
+    ierr = MPI_Win_flush_all(curr_win->win);
+    translate_mpi_error(ierr,"flush_all:MPI_Win_flush_all");
+#else
+    ierr = MPI_Win_fence(0,curr_win->win);
+    translate_mpi_error(ierr,"flush_all:MPI_Win_fence");
+#endif
+    curr_win = curr_win->next;
+  }
+  if (igroup->dirty_count > 0) {
+    memset(igroup->dirty, 0, l_state.size);
+    dirty_count -= igroup->dirty_count;
+    igroup->dirty_count = 0;
+  }
+}
+
 
 /* Translate global process rank to local process rank */
 int get_local_rank_from_win(MPI_Win win, int world_rank, int *local_rank)
@@ -184,6 +257,34 @@ int comex_init()
     /* groups */
     comex_group_init();
 
+    /* env vars */
+    {
+      char *value = NULL;
+      win_per_group = 0; /* default */
+      value = getenv("COMEX_WIN_PER_GROUP");
+      if (NULL != value) {
+        win_per_group = atoi(value);
+      }
+
+      rma_completion = RMA_REQUEST; /* default */
+      value = getenv("COMEX_RMA_COMPLETION");
+      if (NULL != value) {
+        if (0 == strcmp(value, "request")) {
+          rma_completion = RMA_REQUEST;
+        } else if (0 == strcmp(value, "flush_local")) {
+          rma_completion = RMA_FLUSH_LOCAL;
+        } else if (0 == strcmp(value, "flush")) {
+          rma_completion = RMA_FLUSH;
+        } else if (0 == l_state.rank) {
+          fprintf(stderr, "[%d] ignoring unknown COMEX_RMA_COMPLETION=%s\n",
+              l_state.rank, value);
+        }
+      }
+#ifndef USE_MPI_REQUESTS
+      rma_completion = RMA_REQUEST;
+#endif
+    }
+
     /* register windows initialization */
     reg_win_init(l_state.size);
 
@@ -203,6 +304,9 @@ int comex_init()
     }
 #endif
 
+    /* targets with puts or accumulates awaiting remote completion */
+    dirty_count = 0;
+
     /* sync - initialize first communication epoch */
     comex_fence_all(COMEX_GROUP_WORLD);
     /* Synch - Sanity Check */
@@ -261,12 +365,13 @@ int comex_put(
     MPI_Status status;
 #endif
     reg_win = reg_win_find(proc, dst, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     /**
      * All processes called MPI_WIN_LOCK_ALL on the reg_win->win window used for
      * these calls. This call:
@@ -300,50 +405,50 @@ int comex_put(
     translate_mpi_error(ierr,"comex_put:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    /**
-     * The local communication buffer of an RMA call should not be updated, and
-     * the local communication buffer of a get call should not be accessed after
-     * the RMA call until the operation completes at the origin.
-     */
-    ierr = MPI_Put(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_put:MPI_Put");
-    /**
-     * MPI_WIN_FLUSH_LOCAL locally completes at the origin all outstanding RMA
-     * operations initiated by the calling process to the target process
-     * specified by the rank on the specified window. For example, after the
-     * routine completes, the user may reused any buffers provided to put, get,
-     * or accumulate operations
-     */
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_put:MPI_Win_flush_local");
-#else
-    /**
-     * MPI_RPUT is similar to MPI_PUT, except that it allocates a communication
-     * request object and associates it with the request handle. The completion
-     * of an MPI_RPUT operation (i.e. after the corresponding test or wait)
-     * indicates that the sender is now free to update the locations in the
-     * origin buffer. It does not indicate that the data is available at the
-     * target window. If remote completion is required, MPI_WIN_FLUSH,
-     * MPI_WIN_FLUSH_ALL, MPI_WIN_UNLOCK or MPI_WIN_UNLOCK_ALL can be used.
-     */
-    ierr = MPI_Rput(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_put:MPI_Rput");
-    /**
-     * A call to MPI_WAIT returns when the operation identified by the request
-     * is complete. If the request is an active persistent request, it is marked
-     * inactive. Any other type of request is and the request handle is set to
-     * MPI_REQUEST_NULL. MPI_WAIT is a non-local operation
-     */
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_put:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_put:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      /**
+       * The local communication buffer of an RMA call should not be updated, and
+       * the local communication buffer of a get call should not be accessed after
+       * the RMA call until the operation completes at the origin.
+       */
+      ierr = MPI_Put(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_put:MPI_Put");
+      /**
+       * MPI_WIN_FLUSH_LOCAL locally completes at the origin all outstanding RMA
+       * operations initiated by the calling process to the target process
+       * specified by the rank on the specified window. For example, after the
+       * routine completes, the user may reused any buffers provided to put, get,
+       * or accumulate operations
+       */
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_put:MPI_Win_flush_local");
+    } else {
+      /**
+       * MPI_RPUT is similar to MPI_PUT, except that it allocates a communication
+       * request object and associates it with the request handle. The completion
+       * of an MPI_RPUT operation (i.e. after the corresponding test or wait)
+       * indicates that the sender is now free to update the locations in the
+       * origin buffer. It does not indicate that the data is available at the
+       * target window. If remote completion is required, MPI_WIN_FLUSH,
+       * MPI_WIN_FLUSH_ALL, MPI_WIN_UNLOCK or MPI_WIN_UNLOCK_ALL can be used.
+       */
+      ierr = MPI_Rput(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_put:MPI_Rput");
+      /**
+       * A call to MPI_WAIT returns when the operation identified by the request
+       * is complete. If the request is an active persistent request, it is marked
+       * inactive. Any other type of request is and the request handle is set to
+       * MPI_REQUEST_NULL. MPI_WAIT is a non-local operation
+       */
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_put:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_put:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_put:MPI_Win_lock");
@@ -377,7 +482,7 @@ int comex_get(
     MPI_Status status;
 #endif
     reg_win = reg_win_find(proc, src, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(src) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
@@ -388,23 +493,23 @@ int comex_get(
     translate_mpi_error(ierr,"comex_get:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_get:MPI_Get");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_get:MPI_Win_flush_local");
-#else
-    ierr = MPI_Rget(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_get:MPI_Rget");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_get:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_get:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_get:MPI_Get");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_get:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Rget(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_get:MPI_Rget");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_get:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_get:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_get:MPI_Win_lock");
@@ -441,12 +546,13 @@ int comex_acc(
 #endif
     MPI_Datatype mpi_type;
     reg_win = reg_win_find(proc, dst, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     if (datatype == COMEX_ACC_INT) {
       int *buf;
       int *isrc = (int*)src;
@@ -529,23 +635,23 @@ int comex_acc(
     translate_mpi_error(ierr,"comex_acc:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Accumulate(tbuf,count,mpi_type,lproc,displ,count,
-        mpi_type,MPI_SUM,reg_win->win);
-    translate_mpi_error(ierr,"comex_acc:MPI_Accumulate");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_acc:MPI_Win_flush_local");
-#else
-    ierr = MPI_Raccumulate(tbuf,count,mpi_type,lproc,displ,count,
-        mpi_type,MPI_SUM,reg_win->win,&request);
-    translate_mpi_error(ierr,"comex_acc:MPI_Raccumulate");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_acc:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_acc:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Accumulate(tbuf,count,mpi_type,lproc,displ,count,
+          mpi_type,MPI_SUM,reg_win->win);
+      translate_mpi_error(ierr,"comex_acc:MPI_Accumulate");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_acc:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Raccumulate(tbuf,count,mpi_type,lproc,displ,count,
+          mpi_type,MPI_SUM,reg_win->win,&request);
+      translate_mpi_error(ierr,"comex_acc:MPI_Raccumulate");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_acc:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_acc:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_acc:MPI_Win_lock");
@@ -707,7 +813,7 @@ int comex_puts(
       return comex_put(src_ptr, dst_ptr, count[0], proc, group);
     }
     reg_win = reg_win_find(proc, dst_ptr, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst_ptr) - (MPI_Aint)(ptr);
 
     strided_to_subarray_dtype(src_stride_ar, count, stride_levels,
@@ -718,6 +824,7 @@ int comex_puts(
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_puts:MPI_Type_commit");
     ierr = MPI_Type_commit(&dst_type);
@@ -727,23 +834,23 @@ int comex_puts(
     translate_mpi_error(ierr,"comex_puts:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_puts:MPI_Put");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_puts:MPI_Win_flush_local");
-#else
-    ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_puts:MPI_Rput");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_puts:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_puts:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_puts:MPI_Put");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_puts:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_puts:MPI_Rput");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_puts:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_puts:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_puts:MPI_Win_lock");
@@ -850,7 +957,7 @@ int comex_gets(
       return comex_get(src_ptr, dst_ptr, count[0], proc, group);
     }
     reg_win = reg_win_find(proc, src_ptr, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(src_ptr) - (MPI_Aint)(ptr);
 
     strided_to_subarray_dtype(src_stride_ar, count, stride_levels,
@@ -870,23 +977,23 @@ int comex_gets(
     translate_mpi_error(ierr,"comex_gets:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_gets:MPI_Get");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_gets:MPI_Win_flush_local");
-#else
-    ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_gets:MPI_Rget");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_gets:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_gets:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_gets:MPI_Get");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_gets:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_gets:MPI_Rget");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_gets:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_gets:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_gets:MPI_Win_lock");
@@ -1109,12 +1216,13 @@ int comex_accs(
           dst_ptr, count[0], proc, group);
     }
     reg_win = reg_win_find(proc, dst_ptr, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst_ptr) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     packbuf = malloc_strided_acc_buffer(src_ptr, src_stride_ar, count,
         stride_levels, &bufsize, new_strides);
 
@@ -1209,23 +1317,23 @@ int comex_accs(
     translate_mpi_error(ierr,"comex_accs:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Accumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win);
-    translate_mpi_error(ierr,"comex_accs:MPI_Accumulate");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_accs:MPI_Win_flush_local");
-#else
-    ierr = MPI_Raccumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win,&request);
-    translate_mpi_error(ierr,"comex_accs:MPI_Raccumulate");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_accs:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_accs:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Accumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win);
+      translate_mpi_error(ierr,"comex_accs:MPI_Accumulate");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_accs:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Raccumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win,&request);
+      translate_mpi_error(ierr,"comex_accs:MPI_Raccumulate");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_accs:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_accs:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_accs:MPI_Win_lock");
@@ -1363,13 +1471,14 @@ int comex_putv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, dst_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     vector_to_struct_dtype(src_ptr, ptr, iov, iov_len,
         MPI_BYTE, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_putv:MPI_Type_commit");
     ierr = MPI_Type_commit(&dst_type);
@@ -1379,23 +1488,23 @@ int comex_putv(
     translate_mpi_error(ierr,"comex_putv:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_putv:MPI_Put");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_putv:MPI_Win_flush_local");
-#else
-    ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_putv:MPI_Rput");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_putv:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_putv:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_putv:MPI_Put");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_putv:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_putv:MPI_Rput");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_putv:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_putv:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_putv:MPI_Win_lock");
@@ -1448,7 +1557,7 @@ int comex_getv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, src_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     vector_to_struct_dtype(ptr, dst_ptr, iov, iov_len,
         MPI_BYTE, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
@@ -1464,23 +1573,23 @@ int comex_getv(
     translate_mpi_error(ierr,"comex_getv:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_getv:MPI_Get");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_getv:MPI_Win_flush_local");
-#else
-    ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_getv:MPI_Rget");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_getv:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_getv:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_getv:MPI_Get");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_getv:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_getv:MPI_Rget");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_getv:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_getv:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_getv:MPI_Win_lock");
@@ -1766,13 +1875,14 @@ int comex_accv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, dst_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     src_ptr = create_vector_buf_and_dtypes(ptr, iov,
         iov_len, size, scale, base_type, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_accv:MPI_Type_commit");
     ierr = MPI_Type_commit(&dst_type);
@@ -1782,23 +1892,23 @@ int comex_accv(
     translate_mpi_error(ierr,"comex_accv:MPI_Win_flush");
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Accumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win);
-    translate_mpi_error(ierr,"comex_accv:MPI_Accumulate");
-    ierr = MPI_Win_flush_local(lproc, reg_win->win);
-    translate_mpi_error(ierr,"comex_accv:MPI_Win_flush_local");
-#else
-    ierr = MPI_Raccumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win,&request);
-    translate_mpi_error(ierr,"comex_accv:MPI_Raccumulate");
-    ierr = MPI_Wait(&request, &status);
-    translate_mpi_error(ierr,"comex_accv:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-    ierr = MPI_Win_flush(lproc,reg_win->win);
-    translate_mpi_error(ierr,"comex_accv:MPI_Win_flush");
-#endif
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Accumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win);
+      translate_mpi_error(ierr,"comex_accv:MPI_Accumulate");
+      ierr = MPI_Win_flush_local(lproc, reg_win->win);
+      translate_mpi_error(ierr,"comex_accv:MPI_Win_flush_local");
+    } else {
+      ierr = MPI_Raccumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win,&request);
+      translate_mpi_error(ierr,"comex_accv:MPI_Raccumulate");
+      ierr = MPI_Wait(&request, &status);
+      translate_mpi_error(ierr,"comex_accv:MPI_Wait");
+      if (RMA_FLUSH == rma_completion) {
+        ierr = MPI_Win_flush(lproc,reg_win->win);
+        translate_mpi_error(ierr,"comex_accv:MPI_Win_flush");
+      }
+    }
 #else
     ierr = MPI_Win_lock(MPI_LOCK_SHARED,lproc,0,reg_win->win);
     translate_mpi_error(ierr,"comex_accv:MPI_Win_lock");
@@ -1827,15 +1937,16 @@ int comex_fence_all(comex_group_t group)
 int comex_fence_proc(int proc, comex_group_t group)
 {
   comex_igroup_t *igroup = NULL;
-  win_link_t *curr_win;
-  int ierr;
-  igroup = comex_get_igroup_from_group(group);
-  if (igroup != NULL) {
-    curr_win = igroup->win_list;
-    while (curr_win != NULL) {
-      ierr = MPI_Win_flush(proc, curr_win->win);
-      translate_mpi_error(ierr,"comex_fence_proc:MPI_Win_flush");
-      curr_win = curr_win->next;
+  int world_proc, ierr;
+
+  ierr = comex_group_translate_world(group, proc, &world_proc);
+  COMEX_ASSERT(COMEX_SUCCESS == ierr);
+  /* puts and accumulates to proc may have gone through the windows of any
+   * group, and only the groups that wrote to proc since it was last flushed
+   * need a flush */
+  for (igroup = group_list; igroup != NULL; igroup = igroup->next) {
+    if (igroup->dirty != NULL && igroup->dirty[world_proc]) {
+      flush_proc(igroup, world_proc);
     }
   }
   return COMEX_SUCCESS;
@@ -1936,18 +2047,18 @@ int comex_wait(comex_request_t* hdl)
   return COMEX_SUCCESS;
 #endif
 #ifdef USE_MPI_REQUESTS
-#ifdef USE_MPI_FLUSH_LOCAL
-  ierr = MPI_Win_flush_local(nb_list[*hdl]->remote_proc,nb_list[*hdl]->win);
-  translate_mpi_error(ierr,"comex_wait:MPI_Win_flush_local");
-#else
-  MPI_Status status;
-  ierr = MPI_Wait(&(nb_list[*hdl]->request),&status);
-  translate_mpi_error(ierr,"comex_wait:MPI_Wait");
-#ifdef USE_POST_MPI_WIN_FLUSH
-  ierr = MPI_Win_flush(nb_list[*hdl]->remote_proc,nb_list[*hdl]->win);
-  translate_mpi_error(ierr,"comex_wait:MPI_Win_flush_local");
-#endif
-#endif
+  if (RMA_FLUSH_LOCAL == rma_completion) {
+    ierr = MPI_Win_flush_local(nb_list[*hdl]->remote_proc,nb_list[*hdl]->win);
+    translate_mpi_error(ierr,"comex_wait:MPI_Win_flush_local");
+  } else {
+    MPI_Status status;
+    ierr = MPI_Wait(&(nb_list[*hdl]->request),&status);
+    translate_mpi_error(ierr,"comex_wait:MPI_Wait");
+    if (RMA_FLUSH == rma_completion) {
+      ierr = MPI_Win_flush(nb_list[*hdl]->remote_proc,nb_list[*hdl]->win);
+      translate_mpi_error(ierr,"comex_wait:MPI_Win_flush_local");
+    }
+  }
   nb_list[*hdl]->active = 0;
   if (nb_list[*hdl]->use_type) {
     ierr = MPI_Type_free(&(nb_list[*hdl]->src_type));
@@ -1994,22 +2105,34 @@ int comex_test(comex_request_t* hdl, int *status)
 int comex_wait_all(comex_group_t group)
 {
     comex_igroup_t *igroup = NULL;
-    win_link_t *curr_win;
-    int ierr;
-    igroup = comex_get_igroup_from_group(group);
-    if (igroup != NULL) {
-      curr_win = igroup->win_list;
-      while (curr_win != NULL) {
 #ifdef USE_MPI_REQUESTS
-        ierr = MPI_Win_flush_all(curr_win->win);
-        translate_mpi_error(ierr,"comex_wait_all:MPI_Win_flush_all");
-#else
-        ierr = MPI_Win_fence(0,curr_win->win);
-        translate_mpi_error(ierr,"comex_wait_all:MPI_Win_fence");
-#endif
-        curr_win = curr_win->next;
+    comex_request_t i;
+    /* local completion of anything still outstanding */
+    for (i=0; i<nb_max_outstanding; i++) {
+      if (nb_list[i]->active) {
+        comex_wait(&i);
       }
     }
+    /* gets are complete and no put or accumulate needs remote completion,
+     * so the flush of every window can be skipped */
+    if (0 == dirty_count) {
+      return COMEX_SUCCESS;
+    }
+    /* a flush is local, so on the world group it also completes the
+     * operations issued in the windows of the other groups */
+    if (group == COMEX_GROUP_WORLD) {
+      for (igroup = group_list; igroup != NULL; igroup = igroup->next) {
+        if (igroup->dirty_count > 0) {
+          flush_all(igroup);
+        }
+      }
+      return COMEX_SUCCESS;
+    }
+#endif
+    igroup = comex_get_igroup_from_group(group);
+    if (igroup != NULL) {
+      flush_all(igroup);
+    }
     return COMEX_SUCCESS;
 }
 
@@ -2033,30 +2156,31 @@ int comex_nbput(
     reg_entry_t *reg_win;
     MPI_Request request;
     reg_win = reg_win_find(proc, dst, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     get_nb_request(hdl, &req);
 #ifdef USE_PRIOR_MPI_WIN_FLUSH
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbput:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Put(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbput:MPI_Put");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rput(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbput:MPI_Rput");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Put(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbput:MPI_Put");
+    } else {
+      ierr = MPI_Rput(src, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbput:MPI_Rput");
+    }
     req->request = request;
     req->use_type = 0;
+    req->remote_proc = lproc;
+    req->win = reg_win->win;
     req->active = 1;
     return COMEX_SUCCESS;
 #else
@@ -2084,7 +2208,7 @@ int comex_nbget(
     reg_entry_t *reg_win;
     MPI_Request request;
     reg_win = reg_win_find(proc, src, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(src) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
@@ -2095,19 +2219,19 @@ int comex_nbget(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbget:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbget:MPI_Get");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rget(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbget:MPI_Rget");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbget:MPI_Get");
+    } else {
+      ierr = MPI_Rget(dst, bytes, MPI_CHAR, lproc, displ, bytes, MPI_CHAR,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbget:MPI_Rget");
+    }
     req->request = request;
     req->use_type = 0;
+    req->remote_proc = lproc;
+    req->win = reg_win->win;
     req->active = 1;
     return COMEX_SUCCESS;
 #else
@@ -2139,12 +2263,13 @@ int comex_nbacc(
     MPI_Request request;
     MPI_Status status;
     reg_win = reg_win_find(proc, dst_ptr, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst_ptr) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     get_nb_request(hdl, &req);
 #ifdef USE_PRIOR_MPI_WIN_FLUSH
     ierr = MPI_Win_flush(lproc, reg_win->win);
@@ -2159,19 +2284,19 @@ int comex_nbacc(
       for (i=0; i<count; i++) {
         buf[i] = isrc[i]*iscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_INT,lproc,displ,count,
-          MPI_INT,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_INT,lproc,displ,count,
-          MPI_INT,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_INT,lproc,displ,count,
+            MPI_INT,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_INT,lproc,displ,count,
+            MPI_INT,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else if (datatype == COMEX_ACC_LNG) {
@@ -2183,19 +2308,19 @@ int comex_nbacc(
       for (i=0; i<count; i++) {
         buf[i] = lsrc[i]*lscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_LONG,lproc,displ,count,
-          MPI_LONG,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_LONG,lproc,displ,count,
-          MPI_LONG,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_LONG,lproc,displ,count,
+            MPI_LONG,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_LONG,lproc,displ,count,
+            MPI_LONG,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else if (datatype == COMEX_ACC_FLT) {
@@ -2207,19 +2332,19 @@ int comex_nbacc(
       for (i=0; i<count; i++) {
         buf[i] = fsrc[i]*fscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_FLOAT,lproc,displ,count,
-          MPI_FLOAT,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_FLOAT,lproc,displ,count,
-          MPI_FLOAT,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_FLOAT,lproc,displ,count,
+            MPI_FLOAT,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_FLOAT,lproc,displ,count,
+            MPI_FLOAT,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else if (datatype == COMEX_ACC_DBL) {
@@ -2231,19 +2356,19 @@ int comex_nbacc(
       for (i=0; i<count; i++) {
         buf[i] = dsrc[i]*dscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
-          MPI_DOUBLE,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
-          MPI_DOUBLE,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
+            MPI_DOUBLE,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
+            MPI_DOUBLE,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else if (datatype == COMEX_ACC_CPL) {
@@ -2259,19 +2384,19 @@ int comex_nbacc(
         buf[2*i] = csrc[2*i]*crscale-csrc[2*i+1]*ciscale;
         buf[2*i+1] = csrc[2*i]*ciscale+csrc[2*i+1]*crscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_FLOAT,lproc,displ,count,
-          MPI_FLOAT,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_FLOAT,lproc,displ,count,
-          MPI_FLOAT,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_FLOAT,lproc,displ,count,
+            MPI_FLOAT,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_FLOAT,lproc,displ,count,
+            MPI_FLOAT,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else if (datatype == COMEX_ACC_DCP) {
@@ -2287,19 +2412,19 @@ int comex_nbacc(
         buf[2*i] = csrc[2*i]*crscale-csrc[2*i+1]*ciscale;
         buf[2*i+1] = csrc[2*i]*ciscale+csrc[2*i+1]*crscale;
       }
-#ifdef USE_MPI_FLUSH_LOCAL
-      ierr = MPI_Accumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
-          MPI_DOUBLE,MPI_SUM,reg_win->win);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
-      req->remote_proc = lproc;
-      req->win = reg_win->win;
-#else
-      ierr = MPI_Raccumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
-          MPI_DOUBLE,MPI_SUM,reg_win->win,&request);
-      translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
-#endif
+      if (RMA_FLUSH_LOCAL == rma_completion) {
+        ierr = MPI_Accumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
+            MPI_DOUBLE,MPI_SUM,reg_win->win);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Accumulate");
+      } else {
+        ierr = MPI_Raccumulate(buf,count,MPI_DOUBLE,lproc,displ,count,
+            MPI_DOUBLE,MPI_SUM,reg_win->win,&request);
+        translate_mpi_error(ierr,"comex_nbacc:MPI_Raccumulate");
+      }
       req->request = request;
       req->use_type = 0;
+      req->remote_proc = lproc;
+      req->win = reg_win->win;
       req->active = 1;
       free(buf);
     } else {
@@ -2339,7 +2464,7 @@ int comex_nbputs(
           count, stride_levels, proc, group);
     }
     reg_win = reg_win_find(proc, dst, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst) - (MPI_Aint)(ptr);
 
     strided_to_subarray_dtype(src_stride, count, stride_levels,
@@ -2350,6 +2475,7 @@ int comex_nbputs(
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     get_nb_request(hdl, &req);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_nbputs:MPI_Type_commit");
@@ -2359,17 +2485,15 @@ int comex_nbputs(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbputs:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Put(src, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbputs:MPI_Put");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rput(src, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbputs:MPI_Rput");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Put(src, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbputs:MPI_Put");
+    } else {
+      ierr = MPI_Rput(src, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbputs:MPI_Rput");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2412,7 +2536,7 @@ int comex_nbgets(
     MPI_Status status;
     nb_t *req;
     reg_win = reg_win_find(proc, src, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(src) - (MPI_Aint)(ptr);
 
     strided_to_subarray_dtype(src_stride, count, stride_levels,
@@ -2432,17 +2556,15 @@ int comex_nbgets(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbgets:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbgets:MPI_Get");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rget(dst, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbgets:MPI_Rget");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbgets:MPI_Get");
+    } else {
+      ierr = MPI_Rget(dst, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbgets:MPI_Rget");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2496,12 +2618,13 @@ int comex_nbaccs(
     }
     nb_t *req;
     reg_win = reg_win_find(proc, dst, 0);
-    ptr = reg_win->buf;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(dst) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     packbuf = malloc_strided_acc_buffer(src, src_stride, count,
         stride_levels, &bufsize, new_strides);
 
@@ -2592,17 +2715,15 @@ int comex_nbaccs(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbaccs:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Accumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win);
-    translate_mpi_error(ierr,"comex_nbaccs:MPI_Accumulate");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Raccumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win,&request);
-    translate_mpi_error(ierr,"comex_nbaccs:MPI_Rget");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Accumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win);
+      translate_mpi_error(ierr,"comex_nbaccs:MPI_Accumulate");
+    } else {
+      ierr = MPI_Raccumulate(packbuf,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win,&request);
+      translate_mpi_error(ierr,"comex_nbaccs:MPI_Rget");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2646,13 +2767,14 @@ int comex_nbputv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, dst_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     vector_to_struct_dtype(src_ptr, ptr, iov, iov_len,
         MPI_BYTE, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     get_nb_request(handle, &req);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_nbputv:MPI_Type_commit");
@@ -2662,17 +2784,15 @@ int comex_nbputv(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbputv:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbputv:MPI_Put");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbputv:MPI_Rput");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Put(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbputv:MPI_Put");
+    } else {
+      ierr = MPI_Rput(src_ptr, 1, src_type, lproc, displ, 1, dst_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbputv:MPI_Rput");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2712,7 +2832,7 @@ int comex_nbgetv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, src_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     vector_to_struct_dtype(ptr, dst_ptr, iov, iov_len,
         MPI_BYTE, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
@@ -2728,17 +2848,15 @@ int comex_nbgetv(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbgetv:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win);
-    translate_mpi_error(ierr,"comex_nbgetv:MPI_Get");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
-        reg_win->win, &request);
-    translate_mpi_error(ierr,"comex_nbgetv:MPI_Rget");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Get(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win);
+      translate_mpi_error(ierr,"comex_nbgetv:MPI_Get");
+    } else {
+      ierr = MPI_Rget(dst_ptr, 1, dst_type, lproc, displ, 1, src_type,
+          reg_win->win, &request);
+      translate_mpi_error(ierr,"comex_nbgetv:MPI_Rget");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2798,13 +2916,14 @@ int comex_nbaccv(
     dst_ptr = iov[0].dst[0];
     reg_win = reg_win_find(proc, dst_ptr, 0);
     ptr = reg_win->buf;
-    displ = 0;
+    displ = (MPI_Aint)(ptr) - (MPI_Aint)(reg_win->base);
     src_ptr = create_vector_buf_and_dtypes(ptr, iov,
         iov_len, size, scale, base_type, &src_type, &dst_type);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
       assert(0);
     }
+    mark_dirty(reg_win->igroup, proc);
     get_nb_request(handle, &req);
     ierr = MPI_Type_commit(&src_type);
     translate_mpi_error(ierr,"comex_nbaccv:MPI_Type_commit");
@@ -2814,17 +2933,15 @@ int comex_nbaccv(
     ierr = MPI_Win_flush(lproc, reg_win->win);
     translate_mpi_error(ierr,"comex_nbaccv:MPI_Win_flush");
 #endif
-#ifdef USE_MPI_FLUSH_LOCAL
-    ierr = MPI_Accumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win);
-    translate_mpi_error(ierr,"comex_nbaccv:MPI_Accumulate");
-    req->remote_proc = lproc;
-    req->win = reg_win->win;
-#else
-    ierr = MPI_Raccumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
-        MPI_SUM,reg_win->win,&request);
-    translate_mpi_error(ierr,"comex_nbaccv:MPI_Raccumulate");
-#endif
+    if (RMA_FLUSH_LOCAL == rma_completion) {
+      ierr = MPI_Accumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win);
+      translate_mpi_error(ierr,"comex_nbaccv:MPI_Accumulate");
+    } else {
+      ierr = MPI_Raccumulate(src_ptr,1,src_type,lproc,displ,1,dst_type,
+          MPI_SUM,reg_win->win,&request);
+      translate_mpi_error(ierr,"comex_nbaccv:MPI_Raccumulate");
+    }
     req->request = request;
     req->use_type = 1;
     req->src_type = src_type;
@@ -2850,8 +2967,8 @@ int comex_rmw(
     int lproc, ierr;
     reg_entry_t *reg_win;
     reg_win = reg_win_find(proc, prem, 0);
-    ptr = reg_win->buf;
-    if (ptr == NULL) return COMEX_FAILURE;
+    if (reg_win->buf == NULL) return COMEX_FAILURE;
+    ptr = reg_win->base;
     displ = (MPI_Aint)(prem) - (MPI_Aint)(ptr);
     if (!(get_local_rank_from_win(reg_win->win, proc, &lproc)
           == COMEX_SUCCESS)) {
@@ -3196,6 +3313,15 @@ int comex_malloc(void *ptrs[], size_t size, comex_group_t group)
     } else {
       tsize = 8;
     }
+    if (win_per_group) {
+      /* attach the segment to the group's dynamic window instead of paying
+       * for a collective window creation per allocation */
+      reg_entries[comm_rank].win = get_group_win(group, igroup);
+      MPI_Alloc_mem(tsize,MPI_INFO_NULL,&reg_entries[comm_rank].buf);
+      ierr = MPI_Win_attach(reg_entries[comm_rank].win,
+          reg_entries[comm_rank].buf,tsize);
+      translate_mpi_error(ierr,"comex_malloc:MPI_Win_attach");
+    } else {
 #ifdef USE_MPI_WIN_ALLOC
     MPI_Win_allocate(sizeof(char)*tsize,1,MPI_INFO_NULL,comm,&reg_entries[comm_rank].buf,
         &reg_entries[comm_rank].win);
@@ -3208,6 +3334,7 @@ int comex_malloc(void *ptrs[], size_t size, comex_group_t group)
     MPI_Win_lock_all(0,reg_entries[comm_rank].win);
     /* Use MPI_MODE_NOCHECK instead of 0 */
 #endif
+    }
 
 
     /* exchange buffer address */
@@ -3226,10 +3353,14 @@ int comex_malloc(void *ptrs[], size_t size, comex_group_t group)
         reg_entries[i].win = reg_entries[comm_rank].win;
       }
       /* probably want to use commicator rank instead of world rank*/
+      /* displacements in a dynamic window are absolute addresses */
       reg_win_insert(world_rank,  reg_entries[i].buf, reg_entries[i].len,
+          win_per_group ? NULL : reg_entries[i].buf,
           reg_entries[i].win, igroup);
     }
-    comex_igroup_add_win(group,reg_entries[comm_rank].win);
+    if (!win_per_group) {
+      comex_igroup_add_win(group,reg_entries[comm_rank].win);
+    }
 
     comex_wait_all(group);
     /* MPI_Win_fence(0,reg_entries[comm_rank].win); */
@@ -3300,10 +3431,8 @@ int comex_free(void *ptr, comex_group_t group)
     reg_win = reg_win_find(world_rank, ptr, 0);
     window = reg_win->win;
 
-#ifndef USE_MPI_WIN_ALLOC
     /* Save pointer to memory */
     void* buf = reg_win->buf;
-#endif
 
     /* allocate receive buffer for exchange of pointers */
     allgather_ptrs = (void **)malloc(sizeof(void *) * comm_size);
@@ -3322,13 +3451,25 @@ int comex_free(void *ptr, comex_group_t group)
       reg_win_delete(world_rank,allgather_ptrs[i]);
     }
 
-    /* Remove window from group list */
-    comex_igroup_delete_win(group, window);
-
     /* remove my ptr from reg cache and free ptr */
     /* comex_free_local(ptr); */
     free(allgather_ptrs);
 
+    if (window == igroup->dyn_win) {
+      /* the group window stays; only detach this segment once nobody can
+       * still be targeting it */
+#ifdef USE_MPI_REQUESTS
+      ierr = MPI_Win_flush_all(window);
+      translate_mpi_error(ierr,"comex_free:MPI_Win_flush_all");
+#endif
+      MPI_Barrier(comm);
+      ierr = MPI_Win_detach(window, buf);
+      translate_mpi_error(ierr,"comex_free:MPI_Win_detach");
+      MPI_Free_mem(buf);
+    } else {
+    /* Remove window from group list */
+    comex_igroup_delete_win(group, window);
+
     /* free up window */
 #ifdef USE_MPI_REQUESTS
     MPI_Win_unlock_all(window);
@@ -3338,6 +3479,7 @@ int comex_free(void *ptr, comex_group_t group)
     /* Clear memory for this window */
     MPI_Free_mem(buf);
 #endif
+    }
 
     /* Is this needed? */
     MPI_Barrier(comm);
@@ -3347,6 +3489,26 @@ int comex_free(void *ptr, comex_group_t group)
 }
 
 
+/**
+ * Return the dynamic window shared by all allocations on the group, creating
+ * it on first use. Collective on the group, like comex_malloc.
+ */
+static MPI_Win get_group_win(comex_group_t group, comex_igroup_t *igroup)
+{
+  if (igroup->dyn_win == MPI_WIN_NULL) {
+    int ierr;
+    ierr = MPI_Win_create_dynamic(MPI_INFO_NULL,igroup->comm,&igroup->dyn_win);
+    translate_mpi_error(ierr,"get_group_win:MPI_Win_create_dynamic");
+#ifdef USE_MPI_REQUESTS
+    MPI_Win_lock_all(0,igroup->dyn_win);
+    igroup->dyn_win_locked = 1;
+#endif
+    comex_igroup_add_win(group,igroup->dyn_win);
+  }
+  return igroup->dyn_win;
+}
+
+
 static void acquire_remote_lock(int proc)
 {
     assert(0);
@@ -72,6 +72,10 @@ void comex_create_group_and_igroup(
     new_group_list_item->group = MPI_GROUP_NULL;
     new_group_list_item->next = NULL;
     new_group_list_item->win_list = NULL;
+    new_group_list_item->dyn_win = MPI_WIN_NULL;
+    new_group_list_item->dyn_win_locked = 0;
+    new_group_list_item->dirty = NULL;
+    new_group_list_item->dirty_count = 0;
     last_group_list_item->next = new_group_list_item;
 
     /* return the group id and comex igroup */
@@ -169,10 +173,14 @@ void comex_igroup_finalize(comex_igroup_t *igroup)
     curr_win = igroup->win_list;
     while (curr_win != NULL) {
       next_win = curr_win->next;
+      if (curr_win->win == igroup->dyn_win && igroup->dyn_win_locked) {
+        MPI_Win_unlock_all(curr_win->win);
+      }
       MPI_Win_free(&curr_win->win);
       free(curr_win);
       curr_win = next_win;
     }
+    free(igroup->dirty);
 }
 
 
@@ -287,6 +295,10 @@ void comex_group_init()
     group_list->id = COMEX_GROUP_WORLD;
     group_list->next = NULL;
     group_list->win_list = NULL;
+    group_list->dyn_win = MPI_WIN_NULL;
+    group_list->dyn_win_locked = 0;
+    group_list->dirty = NULL;
+    group_list->dirty_count = 0;
 #ifdef USE_MPI_ERRORS_RETURN
     MPI_Comm_set_errhandler(MPI_COMM_WORLD,MPI_ERRORS_RETURN);
 #endif
@@ -312,8 +324,18 @@ void comex_group_finalize()
         free(previous_group_list_item);
     }
 
+    /* free the window shared by allocations on the world group, if any */
+    if (group_list->dyn_win != MPI_WIN_NULL) {
+        comex_igroup_delete_win(COMEX_GROUP_WORLD, group_list->dyn_win);
+        if (group_list->dyn_win_locked) {
+            MPI_Win_unlock_all(group_list->dyn_win);
+        }
+        MPI_Win_free(&(group_list->dyn_win));
+    }
+
     /* ok, now free the world group, but not the world comm */
     MPI_Group_free(&(group_list->group));
+    free(group_list->dirty);
     free(group_list);
     group_list = NULL;
 }
@@ -24,8 +24,16 @@ typedef struct group_link {
     MPI_Comm comm;
     MPI_Group group;
     win_link_t *win_list;
+    MPI_Win dyn_win;    /**< dynamic window shared by all allocations on
+                             this group, or MPI_WIN_NULL */
+    int dyn_win_locked; /**< whether MPI_Win_lock_all was called on dyn_win */
+    char *dirty;        /**< world ranks with puts/accs in the windows of this
+                             group not yet flushed, or NULL */
+    int dirty_count;    /**< number of set entries in dirty */
 } comex_igroup_t;
 
+extern comex_igroup_t *group_list;
+
 extern void comex_group_init();
 extern void comex_group_finalize();
 extern comex_igroup_t* comex_get_igroup_from_group(comex_group_t group);
@@ -514,13 +514,17 @@ reg_win_find_intersection(int rank, void *buf, int len)
  * @param rank processor rank for which buffer location applies
  * @param buf pointer to memory allocation
  * @param len size of memory allocation
+ * @param base address that corresponds to displacement 0 in the window; this
+ *        is buf for a window per allocation and NULL for a dynamic window
+ *        whose displacements are absolute addresses
  * @param win MPI window for memory allocation
  * @param group group associated with memory allocation
  *
  * @return return new entry in linked list
  */
 reg_entry_t*
-reg_win_insert(int rank, void *buf, int len, MPI_Win win, comex_igroup_t *group)
+reg_win_insert(int rank, void *buf, int len, void *base, MPI_Win win,
+        comex_igroup_t *group)
 {
     reg_entry_t *node = NULL;
 
@@ -546,6 +550,7 @@ reg_win_insert(int rank, void *buf, int len, MPI_Win win, comex_igroup_t *group)
     node->rank = rank;
     node->buf = buf;
     node->len = len;
+    node->base = base;
     node->win = win;
     node->igroup = group;
     node->next = NULL;
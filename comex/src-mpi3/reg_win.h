@@ -21,6 +21,8 @@ typedef struct _reg_entry_t {
     int rank;                   /**< rank where this region lives */
     void *buf;                  /**< starting address of region */
     size_t len;                 /**< length of region */
+    void *base;                 /**< address of displacement 0 in win, either
+                                     buf or NULL for a dynamic window */
     struct _reg_entry_t *next;  /**< next memory region in list */
 } reg_entry_t;
 
@@ -32,8 +34,8 @@ typedef struct _reg_entry_t {
 reg_return_t reg_win_init(int nprocs);
 reg_return_t reg_win_destroy();
 reg_entry_t *reg_win_find(int rank, void *buf, int len);
-reg_entry_t *reg_win_insert(int rank, void *buf, int len, MPI_Win win,
-    comex_igroup_t *group);
+reg_entry_t *reg_win_insert(int rank, void *buf, int len, void *base,
+    MPI_Win win, comex_igroup_t *group);
 reg_return_t reg_win_delete(int rank, void *buf);
 
 #endif /* _REG_WINDOW_H_ */
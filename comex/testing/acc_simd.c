@@ -0,0 +1,221 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* The vector accumulate kernels of acc_simd.h against a scalar loop, for
+ * every accumulate type, every instruction set the CPU supports and the
+ * runtime dispatch in _acc(). Lengths cover the vector bodies and all tail
+ * lengths, and source and destination are misaligned with respect to the
+ * vector width independently. Values and scales are small integers and
+ * halves, so that every product and sum is exact and the results must match
+ * bit for bit even where the compiler fuses multiply and add. */
+
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "comex.h"
+#include "acc.h"
+
+#define MAXLEN 1100
+#define MAXOFF 7
+
+static int errors = 0;
+
+typedef void (*kernel_t)(int n, void *dst, const void *src, const void *scale);
+
+/* dst[i] += scale*src[i], the reference */
+static void ref_acc(int op, int n, void *dst, const void *src,
+        const void *scale)
+{
+    int i;
+
+    for (i = 0; i < n; ++i) {
+        switch (op) {
+            case COMEX_ACC_DBL:
+                ((double*)dst)[i] += *(double*)scale * ((double*)src)[i];
+                break;
+            case COMEX_ACC_FLT:
+                ((float*)dst)[i] += *(float*)scale * ((float*)src)[i];
+                break;
+            case COMEX_ACC_INT:
+                ((int*)dst)[i] += *(int*)scale * ((int*)src)[i];
+                break;
+            case COMEX_ACC_LNG:
+                ((long*)dst)[i] += *(long*)scale * ((long*)src)[i];
+                break;
+            case COMEX_ACC_DCP: {
+                DoubleComplex *d = (DoubleComplex*)dst + i;
+                const DoubleComplex *s = (const DoubleComplex*)src + i;
+                const DoubleComplex *a = (const DoubleComplex*)scale;
+                d->real += a->real*s->real - a->imag*s->imag;
+                d->imag += a->real*s->imag + a->imag*s->real;
+                break;
+            }
+            case COMEX_ACC_CPL: {
+                SingleComplex *d = (SingleComplex*)dst + i;
+                const SingleComplex *s = (const SingleComplex*)src + i;
+                const SingleComplex *a = (const SingleComplex*)scale;
+                d->real += a->real*s->real - a->imag*s->imag;
+                d->imag += a->real*s->imag + a->imag*s->real;
+                break;
+            }
+            default: assert(0);
+        }
+    }
+}
+
+static size_t type_size(int op)
+{
+    switch (op) {
+        case COMEX_ACC_DBL: return sizeof(double);
+        case COMEX_ACC_FLT: return sizeof(float);
+        case COMEX_ACC_INT: return sizeof(int);
+        case COMEX_ACC_LNG: return sizeof(long);
+        case COMEX_ACC_DCP: return sizeof(DoubleComplex);
+        case COMEX_ACC_CPL: return sizeof(SingleComplex);
+    }
+    assert(0);
+    return 0;
+}
+
+/* element i of an array of type op set to a small value depending on seed */
+static void set(int op, void *buf, int i, int seed)
+{
+    int v = (i*7 + seed*13) % 61 - 30;
+
+    switch (op) {
+        case COMEX_ACC_DBL: ((double*)buf)[i] = 0.5*v; break;
+        case COMEX_ACC_FLT: ((float*)buf)[i] = 0.5f*v; break;
+        case COMEX_ACC_INT: ((int*)buf)[i] = v; break;
+        case COMEX_ACC_LNG: ((long*)buf)[i] = v; break;
+        case COMEX_ACC_DCP:
+            ((DoubleComplex*)buf)[i].real = 0.5*v;
+            ((DoubleComplex*)buf)[i].imag = -0.25*v;
+            break;
+        case COMEX_ACC_CPL:
+            ((SingleComplex*)buf)[i].real = 0.5f*v;
+            ((SingleComplex*)buf)[i].imag = -0.25f*v;
+            break;
+    }
+}
+
+/* run acc (a kernel, or _acc if NULL) on all lengths and offsets and
+ * compare with ref_acc */
+static void test(const char *name, int op, kernel_t kernel, const void *scale)
+{
+    const size_t size = type_size(op);
+    char *src = malloc((MAXLEN+MAXOFF)*size);
+    char *dst = malloc((MAXLEN+MAXOFF)*size);
+    char *ref = malloc((MAXLEN+MAXOFF)*size);
+    int n, soff, doff, i;
+
+    assert(src && dst && ref);
+    for (n = 0; n <= MAXLEN; n += (n < 80 ? 1 : 511)) {
+        for (soff = 0; soff <= MAXOFF; soff += 3) {
+            for (doff = 0; doff <= MAXOFF; ++doff) {
+                char *s = src + soff*size;
+                char *d = dst + doff*size;
+                char *r = ref + doff*size;
+
+                for (i = 0; i < MAXLEN+MAXOFF; ++i) {
+                    set(op, src, i, 1);
+                    set(op, dst, i, 2);
+                }
+                memcpy(ref, dst, (MAXLEN+MAXOFF)*size);
+                ref_acc(op, n, r, s, scale);
+                if (kernel) {
+                    kernel(n, d, s, scale);
+                }
+                else {
+                    _acc(op, (int)(n*size), d, s, scale);
+                }
+                /* also checks that nothing around dst was touched */
+                if (memcmp(dst, ref, (MAXLEN+MAXOFF)*size)) {
+                    printf("%s: wrong result for n=%d src+%d dst+%d\n",
+                            name, n, soff, doff);
+                    ++errors;
+                    goto done;
+                }
+            }
+        }
+    }
+done:
+    free(ref);
+    free(dst);
+    free(src);
+}
+
+#if COMEX_ACC_SIMD
+/* adapters from the kernels, which take the scale by value */
+#define ADAPT(NAME, ISA, C_TYPE)                                            \
+static void NAME##_##ISA(int n, void *dst, const void *src,                 \
+        const void *scale)                                                  \
+{                                                                           \
+    _acc_simd_##NAME##_##ISA(n, (C_TYPE*)dst, (const C_TYPE*)src,           \
+            *(const C_TYPE*)scale);                                         \
+}
+ADAPT(dbl, avx2, double)
+ADAPT(flt, avx2, float)
+ADAPT(int, avx2, int)
+ADAPT(lng, avx2, long)
+ADAPT(dcp, avx2, DoubleComplex)
+ADAPT(cpl, avx2, SingleComplex)
+ADAPT(dbl, avx512, double)
+ADAPT(flt, avx512, float)
+ADAPT(int, avx512, int)
+ADAPT(lng, avx512, long)
+#undef ADAPT
+#endif
+
+int main(int argc, char **argv)
+{
+    double dscale = 2.5;
+    float fscale = -1.5f;
+    int iscale = 3;
+    long lscale = -7, lone = 1;
+    DoubleComplex zscale = {1.5, -0.5};
+    SingleComplex cscale = {-2.0f, 0.5f};
+
+    test("_acc dbl", COMEX_ACC_DBL, NULL, &dscale);
+    test("_acc flt", COMEX_ACC_FLT, NULL, &fscale);
+    test("_acc int", COMEX_ACC_INT, NULL, &iscale);
+    test("_acc lng", COMEX_ACC_LNG, NULL, &lscale);
+    test("_acc lng unit scale", COMEX_ACC_LNG, NULL, &lone);
+    test("_acc dcp", COMEX_ACC_DCP, NULL, &zscale);
+    test("_acc cpl", COMEX_ACC_CPL, NULL, &cscale);
+
+#if COMEX_ACC_SIMD
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        test("avx2 dbl", COMEX_ACC_DBL, dbl_avx2, &dscale);
+        test("avx2 flt", COMEX_ACC_FLT, flt_avx2, &fscale);
+        test("avx2 int", COMEX_ACC_INT, int_avx2, &iscale);
+        test("avx2 lng", COMEX_ACC_LNG, lng_avx2, &lscale);
+        test("avx2 lng unit scale", COMEX_ACC_LNG, lng_avx2, &lone);
+        test("avx2 dcp", COMEX_ACC_DCP, dcp_avx2, &zscale);
+        test("avx2 cpl", COMEX_ACC_CPL, cpl_avx2, &cscale);
+    }
+    else {
+        printf("AVX2 not supported, kernels not tested\n");
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        test("avx512 dbl", COMEX_ACC_DBL, dbl_avx512, &dscale);
+        test("avx512 flt", COMEX_ACC_FLT, flt_avx512, &fscale);
+        test("avx512 int", COMEX_ACC_INT, int_avx512, &iscale);
+        test("avx512 lng", COMEX_ACC_LNG, lng_avx512, &lscale);
+        test("avx512 lng unit scale", COMEX_ACC_LNG, lng_avx512, &lone);
+    }
+    else {
+        printf("AVX-512 not supported, kernels not tested\n");
+    }
+#endif
+
+    if (errors) {
+        printf("%d failures detected\n", errors);
+        return 1;
+    }
+    printf("No errors detected\n");
+    return 0;
+}
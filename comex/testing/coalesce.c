@@ -0,0 +1,162 @@
+/* Many small contiguous puts and accumulates, which backends supporting
+ * COMEX_ENABLE_COALESCE batch per target into OP_MULTI messages. Checks that
+ * the batched requests all arrive, in order with respect to each other and
+ * to the gets, fences and barriers that follow them. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+#include "comex.h"
+
+#define SLOTS 600      /* elements each process owns in every target array */
+#define NMIX  50       /* elements checked for put/acc/get ordering */
+
+static int me;
+static int nproc;
+
+static void check(int ok, const char *what, int proc, int i)
+{
+    char msg[256];
+
+    if (!ok) {
+        sprintf(msg, "%d: %s: wrong value from proc=%d at %d", me, what,
+                proc, i);
+        comex_error(msg, 1);
+    }
+}
+
+static double value(int src, int dst, int i)
+{
+    return src*1000000.0 + dst*1000.0 + i;
+}
+
+/* length in elements of the j-th small request, 1 to 7 */
+static int chunk(int j)
+{
+    return 1 + j % 7;
+}
+
+int main(int argc, char **argv)
+{
+    void **put_ptr, **dacc_ptr, **iacc_ptr, **mix_ptr;
+    double *buf, dscale = 2.0, one = 1.0, x;
+    int *ibuf, iscale = 3;
+    int t, p, i, j, n;
+    comex_request_t req;
+
+    /* small batches so that they also fill up and are sent early */
+    setenv("COMEX_ENABLE_COALESCE", "1", 0);
+    setenv("COMEX_COALESCE_BUFFER_SIZE", "4096", 0);
+    comex_init_args(&argc, &argv);
+    comex_group_rank(COMEX_GROUP_WORLD, &me);
+    comex_group_size(COMEX_GROUP_WORLD, &nproc);
+    if (0 == me) {
+        printf("Testing small puts and accs on %d processes\n", nproc);
+    }
+
+    put_ptr = (void**)malloc(nproc * sizeof(void*));
+    dacc_ptr = (void**)malloc(nproc * sizeof(void*));
+    iacc_ptr = (void**)malloc(nproc * sizeof(void*));
+    mix_ptr = (void**)malloc(nproc * sizeof(void*));
+    comex_malloc(put_ptr, nproc*SLOTS*sizeof(double), COMEX_GROUP_WORLD);
+    comex_malloc(dacc_ptr, SLOTS*sizeof(double), COMEX_GROUP_WORLD);
+    comex_malloc(iacc_ptr, SLOTS*sizeof(int), COMEX_GROUP_WORLD);
+    comex_malloc(mix_ptr, nproc*NMIX*sizeof(double), COMEX_GROUP_WORLD);
+    memset(put_ptr[me], 0, nproc*SLOTS*sizeof(double));
+    memset(dacc_ptr[me], 0, SLOTS*sizeof(double));
+    memset(iacc_ptr[me], 0, SLOTS*sizeof(int));
+    memset(mix_ptr[me], 0, nproc*NMIX*sizeof(double));
+    buf = (double*)malloc(SLOTS*sizeof(double));
+    ibuf = (int*)malloc(SLOTS*sizeof(int));
+    comex_barrier(COMEX_GROUP_WORLD);
+
+    /* puts of 1 to 7 doubles covering my slots of every target, some of
+     * them non-blocking */
+    for (p=0; p<nproc; p++) {
+        t = (me + p) % nproc;
+        for (i=0; i<SLOTS; i++) buf[i] = value(me, t, i);
+        for (i=0, j=0; i<SLOTS; i+=n, j++) {
+            double *dst = (double*)put_ptr[t] + me*SLOTS + i;
+            n = chunk(j);
+            if (n > SLOTS-i) n = SLOTS-i;
+            if (j % 5) {
+                comex_put(buf+i, dst, n*sizeof(double), t, COMEX_GROUP_WORLD);
+            }
+            else {
+                comex_nbput(buf+i, dst, n*sizeof(double), t,
+                        COMEX_GROUP_WORLD, &req);
+                comex_wait(&req);
+            }
+        }
+    }
+
+    /* every process accumulates into all elements of every target */
+    for (i=0; i<SLOTS; i++) {
+        buf[i] = 1.0 + i;
+        ibuf[i] = i;
+    }
+    for (p=0; p<nproc; p++) {
+        t = (me + p) % nproc;
+        for (i=0, j=0; i<SLOTS; i+=n, j++) {
+            n = chunk(j);
+            if (n > SLOTS-i) n = SLOTS-i;
+            comex_acc(COMEX_ACC_DBL, &dscale, buf+i,
+                    (double*)dacc_ptr[t] + i, n*sizeof(double), t,
+                    COMEX_GROUP_WORLD);
+            comex_acc(COMEX_ACC_INT, &iscale, ibuf+i,
+                    (int*)iacc_ptr[t] + i, n*sizeof(int), t,
+                    COMEX_GROUP_WORLD);
+        }
+    }
+
+    /* a put followed by an acc to the same element, read back right away */
+    for (p=0; p<nproc; p++) {
+        t = (me + p) % nproc;
+        for (i=0; i<NMIX; i++) {
+            double *dst = (double*)mix_ptr[t] + me*NMIX + i;
+            x = value(me, t, i);
+            comex_put(&x, dst, sizeof(double), t, COMEX_GROUP_WORLD);
+            comex_acc(COMEX_ACC_DBL, &one, &one, dst, sizeof(double), t,
+                    COMEX_GROUP_WORLD);
+            comex_get(dst, &x, sizeof(double), t, COMEX_GROUP_WORLD);
+            check(x == value(me, t, i) + 1.0, "put/acc/get", t, i);
+        }
+    }
+
+    comex_fence_all(COMEX_GROUP_WORLD);
+    comex_barrier(COMEX_GROUP_WORLD);
+
+    for (p=0; p<nproc; p++) {
+        for (i=0; i<SLOTS; i++) {
+            check(((double*)put_ptr[me])[p*SLOTS + i] == value(p, me, i),
+                    "put", p, i);
+        }
+    }
+    for (i=0; i<SLOTS; i++) {
+        check(((double*)dacc_ptr[me])[i] == nproc*2.0*(1.0 + i), "acc dbl",
+                -1, i);
+        check(((int*)iacc_ptr[me])[i] == nproc*3*i, "acc int", -1, i);
+    }
+
+    comex_barrier(COMEX_GROUP_WORLD);
+    free(ibuf);
+    free(buf);
+    comex_free(mix_ptr[me], COMEX_GROUP_WORLD);
+    comex_free(iacc_ptr[me], COMEX_GROUP_WORLD);
+    comex_free(dacc_ptr[me], COMEX_GROUP_WORLD);
+    comex_free(put_ptr[me], COMEX_GROUP_WORLD);
+    free(mix_ptr);
+    free(iacc_ptr);
+    free(dacc_ptr);
+    free(put_ptr);
+
+    if (0 == me) {
+        printf("No errors detected\n");
+    }
+    comex_finalize();
+    MPI_Finalize();
+
+    return 0;
+}
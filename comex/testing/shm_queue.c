@@ -0,0 +1,166 @@
+/* Requests to processes on the same node, which backends with shared memory
+ * request queues (src-mpi-pr) serve through the queue when they are small
+ * and through MPI when they are not. The same puts, gets, accumulates and
+ * rmw operations are done with sizes on both sides of the queue slot size,
+ * mixed so that a request on one channel must see the effect of the
+ * previous request on the other. Run with COMEX_ENABLE_SHM_QUEUE=0 to check
+ * the MPI path alone against the same results. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+
+#include "comex.h"
+
+#define LEN  64        /* doubles each process owns in every target */
+#define NINC 200       /* rmw operations per process and target */
+
+static int me;
+static int nproc;
+static MPI_Comm comm = MPI_COMM_NULL;
+static int sizes[] = {1, 3, 8, 20, 27, 40, 64, 0}; /* doubles, 0 is sentinel */
+
+static void check(int ok, const char *what, int proc, int n)
+{
+    char msg[256];
+
+    if (!ok) {
+        sprintf(msg, "%d: %s: wrong value with proc=%d size=%d", me, what,
+                proc, n);
+        comex_error(msg, 1);
+    }
+}
+
+static double value(int t, int i, int k)
+{
+    return me*100000.0 + t*1000.0 + i + 0.25*k;
+}
+
+/* put, get and acc of each size to t, read back over the other channel */
+static void test_contig(void **ptr, int t)
+{
+    double buf[LEN], out[LEN], two = 2.0;
+    double *dst = (double*)ptr[t] + me*LEN;
+    int i, k, n, ok;
+
+    for (k=0; (n = sizes[k]) != 0; k++) {
+        /* a small put seen by a whole-block get, and the reverse */
+        for (i=0; i<n; i++) buf[i] = value(t, i, k);
+        comex_put(buf, dst, n*sizeof(double), t, COMEX_GROUP_WORLD);
+        comex_get(dst, out, LEN*sizeof(double), t, COMEX_GROUP_WORLD);
+        for (i=0, ok=1; i<n; i++) ok = ok && out[i] == value(t, i, k);
+        check(ok, "put then get", t, n);
+
+        for (i=0; i<LEN; i++) buf[i] = -value(t, i, k);
+        comex_put(buf, dst, LEN*sizeof(double), t, COMEX_GROUP_WORLD);
+        comex_get(dst, out, n*sizeof(double), t, COMEX_GROUP_WORLD);
+        for (i=0, ok=1; i<n; i++) ok = ok && out[i] == -value(t, i, k);
+        check(ok, "large put then get", t, n);
+
+        /* small and large accumulates to the same elements */
+        for (i=0; i<LEN; i++) buf[i] = 1.0;
+        comex_acc(COMEX_ACC_DBL, &two, buf, dst, n*sizeof(double), t,
+                COMEX_GROUP_WORLD);
+        comex_acc(COMEX_ACC_DBL, &two, buf, dst, LEN*sizeof(double), t,
+                COMEX_GROUP_WORLD);
+        comex_get(dst, out, LEN*sizeof(double), t, COMEX_GROUP_WORLD);
+        for (i=0, ok=1; i<LEN; i++)
+            ok = ok && out[i] == -value(t, i, k) + (i < n ? 4.0 : 2.0);
+        check(ok, "acc then get", t, n);
+    }
+}
+
+/* fetch-and-add from every process to counters on t; each value is
+ * returned exactly once */
+static void test_rmw(void **iptr, void **lptr, int t)
+{
+    int i, ival;
+    long lval, sum[2] = {0, 0}, total[2];
+
+    comex_barrier(COMEX_GROUP_WORLD);
+    for (i=0; i<NINC; i++) {
+        comex_rmw(COMEX_FETCH_AND_ADD, &ival, iptr[t], 1, t,
+                COMEX_GROUP_WORLD);
+        comex_rmw(COMEX_FETCH_AND_ADD_LONG, &lval, lptr[t], 1, t,
+                COMEX_GROUP_WORLD);
+        sum[0] += ival;
+        sum[1] += lval;
+    }
+    MPI_Allreduce(sum, total, 2, MPI_LONG, MPI_SUM, comm);
+    check(total[0] == (long)nproc*NINC*(nproc*NINC-1)/2, "fetch and add",
+            t, 1);
+    check(total[1] == (long)nproc*NINC*(nproc*NINC-1)/2, "fetch and add long",
+            t, 1);
+
+    /* swaps pass the values 1..nproc around, none is lost */
+    comex_barrier(COMEX_GROUP_WORLD);
+    if (me == t) *(int*)iptr[t] = 0;
+    comex_barrier(COMEX_GROUP_WORLD);
+    ival = me + 1;
+    comex_rmw(COMEX_SWAP, &ival, iptr[t], 0, t, COMEX_GROUP_WORLD);
+    sum[0] = ival;
+    comex_barrier(COMEX_GROUP_WORLD);
+    if (me == t) sum[0] += *(int*)iptr[t];
+    MPI_Allreduce(sum, total, 1, MPI_LONG, MPI_SUM, comm);
+    check(total[0] == (long)nproc*(nproc+1)/2, "swap", t, 1);
+    comex_barrier(COMEX_GROUP_WORLD);
+    if (me == t) {
+        *(int*)iptr[t] = 0;
+        *(long*)lptr[t] = 0;
+    }
+    comex_barrier(COMEX_GROUP_WORLD);
+}
+
+int main(int argc, char **argv)
+{
+    void **ptr, **iptr, **lptr;
+    int t, p;
+
+    /* node-local requests take the queue only if the SMP paths are off */
+    setenv("COMEX_ENABLE_PUT_SMP", "0", 0);
+    setenv("COMEX_ENABLE_GET_SMP", "0", 0);
+    setenv("COMEX_ENABLE_ACC_SMP", "0", 0);
+    comex_init_args(&argc, &argv);
+    comex_group_rank(COMEX_GROUP_WORLD, &me);
+    comex_group_size(COMEX_GROUP_WORLD, &nproc);
+    comex_group_comm(COMEX_GROUP_WORLD, &comm);
+    if (0 == me) {
+        printf("Testing node-local requests on %d processes\n", nproc);
+    }
+
+    ptr = (void**)malloc(nproc * sizeof(void*));
+    iptr = (void**)malloc(nproc * sizeof(void*));
+    lptr = (void**)malloc(nproc * sizeof(void*));
+    comex_malloc(ptr, nproc*LEN*sizeof(double), COMEX_GROUP_WORLD);
+    comex_malloc(iptr, sizeof(int), COMEX_GROUP_WORLD);
+    comex_malloc(lptr, sizeof(long), COMEX_GROUP_WORLD);
+    memset(ptr[me], 0, nproc*LEN*sizeof(double));
+    *(int*)iptr[me] = 0;
+    *(long*)lptr[me] = 0;
+    comex_barrier(COMEX_GROUP_WORLD);
+
+    for (p=0; p<nproc; p++) {
+        t = (me + p) % nproc;
+        test_contig(ptr, t);
+    }
+    for (t=0; t<nproc; t++) {
+        test_rmw(iptr, lptr, t);
+    }
+
+    comex_barrier(COMEX_GROUP_WORLD);
+    comex_free(lptr[me], COMEX_GROUP_WORLD);
+    comex_free(iptr[me], COMEX_GROUP_WORLD);
+    comex_free(ptr[me], COMEX_GROUP_WORLD);
+    free(lptr);
+    free(iptr);
+    free(ptr);
+
+    if (0 == me) {
+        printf("No errors detected\n");
+    }
+    comex_finalize();
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,15 @@
+/** @file
+ *  This is a dummy header file that is used if no Fortran compiler
+ *  is specified. These symbols are needed by the GA build even if
+ *  the Fortran interface is not being used
+ */
+#ifndef F77_FUNC_HEADER_INCLUDED
+#define F77_FUNC_HEADER_INCLUDED
+
+/* Mangling for Fortran global symbols without underscores. */
+#define F77_FUNC_GLOBAL(name,NAME) name##_
+
+/* Mangling for Fortran global symbols with underscores. */
+#define F77_FUNC_GLOBAL_(name,NAME) name##_
+
+#endif /* f2c_cmake.h  */
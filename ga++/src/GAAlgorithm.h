@@ -0,0 +1,610 @@
+#ifndef _GAALGORITHM_H
+#define _GAALGORITHM_H
+
+/**
+ * @file GAAlgorithm.h
+ *
+ * STL-style algorithms over the locally held data of GA::Array objects.
+ * Each algorithm visits every block of the array owned by the calling
+ * process, including all blocks of block-cyclic and ScaLAPACK-type
+ * distributions, and hands unit-stride runs of elements to the user
+ * functors so that the inner loops can be vectorized. With GA::par the runs
+ * are spread over threads, using OpenMP when the caller is compiled with it
+ * and std::thread otherwise. Reductions are completed across processes with
+ * GA's global operations. Requires C++11.
+ */
+
+#if __cplusplus >= 201103L
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <thread>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace GA {
+
+/**
+ * Execution policy that runs an algorithm on the calling thread only.
+ */
+class sequenced_policy {
+};
+
+/**
+ * Execution policy that spreads the local work of an algorithm over threads
+ * of the calling process. The functors must then be safe to call
+ * concurrently on different elements.
+ */
+class parallel_policy {
+
+ public:
+  /**
+   * @param[in] nthreads number of threads; if 0, the OpenMP default when
+   *                     compiled with OpenMP, otherwise OMP_NUM_THREADS or
+   *                     the cores of the node shared among its processes
+   */
+  explicit parallel_policy(int nthreads = 0) : mThreads(nthreads) {}
+
+  /** Number of threads to use. */
+  int threads() const {
+    int n = mThreads;
+    if (n <= 0) {
+#ifdef _OPENMP
+      n = omp_get_max_threads();
+#else
+      const char *env = getenv("OMP_NUM_THREADS");
+      if (env) n = atoi(env);
+      if (n <= 0) {
+        int ppn = GA_Cluster_nprocs(GA_Cluster_nodeid());
+        n = (int)std::thread::hardware_concurrency()/(ppn > 0 ? ppn : 1);
+      }
+#endif
+    }
+    return n > 0 ? n : 1;
+  }
+
+ private:
+  int mThreads;
+};
+
+const sequenced_policy seq = sequenced_policy();
+const parallel_policy par = parallel_policy();
+
+/** Function object returning the larger of its arguments. */
+template <typename T> struct maximum {
+  T operator()(const T &a, const T &b) const { return a < b ? b : a; }
+};
+
+/** Function object returning the smaller of its arguments. */
+template <typename T> struct minimum {
+  T operator()(const T &a, const T &b) const { return b < a ? b : a; }
+};
+
+namespace detail {
+
+/* reduction operators that have a GA global operation of their own */
+template <typename Op, typename T> struct GopOp {
+  static const bool known = false;
+  static const char* name() { return "+"; }
+  static T identity() { return T(); }
+};
+template <typename T> struct GopOp<std::plus<T>, T> {
+  static const bool known = true;
+  static const char* name() { return "+"; }
+  static T identity() { return T(0); }
+};
+template <typename T> struct GopOp<std::multiplies<T>, T> {
+  static const bool known = true;
+  static const char* name() { return "*"; }
+  static T identity() { return T(1); }
+};
+template <typename T> struct GopOp<maximum<T>, T> {
+  static const bool known = true;
+  static const char* name() { return "max"; }
+  static T identity() { return std::numeric_limits<T>::lowest(); }
+};
+template <typename T> struct GopOp<minimum<T>, T> {
+  static const bool known = true;
+  static const char* name() { return "min"; }
+  static T identity() { return std::numeric_limits<T>::max(); }
+};
+
+inline void gop(int *x, int n, const char *op) {
+  GA_Igop(x, n, const_cast<char*>(op));
+}
+inline void gop(long *x, int n, const char *op) {
+  GA_Lgop(x, n, const_cast<char*>(op));
+}
+inline void gop(long long *x, int n, const char *op) {
+  GA_Llgop(x, n, const_cast<char*>(op));
+}
+inline void gop(float *x, int n, const char *op) {
+  GA_Fgop(x, n, const_cast<char*>(op));
+}
+inline void gop(double *x, int n, const char *op) {
+  GA_Dgop(x, n, const_cast<char*>(op));
+}
+inline void gop(SingleComplex *x, int n, const char *op) {
+  GA_Cgop(x, n, const_cast<char*>(op));
+}
+inline void gop(DoubleComplex *x, int n, const char *op) {
+  GA_Zgop(x, n, const_cast<char*>(op));
+}
+
+/**
+ * All blocks of an array held by the calling process, accessed on
+ * construction and released on destruction.
+ */
+template <typename T, std::size_t N>
+class LocalBlocks {
+
+ public:
+  LocalBlocks(const Array<T,N> &a, bool update)
+    : mHandle(a.handle()), mUpdate(update) {
+    int me = GA_Nodeid(), nproc = GA_Nnodes();
+    int total = GA_Total_blocks(mHandle);
+    typename Array<T,N>::index_type lo, hi;
+    typename Array<T,N>::ld_type ld;
+    T *ptr;
+
+    if (total <= 0) {
+      mMode = REGULAR;
+      NGA_Distribution64(mHandle, me, lo.data(), hi.data());
+      for (std::size_t d = 0; d < N; d++)
+        if (lo[d] < 0 || hi[d] < lo[d]) return;
+      NGA_Access64(mHandle, lo.data(), hi.data(), &ptr, ld.data());
+      mBlocks.push_back(LocalBlock<T,N>(ptr, lo, hi, ld.data()));
+    } else if (!NGA_Uses_proc_grid(mHandle)) {
+      mMode = CYCLIC;
+      for (int idx = me; idx < total; idx += nproc) {
+        NGA_Distribution64(mHandle, idx, lo.data(), hi.data());
+        NGA_Access_block64(mHandle, idx, &ptr, ld.data());
+        mBlocks.push_back(LocalBlock<T,N>(ptr, lo, hi, ld.data()));
+        mIds.push_back(idx);
+      }
+    } else {
+      int nblocks[GA_MAX_DIM], bdims[GA_MAX_DIM], pgrid[GA_MAX_DIM];
+      int mine[GA_MAX_DIM], type, ndim;
+      int64_t dims[GA_MAX_DIM], index[GA_MAX_DIM];
+      mMode = GRID;
+      NGA_Inquire64(mHandle, &type, &ndim, dims);
+      NGA_Get_block_info(mHandle, nblocks, bdims);
+      /* NGA_Get_proc_grid is in Fortran order, NGA_Get_proc_index in C
+       * order: take the grid from the indices of all processes */
+      for (std::size_t d = 0; d < N; d++) pgrid[d] = 1;
+      for (int p = 0; p < nproc; p++) {
+        NGA_Get_proc_index(mHandle, p, mine);
+        for (std::size_t d = 0; d < N; d++)
+          pgrid[d] = std::max(pgrid[d], mine[d]+1);
+      }
+      NGA_Get_proc_index(mHandle, me, mine);
+      for (std::size_t d = 0; d < N; d++) {
+        if (mine[d] >= nblocks[d]) return;
+        index[d] = mine[d];
+      }
+      /* blocks (mine + k*pgrid), odometer over the dimensions */
+      for (;;) {
+        for (std::size_t d = 0; d < N; d++) {
+          lo[d] = index[d]*bdims[d];
+          hi[d] = std::min(lo[d] + bdims[d], dims[d]) - 1;
+        }
+        NGA_Access_block_grid64(mHandle, index, &ptr, ld.data());
+        mBlocks.push_back(LocalBlock<T,N>(ptr, lo, hi, ld.data()));
+        mGrid.insert(mGrid.end(), index, index + N);
+        std::size_t d = N;
+        for (;;) {
+          if (d == 0) return;
+          d--;
+          index[d] += pgrid[d];
+          if (index[d] < nblocks[d]) break;
+          index[d] = mine[d];
+        }
+      }
+    }
+  }
+
+  ~LocalBlocks() {
+    for (std::size_t i = 0; i < mBlocks.size(); i++) {
+      if (mMode == REGULAR) {
+        typename Array<T,N>::index_type lo = mBlocks[i].lo();
+        typename Array<T,N>::index_type hi = mBlocks[i].hi();
+        if (mUpdate) NGA_Release_update64(mHandle, lo.data(), hi.data());
+        else NGA_Release64(mHandle, lo.data(), hi.data());
+      } else if (mMode == CYCLIC) {
+        if (mUpdate) NGA_Release_update_block(mHandle, mIds[i]);
+        else NGA_Release_block(mHandle, mIds[i]);
+      } else {
+        int index[GA_MAX_DIM];
+        for (std::size_t d = 0; d < N; d++) index[d] = (int)mGrid[i*N+d];
+        if (mUpdate) NGA_Release_update_block_grid(mHandle, index);
+        else NGA_Release_block_grid(mHandle, index);
+      }
+    }
+  }
+
+  std::size_t size() const { return mBlocks.size(); }
+  const LocalBlock<T,N>& operator[](std::size_t i) const { return mBlocks[i]; }
+
+ private:
+  LocalBlocks(const LocalBlocks&);
+  LocalBlocks& operator=(const LocalBlocks&);
+
+  enum { REGULAR, CYCLIC, GRID } mMode;
+  int mHandle;
+  bool mUpdate;
+  std::vector<LocalBlock<T,N> > mBlocks;
+  std::vector<int> mIds;
+  std::vector<int64_t> mGrid;
+};
+
+/**
+ * A piece of local work: columns c0..c1-1 of rows r0..r1-1 of block blk.
+ * A block that is contiguous in all arrays involved is one row.
+ */
+struct WorkItem {
+  std::size_t blk;
+  int64_t r0, r1, c0, c1;
+  bool flat;
+};
+
+/* cut the local blocks into about 4 pieces of work per thread */
+template <typename T, std::size_t N>
+std::vector<WorkItem> split(const LocalBlocks<T,N> &b, bool flat_ok,
+                            int nthreads) {
+  std::vector<WorkItem> items;
+  int64_t total = 0, grain;
+  for (std::size_t i = 0; i < b.size(); i++) total += b[i].size();
+  grain = std::max<int64_t>(total/(4*nthreads), 1024);
+
+  for (std::size_t i = 0; i < b.size(); i++) {
+    WorkItem w;
+    int64_t nrow, ncol;
+    if (b[i].empty()) continue;
+    w.blk = i;
+    w.flat = flat_ok && b[i].contiguous();
+    nrow = w.flat ? 1 : b[i].rows();
+    ncol = w.flat ? b[i].size() : b[i].extent(N-1);
+    if (ncol >= grain) {
+      for (int64_t r = 0; r < nrow; r++) {
+        for (int64_t c = 0; c < ncol; c += grain) {
+          w.r0 = r; w.r1 = r+1;
+          w.c0 = c; w.c1 = std::min(c + grain, ncol);
+          items.push_back(w);
+        }
+      }
+    } else {
+      int64_t step = std::max<int64_t>(grain/ncol, 1);
+      for (int64_t r = 0; r < nrow; r += step) {
+        w.r0 = r; w.r1 = std::min(r + step, nrow);
+        w.c0 = 0; w.c1 = ncol;
+        items.push_back(w);
+      }
+    }
+  }
+  return items;
+}
+
+template <typename T, std::size_t N>
+inline T* rowOf(const LocalBlock<T,N> &b, const WorkItem &w, int64_t r) {
+  return w.flat ? b.data() : b.row(r);
+}
+
+inline int threads(const sequenced_policy&) { return 1; }
+inline int threads(const parallel_policy &p) { return p.threads(); }
+
+/* call f(i) for i in [0,n) */
+template <typename F>
+void run(const sequenced_policy&, std::size_t n, F f) {
+  for (std::size_t i = 0; i < n; i++) f(i);
+}
+
+template <typename F>
+void run(const parallel_policy &p, std::size_t n, F f) {
+  int nt = (int)std::min<std::size_t>(p.threads(), n);
+  if (nt <= 1) {
+    for (std::size_t i = 0; i < n; i++) f(i);
+    return;
+  }
+#ifdef _OPENMP
+  long ln = (long)n;
+#pragma omp parallel for num_threads(nt) schedule(dynamic,1)
+  for (long i = 0; i < ln; i++) f((std::size_t)i);
+#else
+  std::atomic<std::size_t> next(0);
+  std::vector<std::thread> pool;
+  auto worker = [&]() {
+    for (std::size_t i = next++; i < n; i = next++) f(i);
+  };
+  for (int t = 1; t < nt; t++) pool.push_back(std::thread(worker));
+  worker();
+  for (std::size_t t = 0; t < pool.size(); t++) pool[t].join();
+#endif
+}
+
+/* combine the per-process partial results, init counted once */
+template <typename T, typename Op>
+T allreduce(const T &init, const T &part, bool has, Op op) {
+  if (GopOp<Op,T>::known) {
+    T x = has ? part : GopOp<Op,T>::identity();
+    gop(&x, 1, GopOp<Op,T>::name());
+    return op(init, x);
+  }
+  /* no global operation for op: gather all partials and fold in order */
+  int me = GA_Nodeid(), nproc = GA_Nnodes();
+  std::vector<T> v(nproc, T());
+  std::vector<int> h(nproc, 0);
+  T r = init;
+  if (has) {
+    v[me] = part;
+    h[me] = 1;
+  }
+  gop(v.data(), nproc, "+");
+  gop(h.data(), nproc, "+");
+  for (int i = 0; i < nproc; i++) if (h[i]) r = op(r, v[i]);
+  return r;
+}
+
+/* fold the partial results of the work items in order */
+template <typename T, typename Op>
+bool fold(const std::vector<T> &part, const std::vector<char> &has, Op op,
+          T &r) {
+  bool any = false;
+  for (std::size_t i = 0; i < part.size(); i++) {
+    if (!has[i]) continue;
+    r = any ? op(r, part[i]) : part[i];
+    any = true;
+  }
+  return any;
+}
+
+}
+
+/**
+ * Calls f(x) for every element x of the array held by the calling process;
+ * f may modify x. No synchronization is done.
+ *
+ * This is a local operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      array
+ * @param[in] f      callable taking T&
+ */
+template <typename Policy, typename T, std::size_t N, typename F>
+void for_each_local(const Policy &policy, const Array<T,N> &a, F f) {
+  detail::LocalBlocks<T,N> ba(a, true);
+  std::vector<detail::WorkItem> items =
+    detail::split(ba, true, detail::threads(policy));
+  detail::run(policy, items.size(), [&](std::size_t i) {
+    const detail::WorkItem &w = items[i];
+    for (int64_t r = w.r0; r < w.r1; r++) {
+      T *pa = detail::rowOf(ba[w.blk], w, r);
+      for (int64_t c = w.c0; c < w.c1; c++) f(pa[c]);
+    }
+  });
+}
+
+/**
+ * Sets every element of b to f applied to the corresponding element of a.
+ * a and b must have the same distribution and may be the same array.
+ *
+ * This is a collective operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      input array
+ * @param[in] b      output array
+ * @param[in] f      callable taking T and returning U
+ */
+template <typename Policy, typename T, typename U, std::size_t N, typename F>
+void transform(const Policy &policy, const Array<T,N> &a, const Array<U,N> &b,
+               F f) {
+  if (GA_Compare_distr(a.handle(), b.handle()))
+    GA_Error((char *)"GA::transform: arrays have different distributions",0);
+  GA_Sync();
+  {
+    detail::LocalBlocks<T,N> ba(a, false);
+    detail::LocalBlocks<U,N> bb(b, true);
+    bool flat = true;
+    for (std::size_t i = 0; i < ba.size(); i++)
+      flat = flat && ba[i].contiguous() && bb[i].contiguous();
+    std::vector<detail::WorkItem> items =
+      detail::split(ba, flat, detail::threads(policy));
+    detail::run(policy, items.size(), [&](std::size_t i) {
+      const detail::WorkItem &w = items[i];
+      for (int64_t r = w.r0; r < w.r1; r++) {
+        const T *pa = detail::rowOf(ba[w.blk], w, r);
+        U *pb = detail::rowOf(bb[w.blk], w, r);
+        for (int64_t c = w.c0; c < w.c1; c++) pb[c] = f(pa[c]);
+      }
+    });
+  }
+  GA_Sync();
+}
+
+/**
+ * Sets every element of c to f applied to the corresponding elements of a
+ * and b. All three arrays must have the same distribution; c may be the
+ * same array as a or b.
+ *
+ * This is a collective operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      first input array
+ * @param[in] b      second input array
+ * @param[in] c      output array
+ * @param[in] f      callable taking T, U and returning V
+ */
+template <typename Policy, typename T, typename U, typename V, std::size_t N,
+          typename F>
+void transform(const Policy &policy, const Array<T,N> &a, const Array<U,N> &b,
+               const Array<V,N> &c, F f) {
+  if (GA_Compare_distr(a.handle(), b.handle()) ||
+      GA_Compare_distr(a.handle(), c.handle()))
+    GA_Error((char *)"GA::transform: arrays have different distributions",0);
+  GA_Sync();
+  {
+    detail::LocalBlocks<T,N> ba(a, false);
+    detail::LocalBlocks<U,N> bb(b, false);
+    detail::LocalBlocks<V,N> bc(c, true);
+    bool flat = true;
+    for (std::size_t i = 0; i < ba.size(); i++)
+      flat = flat && ba[i].contiguous() && bb[i].contiguous() &&
+        bc[i].contiguous();
+    std::vector<detail::WorkItem> items =
+      detail::split(ba, flat, detail::threads(policy));
+    detail::run(policy, items.size(), [&](std::size_t i) {
+      const detail::WorkItem &w = items[i];
+      for (int64_t r = w.r0; r < w.r1; r++) {
+        const T *pa = detail::rowOf(ba[w.blk], w, r);
+        const U *pb = detail::rowOf(bb[w.blk], w, r);
+        V *pc = detail::rowOf(bc[w.blk], w, r);
+        for (int64_t k = w.c0; k < w.c1; k++) pc[k] = f(pa[k], pb[k]);
+      }
+    });
+  }
+  GA_Sync();
+}
+
+/**
+ * Returns init combined by rop with top(x) for all elements x of the array.
+ * rop must be associative and commutative. std::plus, std::multiplies,
+ * GA::maximum and GA::minimum are completed with a single global operation;
+ * other operators gather one partial result per process.
+ *
+ * This is a collective operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      array
+ * @param[in] init   initial value
+ * @param[in] rop    callable taking two R and returning R
+ * @param[in] top    callable taking T and returning R
+ */
+template <typename Policy, typename T, std::size_t N, typename R,
+          typename ROp, typename TOp>
+R transform_reduce(const Policy &policy, const Array<T,N> &a, R init,
+                   ROp rop, TOp top) {
+  R local = R();
+  bool has;
+  GA_Sync();
+  {
+    detail::LocalBlocks<T,N> ba(a, false);
+    std::vector<detail::WorkItem> items =
+      detail::split(ba, true, detail::threads(policy));
+    std::vector<R> part(items.size());
+    std::vector<char> phas(items.size(), 0);
+    detail::run(policy, items.size(), [&](std::size_t i) {
+      const detail::WorkItem &w = items[i];
+      R acc = R();
+      for (int64_t r = w.r0; r < w.r1; r++) {
+        const T *pa = detail::rowOf(ba[w.blk], w, r);
+        R row = top(pa[w.c0]);
+        for (int64_t c = w.c0+1; c < w.c1; c++) row = rop(row, top(pa[c]));
+        acc = r == w.r0 ? row : rop(acc, row);
+      }
+      part[i] = acc;
+      phas[i] = 1;
+    });
+    has = detail::fold(part, phas, rop, local);
+  }
+  return detail::allreduce(init, local, has, rop);
+}
+
+/**
+ * Returns init combined by rop with top(x, y) for all corresponding elements
+ * x of a and y of b, which must have the same distribution.
+ *
+ * This is a collective operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      first array
+ * @param[in] b      second array
+ * @param[in] init   initial value
+ * @param[in] rop    callable taking two R and returning R
+ * @param[in] top    callable taking T, U and returning R
+ */
+template <typename Policy, typename T, typename U, std::size_t N, typename R,
+          typename ROp, typename TOp>
+R transform_reduce(const Policy &policy, const Array<T,N> &a,
+                   const Array<U,N> &b, R init, ROp rop, TOp top) {
+  R local = R();
+  bool has;
+  if (GA_Compare_distr(a.handle(), b.handle()))
+    GA_Error((char *)"GA::transform_reduce: arrays have different"
+             " distributions",0);
+  GA_Sync();
+  {
+    detail::LocalBlocks<T,N> ba(a, false);
+    detail::LocalBlocks<U,N> bb(b, false);
+    bool flat = true;
+    for (std::size_t i = 0; i < ba.size(); i++)
+      flat = flat && ba[i].contiguous() && bb[i].contiguous();
+    std::vector<detail::WorkItem> items =
+      detail::split(ba, flat, detail::threads(policy));
+    std::vector<R> part(items.size());
+    std::vector<char> phas(items.size(), 0);
+    detail::run(policy, items.size(), [&](std::size_t i) {
+      const detail::WorkItem &w = items[i];
+      R acc = R();
+      for (int64_t r = w.r0; r < w.r1; r++) {
+        const T *pa = detail::rowOf(ba[w.blk], w, r);
+        const U *pb = detail::rowOf(bb[w.blk], w, r);
+        R row = top(pa[w.c0], pb[w.c0]);
+        for (int64_t c = w.c0+1; c < w.c1; c++)
+          row = rop(row, top(pa[c], pb[c]));
+        acc = r == w.r0 ? row : rop(acc, row);
+      }
+      part[i] = acc;
+      phas[i] = 1;
+    });
+    has = detail::fold(part, phas, rop, local);
+  }
+  return detail::allreduce(init, local, has, rop);
+}
+
+/**
+ * Returns init plus the sum of the products of corresponding elements of a
+ * and b, which must have the same distribution.
+ *
+ * This is a collective operation.
+ */
+template <typename Policy, typename T, typename U, std::size_t N, typename R>
+R transform_reduce(const Policy &policy, const Array<T,N> &a,
+                   const Array<U,N> &b, R init) {
+  return transform_reduce(policy, a, b, init, std::plus<R>(),
+                          [](const T &x, const U &y) { return R(x*y); });
+}
+
+/**
+ * Returns init combined by op with all elements of the array.
+ *
+ * This is a collective operation.
+ *
+ * @param[in] policy GA::seq or GA::par
+ * @param[in] a      array
+ * @param[in] init   initial value
+ * @param[in] op     callable taking two T and returning T
+ */
+template <typename Policy, typename T, std::size_t N, typename Op>
+T reduce(const Policy &policy, const Array<T,N> &a, T init, Op op) {
+  return transform_reduce(policy, a, init, op, [](const T &x) { return x; });
+}
+
+/**
+ * Returns init plus the sum of all elements of the array.
+ *
+ * This is a collective operation.
+ */
+template <typename Policy, typename T, std::size_t N>
+T reduce(const Policy &policy, const Array<T,N> &a, T init) {
+  return reduce(policy, a, init, std::plus<T>());
+}
+
+}
+
+#endif /* __cplusplus >= 201103L */
+
+#endif /* _GAALGORITHM_H */
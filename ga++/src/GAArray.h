@@ -0,0 +1,527 @@
+#ifndef _GAARRAY_H
+#define _GAARRAY_H
+
+/**
+ * @file GAArray.h
+ *
+ * Typed global arrays. GA::Array<T,N> carries the element type and the
+ * number of dimensions of a global array in its type, so that patch
+ * transfers take std::array bounds and typed buffers, and local data is
+ * reached through typed GA::LocalBlock views instead of void pointers. Loops
+ * over local blocks are instantiated for T and N and can be vectorized by the
+ * compiler. Requires C++11.
+ */
+
+#if __cplusplus >= 201103L
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace GA {
+
+/**
+ * Maps a C++ element type to the GA type of a global array.
+ */
+template <typename T> struct TypeOf;
+template <> struct TypeOf<int>           { static const int value = C_INT; };
+template <> struct TypeOf<long>          { static const int value = C_LONG; };
+template <> struct TypeOf<long long>     { static const int value = C_LONGLONG; };
+template <> struct TypeOf<float>         { static const int value = C_FLOAT; };
+template <> struct TypeOf<double>        { static const int value = C_DBL; };
+template <> struct TypeOf<SingleComplex> { static const int value = C_SCPL; };
+template <> struct TypeOf<DoubleComplex> { static const int value = C_DCPL; };
+
+/**
+ * Typed view of a block of a global array held in local memory. The block
+ * covers the global indices lo..hi (0-based, inclusive); the last dimension
+ * is contiguous and ld holds the leading dimensions of the others, as
+ * returned by NGA_Access. A view does not own the memory and must not be
+ * used after the block has been released.
+ */
+template <typename T, std::size_t N>
+class LocalBlock {
+
+ public:
+  typedef T value_type;
+  typedef std::array<int64_t, N> index_type;
+
+  /** Creates an empty block. */
+  LocalBlock() : mPtr(nullptr) {
+    for (std::size_t d = 0; d < N; d++) {
+      mLo[d] = 0;
+      mHi[d] = -1;
+      mStride[d] = 0;
+    }
+  }
+
+  /**
+   * Creates a view of the block at ptr.
+   *
+   * @param[in] ptr first element of the block
+   * @param[in] lo  global indices of the first element
+   * @param[in] hi  global indices of the last element
+   * @param[in] ld  leading dimensions of the block, N-1 values
+   */
+  LocalBlock(T *ptr, const index_type &lo, const index_type &hi,
+             const int64_t *ld) : mPtr(ptr), mLo(lo), mHi(hi) {
+    mStride[N-1] = 1;
+    for (std::size_t d = N-1; d > 0; d--) mStride[d-1] = mStride[d]*ld[d-1];
+  }
+
+  T* data() const { return mPtr; }
+  const index_type& lo() const { return mLo; }
+  const index_type& hi() const { return mHi; }
+
+  /** Number of elements of the block along dimension d. */
+  int64_t extent(std::size_t d) const { return mHi[d] - mLo[d] + 1; }
+
+  /** Distance in elements between neighbours along dimension d. */
+  int64_t stride(std::size_t d) const { return mStride[d]; }
+
+  /** Number of elements in the block. */
+  int64_t size() const {
+    int64_t n = 1;
+    for (std::size_t d = 0; d < N; d++) n *= extent(d) > 0 ? extent(d) : 0;
+    return n;
+  }
+
+  bool empty() const { return mPtr == nullptr || size() == 0; }
+
+  /** Number of rows, i.e. of runs of extent(N-1) contiguous elements. */
+  int64_t rows() const {
+    int64_t n = 1;
+    for (std::size_t d = 0; d+1 < N; d++) n *= extent(d) > 0 ? extent(d) : 0;
+    return n;
+  }
+
+  /** First element of row r, counting rows in C order. */
+  T* row(int64_t r) const {
+    int64_t off = 0;
+    for (std::size_t d = N-1; d > 0; d--) {
+      off += (r % extent(d-1))*mStride[d-1];
+      r /= extent(d-1);
+    }
+    return mPtr + off;
+  }
+
+  /** True if the elements of the block are stored without gaps. */
+  bool contiguous() const {
+    for (std::size_t d = 0; d+1 < N; d++)
+      if (mStride[d] != mStride[d+1]*extent(d+1)) return false;
+    return true;
+  }
+
+  /** Element with global indices i, which must lie within the block. */
+  T& operator[](const index_type &i) const {
+    int64_t off = 0;
+    for (std::size_t d = 0; d < N; d++) off += (i[d] - mLo[d])*mStride[d];
+    return mPtr[off];
+  }
+
+  /**
+   * Calls f(row, n) for every run of n contiguous elements of the block,
+   * i.e. once per index of the leading N-1 dimensions. Loops over the
+   * row inside f are unit stride.
+   *
+   * @param[in] f callable taking (T*, int64_t)
+   */
+  template <typename F>
+  void forEachRow(F f) const {
+    if (empty()) return;
+    if (contiguous()) {
+      f(mPtr, size());
+      return;
+    }
+    /* i runs over the leading dimensions like an odometer */
+    index_type i;
+    for (std::size_t d = 0; d < N; d++) i[d] = 0;
+    const int64_t n = extent(N-1);
+    for (;;) {
+      int64_t off = 0;
+      for (std::size_t d = 0; d+1 < N; d++) off += i[d]*mStride[d];
+      f(mPtr + off, n);
+      std::size_t d = N-1;
+      for (;;) {
+        if (d == 0) return;
+        d--;
+        if (++i[d] < extent(d)) break;
+        i[d] = 0;
+      }
+    }
+  }
+
+ private:
+  T *mPtr;
+  index_type mLo;
+  index_type mHi;
+  index_type mStride;
+};
+
+/**
+ * A GlobalArray whose element type T and number of dimensions N are known at
+ * compile time. All members of GlobalArray remain available; the members
+ * added here take typed arguments and std::array bounds with 0-based,
+ * inclusive C indices.
+ */
+template <typename T, std::size_t N>
+class Array : public GlobalArray {
+
+ public:
+  typedef T value_type;
+  typedef std::array<int64_t, N> index_type;
+  typedef std::array<int64_t, (N > 1 ? N-1 : 1)> ld_type;
+  typedef LocalBlock<T, N> block_type;
+
+  /**
+   * Creates an array with a regular distribution.
+   *
+   * This is a collective operation.
+   *
+   * @param[in] dims      array dimensions
+   * @param[in] arrayname a character string
+   * @param[in] chunk     minimum block sizes, even distribution if NULL
+   */
+  explicit Array(const index_type &dims, const char *arrayname = "Array",
+        const index_type *chunk = nullptr)
+    : GlobalArray(create(dims, arrayname, chunk, nullptr)) {}
+
+  /**
+   * @copydoc Array::Array(const index_type&,const char*,const index_type*)
+   * @param[in] p_handle processor group handle
+   */
+  Array(const index_type &dims, const char *arrayname,
+        const index_type *chunk, PGroup *p_handle)
+    : GlobalArray(create(dims, arrayname, chunk, p_handle)) {}
+
+  /**
+   * Creates an array with a block-cyclic distribution. Blocks of size block
+   * are dealt out to the processes round-robin or, if proc_grid is given,
+   * cyclically over a process grid as in ScaLAPACK.
+   *
+   * This is a collective operation.
+   *
+   * @param[in] dims      array dimensions
+   * @param[in] block     block dimensions
+   * @param[in] arrayname a character string
+   * @param[in] proc_grid process grid, its product must be the number of
+   *                      processes
+   */
+  Array(const index_type &dims, const std::array<int, N> &block,
+        const char *arrayname = "Array",
+        const std::array<int, N> *proc_grid = nullptr)
+    : GlobalArray(createBlockCyclic(dims, block, arrayname, proc_grid)) {}
+
+  /** Dimensions of the array. This is a local operation. */
+  index_type dims() const {
+    int type, ndim;
+    int64_t d[GA_MAX_DIM];
+    index_type r;
+    NGA_Inquire64(mHandle, &type, &ndim, d);
+    for (std::size_t i = 0; i < N; i++) r[i] = d[i];
+    return r;
+  }
+
+  using GlobalArray::get;
+  using GlobalArray::put;
+  using GlobalArray::acc;
+  using GlobalArray::access;
+  using GlobalArray::release;
+  using GlobalArray::releaseUpdate;
+
+  /**
+   * Copies the patch lo..hi into buf, whose leading dimensions are ld.
+   *
+   * This is a one-sided operation.
+   */
+  void get(const index_type &lo, const index_type &hi, T *buf,
+           const ld_type &ld) const {
+    index_type l = lo, h = hi;
+    ld_type m = ld;
+    NGA_Get64(mHandle, l.data(), h.data(), buf, m.data());
+  }
+
+  /**
+   * Copies the patch lo..hi into buf, which holds the patch densely.
+   *
+   * This is a one-sided operation.
+   */
+  void get(const index_type &lo, const index_type &hi, T *buf) const {
+    get(lo, hi, buf, denseLd(lo, hi));
+  }
+
+  /** Returns the element with indices i. This is a one-sided operation. */
+  T get(const index_type &i) const {
+    T v;
+    get(i, i, &v);
+    return v;
+  }
+
+  /**
+   * Copies buf, whose leading dimensions are ld, into the patch lo..hi.
+   *
+   * This is a one-sided operation.
+   */
+  void put(const index_type &lo, const index_type &hi, const T *buf,
+           const ld_type &ld) const {
+    index_type l = lo, h = hi;
+    ld_type m = ld;
+    NGA_Put64(mHandle, l.data(), h.data(), const_cast<T*>(buf), m.data());
+  }
+
+  /**
+   * Copies the dense buffer buf into the patch lo..hi.
+   *
+   * This is a one-sided operation.
+   */
+  void put(const index_type &lo, const index_type &hi, const T *buf) const {
+    put(lo, hi, buf, denseLd(lo, hi));
+  }
+
+  /** Stores v at indices i. This is a one-sided operation. */
+  void put(const index_type &i, const T &v) const {
+    put(i, i, &v);
+  }
+
+  /**
+   * Atomically adds alpha*buf to the patch lo..hi; buf has leading
+   * dimensions ld.
+   *
+   * This is a one-sided and atomic operation.
+   */
+  void acc(const index_type &lo, const index_type &hi, const T *buf,
+           const ld_type &ld, const T &alpha) const {
+    index_type l = lo, h = hi;
+    ld_type m = ld;
+    T a = alpha;
+    NGA_Acc64(mHandle, l.data(), h.data(), const_cast<T*>(buf), m.data(), &a);
+  }
+
+  /**
+   * Atomically adds alpha times the dense buffer buf to the patch lo..hi.
+   *
+   * This is a one-sided and atomic operation.
+   */
+  void acc(const index_type &lo, const index_type &hi, const T *buf,
+           const T &alpha) const {
+    acc(lo, hi, buf, denseLd(lo, hi), alpha);
+  }
+
+  /**
+   * Returns a view of the block of the array held by this process, which is
+   * empty if the process holds no data. The block must be given back with
+   * release() or releaseUpdate(). Not available for block-cyclic arrays.
+   *
+   * This is a local operation.
+   */
+  block_type access() const {
+    index_type lo, hi;
+    ld_type ld;
+    T *ptr = nullptr;
+    NGA_Distribution64(mHandle, GA_Nodeid(), lo.data(), hi.data());
+    for (std::size_t d = 0; d < N; d++)
+      if (lo[d] < 0 || hi[d] < lo[d]) return block_type();
+    NGA_Access64(mHandle, lo.data(), hi.data(), &ptr, ld.data());
+    return block_type(ptr, lo, hi, ld.data());
+  }
+
+  /** Releases a block obtained from access() without changes. */
+  void release(const block_type &b) const {
+    if (b.data() == nullptr) return;
+    index_type lo = b.lo(), hi = b.hi();
+    NGA_Release64(mHandle, lo.data(), hi.data());
+  }
+
+  /** Releases a block obtained from access() after changing it. */
+  void releaseUpdate(const block_type &b) const {
+    if (b.data() == nullptr) return;
+    index_type lo = b.lo(), hi = b.hi();
+    NGA_Release_update64(mHandle, lo.data(), hi.data());
+  }
+
+  using GlobalArray::nbGet;
+  using GlobalArray::nbPut;
+  using GlobalArray::nbAcc;
+
+  /**
+   * Starts copying the patch lo..hi into the dense buffer buf, which must
+   * stay valid until the returned future is ready.
+   *
+   * This is a non-blocking one-sided operation.
+   */
+  Future<void> nbGet(const index_type &lo, const index_type &hi,
+                     T *buf) const {
+    index_type l = lo, h = hi;
+    ld_type ld = denseLd(lo, hi);
+    ga_nbhdl_t hdl;
+    NGA_NbGet64(mHandle, l.data(), h.data(), buf, ld.data(), &hdl);
+    return Future<void>(hdl);
+  }
+
+  /**
+   * Starts copying the patch lo..hi into a new dense buffer, which is the
+   * value of the returned future.
+   *
+   * This is a non-blocking one-sided operation.
+   */
+  Future<std::vector<T> > nbGet(const index_type &lo,
+                                const index_type &hi) const {
+    std::shared_ptr<detail::ValueState<std::vector<T> > > s =
+      std::make_shared<detail::ValueState<std::vector<T> > >();
+    index_type l = lo, h = hi;
+    ld_type ld = denseLd(lo, hi);
+    ga_nbhdl_t hdl;
+    int64_t n = 1;
+    for (std::size_t d = 0; d < N; d++) n *= hi[d] - lo[d] + 1;
+    s->mValue.resize(n);
+    NGA_NbGet64(mHandle, l.data(), h.data(), s->mValue.data(), ld.data(),
+                &hdl);
+    s->addHandle(hdl);
+    detail::track(s);
+    return Future<std::vector<T> >(s);
+  }
+
+  /**
+   * Starts copying the dense buffer buf into the patch lo..hi; buf must stay
+   * valid until the returned future is ready.
+   *
+   * This is a non-blocking one-sided operation.
+   */
+  Future<void> nbPut(const index_type &lo, const index_type &hi,
+                     const T *buf) const {
+    index_type l = lo, h = hi;
+    ld_type ld = denseLd(lo, hi);
+    ga_nbhdl_t hdl;
+    NGA_NbPut64(mHandle, l.data(), h.data(), const_cast<T*>(buf), ld.data(),
+                &hdl);
+    return Future<void>(hdl);
+  }
+
+  /**
+   * Starts copying the dense buffer buf into the patch lo..hi. The future
+   * keeps the buffer until the copy has completed.
+   *
+   * This is a non-blocking one-sided operation.
+   */
+  Future<void> nbPut(const index_type &lo, const index_type &hi,
+                     std::vector<T> buf) const {
+    std::shared_ptr<std::vector<T> > b =
+      std::make_shared<std::vector<T> >(std::move(buf));
+    Future<void> f = nbPut(lo, hi, b->data());
+    f.state()->keep(b);
+    return f;
+  }
+
+  /**
+   * Starts adding alpha times the dense buffer buf to the patch lo..hi; buf
+   * must stay valid until the returned future is ready.
+   *
+   * This is a non-blocking one-sided and atomic operation.
+   */
+  Future<void> nbAcc(const index_type &lo, const index_type &hi,
+                     const T *buf, const T &alpha) const {
+    index_type l = lo, h = hi;
+    ld_type ld = denseLd(lo, hi);
+    std::shared_ptr<T> a = std::make_shared<T>(alpha);
+    ga_nbhdl_t hdl;
+    NGA_NbAcc64(mHandle, l.data(), h.data(), const_cast<T*>(buf), ld.data(),
+                a.get(), &hdl);
+    Future<void> f(hdl);
+    f.state()->keep(a);
+    return f;
+  }
+
+  using GlobalArray::fill;
+  using GlobalArray::scale;
+
+  /**
+   * Assigns v to all elements of the array.
+   *
+   * This is a collective operation.
+   */
+  void fill(const T &v) const {
+    if (GA_Total_blocks(mHandle) > 0) {
+      T w = v;
+      GlobalArray::fill(&w);
+      return;
+    }
+    GA_Sync();
+    block_type b = access();
+    b.forEachRow([&v](T *p, int64_t n) {
+      for (int64_t i = 0; i < n; i++) p[i] = v;
+    });
+    releaseUpdate(b);
+    GA_Sync();
+  }
+
+  /**
+   * Multiplies all elements of the array by s.
+   *
+   * This is a collective operation.
+   */
+  void scale(const T &s) const {
+    if (GA_Total_blocks(mHandle) > 0) {
+      T w = s;
+      GlobalArray::scale(&w);
+      return;
+    }
+    GA_Sync();
+    block_type b = access();
+    b.forEachRow([&s](T *p, int64_t n) {
+      for (int64_t i = 0; i < n; i++) p[i] *= s;
+    });
+    releaseUpdate(b);
+    GA_Sync();
+  }
+
+ private:
+  static int create(const index_type &dims, const char *arrayname,
+                    const index_type *chunk, PGroup *p_handle) {
+    index_type d = dims, c;
+    int g_a;
+    if (chunk) c = *chunk;
+    else c.fill(-1);
+    if (p_handle)
+      g_a = NGA_Create_config64(TypeOf<T>::value, (int)N, d.data(),
+                                const_cast<char*>(arrayname), c.data(),
+                                p_handle->handle());
+    else
+      g_a = NGA_Create64(TypeOf<T>::value, (int)N, d.data(),
+                         const_cast<char*>(arrayname), c.data());
+    if (!g_a) GA_Error((char *)" GA creation failed",0);
+    return g_a;
+  }
+
+  static int createBlockCyclic(const index_type &dims,
+                               const std::array<int, N> &block,
+                               const char *arrayname,
+                               const std::array<int, N> *proc_grid) {
+    index_type d = dims;
+    std::array<int, N> b = block, p;
+    int g_a = GA_Create_handle();
+    NGA_Set_data64(g_a, (int)N, d.data(), TypeOf<T>::value);
+    NGA_Set_array_name(g_a, const_cast<char*>(arrayname));
+    if (proc_grid) {
+      p = *proc_grid;
+      NGA_Set_block_cyclic_proc_grid(g_a, b.data(), p.data());
+    } else {
+      NGA_Set_block_cyclic(g_a, b.data());
+    }
+    if (!NGA_Allocate(g_a)) GA_Error((char *)" GA creation failed",0);
+    return g_a;
+  }
+
+  static ld_type denseLd(const index_type &lo, const index_type &hi) {
+    ld_type ld;
+    ld[0] = 1;
+    for (std::size_t d = 0; d+1 < N; d++) ld[d] = hi[d+1] - lo[d+1] + 1;
+    return ld;
+  }
+};
+
+}
+
+#endif /* __cplusplus >= 201103L */
+
+#endif /* _GAARRAY_H */
@@ -0,0 +1,331 @@
+#ifndef _GAFUTURE_H
+#define _GAFUTURE_H
+
+/**
+ * @file GAFuture.h
+ *
+ * Futures for non-blocking GA operations. A GA::Future<T> stands for the
+ * completion of one or more non-blocking requests (ga_nbhdl_t handles) and,
+ * optionally, a value of type T such as the buffer filled by a get.
+ * Continuations attached with then() run when the requests they depend on
+ * have completed, and may themselves start further non-blocking operations
+ * by returning a future. Completion is detected by polling the handles with
+ * NGA_NbTest, either when a future is queried or waited on, or for all
+ * outstanding futures by GA::progress(). Nothing runs in the background;
+ * continuations are executed by the thread that calls into this layer.
+ * Requires C++11.
+ */
+
+#if __cplusplus >= 201103L
+
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace GA {
+
+template <typename T> class Future;
+
+namespace detail {
+
+/**
+ * Shared state of a future: the GA requests and the other states it waits
+ * for, and an action to run once all of them have completed.
+ */
+class AsyncState {
+
+ public:
+  AsyncState() : mDone(false) {}
+  virtual ~AsyncState() {}
+
+  void addHandle(ga_nbhdl_t h) { mHandles.push_back(h); }
+  void addWait(const std::shared_ptr<AsyncState> &s) { mWaits.push_back(s); }
+  void setAction(const std::function<void()> &f) { mAction = f; }
+
+  /* keep p alive until the state has completed */
+  void keep(const std::shared_ptr<void> &p) { mKeep.push_back(p); }
+
+  /* returns true once completed, running the action if it is due */
+  bool poll() {
+    for (;;) {
+      if (mDone) return true;
+      /* a handle that tests complete is released by GA, so it is dropped
+       * rather than tested or waited for again */
+      while (!mHandles.empty()) {
+        if (!NGA_NbTest(&mHandles.back())) return false;
+        mHandles.pop_back();
+      }
+      for (std::size_t i = 0; i < mWaits.size(); i++)
+        if (!mWaits[i]->poll()) return false;
+      if (!advance()) return true;
+    }
+  }
+
+  /* blocks until completed */
+  void wait() {
+    for (;;) {
+      if (mDone) return;
+      for (std::size_t i = 0; i < mWaits.size(); i++) mWaits[i]->wait();
+      if (!advance()) return;
+    }
+  }
+
+ private:
+  /* all dependencies are complete: release them and run the action, which
+   * may add new dependencies; returns true if there are any */
+  bool advance() {
+    for (std::size_t i = 0; i < mHandles.size(); i++)
+      NGA_NbWait(&mHandles[i]);
+    mHandles.clear();
+    mWaits.clear();
+    if (mAction) {
+      std::function<void()> f;
+      f.swap(mAction);
+      f();
+      if (!mHandles.empty() || !mWaits.empty() || mAction) return true;
+    }
+    mKeep.clear();
+    mDone = true;
+    return false;
+  }
+
+  AsyncState(const AsyncState&);
+  AsyncState& operator=(const AsyncState&);
+
+  bool mDone;
+  std::vector<ga_nbhdl_t> mHandles;
+  std::vector<std::shared_ptr<AsyncState> > mWaits;
+  std::vector<std::shared_ptr<void> > mKeep;
+  std::function<void()> mAction;
+};
+
+template <typename T> class ValueState : public AsyncState {
+ public:
+  ValueState() : mValue() {}
+  T mValue;
+};
+
+template <> class ValueState<void> : public AsyncState {
+};
+
+/* states not yet seen complete by progress() */
+inline std::vector<std::shared_ptr<AsyncState> >& pending() {
+  static std::vector<std::shared_ptr<AsyncState> > list;
+  return list;
+}
+
+inline void track(const std::shared_ptr<AsyncState> &s) {
+  pending().push_back(s);
+}
+
+template <typename T> inline T& value(ValueState<T> &s) { return s.mValue; }
+inline void value(ValueState<void>&) {}
+
+template <typename T>
+inline void assign(ValueState<T> &dst, ValueState<T> &src) {
+  dst.mValue = std::move(src.mValue);
+}
+inline void assign(ValueState<void>&, ValueState<void>&) {}
+
+/* call a continuation with the value of the state it follows */
+template <typename F, typename T>
+auto invoke(F &f, ValueState<T> &s) -> decltype(f(s.mValue)) {
+  return f(s.mValue);
+}
+template <typename F>
+auto invoke(F &f, ValueState<void>&) -> decltype(f()) {
+  return f();
+}
+
+/* futures returned by continuations are unwrapped */
+template <typename R> struct Unwrap {
+  typedef R type;
+};
+template <typename U> struct Unwrap<Future<U> > {
+  typedef U type;
+};
+
+/* store the result of a continuation in the state c */
+template <typename R> struct Run {
+  template <typename F, typename T, typename V>
+  static void run(F &f, ValueState<T> &p, ValueState<V> &c) {
+    c.mValue = invoke(f, p);
+  }
+};
+template <> struct Run<void> {
+  template <typename F, typename T>
+  static void run(F &f, ValueState<T> &p, ValueState<void>&) {
+    invoke(f, p);
+  }
+};
+template <typename U> struct Run<Future<U> > {
+  template <typename F, typename T>
+  static void run(F &f, ValueState<T> &p, ValueState<U> &c) {
+    std::shared_ptr<ValueState<U> > in = invoke(f, p).state();
+    ValueState<U> *cp = &c;
+    c.addWait(in);
+    c.setAction([in, cp]() { assign(*cp, *in); });
+  }
+};
+
+/* add the states of the futures to s */
+inline void addWaits(AsyncState&) {}
+
+template <typename T, typename... Rest>
+void addWaits(AsyncState &s, const Future<T> &f, const Rest&... rest) {
+  s.addWait(f.state());
+  addWaits(s, rest...);
+}
+
+}
+
+/**
+ * Processes all outstanding futures: tests their requests and runs the
+ * continuations that have become due. Returns the number of futures still
+ * outstanding.
+ *
+ * This is a local operation.
+ */
+inline std::size_t progress() {
+  std::vector<std::shared_ptr<detail::AsyncState> > list, keep;
+  list.swap(detail::pending());
+  for (std::size_t i = 0; i < list.size(); i++)
+    if (!list[i]->poll()) keep.push_back(list[i]);
+  /* continuations may have started new futures meanwhile */
+  std::vector<std::shared_ptr<detail::AsyncState> > &p = detail::pending();
+  p.insert(p.end(), keep.begin(), keep.end());
+  return p.size();
+}
+
+/**
+ * Waits for all outstanding futures, including those started by their
+ * continuations.
+ *
+ * This is a local operation.
+ */
+inline void wait_all() {
+  while (!detail::pending().empty()) {
+    std::vector<std::shared_ptr<detail::AsyncState> > list;
+    list.swap(detail::pending());
+    for (std::size_t i = 0; i < list.size(); i++) list[i]->wait();
+  }
+}
+
+/**
+ * The eventual completion of non-blocking GA operations, with a value of
+ * type T (void for none). Futures are cheap to copy; copies share state.
+ * Buffers passed to the operation must stay valid until the future is
+ * ready. Dropping a future does not cancel or complete its operations; it
+ * completes at the next progress() or wait_all().
+ */
+template <typename T>
+class Future {
+
+ public:
+  typedef T value_type;
+
+  /** Creates a future that is ready. */
+  Future() : mState(std::make_shared<detail::ValueState<T> >()) {
+    mState->wait();
+  }
+
+  /** Creates a future for the shared state s. */
+  explicit Future(const std::shared_ptr<detail::ValueState<T> > &s)
+    : mState(s) {}
+
+  /**
+   * Creates a future for the non-blocking request h.
+   *
+   * @param[in] h handle from an NGA_Nb* call
+   */
+  explicit Future(ga_nbhdl_t h)
+    : mState(std::make_shared<detail::ValueState<T> >()) {
+    mState->addHandle(h);
+    detail::track(mState);
+  }
+
+  /** Returns true if the operations have completed, without blocking. */
+  bool ready() const { return mState->poll(); }
+
+  /** Blocks until the operations have completed. */
+  void wait() const { mState->wait(); }
+
+  /** Waits and returns the value. */
+  typename std::add_lvalue_reference<T>::type get() const {
+    mState->wait();
+    return detail::value(*mState);
+  }
+
+  /**
+   * Attaches a continuation f, called with the value of this future (or
+   * without arguments for Future<void>) after it has completed. Returns a
+   * future for the result of f; if f returns a future, the returned future
+   * completes with that one.
+   *
+   * @param[in] f callable
+   */
+  template <typename F>
+  Future<typename detail::Unwrap<typename std::decay<decltype(
+      detail::invoke(std::declval<F&>(),
+                     std::declval<detail::ValueState<T>&>()))>::type>::type>
+  then(F f) const {
+    typedef typename std::decay<decltype(
+        detail::invoke(std::declval<F&>(),
+                       std::declval<detail::ValueState<T>&>()))>::type R;
+    typedef typename detail::Unwrap<R>::type V;
+    std::shared_ptr<detail::ValueState<T> > parent = mState;
+    std::shared_ptr<detail::ValueState<V> > child =
+      std::make_shared<detail::ValueState<V> >();
+    /* the action belongs to child, so it must not hold a reference */
+    detail::ValueState<V> *c = child.get();
+    child->addWait(parent);
+    child->setAction([parent, c, f]() mutable {
+      detail::Run<R>::run(f, *parent, *c);
+    });
+    detail::track(child);
+    return Future<V>(child);
+  }
+
+  /** The shared state. */
+  const std::shared_ptr<detail::ValueState<T> >& state() const {
+    return mState;
+  }
+
+ private:
+  std::shared_ptr<detail::ValueState<T> > mState;
+};
+
+/**
+ * Returns a future that completes when all futures in fs have completed.
+ *
+ * @param[in] fs futures
+ */
+template <typename T>
+Future<void> when_all(const std::vector<Future<T> > &fs) {
+  std::shared_ptr<detail::ValueState<void> > s =
+    std::make_shared<detail::ValueState<void> >();
+  for (std::size_t i = 0; i < fs.size(); i++) s->addWait(fs[i].state());
+  detail::track(s);
+  return Future<void>(s);
+}
+
+/**
+ * Returns a future that completes when all of the given futures have
+ * completed.
+ */
+template <typename... Fs>
+Future<void> when_all(const Fs&... fs) {
+  std::shared_ptr<detail::ValueState<void> > s =
+    std::make_shared<detail::ValueState<void> >();
+  detail::addWaits(*s, fs...);
+  detail::track(s);
+  return Future<void>(s);
+}
+
+}
+
+#endif /* __cplusplus >= 201103L */
+
+#endif /* _GAFUTURE_H */
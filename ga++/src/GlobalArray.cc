@@ -146,13 +146,37 @@ GA::GlobalArray::GlobalArray(const GA::GlobalArray &g_a) {
   GA_Copy(g_a.mHandle, mHandle);
 }
 
+#if __cplusplus >= 201103L
+GA::GlobalArray::GlobalArray(GA::GlobalArray &&g_a) noexcept {
+  mHandle = g_a.mHandle;
+  g_a.mHandle = INVALID_HANDLE;
+}
+#endif
+
 GA::GlobalArray::GlobalArray() {
   mHandle = GA_Create_handle();
   if(!mHandle) GA_Error((char *)" GA creation failed",0);
 }
 
+GA::GlobalArray::GlobalArray(int handle) {
+  mHandle = handle;
+}
+
 GA::GlobalArray::~GlobalArray() {
-  GA_Destroy(mHandle); 
+  if(mHandle != INVALID_HANDLE) GA_Destroy(mHandle); 
+  mHandle = INVALID_HANDLE;
+}
+
+GA::GlobalArrayView::GlobalArrayView(const GA::GlobalArray &g_a)
+  : GA::GlobalArray(g_a.handle()) {
+}
+
+GA::GlobalArrayView::GlobalArrayView(const GA::GlobalArrayView &v)
+  : GA::GlobalArray(v.handle()) {
+}
+
+GA::GlobalArrayView::~GlobalArrayView() {
+  /* keep ~GlobalArray from destroying the viewed array */
   mHandle = INVALID_HANDLE;
 }
 
@@ -314,6 +338,15 @@ GA::GlobalArray::ddotPatch(char ta, int64_t alo[], int64_t ahi[],
   return NGA_Ddot_patch64(mHandle, ta, alo, ahi, g_a->mHandle, tb, blo, bhi);
 }
 
+#if __cplusplus >= 201103L
+GA::GlobalArray
+GA::GlobalArray::clone(char *arrayname) const {
+  GA::GlobalArray g_b(*this, arrayname ? arrayname : inquireName());
+  GA_Copy(mHandle, g_b.mHandle);
+  return g_b;
+}
+#endif
+
 void 
 GA::GlobalArray::destroy() {
   GA_Destroy(mHandle);
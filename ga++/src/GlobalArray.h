@@ -4,6 +4,7 @@
 namespace GA {
 
 class PGroup;
+class GlobalArrayView;
 
 /**
  * This is the GlobalArray class.
@@ -249,6 +250,26 @@ class GlobalArray {
    */
   GlobalArray(const GlobalArray &g_a);
 
+#if __cplusplus >= 201103L
+  /**
+   * Creates an array object that takes over the array of g_a. No array is
+   * created and no data is copied; g_a is left without an array and may
+   * only be destroyed or assigned to.
+   *
+   * This is a local operation. 
+   *
+   * @param[in] g_a array to move from
+   */
+  GlobalArray(GlobalArray &&g_a) noexcept;
+
+  /**
+   * A view does not own its array, so it cannot be moved from; without this
+   * a temporary view would bind to the move constructor and hand the viewed
+   * array to the new object. Copy the view to get a new array instead.
+   */
+  GlobalArray(GlobalArrayView &&v) = delete;
+#endif
+
   /**
    * Creates a new array with no existing attributes.
    *
@@ -2801,13 +2822,96 @@ class GlobalArray {
 			       int64_t *mlo, int64_t *mhi) const;
 
    GlobalArray& operator=(const GlobalArray &g_a);
+#if __cplusplus >= 201103L
+  /**
+   * Destroys this array and takes over the array of g_a, which is left
+   * without an array. No data is copied.
+   *
+   * This is a collective operation. 
+   *
+   * @param[in] g_a array to move from
+   */
+   GlobalArray& operator=(GlobalArray &&g_a) noexcept;
+
+  /**
+   * A view cannot be moved from, see GlobalArray(GlobalArrayView&&).
+   */
+   GlobalArray& operator=(GlobalArrayView &&v) = delete;
+
+  /**
+   * Creates a new array with the properties and the contents of this one.
+   * Unlike the copy constructor this is the only way to get a deep copy
+   * that is explicit at the call site.
+   *
+   * This is a collective operation. 
+   *
+   * @param[in] arrayname a character string, the name of this array if NULL
+   */
+   GlobalArray clone(char *arrayname=NULL) const;
+#endif
    int operator==(const GlobalArray &g_a) const;
    int operator!=(const GlobalArray &g_a) const;
+
+ protected:
+  /**
+   * Wraps an existing array handle without creating an array.
+   *
+   * @param[in] handle integer handle of an existing array
+   */
+  explicit GlobalArray(int handle);
   
- private:
   int mHandle; /**<< g_a handle */
 };
 
+/**
+ * Non-owning view of a GlobalArray. A view refers to the array it was made
+ * from and provides the full GlobalArray interface on it, but never creates
+ * or destroys an array, so views can be copied and passed by value without
+ * collective operations or data movement. The viewed array must outlive the
+ * view. Assigning to a view is not allowed.
+ */
+class GlobalArrayView : public GlobalArray {
+
+ public:
+  /**
+   * Creates a view of g_a.
+   *
+   * This is a local operation. 
+   *
+   * @param[in] g_a array to view
+   */
+  GlobalArrayView(const GlobalArray &g_a);
+
+  /**
+   * Creates another view of the array viewed by v.
+   *
+   * This is a local operation. 
+   *
+   * @param[in] v view to copy
+   */
+  GlobalArrayView(const GlobalArrayView &v);
+
+  /**
+   * Destroys the view, leaving the viewed array alone.
+   */
+  ~GlobalArrayView();
+
+#if __cplusplus >= 201103L
+  /**
+   * A view does not own its array and cannot destroy it; the owner of the
+   * array destroys it.
+   */
+  void destroy() = delete;
+#endif
+
+ private:
+#if __cplusplus < 201103L
+  void destroy();
+#endif
+  GlobalArrayView& operator=(const GlobalArrayView &v);
+  GlobalArrayView& operator=(const GlobalArray &g_a);
+};
+
 }
 
 #endif /* _GLOBALARRAY_H */
@@ -46,6 +46,9 @@
 #include "services.h"
 #include "PGroup.h"
 #include "GlobalArray.h"
+#include "GAFuture.h"
+#include "GAArray.h"
+#include "GAAlgorithm.h"
 #include "GAServices.h"
 
 #endif // _GAPP_H
@@ -12,6 +12,7 @@
 #endif
 #define FALSE 0
 #define TRUE  1
+#define INVALID_HANDLE -1000
 
 /**
  * More operator overloading stuff (a lot!!) to come.
@@ -21,7 +22,7 @@ GA::GlobalArray&
 GA::GlobalArray::operator=(const GA::GlobalArray &g_a) {
 
   if(this != &g_a) { 
-    GA_Destroy(mHandle);
+    if(mHandle != INVALID_HANDLE) GA_Destroy(mHandle);
     
     mHandle = GA_Duplicate(g_a.mHandle, g_a.inquireName());
     if(!mHandle)  GA_Error((char *)" GA creation failed",0);
@@ -31,6 +32,19 @@ GA::GlobalArray::operator=(const GA::GlobalArray &g_a) {
   return *this;
 }
 
+#if __cplusplus >= 201103L
+GA::GlobalArray&
+GA::GlobalArray::operator=(GA::GlobalArray &&g_a) noexcept {
+
+  if(this != &g_a) {
+    if(mHandle != INVALID_HANDLE) GA_Destroy(mHandle);
+    mHandle = g_a.mHandle;
+    g_a.mHandle = INVALID_HANDLE;
+  }
+  return *this;
+}
+#endif
+
 int
 GA::GlobalArray::operator==(const GA::GlobalArray &g_a) const {
 
@@ -0,0 +1,116 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* tests of the local block algorithms of GAAlgorithm.h */
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "ga++.h"
+
+#define GA_DATA_TYPE MT_C_DBL
+
+#if __cplusplus >= 201103L
+
+#define NROW 37
+#define NCOL 53
+
+static int me, nproc;
+
+static void check(bool ok, const char *dist, const char *what) {
+  if (!ok) {
+    printf("%d: %s: %s failed\n", me, dist, what);
+    GA::SERVICES.error("algorithmt: check failed", 0);
+  }
+}
+
+/* a(i,j) = i*1000 + j */
+static void init(const GA::Array<double,2> &a) {
+  if (me == 0) {
+    std::vector<double> buf(NROW*NCOL);
+    for (int i = 0; i < NROW; i++)
+      for (int j = 0; j < NCOL; j++) buf[i*NCOL+j] = i*1000.0 + j;
+    a.put({0, 0}, {NROW-1, NCOL-1}, buf.data());
+  }
+  GA::SERVICES.sync();
+}
+
+template <typename Policy>
+static void test(const Policy &p, const GA::Array<double,2> &a,
+                 const GA::Array<double,2> &b, const char *dist) {
+  double sum = 0.0, sum2 = 0.0, r;
+  for (int i = 0; i < NROW; i++)
+    for (int j = 0; j < NCOL; j++) {
+      sum += i*1000.0 + j;
+      sum2 += (i*1000.0 + j)*(i*1000.0 + j);
+    }
+
+  init(a);
+  r = GA::reduce(p, a, 1.0);
+  check(r == sum + 1.0, dist, "reduce");
+  r = GA::reduce(p, a, 0.0, GA::maximum<double>());
+  check(r == (NROW-1)*1000.0 + NCOL-1, dist, "reduce max");
+  r = GA::reduce(p, a, 1e9, [](double x, double y) { return x < y ? x : y; });
+  check(r == 0.0, dist, "reduce with generic operator");
+
+  GA::for_each_local(p, a, [](double &x) { x = 2*x; });
+  GA::SERVICES.sync();
+  check(a.get({NROW-1, 7}) == 2*((NROW-1)*1000.0 + 7), dist, "for_each_local");
+
+  GA::transform(p, a, b, [](double x) { return x/2; });
+  check(b.get({3, NCOL-1}) == 3000.0 + NCOL-1, dist, "transform");
+  GA::transform(p, a, b, b, [](double x, double y) { return x - y; });
+  r = GA::transform_reduce(p, a, b, 0.0);
+  check(std::fabs(r - 2*sum2) <= 1e-12*sum2, dist, "transform_reduce dot");
+  r = GA::transform_reduce(p, b, 0.0, std::plus<double>(),
+                           [](double x) { return x*x; });
+  check(std::fabs(r - sum2) <= 1e-12*sum2, dist, "transform_reduce");
+}
+
+static void test_all(const GA::Array<double,2> &a,
+                     const GA::Array<double,2> &b, const char *dist) {
+  if (me == 0) printf("Testing %s distribution\n", dist);
+  test(GA::seq, a, b, dist);
+  test(GA::parallel_policy(4), a, b, dist);
+}
+
+int
+main(int argc, char **argv) {
+  GA::Initialize(argc, argv, 1000000, 1000000, GA_DATA_TYPE, 0);
+  me = GA_Nodeid();
+  nproc = GA_Nnodes();
+  {
+    GA::Array<double,2> a({NROW, NCOL}, "a"), b({NROW, NCOL}, "b");
+    test_all(a, b, "regular");
+  }
+  {
+    std::array<int,2> block = {{5, 7}};
+    GA::Array<double,2> a({NROW, NCOL}, block, "a");
+    GA::Array<double,2> b({NROW, NCOL}, block, "b");
+    test_all(a, b, "block-cyclic");
+  }
+  {
+    std::array<int,2> block = {{5, 7}}, grid;
+    grid[0] = (int)std::sqrt((double)nproc);
+    while (nproc % grid[0]) grid[0]--;
+    grid[1] = nproc/grid[0];
+    GA::Array<double,2> a({NROW, NCOL}, block, "a", &grid);
+    GA::Array<double,2> b({NROW, NCOL}, block, "b", &grid);
+    test_all(a, b, "process grid");
+  }
+
+  if (me == 0) printf("\nSuccessfull\n\n");
+  GA::Terminate();
+  return 0;
+}
+
+#else
+
+int
+main(int argc, char **argv) {
+  printf("GAAlgorithm.h requires C++11, test skipped\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,105 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* tests of the typed GA::Array<T,N> layer */
+
+#include <cstdio>
+#include <vector>
+#include "ga++.h"
+
+#define GA_DATA_TYPE MT_C_DBL
+
+#if __cplusplus >= 201103L
+
+static int me;
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("%d: %s failed\n", me, what);
+    GA::SERVICES.error("arrayt: check failed", 0);
+  }
+}
+
+static void test_patches() {
+  GA::Array<double,3> a({6, 7, 8}, "a");
+  int64_t dims = a.dims()[0]*a.dims()[1]*a.dims()[2];
+
+  if (me == 0) printf("Testing GA::Array<double,3> fill/scale/get/put/acc\n");
+  check(dims == 6*7*8, "dims");
+  a.fill(2.0);
+  a.scale(1.5);
+  check(a.get({5, 6, 7}) == 3.0, "fill/scale");
+  GA::SERVICES.sync();
+
+  if (me == 0) {
+    std::vector<double> buf(2*3*4, 1.0);
+    a.acc({1, 2, 3}, {2, 4, 6}, buf.data(), 2.0);
+    a.put({0, 0, 0}, 9.0);
+  }
+  GA::SERVICES.sync();
+  check(a.get({2, 4, 6}) == 5.0, "acc");
+  check(a.get({3, 4, 6}) == 3.0, "acc bounds");
+  check(a.get({0, 0, 0}) == 9.0, "put");
+
+  std::vector<double> row(8);
+  a.get({1, 3, 0}, {1, 3, 7}, row.data());
+  check(row[2] == 3.0 && row[3] == 5.0, "patch get");
+}
+
+static void test_local() {
+  GA::Array<int,2> a({20, 30}, "b");
+  GA::Array<int,2>::block_type b;
+  long sum;
+  int64_t n;
+
+  if (me == 0) printf("Testing GA::LocalBlock views\n");
+  a.fill(1);
+  GA::SERVICES.sync();
+  b = a.access();
+  n = b.size();
+  b.forEachRow([&](int *p, int64_t len) {
+    for (int64_t i = 0; i < len; i++) p[i] += (int)b.lo()[0];
+  });
+  if (!b.empty()) check(b[b.hi()] == 1 + b.lo()[0], "forEachRow");
+  a.releaseUpdate(b);
+
+  sum = n;
+  GA::SERVICES.lgop(&sum, 1, (char *)"+");
+  check(sum == 20*30, "local block sizes");
+
+  /* a 3x4 block inside 3x6 storage */
+  int st[18] = {0};
+  int64_t ld[1] = {6};
+  GA::LocalBlock<int,2> nb(st, {10, 20}, {12, 23}, ld);
+  int rows = 0;
+  nb.forEachRow([&](int *p, int64_t len) {
+    rows++;
+    for (int64_t i = 0; i < len; i++) p[i] = 1;
+  });
+  check(!nb.contiguous() && rows == 3, "strided rows");
+  check(nb[{11, 21}] == 1 && st[7] == 1 && st[4] == 0, "strided indexing");
+}
+
+int
+main(int argc, char **argv) {
+  GA::Initialize(argc, argv, 1000000, 1000000, GA_DATA_TYPE, 0);
+  me = GA_Nodeid();
+
+  test_patches();
+  test_local();
+
+  if (me == 0) printf("\nSuccessfull\n\n");
+  GA::Terminate();
+  return 0;
+}
+
+#else
+
+int
+main(int argc, char **argv) {
+  printf("GA::Array requires C++11, test skipped\n");
+  return 0;
+}
+
+#endif
@@ -0,0 +1,153 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* tests of the futures for non-blocking operations of GAFuture.h */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+#include "ga++.h"
+
+#define GA_DATA_TYPE MT_C_DBL
+
+#if __cplusplus >= 201103L
+
+#define NELEM 4000
+#define NCHUNK 40   /* more requests than GA keeps handles for */
+
+static int me, nproc;
+
+/* comex reports some misuse on stderr without failing the call, e.g. a wait
+ * on a request that has already been released, so stderr is captured while
+ * the tests run and any error in it fails the test */
+static FILE *errlog = NULL;
+static int stderr_fd = -1;
+
+static void capture_stderr() {
+  fflush(stderr);
+  errlog = tmpfile();
+  if (!errlog) return;
+  stderr_fd = dup(fileno(stderr));
+  dup2(fileno(errlog), fileno(stderr));
+}
+
+static bool stderr_clean() {
+  char line[1024];
+  bool clean = true;
+
+  if (!errlog) return true;
+  fflush(stderr);
+  dup2(stderr_fd, fileno(stderr));
+  close(stderr_fd);
+  rewind(errlog);
+  while (fgets(line, sizeof(line), errlog)) {
+    fputs(line, stderr);
+    if (strstr(line, "Error") || strstr(line, "error")) clean = false;
+  }
+  fclose(errlog);
+  errlog = NULL;
+  return clean;
+}
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("%d: %s failed\n", me, what);
+    GA::SERVICES.error("futuret: check failed", 0);
+  }
+}
+
+static void init(const GA::Array<double,1> &a) {
+  if (me == 0) {
+    std::vector<double> buf(NELEM);
+    for (int i = 0; i < NELEM; i++) buf[i] = i;
+    a.put({0}, {NELEM-1}, buf.data());
+  }
+  GA::SERVICES.sync();
+}
+
+/* gets of many chunks, combined with when_all and continuations */
+static void test_gets(const GA::Array<double,1> &a) {
+  const int64_t len = NELEM/NCHUNK;
+  std::vector<GA::Future<double> > sums;
+  std::vector<double> raw(len);
+  double sum = 0.0;
+
+  if (me == 0) printf("Testing nbGet futures and continuations\n");
+  init(a);
+  for (int64_t c = 0; c < NCHUNK; c++) {
+    GA::Future<std::vector<double> > f = a.nbGet({c*len}, {(c+1)*len-1});
+    sums.push_back(f.then([](std::vector<double> &v) {
+      double s = 0.0;
+      for (std::size_t i = 0; i < v.size(); i++) s += v[i];
+      return s;
+    }));
+  }
+  GA::Future<void> raw_done = a.nbGet({len}, {2*len-1}, raw.data());
+  GA::Future<void> all = GA::when_all(sums);
+  GA::when_all(all, raw_done).wait();
+  check(all.ready() && raw_done.ready(), "when_all");
+  for (int c = 0; c < NCHUNK; c++) sum += sums[c].get();
+  check(sum == 0.5*NELEM*(NELEM-1), "chunk sums");
+  check(raw[0] == len && raw[len-1] == 2*len-1, "get into buffer");
+  GA::SERVICES.sync();
+}
+
+/* get, modify, put back: continuations returning futures */
+static void test_chains(const GA::Array<double,1> &a) {
+  const int64_t len = NELEM/nproc/8;  /* first half of a block */
+  int64_t base = ((me+1)%nproc)*(NELEM/nproc);
+
+  if (me == 0) printf("Testing chained futures and progress\n");
+  init(a);
+  for (int64_t c = 0; c < 4; c++) {
+    int64_t lo = base + c*len, hi = lo + len - 1;
+    a.nbGet({lo}, {hi}).then([&a, lo, hi](std::vector<double> &v) {
+      for (std::size_t i = 0; i < v.size(); i++) v[i] = -v[i];
+      return a.nbPut({lo}, {hi}, v);
+    });
+  }
+  while (GA::progress() > 0) ;
+  GA::SERVICES.sync();
+  check(a.get({base}) == -(double)base, "chained put");
+  check(a.get({base+4*len-1}) == -(double)(base+4*len-1), "chained put end");
+  check(a.get({base+4*len}) == base+4*len, "chained put bounds");
+  GA::SERVICES.sync();
+
+  double v0 = a.get({NELEM-1});
+  GA::SERVICES.sync();
+  std::vector<double> ones(NELEM, 1.0);
+  GA::Future<void> f = a.nbAcc({0}, {NELEM-1}, ones.data(), 2.0);
+  while (!f.ready()) ;
+  GA::wait_all();
+  GA::SERVICES.sync();
+  check(a.get({NELEM-1}) == v0 + 2.0*nproc, "acc");
+}
+
+int
+main(int argc, char **argv) {
+  GA::Initialize(argc, argv, 1000000, 1000000, GA_DATA_TYPE, 0);
+  me = GA_Nodeid();
+  nproc = GA_Nnodes();
+  capture_stderr();
+  {
+    GA::Array<double,1> a({NELEM}, "a");
+    test_gets(a);
+    test_chains(a);
+  }
+  check(stderr_clean(), "errors on stderr");
+  if (me == 0) printf("\nSuccessfull\n\n");
+  GA::Terminate();
+  return 0;
+}
+
+#else
+
+int
+main(int argc, char **argv) {
+  printf("GAFuture.h requires C++11, test skipped\n");
+  return 0;
+}
+
+#endif
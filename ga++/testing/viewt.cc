@@ -0,0 +1,128 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* tests of GA::GlobalArrayView, move construction and clone() of
+ * GA::GlobalArray: views share the array they were made from, never
+ * destroy it and cannot be asked to */
+
+#include <cstdio>
+#include <type_traits>
+#include <utility>
+#include "ga++.h"
+
+#define GA_DATA_TYPE MT_C_DBL
+
+#if __cplusplus >= 201103L
+
+#define N 100
+
+static int me;
+
+/* whether a.destroy() can be called on an object of type T */
+template <class T>
+static auto can_destroy(int) -> decltype(std::declval<T&>().destroy(),
+                                         std::true_type());
+template <class T>
+static std::false_type can_destroy(...);
+
+static_assert(decltype(can_destroy<GA::GlobalArray>(0))::value,
+              "GlobalArray::destroy() must be callable");
+static_assert(!decltype(can_destroy<GA::GlobalArrayView>(0))::value,
+              "GlobalArrayView::destroy() must not be callable");
+
+static void check(bool ok, const char *what) {
+  if (!ok) {
+    printf("%d: %s failed\n", me, what);
+    GA::SERVICES.error("viewt: check failed", 0);
+  }
+}
+
+static double element(const GA::GlobalArray &a, int i) {
+  int lo[1] = {i}, hi[1] = {i}, ld[1] = {1};
+  double x;
+
+  a.get(lo, hi, &x, ld);
+  return x;
+}
+
+/* views are passed by value, so every call makes and drops a view */
+static void scale(GA::GlobalArrayView v, double s) {
+  v.scale(&s);
+}
+
+static void test_views() {
+  int dims[1] = {N};
+  double one = 1.0;
+  GA::GlobalArray a(C_DBL, 1, dims, (char *)"a", NULL);
+
+  if (me == 0) printf("Testing GA::GlobalArrayView\n");
+  a.fill(&one);
+  {
+    GA::GlobalArrayView v(a);
+    GA::GlobalArrayView w(v);
+
+    check(v.handle() == a.handle() && w.handle() == a.handle(), "same handle");
+    scale(v, 2.0);
+    scale(w, 3.0);
+    GA::SERVICES.sync();
+    check(element(a, N-1) == 6.0, "update through views");
+  }
+  /* the views are gone, the array is not */
+  check(GA_Valid_handle(a.handle()), "array outlives its views");
+  check(element(a, 0) == 6.0, "contents after views");
+
+  /* a copy of a view is a new array */
+  {
+    GA::GlobalArrayView v(a);
+    GA::GlobalArray c(v);
+    double two = 2.0;
+
+    check(c.handle() != a.handle(), "copy of a view");
+    c.fill(&two);
+    GA::SERVICES.sync();
+    check(element(a, 0) == 6.0 && element(c, 0) == 2.0, "copy is separate");
+  }
+  check(GA_Valid_handle(a.handle()), "array after copy of a view");
+  GA::SERVICES.sync();
+}
+
+static void test_move() {
+  int dims[1] = {N};
+  double three = 3.0;
+  GA::GlobalArray a(C_DBL, 1, dims, (char *)"a", NULL);
+  int handle = a.handle();
+
+  if (me == 0) printf("Testing move and clone of GA::GlobalArray\n");
+  a.fill(&three);
+  GA::GlobalArray b(std::move(a));
+  check(b.handle() == handle, "move keeps the array");
+  check(GA_Valid_handle(b.handle()), "moved array");
+  GA::GlobalArray c = b.clone((char *)"c");
+  check(c.handle() != b.handle(), "clone is a new array");
+  GA::SERVICES.sync();
+  check(element(c, N/2) == 3.0, "clone contents");
+  b.destroy();
+  GA::SERVICES.sync();
+}
+
+int
+main(int argc, char **argv) {
+  GA::Initialize(argc, argv, 1000000, 1000000, GA_DATA_TYPE, 0);
+  me = GA_Nodeid();
+  test_views();
+  test_move();
+  if (me == 0) printf("\nSuccessfull\n\n");
+  GA::Terminate();
+  return 0;
+}
+
+#else
+
+int
+main(int argc, char **argv) {
+  printf("GlobalArrayView tests require C++11, test skipped\n");
+  return 0;
+}
+
+#endif
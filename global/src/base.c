@@ -363,6 +363,7 @@ int bytes;
        GA[i].rstrctd_list = (C_Integer*)0;
        GA[i].rank_rstrctd = (C_Integer*)0;
        GA[i].property = NO_PROPERTY;
+       GA[i].ooc = NULL;
 #ifdef ENABLE_CHECKPOINT
        GA[i].record_id = 0;
 #endif
@@ -451,6 +452,9 @@ int bytes;
     /* set MA error function */
     MA_set_error_callback(ARMCI_Error);
 
+    /* threads other than this one allocate from their own arenas */
+    ga_malloc_init();
+
     GAinitialized = 1;
 
 #ifdef PROFILE_OLD 
@@ -1127,6 +1131,9 @@ logical pnga_pgroup_destroy(Integer grp_id)
 
   _ga_sync_begin = 1; _ga_sync_end=1; /*remove any previous sync masking*/
 
+  /* free memory kept for arrays on this group */
+  gai_pool_flush((int)grp_id);
+
 #ifdef MSG_COMMS_MPI
        ARMCI_Group_free(&PGRP_LIST[grp_id].group);
 #endif
@@ -1350,6 +1357,8 @@ Integer pnga_create_handle()
   GA[ga_handle].actv_handle = 1;
   GA[ga_handle].has_data = 1;
   GA[ga_handle].property = NO_PROPERTY;
+  GA[ga_handle].ooc = NULL;
+  GA[ga_handle].mem_hints = gai_default_mem_hints();
   return g_a;
 }
 
@@ -2008,6 +2017,13 @@ void pnga_set_property(Integer g_a, char* property) {
 #endif
     }
     pnga_destroy(g_tmp);
+  } else if (strcmp(property,"out_of_core")==0) {
+    /* data is kept in a file and paged in by ga_ooc.c, so the property must
+     * be set before memory is allocated */
+    if (GA[ga_handle].actv) {
+      pnga_error("Property out_of_core must be set before allocation",0);
+    }
+    GA[ga_handle].property = OUT_OF_CORE;
   } else {
     pnga_error("Trying to set unknown property",0);
   }
@@ -2161,6 +2177,11 @@ void pnga_unset_property(Integer g_a) {
 #endif
     }
     pnga_destroy(g_tmp);
+  } else if (GA[ga_handle].property == OUT_OF_CORE) {
+    if (GA[ga_handle].actv) {
+      pnga_error("Cannot unset out_of_core on an allocated array",0);
+    }
+    GA[ga_handle].property = NO_PROPERTY;
   } else {
     GA[ga_handle].property = NO_PROPERTY;
   }
@@ -2402,6 +2423,8 @@ logical pnga_allocate(Integer g_a)
   } else {
     mem_size = block_size * GA[ga_handle].elemsize;
   }
+  /* out-of-core arrays keep their data in a file, see ga_ooc.c */
+  if (GA[ga_handle].property == OUT_OF_CORE) mem_size = 0;
   GA[ga_handle].id = INVALID_MA_HANDLE;
   GA[ga_handle].size = (C_Long)mem_size;
   /* if requested, enforce limits on memory consumption */
@@ -2419,8 +2442,12 @@ logical pnga_allocate(Integer g_a)
   }else status = 1;
 
   if (status) {
-    status = !gai_getmem(GA[ga_handle].name, GA[ga_handle].ptr,mem_size,
+    status = gai_pool_get(GA[ga_handle].ptr, mem_size, GA[ga_handle].type,
+                          &GA[ga_handle].id, p_handle)
+          || !gai_getmem(GA[ga_handle].name, GA[ga_handle].ptr,mem_size,
                              GA[ga_handle].type, &GA[ga_handle].id, p_handle);
+    if (status) gai_apply_mem_hints(GA[ga_handle].ptr[grp_me], mem_size,
+                                    GA[ga_handle].mem_hints);
   } else {
      GA[ga_handle].ptr[grp_me]=NULL;
   }
@@ -2435,6 +2462,8 @@ logical pnga_allocate(Integer g_a)
     /* ngai_get_first_last_indices(&g_a); */
   }
 
+  if (status && GA[ga_handle].property == OUT_OF_CORE) gai_ooc_create(g_a);
+
   pnga_pgroup_sync(p_handle);
   if (status) {
     GAstat.curmem += (long)GA[ga_handle].size;
@@ -2997,6 +3026,7 @@ logical pnga_duplicate(Integer g_a, Integer *g_b, char* array_name)
   GA[ga_handle] = GA[GA_OFFSET + g_a]; /* <--- shallow copy */
   strcpy(GA[ga_handle].name, array_name);
   GA[ga_handle].ptr = save_ptr;
+  GA[ga_handle].ooc = NULL;
   if (maplen > 0) {
     GA[ga_handle].mapc = (C_Integer*)malloc((maplen+1)*sizeof(C_Integer*));
     for(i=0;i<maplen; i++)GA[ga_handle].mapc[i] = GA[GA_OFFSET+ g_a].mapc[i];
@@ -3038,14 +3068,20 @@ logical pnga_duplicate(Integer g_a, Integer *g_b, char* array_name)
 
   if(status)
   {
-    status = !gai_getmem(array_name, GA[ga_handle].ptr,mem_size,
+    status = gai_pool_get(GA[ga_handle].ptr, mem_size,
+        (int)GA[ga_handle].type, &GA[ga_handle].id, (int)grp_id)
+      || !gai_getmem(array_name, GA[ga_handle].ptr,mem_size,
         (int)GA[ga_handle].type, &GA[ga_handle].id,
         (int)grp_id);
+    if (status) gai_apply_mem_hints(GA[ga_handle].ptr[grp_me], mem_size,
+                                    GA[ga_handle].mem_hints);
 }
   else{
     GA[ga_handle].ptr[grp_me]=NULL;
   }
 
+  if(status && GA[ga_handle].property == OUT_OF_CORE) gai_ooc_create(*g_b);
+
   if(local_sync_end)pnga_pgroup_sync(grp_id);
 
 #     ifdef GA_CREATE_INDEF
@@ -3207,6 +3243,18 @@ int local_sync_begin,local_sync_end;
       pnga_pgroup_destroy(GA[ga_handle].p_handle);
     }
 
+    if (GA[ga_handle].property == OUT_OF_CORE) gai_ooc_destroy(g_a);
+
+    /* keep the memory for reuse by a new array, see ga_pool.c */
+    if (GA[ga_handle].property == NO_PROPERTY
+        && gai_pool_put(GA[ga_handle].ptr, GA[ga_handle].size,
+                        GA[ga_handle].type, GA[ga_handle].id, (int)grp_id)) {
+      if(GA_memory_limited) GA_total_memory += GA[ga_handle].size;
+      GAstat.curmem -= GA[ga_handle].size;
+      if(local_sync_end)pnga_pgroup_sync(grp_id);
+      return(TRUE);
+    }
+
     if(GA[ga_handle].ptr[grp_me]==NULL){
        return TRUE;
     } 
@@ -3262,12 +3310,14 @@ Integer i, handle;
 #ifdef PROFILE_OLD 
     ga_profile_terminate();
 #endif
+    pnga_checkpoint_wait();
     for (i=0;i<_max_global_array;i++){
           handle = i - GA_OFFSET ;
           if(GA[i].actv) pnga_destroy(handle);
           if(GA[i].ptr) free(GA[i].ptr);
           if(GA[i].mapc) free(GA[i].mapc);
     }
+    gai_pool_finalize();
     /* don't free groups list until all arrays destroyed */
     for (i=0;i<_max_global_array;i++){
           if(PGRP_LIST[i].actv) free(PGRP_LIST[i].map_proc_list);
@@ -3437,7 +3487,9 @@ void pnga_fill(Integer g_a, void* val)
   elems = GA[handle].size/((C_Long)GA[handle].elemsize);
   num_blocks = GA[handle].block_total;
 
-  if (num_blocks < 0) {
+  if (GA[handle].property == OUT_OF_CORE) {
+    gai_ooc_fill(g_a, val);
+  } else if (num_blocks < 0) {
     /* Bruce..Please CHECK if this is correct */
     if (grp_id >= 0){  
       Integer grp_me = PGRP_LIST[GA[handle].p_handle].map_proc_list[GAme];
@@ -4097,6 +4149,8 @@ int m,p;
    m = num_mutexes%chunk_mutex;
 
    ARMCI_Lock(m,p);
+   /* do not read out-of-core data cached before the lock was taken */
+   gai_ooc_sync();
 }
 
 /**
@@ -4116,6 +4170,8 @@ int m,p;
    p = num_mutexes/chunk_mutex -1;
    m = num_mutexes%chunk_mutex;
 
+   /* write back out-of-core data put while the lock was held */
+   gai_ooc_sync();
    ARMCI_Unlock(m,p);
 }              
    
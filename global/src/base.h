@@ -81,15 +81,23 @@ typedef struct {
        int old_handle;              /* original group handle                */
        int old_lo[MAXDIM];          /* original lo array                    */
        int old_chunk[MAXDIM];       /* original chunk array                 */
+       void *ooc;                   /* page cache of out-of-core array      */
+       int mem_hints;               /* GA_MEMHINT_ flags for local memory   */
 #ifdef ENABLE_CHECKPOINT
        int record_id;               /* record id for writing ga to disk     */
 #endif
 } global_array_t;
 
 enum property_type { NO_PROPERTY,
-                     READ_ONLY
+                     READ_ONLY,
+                     OUT_OF_CORE
 };
 
+/* memory hints for the local block of an array, see ga_memhint.c */
+#define GA_MEMHINT_HUGEPAGES 1
+#define GA_MEMHINT_BIND      2
+#define GA_MEMHINT_TOUCH     4
+
 extern global_array_t *_ga_main_data_structure; 
 extern proc_list_t *_proc_list_main_data_structure; 
 /*\
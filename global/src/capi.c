@@ -742,6 +742,20 @@ void NGA_Set_property(int g_a, char* property)
     wnga_set_property(aa,property);
 }
 
+void GA_Set_memory_hints(int g_a, char* hints)
+{
+    Integer aa;
+    aa = (Integer)g_a;
+    wnga_set_memory_hints(aa,hints);
+}
+
+void NGA_Set_memory_hints(int g_a, char* hints)
+{
+    Integer aa;
+    aa = (Integer)g_a;
+    wnga_set_memory_hints(aa,hints);
+}
+
 void GA_Unset_property(int g_a)
 {
     Integer aa;
@@ -1932,6 +1946,26 @@ void NGA_Periodic_put64(int g_a, int64_t lo[], int64_t hi[], void* buf, int64_t
     wnga_periodic(a, _ga_lo, _ga_hi, buf, _ga_work, NULL, PERIODIC_PUT);
 }
 
+void NGA_Prefetch(int g_a, int lo[], int hi[])
+{
+    Integer a=(Integer)g_a;
+    Integer ndim = wnga_ndim(a);
+    Integer _ga_lo[MAXDIM], _ga_hi[MAXDIM];
+    COPYINDEX_C2F(lo,_ga_lo, ndim);
+    COPYINDEX_C2F(hi,_ga_hi, ndim);
+    wnga_prefetch(a, _ga_lo, _ga_hi);
+}
+
+void NGA_Prefetch64(int g_a, int64_t lo[], int64_t hi[])
+{
+    Integer a=(Integer)g_a;
+    Integer ndim = wnga_ndim(a);
+    Integer _ga_lo[MAXDIM], _ga_hi[MAXDIM];
+    COPYINDEX_C2F(lo,_ga_lo, ndim);
+    COPYINDEX_C2F(hi,_ga_hi, ndim);
+    wnga_prefetch(a, _ga_lo, _ga_hi);
+}
+
 void NGA_Periodic_acc(int g_a, int lo[], int hi[], void* buf,int ld[], void* alpha)
 {
     Integer a=(Integer)g_a;
@@ -4811,6 +4845,29 @@ int NGA_Get_debug()
     return (int)wnga_get_debug();
 }
 
+void GA_Checkpoint_arrays(int g_a[], int n, char *path)
+{
+    Integer i, *gas = (Integer*)malloc(n*sizeof(Integer));
+    if (!gas) GA_Error("GA_Checkpoint_arrays: malloc failed", n);
+    for (i=0; i<n; i++) gas[i] = (Integer)g_a[i];
+    wnga_checkpoint(gas, (Integer)n, path);
+    free(gas);
+}
+
+void GA_Checkpoint_wait()
+{
+    wnga_checkpoint_wait();
+}
+
+void GA_Restart_arrays(int g_a[], int n, char *path)
+{
+    Integer i, *gas = (Integer*)malloc(n*sizeof(Integer));
+    if (!gas) GA_Error("GA_Restart_arrays: malloc failed", n);
+    for (i=0; i<n; i++) gas[i] = (Integer)g_a[i];
+    wnga_restart(gas, (Integer)n, path);
+    free(gas);
+}
+
 #ifdef ENABLE_CHECKPOINT
 void GA_Checkpoint(int* gas, int num)
 {
@@ -109,6 +109,10 @@ void pnga_pgroup_brdcst(Integer grp_id, Integer type, void *buf,
 
 
 #ifdef MSG_COMMS_MPI
+#   if !HAVE_ARMCI_GROUP_COMM_MEMBER
+/* undocumented ARMCI call, undeclared it would truncate the returned handle */
+extern MPI_Comm armci_group_comm(ARMCI_Group *group);
+#   endif
 MPI_Comm GA_MPI_Comm()
 {
     return GA_MPI_Comm_pgroup(-1);
@@ -367,6 +367,20 @@ extern Integer pnga_spd_invert(Integer g_a);
 extern void pnga_copy_patch_dp(char *t_a, Integer g_a, Integer ailo, Integer aihi, Integer ajlo, Integer ajhi, Integer g_b, Integer bilo, Integer bihi, Integer bjlo, Integer bjhi);
 extern DoublePrecision pnga_ddot_patch_dp(Integer g_a, char *t_a, Integer ailo, Integer aihi, Integer ajlo, Integer ajhi, Integer g_b, char *t_b, Integer bilo, Integer bihi, Integer bjlo, Integer bjhi);
 
+/* Routines from ga_checkpoint.c */
+
+extern void pnga_checkpoint(Integer *g_a, Integer n, char *path);
+extern void pnga_checkpoint_wait();
+extern void pnga_restart(Integer *g_a, Integer n, char *path);
+
+/* Routines from ga_memhint.c */
+
+extern void pnga_set_memory_hints(Integer g_a, char *hints);
+
+/* Routines from ga_ooc.c */
+
+extern void pnga_prefetch(Integer g_a, Integer *lo, Integer *hi);
+
 /* Routines from ga_trace.c */
 
 extern double pnga_timer();
@@ -28,6 +28,8 @@ extern SingleComplex GA_Cdot(int g_a, int g_b);
 extern void          GA_Cgop(SingleComplex x[], int n, char *op);
 extern void          GA_Cgemm(char ta, char tb, int m, int n, int k, SingleComplex alpha, int g_a, int g_b, SingleComplex beta, int g_c );
 extern void          GA_Check_handle(int g_a, char *string);
+extern void          GA_Checkpoint_arrays(int g_a[], int n, char *path);
+extern void          GA_Checkpoint_wait(void);
 extern int           GA_Cluster_nnodes(void);
 extern int           GA_Cluster_nodeid(void);
 extern int           GA_Cluster_nprocs(int x);
@@ -133,6 +135,7 @@ extern void          GA_Randomize(int g_a, void *value);
 extern void          GA_Recip(int g_a);
 extern void          GA_Recip_patch(int g_a,int *lo, int *hi);
 extern void          GA_Register_stack_memory(void * (*ext_alloc)(size_t, int, char *), void (*ext_free)(void *));
+extern void          GA_Restart_arrays(int g_a[], int n, char *path);
 extern void          GA_Scale_cols(int g_a, int g_v);
 extern void          GA_Scale(int g_a, void *value); 
 extern void          GA_Scale_rows(int g_a, int g_v);
@@ -150,6 +153,7 @@ extern void          GA_Set_ghost_corner_flag(int g_a, int flag);
 extern void          GA_Set_ghosts(int g_a, int width[]);
 extern void          GA_Set_irreg_distr(int g_a, int map[], int block[]);
 extern void          GA_Set_irreg_flag(int g_a, int flag);
+extern void          GA_Set_memory_hints(int g_a, char *hints);
 extern void          GA_Set_memory_limit(size_t limit);
 extern void          GA_Set_pgroup(int g_a, int p_handle);
 extern void          GA_Set_restricted(int g_a, int list[], int size);
@@ -284,6 +288,7 @@ extern void          NGA_Pgroup_set_default(int p_handle);
 extern int           NGA_Pgroup_split(int grp_id, int num_group);
 extern int           NGA_Pgroup_split_irreg(int grp_id, int color);
 extern void          NGA_Pgroup_sync(int grp_id);
+extern void          NGA_Prefetch(int g_a, int lo[], int hi[]);
 extern void          NGA_Print_patch(int g_a, int lo[], int hi[], int pretty);
 extern void          NGA_Proc_topology(int g_a, int proc, int coord[]);
 extern void          NGA_Put(int g_a, int lo[], int hi[], void* buf, int ld[]); 
@@ -319,6 +324,7 @@ extern void          NGA_Set_debug(int flag);
 extern void          NGA_Set_ghosts(int g_a, int width[]);
 extern void          NGA_Set_irreg_distr(int g_a, int map[], int block[]);
 extern void          NGA_Set_irreg_flag(int g_a, int flag);
+extern void          NGA_Set_memory_hints(int g_a, char *hints);
 extern void          NGA_Set_memory_limit(size_t limit);
 extern void          NGA_Set_pgroup(int g_a, int p_handle);
 extern void          NGA_Set_restricted(int g_a, int list[], int size);
@@ -416,6 +422,7 @@ extern void          NGA_NbPut64(int g_a, int64_t lo[], int64_t hi[], void* buf,
 extern void          NGA_Periodic_acc64(int g_a, int64_t lo[], int64_t hi[],void* buf,int64_t ld[],void* alpha);
 extern void          NGA_Periodic_get64(int g_a, int64_t lo[], int64_t hi[], void* buf, int64_t ld[]); 
 extern void          NGA_Periodic_put64(int g_a, int64_t lo[], int64_t hi[], void* buf, int64_t ld[]); 
+extern void          NGA_Prefetch64(int g_a, int64_t lo[], int64_t hi[]);
 extern void          NGA_Print_patch64(int g_a, int64_t lo[], int64_t hi[], int pretty);
 extern void          NGA_Put64(int g_a, int64_t lo[], int64_t hi[], void* buf, int64_t ld[]); 
 extern long          NGA_Read_inc64(int g_a, int64_t subscript[], long inc);
@@ -0,0 +1,430 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* checkpoint/restart of global arrays directly to local files
+ *
+ * pnga_checkpoint copies the local memory of a list of arrays into a staging
+ * buffer and returns; a background thread then drains the buffer to one file
+ * per process, <path>.<me>. The local memory of every array is divided into
+ * pages of GA_CKPT_PAGE bytes and a hash of each page is kept between
+ * checkpoints, so that checkpointing the same arrays to the same path again
+ * only stages and writes the pages that changed since the last one.
+ *
+ * File layout: header, array entries, page aligned array images. Pages are
+ * overwritten in place, so the magic number of the header is cleared and
+ * synced to disk before any page is written, and the header is rewritten
+ * only after all pages of the checkpoint have reached the disk. A file left
+ * behind by a crash in between is rejected by pnga_restart.
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDDEF_H
+#   include <stddef.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#   include <unistd.h>
+#endif
+#include <fcntl.h>
+#include <pthread.h>
+
+#include "globalp.h"
+#include "base.h"
+#include "ga-papi.h"
+#include "ga-wapi.h"
+
+#define GA_CKPT_MAGIC 0x4741434bL    /**< marks a complete checkpoint file */
+#define GA_CKPT_PAGE  (64*1024)      /**< granularity of dirty detection */
+#define GA_CKPT_NAME  1024           /**< max length of checkpoint file name */
+
+typedef struct {
+    long magic;
+    long epoch;             /**< number of checkpoints written to the file */
+    long narr;
+} ckpt_header_t;
+
+typedef struct {
+    long type;
+    long ndim;
+    long dims[MAXDIM];
+    long bytes;             /**< size of the local memory of the array */
+    long offset;            /**< file offset of the image of the array */
+} ckpt_entry_t;
+
+typedef struct {            /**< staged data of one contiguous file range */
+    char *src;              /**< local memory of the array */
+    long offset;
+    long bytes;
+    long stage;             /**< offset in the staging buffer */
+} ckpt_extent_t;
+
+static struct {
+    char  fname[GA_CKPT_NAME];
+    long  narr;
+    Integer *handles;
+    ckpt_entry_t *entry;
+    unsigned long **hash;   /**< page hashes of the last checkpoint */
+    long  epoch;
+    char  *header;
+    long  header_len;
+    char  *stage;
+    long  stage_size;
+    ckpt_extent_t *ext;
+    long  next;
+    long  maxext;
+    int   full;             /**< rewrite the whole file */
+    pthread_t thread;
+    int   active;           /**< drain thread is running */
+    int   status;           /**< 0 if the last drain succeeded */
+} ckpt;
+
+
+/* local memory of array g_a on this process */
+static void gai_ckpt_local(Integer g_a, char **ptr, long *bytes)
+{
+    Integer handle = GA_OFFSET + g_a;
+    Integer p = pnga_pgroup_nodeid((Integer)GA[handle].p_handle);
+
+    *ptr = NULL;
+    *bytes = 0;
+    if (p < 0) return;
+    *ptr = GA[handle].ptr[p];
+    *bytes = (long)GA[handle].size;
+}
+
+
+static unsigned long gai_ckpt_hash(char *buf, long bytes)
+{
+    unsigned long h = 14695981039346656037UL, w;
+    long i;
+
+    for (i=0; i+(long)sizeof(w)<=bytes; i+=sizeof(w)) {
+        memcpy(&w, buf+i, sizeof(w));
+        h = (h ^ w) * 1099511628211UL;
+    }
+    for (; i<bytes; i++) h = (h ^ (unsigned char)buf[i]) * 1099511628211UL;
+    return h;
+}
+
+
+static void gai_ckpt_reset()
+{
+    long i;
+
+    for (i=0; i<ckpt.narr; i++) free(ckpt.hash[i]);
+    free(ckpt.hash);
+    free(ckpt.handles);
+    free(ckpt.entry);
+    free(ckpt.header);
+    ckpt.hash = NULL;
+    ckpt.handles = NULL;
+    ckpt.entry = NULL;
+    ckpt.header = NULL;
+    ckpt.narr = 0;
+    ckpt.fname[0] = '\0';
+}
+
+
+/* set up the file layout for arrays g_a[0:n-1] checkpointed to fname */
+static void gai_ckpt_layout(Integer *g_a, Integer n, char *fname)
+{
+    Integer type, ndim, dims[MAXDIM];
+    ckpt_header_t hdr;
+    long i, j, offset, npages;
+    char *ptr;
+
+    gai_ckpt_reset();
+    strcpy(ckpt.fname, fname);
+    ckpt.narr = n;
+    ckpt.handles = (Integer*)malloc(n*sizeof(Integer));
+    ckpt.entry = (ckpt_entry_t*)malloc(n*sizeof(ckpt_entry_t));
+    ckpt.hash = (unsigned long**)calloc(n, sizeof(unsigned long*));
+    ckpt.header_len = sizeof(ckpt_header_t) + n*sizeof(ckpt_entry_t);
+    ckpt.header = (char*)malloc(ckpt.header_len);
+    if (!ckpt.handles || !ckpt.entry || !ckpt.hash || !ckpt.header)
+        pnga_error("ga_checkpoint: malloc failed", n);
+
+    offset = ((ckpt.header_len + GA_CKPT_PAGE-1)/GA_CKPT_PAGE)*GA_CKPT_PAGE;
+    for (i=0; i<n; i++) {
+        ckpt.handles[i] = g_a[i];
+        pnga_inquire(g_a[i], &type, &ndim, dims);
+        ckpt.entry[i].type = (long)type;
+        ckpt.entry[i].ndim = (long)ndim;
+        for (j=0; j<MAXDIM; j++) ckpt.entry[i].dims[j] = j<ndim ? dims[j] : 0;
+        gai_ckpt_local(g_a[i], &ptr, &ckpt.entry[i].bytes);
+        ckpt.entry[i].offset = offset;
+        npages = (ckpt.entry[i].bytes + GA_CKPT_PAGE-1)/GA_CKPT_PAGE;
+        ckpt.hash[i] = (unsigned long*)malloc((npages+1)*sizeof(unsigned long));
+        if (!ckpt.hash[i]) pnga_error("ga_checkpoint: malloc failed", npages);
+        offset += npages*GA_CKPT_PAGE;
+    }
+
+    hdr.magic = GA_CKPT_MAGIC;
+    hdr.epoch = 0;
+    hdr.narr = n;
+    memcpy(ckpt.header, &hdr, sizeof(hdr));
+    memcpy(ckpt.header+sizeof(hdr), ckpt.entry, n*sizeof(ckpt_entry_t));
+    ckpt.epoch = 0;
+    ckpt.full = 1;
+}
+
+
+/* append page src, stored at [offset, offset+bytes) of the file, to the
+ * staged list */
+static void gai_ckpt_add_extent(char *src, long offset, long bytes, long stage)
+{
+    ckpt_extent_t *e;
+
+    if (ckpt.next > 0) {
+        e = ckpt.ext + ckpt.next-1;
+        if (e->src+e->bytes == src && e->offset+e->bytes == offset &&
+                e->stage+e->bytes == stage) {
+            e->bytes += bytes;
+            return;
+        }
+    }
+    if (ckpt.next == ckpt.maxext) {
+        ckpt.maxext = ckpt.maxext ? 2*ckpt.maxext : 64;
+        ckpt.ext = (ckpt_extent_t*)realloc(ckpt.ext,
+                ckpt.maxext*sizeof(ckpt_extent_t));
+        if (!ckpt.ext) pnga_error("ga_checkpoint: malloc failed", ckpt.maxext);
+    }
+    e = ckpt.ext + ckpt.next++;
+    e->src = src;
+    e->offset = offset;
+    e->bytes = bytes;
+    e->stage = stage;
+}
+
+
+static int gai_ckpt_pwrite(int fd, char *buf, long bytes, long offset)
+{
+    ssize_t rc;
+
+    while (bytes > 0) {
+        rc = pwrite(fd, buf, (size_t)bytes, (off_t)offset);
+        if (rc <= 0) return 1;
+        buf += rc;
+        bytes -= rc;
+        offset += rc;
+    }
+    return 0;
+}
+
+
+static int gai_ckpt_pread(int fd, char *buf, long bytes, long offset)
+{
+    ssize_t rc;
+
+    while (bytes > 0) {
+        rc = pread(fd, buf, (size_t)bytes, (off_t)offset);
+        if (rc <= 0) return 1;
+        buf += rc;
+        bytes -= rc;
+        offset += rc;
+    }
+    return 0;
+}
+
+
+/* body of the drain thread, invalidates the file, writes the staged extents
+ * and then the header; arg is nonzero if the file has to be rewritten from
+ * scratch */
+static void* gai_ckpt_drain(void *arg)
+{
+    int fd, rc = 0;
+    long i, magic = 0;
+
+    fd = open(ckpt.fname, O_WRONLY|O_CREAT|(arg ? O_TRUNC : 0), 0644);
+    if (fd < 0) {
+        ckpt.status = 1;
+        return NULL;
+    }
+    /* after O_TRUNC this also makes the truncation durable */
+    rc = gai_ckpt_pwrite(fd, (char*)&magic, sizeof(magic),
+            offsetof(ckpt_header_t, magic));
+    if (!rc) rc = fsync(fd) != 0;
+    for (i=0; i<ckpt.next && !rc; i++)
+        rc = gai_ckpt_pwrite(fd, ckpt.stage+ckpt.ext[i].stage,
+                ckpt.ext[i].bytes, ckpt.ext[i].offset);
+    if (!rc) rc = fsync(fd) != 0;
+    if (!rc) rc = gai_ckpt_pwrite(fd, ckpt.header, ckpt.header_len, 0);
+    if (!rc) rc = fsync(fd) != 0;
+    if (close(fd)) rc = 1;
+    ckpt.status = rc;
+    return NULL;
+}
+
+
+/**
+ *  Wait until the last checkpoint of this process has been written to disk
+ */
+#if HAVE_SYS_WEAK_ALIAS_PRAGMA
+#   pragma weak wnga_checkpoint_wait =  pnga_checkpoint_wait
+#endif
+
+void pnga_checkpoint_wait()
+{
+    if (!ckpt.active) return;
+    pthread_join(ckpt.thread, NULL);
+    ckpt.active = 0;
+    if (ckpt.status) {
+        /* the file no longer matches the page hashes */
+        gai_ckpt_reset();
+        ckpt.status = 0;
+        pnga_error("ga_checkpoint: writing checkpoint file failed", 0);
+    }
+}
+
+
+/**
+ *  Checkpoint arrays g_a[0:n-1] to the files <path>.<proc>. Collective on the
+ *  world group. Returns as soon as the local data has been copied to the
+ *  staging buffer, the file is written in the background; use
+ *  pnga_checkpoint_wait to wait for it. Repeated checkpoints of the same
+ *  arrays to the same path only write the pages that were modified.
+ */
+#if HAVE_SYS_WEAK_ALIAS_PRAGMA
+#   pragma weak wnga_checkpoint =  pnga_checkpoint
+#endif
+
+void pnga_checkpoint(Integer *g_a, Integer n, char *path)
+{
+    char fname[GA_CKPT_NAME], *ptr;
+    long i, j, npages, bytes, len, staged;
+    unsigned long h;
+    int same;
+
+    if (n <= 0) pnga_error("ga_checkpoint: invalid number of arrays", n);
+    if (strlen(path) + 16 > GA_CKPT_NAME)
+        pnga_error("ga_checkpoint: path too long", GA_CKPT_NAME);
+    for (i=0; i<n; i++) pnga_check_handle(g_a[i], "ga_checkpoint");
+    sprintf(fname, "%s.%ld", path, (long)pnga_nodeid());
+
+    /* one checkpoint in flight, the staging buffer is still being drained */
+    pnga_checkpoint_wait();
+    pnga_sync();
+
+    same = ckpt.narr == n && strcmp(ckpt.fname, fname) == 0;
+    for (i=0; same && i<n; i++) {
+        same = ckpt.handles[i] == g_a[i];
+        gai_ckpt_local(g_a[i], &ptr, &bytes);
+        if (bytes != ckpt.entry[i].bytes) same = 0;
+    }
+    if (!same) gai_ckpt_layout(g_a, n, fname);
+
+    /* find the modified pages and the size of the staging buffer */
+    ckpt.next = 0;
+    staged = 0;
+    for (i=0; i<n; i++) {
+        gai_ckpt_local(g_a[i], &ptr, &bytes);
+        npages = (bytes + GA_CKPT_PAGE-1)/GA_CKPT_PAGE;
+        for (j=0; j<npages; j++) {
+            len = GA_MIN(GA_CKPT_PAGE, bytes - j*GA_CKPT_PAGE);
+            h = gai_ckpt_hash(ptr + j*GA_CKPT_PAGE, len);
+            if (!ckpt.full && h == ckpt.hash[i][j]) continue;
+            ckpt.hash[i][j] = h;
+            gai_ckpt_add_extent(ptr + j*GA_CKPT_PAGE,
+                    ckpt.entry[i].offset + j*GA_CKPT_PAGE, len, staged);
+            staged += len;
+        }
+    }
+
+    if (staged > ckpt.stage_size) {
+        free(ckpt.stage);
+        ckpt.stage = (char*)malloc(staged);
+        if (!ckpt.stage) pnga_error("ga_checkpoint: staging malloc failed",
+                (Integer)staged);
+        ckpt.stage_size = staged;
+    }
+
+    /* copy the modified pages */
+    for (j=0; j<ckpt.next; j++)
+        memcpy(ckpt.stage + ckpt.ext[j].stage, ckpt.ext[j].src,
+                ckpt.ext[j].bytes);
+
+    ckpt.epoch++;
+    memcpy(ckpt.header + offsetof(ckpt_header_t, epoch), &ckpt.epoch,
+            sizeof(long));
+
+    /* nobody may modify the arrays before all copies are complete */
+    pnga_sync();
+
+    ckpt.status = 0;
+    if (pthread_create(&ckpt.thread, NULL, gai_ckpt_drain,
+                (void*)(long)ckpt.full)) {
+        gai_ckpt_drain((void*)(long)ckpt.full);
+        ckpt.active = 0;
+        if (ckpt.status) {
+            gai_ckpt_reset();
+            ckpt.status = 0;
+            pnga_error("ga_checkpoint: writing checkpoint file failed", 0);
+        }
+    } else {
+        ckpt.active = 1;
+    }
+    ckpt.full = 0;
+}
+
+
+/**
+ *  Restore arrays g_a[0:n-1] from the files written by pnga_checkpoint to
+ *  path. The arrays must have the same types, shapes and distributions as
+ *  the checkpointed ones. Collective on the world group.
+ */
+#if HAVE_SYS_WEAK_ALIAS_PRAGMA
+#   pragma weak wnga_restart =  pnga_restart
+#endif
+
+void pnga_restart(Integer *g_a, Integer n, char *path)
+{
+    char fname[GA_CKPT_NAME], *ptr;
+    ckpt_header_t hdr;
+    ckpt_entry_t entry;
+    Integer type, ndim, dims[MAXDIM];
+    long i, j, bytes;
+    int fd, rc = 0;
+
+    if (strlen(path) + 16 > GA_CKPT_NAME)
+        pnga_error("ga_restart: path too long", GA_CKPT_NAME);
+    for (i=0; i<n; i++) pnga_check_handle(g_a[i], "ga_restart");
+    sprintf(fname, "%s.%ld", path, (long)pnga_nodeid());
+
+    pnga_checkpoint_wait();
+    pnga_sync();
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0) pnga_error("ga_restart: cannot open checkpoint file", 0);
+    if (gai_ckpt_pread(fd, (char*)&hdr, sizeof(hdr), 0) ||
+            hdr.magic != GA_CKPT_MAGIC)
+        pnga_error("ga_restart: not a checkpoint file", 0);
+    if (hdr.narr != n)
+        pnga_error("ga_restart: number of arrays does not match", hdr.narr);
+
+    for (i=0; i<n && !rc; i++) {
+        rc = gai_ckpt_pread(fd, (char*)&entry, sizeof(entry),
+                sizeof(hdr) + i*sizeof(entry));
+        if (rc) break;
+        pnga_inquire(g_a[i], &type, &ndim, dims);
+        gai_ckpt_local(g_a[i], &ptr, &bytes);
+        if (entry.type != type || entry.ndim != ndim || entry.bytes != bytes)
+            pnga_error("ga_restart: array does not match checkpoint", i);
+        for (j=0; j<ndim; j++) if (entry.dims[j] != dims[j])
+            pnga_error("ga_restart: array dimensions do not match", i);
+        rc = gai_ckpt_pread(fd, ptr, bytes, entry.offset);
+    }
+    close(fd);
+    if (rc) pnga_error("ga_restart: reading checkpoint file failed", 0);
+
+    /* the next checkpoint rewrites the whole file */
+    gai_ckpt_reset();
+    pnga_sync();
+}
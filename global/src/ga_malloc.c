@@ -3,19 +3,161 @@
 #endif
 
 
-/** GA Memory Allocation Routines: uses either MA or external allocator */
+/** GA Memory Allocation Routines: uses either MA or external allocator
+ *
+ *  The thread that initialized GA allocates from the MA stack.  Other
+ *  threads, such as OpenMP workers, each allocate from their own arena
+ *  used as a private stack, so these allocations need no lock.  MA is not
+ *  thread safe and the rest of GA calls it from the main thread without
+ *  any lock, so worker threads never call MA: the arenas are slots of one
+ *  block obtained from the system allocator when GA is initialized, and
+ *  requests that do not fit in an arena, or come from a thread that found
+ *  no free slot, are served by malloc.  There are GA_THREAD_ARENAS slots
+ *  (default 16) of GA_THREAD_ARENA bytes (default 4MB); a thread takes
+ *  one on its first ga_malloc and returns it when it exits.  Buffers must
+ *  be freed in reverse order of allocation by the allocating thread, as
+ *  for MA_pop_stack.  Define NOTHREADARENA to disable.
+ */
 
 #include "globalp.h"
 #include "ga-papi.h"
 #include "ga-wapi.h"
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
 #define GA_MAXMEM_AVAIL ( ( (long)1 << (8*sizeof(Integer)-2) ) -1)
 #define CHECK           0
 #define ALIGNMENT       sizeof(DoubleComplex)
 
+#if !defined(WIN32) && !defined(NOTHREADARENA)
+#   define THREAD_ARENA
+#   include <pthread.h>
+#endif
+
+/* kind of buffer, stored after the handle in the buffer header */
+#define BUF_STACK 0   /* MA stack, handle */
+#define BUF_EXT   1   /* external allocator, alignment adjustment */
+#define BUF_ARENA 2   /* thread arena, offset of the previous header */
+#define BUF_SYS   3   /* malloc, alignment adjustment */
+
+#define BUF_HANDLE(hdr) (*((Integer*)(hdr)))
+#define BUF_KIND(hdr)   (*((int*)((char*)(hdr) + sizeof(Integer))))
+
 static void * (*ga_ext_alloc)(size_t, int, char *);
 static void (*ga_ext_free)(void *);
 short int ga_usesMA = 1; 
 
+#ifdef THREAD_ARENA
+typedef struct {
+    char *base;         /* first byte, aligned */
+    char *top;          /* next free byte */
+    char *end;
+    Integer last;       /* offset of the header of the newest buffer or -1 */
+    int next;           /* next free slot or -1 */
+} ga_arena_t;
+
+#define ARENA_DEFAULT   (4L<<20)
+#define ARENAS_DEFAULT  16
+#define ARENA_NONE      ((ga_arena_t*)&ga_arena_none) /* no slot was free */
+
+static pthread_mutex_t ga_arena_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t ga_arena_once = PTHREAD_ONCE_INIT;
+static pthread_key_t ga_arena_key;
+static pthread_t ga_main_thread;
+static int ga_main_thread_set = 0;
+static char ga_arena_none;
+static ga_arena_t *ga_arena = NULL;   /* the slots */
+static int ga_arena_free = -1;        /* first free slot or -1 */
+
+
+/* thread exit: return the slot of the thread */
+static void ga_arena_release(void *p)
+{
+    ga_arena_t *arena = (ga_arena_t*)p;
+
+    if(arena == NULL || arena == ARENA_NONE) return;
+    pthread_mutex_lock(&ga_arena_lock);
+    arena->next = ga_arena_free;
+    ga_arena_free = (int)(arena - ga_arena);
+    pthread_mutex_unlock(&ga_arena_lock);
+}
+
+
+/* the block holding all arenas, obtained once for the process; threads
+ * may keep a slot past GA_Terminate, so it is never returned */
+static void ga_arena_setup()
+{
+    char *val, *block;
+    long size = ARENA_DEFAULT, n;
+    int narenas = ARENAS_DEFAULT, i;
+
+    if(pthread_key_create(&ga_arena_key, ga_arena_release))
+      pnga_error("ga_malloc: pthread_key_create failed",0);
+    if((val = getenv("GA_THREAD_ARENA")) && (n = atol(val)) > 0) size = n;
+    if((val = getenv("GA_THREAD_ARENAS")) && (n = atol(val)) >= 0)
+      narenas = (int)n;
+    if(size%ALIGNMENT) size += ALIGNMENT - size%ALIGNMENT;
+    if(narenas == 0) return;
+
+    ga_arena = (ga_arena_t*)malloc(narenas*sizeof(ga_arena_t));
+    block = (char*)malloc((size_t)narenas*size + ALIGNMENT);
+    if(ga_arena == NULL || block == NULL) {
+      free(ga_arena);
+      free(block);
+      ga_arena = NULL;
+      return;
+    }
+    if((unsigned long)block%ALIGNMENT)
+      block += ALIGNMENT - (unsigned long)block%ALIGNMENT;
+    for(i=0; i<narenas; i++) {
+      ga_arena[i].base = ga_arena[i].top = block + i*size;
+      ga_arena[i].end = ga_arena[i].base + size;
+      ga_arena[i].last = -1;
+      ga_arena[i].next = i+1 < narenas ? i+1 : -1;
+    }
+    ga_arena_free = 0;
+}
+
+
+/* returns the arena of the calling thread, NULL for the main thread */
+static ga_arena_t* ga_arena_get()
+{
+    ga_arena_t *arena;
+
+    if(!ga_main_thread_set) return NULL;
+    arena = (ga_arena_t*)pthread_getspecific(ga_arena_key);
+    if(arena) return arena;
+    if(pthread_equal(pthread_self(), ga_main_thread)) return NULL;
+
+    /* first call from this thread */
+    arena = ARENA_NONE;
+    pthread_mutex_lock(&ga_arena_lock);
+    if(ga_arena_free >= 0) {
+       arena = ga_arena + ga_arena_free;
+       ga_arena_free = arena->next;
+       arena->top = arena->base;
+       arena->last = -1;
+    }
+    pthread_mutex_unlock(&ga_arena_lock);
+    pthread_setspecific(ga_arena_key, arena);
+    return arena;
+}
+#endif
+
+
+/**
+ *  Record the calling thread as the one allocating from the MA stack and
+ *  set up the arenas of the other threads.  Called by ga_initialize.
+ */
+void ga_malloc_init()
+{
+#ifdef THREAD_ARENA
+    pthread_once(&ga_arena_once, ga_arena_setup);
+    ga_main_thread = pthread_self();
+    ga_main_thread_set = 1;
+#endif
+}
+
 void GA_Register_stack_memory(
         void * (*ext_alloc)(size_t, int, char *),
         void   (*ext_free)(void *))
@@ -31,6 +173,10 @@ void* ga_malloc(Integer nelem, int type, char *name)
     unsigned long addr;
     Integer handle, adjust=0, bytes, item_size=GAsizeofM(pnga_type_f2c(type));
     Integer extra;
+    int kind;
+#ifdef THREAD_ARENA
+    ga_arena_t *arena = ga_usesMA ? ga_arena_get() : NULL;
+#endif
 
 #if NOFORT
     type = pnga_type_f2c(type);
@@ -42,25 +188,49 @@ void* ga_malloc(Integer nelem, int type, char *name)
     extra = 2*ALIGNMENT/item_size;
     nelem += extra;
 
+#ifdef THREAD_ARENA
+    if(arena) {
+       bytes = nelem*item_size;
+       if(bytes%ALIGNMENT) bytes += ALIGNMENT - bytes%ALIGNMENT;
+       if(arena != ARENA_NONE && bytes <= arena->end - arena->top) {
+          /* the arena top is always aligned */
+          ptr = arena->top;
+          arena->top += bytes;
+          BUF_HANDLE(ptr) = arena->last;
+          BUF_KIND(ptr) = BUF_ARENA;
+          arena->last = (Integer)((char*)ptr - arena->base);
+          return ((char*)ptr) + ALIGNMENT;
+       }
+       /* not MA, which the main thread may be using */
+       addr = (unsigned long)malloc((size_t)(nelem*item_size));
+       if(!addr) pnga_error("ga_malloc: malloc failed",nelem*item_size);
+       kind = BUF_SYS;
+    }
+    else
+#endif
     if(ga_usesMA) { /* Uses Memory Allocator (MA) */
        if(MA_push_stack(type,nelem,name,&handle))  MA_get_pointer(handle,&ptr);
-       else pnga_error("ga_malloc: MA_push_stack failed",0);
+       else ptr = NULL;
+       if(ptr == NULL) pnga_error("ga_malloc: MA_push_stack failed",0);
        addr = (unsigned long)ptr;
+       kind = BUF_STACK;
     }
     else { /* else, using external memory allocator */
        bytes = nelem*item_size;
        addr  = (unsigned long)(*ga_ext_alloc)(
                (size_t)bytes, (int)item_size, name);
+       kind = BUF_EXT;
     }
 
     /* Address Alignment */
     adjust = (Integer) (addr%ALIGNMENT);
     if(adjust != 0) { adjust=ALIGNMENT-adjust; addr+=adjust; }
     ptr = (void *)addr; 
-    if(!ga_usesMA) handle = adjust;
+    if(kind == BUF_EXT || kind == BUF_SYS) handle = adjust;
 
     if(ptr == NULL) pnga_error("ga_malloc failed", 0L);
-    *((Integer*)ptr)=handle;/*store handle or adjustment-value in this buffer*/
+    BUF_HANDLE(ptr) = handle; /*store handle or adjustment-value in this buffer*/
+    BUF_KIND(ptr) = kind;
     ptr = ((char*)ptr) + ALIGNMENT;
 
     return ptr;
@@ -69,13 +239,33 @@ void* ga_malloc(Integer nelem, int type, char *name)
 void ga_free(void *ptr)
 {
     Integer handle;
+#ifdef THREAD_ARENA
+    ga_arena_t *arena;
+#endif
+
     ptr = ((char*)ptr)-ALIGNMENT;
-    handle= *((Integer*)ptr); /* retreive handle */
+    handle= BUF_HANDLE(ptr); /* retreive handle */
 
-    if(ga_usesMA) {
-      if(!MA_pop_stack(handle)) pnga_error("ga_free: MA_pop_stack failed",0);}
-    else /*make sure to free original(before address alignment) pointer*/
+    switch(BUF_KIND(ptr)) {
+#ifdef THREAD_ARENA
+    case BUF_ARENA:
+      arena = (ga_arena_t*)pthread_getspecific(ga_arena_key);
+      if(arena == NULL || arena == ARENA_NONE
+         || (char*)ptr != arena->base + arena->last)
+        pnga_error("ga_free: not the last buffer allocated by this thread",0);
+      arena->top = (char*)ptr;
+      arena->last = handle;
+      break;
+    case BUF_SYS:
+      free((char *)ptr - handle);
+      break;
+#endif
+    case BUF_STACK:
+      if(!MA_pop_stack(handle)) pnga_error("ga_free: MA_pop_stack failed",0);
+      break;
+    default: /*make sure to free original(before address alignment) pointer*/
       (*ga_ext_free)((char *)ptr - handle);
+    }
 }
 
 #if HAVE_SYS_WEAK_ALIAS_PRAGMA
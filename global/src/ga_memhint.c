@@ -0,0 +1,151 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* page size and NUMA placement hints for the local memory of global arrays
+ *
+ * Hints are given per array with pnga_set_memory_hints before the array is
+ * allocated, or for all arrays in the GA_MEMORY_HINTS environment variable,
+ * as a comma separated list of
+ *
+ *   hugepages    back the local block with transparent huge pages
+ *                (madvise MADV_HUGEPAGE)
+ *   bind         bind the pages of the local block to the NUMA node the
+ *                owning process runs on when the array is allocated
+ *   first_touch  have the owning process touch every page of its block when
+ *                the array is allocated, so that the pages are placed by the
+ *                owner before processes on the same node access them
+ *
+ * or "none". The memory itself still comes from ARMCI, so the hints are
+ * applied to it after allocation and only to the whole pages within the
+ * local block. They are advisory: a hint the system does not support is
+ * ignored. They only have an effect on Linux.
+ */
+
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#   include <unistd.h>
+#endif
+#if defined(__linux__)
+#   include <sys/mman.h>
+#   include <sys/syscall.h>
+#   include <linux/mempolicy.h>
+#endif
+
+#include "globalp.h"
+#include "base.h"
+#include "ga-papi.h"
+#include "ga-wapi.h"
+
+#define GA_MEMHINT_NAME 32          /**< max length of one hint */
+
+static int memhint_default = -1;    /**< hints from GA_MEMORY_HINTS */
+
+
+/**
+ *  Convert a list of hints to a combination of the GA_MEMHINT_ flags,
+ *  -1 if the list contains a hint that is not known
+ */
+int gai_parse_mem_hints(char *hints)
+{
+    char word[GA_MEMHINT_NAME];
+    int flags = 0;
+    size_t len;
+
+    while (hints && *hints) {
+        len = strcspn(hints, ", ");
+        if (len > 0) {
+            if (len >= GA_MEMHINT_NAME) len = GA_MEMHINT_NAME-1;
+            strncpy(word, hints, len);
+            word[len] = '\0';
+            if (strcmp(word, "hugepages") == 0) flags |= GA_MEMHINT_HUGEPAGES;
+            else if (strcmp(word, "bind") == 0) flags |= GA_MEMHINT_BIND;
+            else if (strcmp(word, "first_touch") == 0) flags |= GA_MEMHINT_TOUCH;
+            else if (strcmp(word, "none") == 0) flags = 0;
+            else return -1;
+        }
+        hints += strcspn(hints, ", ");
+        hints += strspn(hints, ", ");
+    }
+    return flags;
+}
+
+
+/**
+ *  Hints for new arrays, from the GA_MEMORY_HINTS environment variable
+ */
+int gai_default_mem_hints()
+{
+    if (memhint_default < 0) {
+        memhint_default = gai_parse_mem_hints(getenv("GA_MEMORY_HINTS"));
+        if (memhint_default < 0)
+            pnga_error("GA_MEMORY_HINTS: unknown memory hint", 0);
+    }
+    return memhint_default;
+}
+
+
+/**
+ *  Apply hints to the local memory [ptr, ptr+bytes) of an array
+ */
+void gai_apply_mem_hints(char *ptr, long bytes, int flags)
+{
+#if defined(__linux__)
+    unsigned long page, start, end;
+    volatile char *p;
+
+    if (!flags || !ptr || bytes <= 0) return;
+    page = (unsigned long)sysconf(_SC_PAGESIZE);
+    start = ((unsigned long)ptr + page - 1) / page * page;
+    end = ((unsigned long)ptr + (unsigned long)bytes) / page * page;
+    if (end <= start) return;
+
+#   ifdef MADV_HUGEPAGE
+    if (flags & GA_MEMHINT_HUGEPAGES)
+        (void)madvise((void*)start, end - start, MADV_HUGEPAGE);
+#   endif
+#   if defined(SYS_mbind) && defined(SYS_getcpu)
+    if (flags & GA_MEMHINT_BIND) {
+        unsigned cpu, node;
+        unsigned long mask[16];
+
+        if (syscall(SYS_getcpu, &cpu, &node, NULL) == 0
+                && node < 8*sizeof(mask)) {
+            memset(mask, 0, sizeof(mask));
+            mask[node/(8*sizeof(long))] = 1UL << (node%(8*sizeof(long)));
+            (void)syscall(SYS_mbind, (void*)start, end - start, MPOL_BIND,
+                          mask, 8*sizeof(mask), MPOL_MF_MOVE);
+        }
+    }
+#   endif
+    /* write each page back unchanged, which places it without clearing data
+     * the array may already hold */
+    if (flags & GA_MEMHINT_TOUCH)
+        for (p = (volatile char*)start; p < (volatile char*)end; p += page)
+            *p = *p;
+#endif
+}
+
+
+/**
+ *  Set page size and placement hints for the local memory of a new array
+ */
+#if HAVE_SYS_WEAK_ALIAS_PRAGMA
+#   pragma weak wnga_set_memory_hints = pnga_set_memory_hints
+#endif
+
+void pnga_set_memory_hints(Integer g_a, char *hints)
+{
+    Integer ga_handle = g_a + GA_OFFSET;
+    int flags;
+    if (GA[ga_handle].actv == 1)
+        pnga_error("Cannot set memory hints on array that has been allocated",0);
+    flags = gai_parse_mem_hints(hints);
+    if (flags < 0) pnga_error("unknown memory hint", 0);
+    GA[ga_handle].mem_hints = flags;
+}
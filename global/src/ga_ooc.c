@@ -0,0 +1,650 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* out-of-core global arrays
+ *
+ * An array with the "out_of_core" property keeps no data in memory. Its
+ * elements live in one file shared by the processes of the array's group, a
+ * dense column-major image of the whole array in GA_OOC_DIR (default: the
+ * working directory), and every process keeps a software cache of the pages
+ * of that file it has touched. The cache holds GA_OOC_CACHE_MB megabytes per
+ * array (default 64) in pages of GA_OOC_PAGE_KB kilobytes (default 64) and
+ * evicts the least recently used page.
+ *
+ * Consistency follows the GA model. Puts are written into the cache and only
+ * the elements actually written are marked dirty, so processes that share a
+ * page never overwrite each other's data. At every sync each process writes
+ * back its dirty elements and drops its cached pages; data put before a sync
+ * is therefore visible everywhere after it. GA_Lock and GA_Unlock do the same,
+ * so data written inside a critical section is seen by the next process to
+ * take the lock, and GA_Fence writes the dirty elements back. Accumulates and
+ * read-increments bypass the cache and update the file under a byte range
+ * lock, which makes them atomic across processes. Access to a patch returns
+ * a private copy of the patch that is written back by pnga_release_update.
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#   include <unistd.h>
+#endif
+#include <errno.h>
+#include <fcntl.h>
+
+#include "globalp.h"
+#include "base.h"
+#include "ga-papi.h"
+#include "ga-wapi.h"
+
+#define GA_OOC_NAME   1024          /**< max length of backing file name */
+#define GA_OOC_CACHE  64            /**< default cache size per array, MB */
+#define GA_OOC_PAGE   64            /**< default page size, KB */
+
+typedef struct ooc_page_s {
+    Integer page;                   /**< page number, -1 if slot is free */
+    char *data;
+    char *dirty;                    /**< one flag per element */
+    long ndirty;
+    unsigned long used;             /**< LRU stamp */
+    struct ooc_page_s *next;        /**< hash chain */
+} ooc_page_t;
+
+typedef struct ooc_access_s {       /**< outstanding pnga_access_ptr */
+    Integer lo[MAXDIM];
+    Integer hi[MAXDIM];
+    char *buf;
+    struct ooc_access_s *next;
+} ooc_access_t;
+
+typedef struct ooc_s {
+    Integer g_a;
+    int fd;
+    char fname[GA_OOC_NAME];
+    int type;
+    long elemsize;
+    int ndim;
+    Integer dims[MAXDIM];
+    long page_elems;
+    long page_bytes;
+    long nslots;
+    ooc_page_t *slot;
+    ooc_page_t **bucket;
+    ooc_page_t *last;               /**< last page hit */
+    unsigned long clock;
+    ooc_access_t *access;
+    struct ooc_s *next;
+} ooc_t;
+
+static ooc_t *ooc_list = NULL;      /**< all out-of-core arrays of process */
+static int ooc_serial = 0;
+
+#define OOC(_g_a) ((ooc_t*)GA[GA_OFFSET + (_g_a)].ooc)
+
+
+static long ooc_env(char *name, long dflt)
+{
+    char *val = getenv(name);
+    long n;
+    if (!val) return dflt;
+    n = atol(val);
+    return n > 0 ? n : dflt;
+}
+
+
+static void ooc_pread(ooc_t *o, char *buf, long bytes, long offset)
+{
+    ssize_t rc;
+    while (bytes > 0) {
+        rc = pread(o->fd, buf, (size_t)bytes, (off_t)offset);
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc < 0) pnga_error("ga_ooc: read failed", errno);
+        if (rc == 0) {              /* past end of file reads as zeros */
+            memset(buf, 0, (size_t)bytes);
+            return;
+        }
+        buf += rc; bytes -= rc; offset += rc;
+    }
+}
+
+
+static void ooc_pwrite(ooc_t *o, char *buf, long bytes, long offset)
+{
+    ssize_t rc;
+    while (bytes > 0) {
+        rc = pwrite(o->fd, buf, (size_t)bytes, (off_t)offset);
+        if (rc < 0 && errno == EINTR) continue;
+        if (rc <= 0) pnga_error("ga_ooc: write failed", errno);
+        buf += rc; bytes -= rc; offset += rc;
+    }
+}
+
+
+static void ooc_lock(ooc_t *o, int type, long bytes, long offset)
+{
+    struct flock fl;
+    fl.l_type = (short)type;
+    fl.l_whence = SEEK_SET;
+    fl.l_start = (off_t)offset;
+    fl.l_len = (off_t)bytes;
+    while (fcntl(o->fd, F_SETLKW, &fl) < 0)
+        if (errno != EINTR) pnga_error("ga_ooc: lock failed", errno);
+}
+
+
+/* write back the dirty elements of a cached page, one pwrite per run */
+static void ooc_page_flush(ooc_t *o, ooc_page_t *p)
+{
+    long i, j, base;
+
+    if (!p->ndirty) return;
+    base = p->page * o->page_bytes;
+    for (i=0; i<o->page_elems; i=j) {
+        if (!p->dirty[i]) { j = i+1; continue; }
+        for (j=i+1; j<o->page_elems && p->dirty[j]; j++);
+        ooc_pwrite(o, p->data + i*o->elemsize, (j-i)*o->elemsize,
+                base + i*o->elemsize);
+    }
+    memset(p->dirty, 0, (size_t)o->page_elems);
+    p->ndirty = 0;
+}
+
+
+static void ooc_page_drop(ooc_t *o, ooc_page_t *p)
+{
+    ooc_page_t **q;
+
+    ooc_page_flush(o, p);
+    for (q = &o->bucket[p->page % o->nslots]; *q != p; q = &(*q)->next);
+    *q = p->next;
+    p->next = NULL;
+    p->page = -1;
+    if (o->last == p) o->last = NULL;
+}
+
+
+static ooc_page_t* ooc_page_find(ooc_t *o, Integer page)
+{
+    ooc_page_t *p;
+
+    if (o->last && o->last->page == page) return o->last;
+    for (p = o->bucket[page % o->nslots]; p; p = p->next)
+        if (p->page == page) return p;
+    return NULL;
+}
+
+
+/* return page, reading it from the file unless it will be overwritten */
+static ooc_page_t* ooc_page_get(ooc_t *o, Integer page, int whole)
+{
+    ooc_page_t *p, *victim = NULL;
+    long i;
+
+    p = ooc_page_find(o, page);
+    if (!p) {
+        for (i=0; i<o->nslots; i++) {
+            if (o->slot[i].page < 0) { victim = &o->slot[i]; break; }
+            if (!victim || o->slot[i].used < victim->used)
+                victim = &o->slot[i];
+        }
+        if (victim->page >= 0) ooc_page_drop(o, victim);
+        p = victim;
+        p->page = page;
+        p->next = o->bucket[page % o->nslots];
+        o->bucket[page % o->nslots] = p;
+        if (!whole) ooc_pread(o, p->data, o->page_bytes, page*o->page_bytes);
+    }
+    p->used = ++o->clock;
+    o->last = p;
+    return p;
+}
+
+
+#define OOC_OP_GET  0
+#define OOC_OP_PUT  1
+#define OOC_OP_ACC  2
+#define OOC_OP_FILL 3
+
+/* copy n elements starting at element e of the file to/from buf, or set
+ * them all to the single element in buf for OOC_OP_FILL */
+static void ooc_run(ooc_t *o, int op, long e, long n, char *buf)
+{
+    ooc_page_t *p;
+    long i, off, len, es = o->elemsize;
+
+    while (n > 0) {
+        off = e % o->page_elems;
+        len = GA_MIN(n, o->page_elems - off);
+        p = ooc_page_get(o, e / o->page_elems,
+                op != OOC_OP_GET && len == o->page_elems);
+        if (op == OOC_OP_GET) {
+            memcpy(buf, p->data + off*es, (size_t)(len*es));
+        } else {
+            if (op == OOC_OP_FILL)
+                for (i=0; i<len; i++)
+                    memcpy(p->data + (off+i)*es, buf, (size_t)es);
+            else
+                memcpy(p->data + off*es, buf, (size_t)(len*es));
+            for (; off < e % o->page_elems + len; off++)
+                if (!p->dirty[off]) { p->dirty[off] = 1; p->ndirty++; }
+        }
+        e += len; n -= len;
+        if (op != OOC_OP_FILL) buf += len*es;
+    }
+}
+
+
+#define OOC_ACC(_type) {                                                   \
+    _type *_d = (_type*)dst, *_s = (_type*)src, _a = *(_type*)alpha;       \
+    for (i=0; i<n; i++) _d[i] += _a*_s[i];                                 \
+}
+#define OOC_ACC_CPL(_type) {                                               \
+    _type *_d = (_type*)dst, *_s = (_type*)src, *_a = (_type*)alpha;       \
+    for (i=0; i<n; i++) {                                                  \
+        _d[2*i]   += _a[0]*_s[2*i] - _a[1]*_s[2*i+1];                      \
+        _d[2*i+1] += _a[0]*_s[2*i+1] + _a[1]*_s[2*i];                      \
+    }                                                                      \
+}
+
+static void ooc_accumulate(int type, char *dst, char *src, long n,
+        void *alpha)
+{
+    long i;
+    switch (type) {
+        case C_INT:      OOC_ACC(int); break;
+        case C_LONG:     OOC_ACC(long); break;
+        case C_LONGLONG: OOC_ACC(long long); break;
+        case C_FLOAT:    OOC_ACC(float); break;
+        case C_DBL:      OOC_ACC(double); break;
+        case C_SCPL:     OOC_ACC_CPL(float); break;
+        case C_DCPL:     OOC_ACC_CPL(double); break;
+        default: pnga_error("ga_ooc: type not supported for acc", type);
+    }
+}
+
+
+/* accumulate n elements of buf into the file, page by page, under lock */
+static void ooc_acc_run(ooc_t *o, long e, long n, char *buf, void *alpha,
+        char *tmp)
+{
+    ooc_page_t *p;
+    long len, es = o->elemsize;
+
+    while (n > 0) {
+        len = GA_MIN(n, o->page_elems - e % o->page_elems);
+        p = ooc_page_find(o, e / o->page_elems);
+        if (p) ooc_page_drop(o, p);
+        ooc_lock(o, F_WRLCK, len*es, e*es);
+        ooc_pread(o, tmp, len*es, e*es);
+        ooc_accumulate(o->type, tmp, buf, len, alpha);
+        ooc_pwrite(o, tmp, len*es, e*es);
+        ooc_lock(o, F_UNLCK, len*es, e*es);
+        e += len; n -= len; buf += len*es;
+    }
+}
+
+
+/* walk patch lo:hi in runs along the first dimension; ld is not used by
+ * OOC_OP_FILL */
+static void ooc_patch(ooc_t *o, int op, Integer *lo, Integer *hi, char *buf,
+        Integer *ld, void *alpha)
+{
+    Integer idx[MAXDIM];
+    long e, bo, n, es = o->elemsize;
+    char *tmp = NULL;
+    int i, ndim = o->ndim;
+
+    for (i=0; i<ndim; i++)
+        if (lo[i] < 1 || hi[i] > o->dims[i] || lo[i] > hi[i])
+            pnga_error("ga_ooc: invalid patch", i);
+    if (op == OOC_OP_ACC) {
+        tmp = (char*)malloc((size_t)o->page_bytes);
+        if (!tmp) pnga_error("ga_ooc: malloc failed", o->page_bytes);
+    }
+
+    n = hi[0] - lo[0] + 1;
+    for (i=0; i<ndim; i++) idx[i] = lo[i];
+    while (1) {
+        for (i=ndim-1, e=0; i>=0; i--) e = e*o->dims[i] + idx[i] - 1;
+        for (i=ndim-1, bo=0; i>0 && op != OOC_OP_FILL; i--) {
+            if (i < ndim-1) bo *= ld[i];
+            bo += idx[i] - lo[i];
+        }
+        if (ndim > 1 && op != OOC_OP_FILL) bo *= ld[0];
+        if (op == OOC_OP_ACC) ooc_acc_run(o, e, n, buf + bo*es, alpha, tmp);
+        else ooc_run(o, op, e, n, buf + bo*es);
+
+        for (i=1; i<ndim; i++) {
+            if (++idx[i] <= hi[i]) break;
+            idx[i] = lo[i];
+        }
+        if (i >= ndim) break;
+    }
+    if (tmp) free(tmp);
+}
+
+
+/**
+ * Create the backing file of out-of-core array g_a. Collective on the group
+ * of the array.
+ */
+void gai_ooc_create(Integer g_a)
+{
+    Integer handle = GA_OFFSET + g_a;
+    Integer grp = GA[handle].p_handle;
+    Integer me = pnga_pgroup_nodeid(grp);
+    long cache, bytes, i;
+    ooc_t *o;
+    char *dir;
+
+    if (GA[handle].distr_type != REGULAR)
+        pnga_error("ga_ooc: block-cyclic arrays cannot be out of core", g_a);
+    if (GA[handle].ghosts)
+        pnga_error("ga_ooc: arrays with ghost cells cannot be out of core",g_a);
+
+    o = (ooc_t*)calloc(1, sizeof(ooc_t));
+    if (!o) pnga_error("ga_ooc: malloc failed", 0);
+    o->g_a = g_a;
+    o->type = GA[handle].type;
+    o->elemsize = (long)GA[handle].elemsize;
+    o->ndim = GA[handle].ndim;
+    for (i=0, bytes=o->elemsize; i<o->ndim; i++) {
+        o->dims[i] = GA[handle].dims[i];
+        bytes *= o->dims[i];
+    }
+
+    o->page_elems = ooc_env("GA_OOC_PAGE_KB", GA_OOC_PAGE)*1024/o->elemsize;
+    if (o->page_elems < 1) o->page_elems = 1;
+    o->page_bytes = o->page_elems*o->elemsize;
+    cache = ooc_env("GA_OOC_CACHE_MB", GA_OOC_CACHE)*1024*1024;
+    o->nslots = GA_MAX(cache/o->page_bytes, 1);
+    o->slot = (ooc_page_t*)calloc((size_t)o->nslots, sizeof(ooc_page_t));
+    o->bucket = (ooc_page_t**)calloc((size_t)o->nslots, sizeof(ooc_page_t*));
+    if (!o->slot || !o->bucket) pnga_error("ga_ooc: malloc failed", 0);
+    for (i=0; i<o->nslots; i++) {
+        o->slot[i].page = -1;
+        o->slot[i].data = (char*)malloc((size_t)o->page_bytes);
+        o->slot[i].dirty = (char*)calloc((size_t)o->page_elems, 1);
+        if (!o->slot[i].data || !o->slot[i].dirty)
+            pnga_error("ga_ooc: cannot allocate page cache", o->nslots);
+    }
+
+    /* the first process of the group names and sizes the file */
+    if (me == 0) {
+        dir = getenv("GA_OOC_DIR");
+        snprintf(o->fname, GA_OOC_NAME, "%s/ga_ooc.%ld.%d.%ld",
+                dir ? dir : ".", (long)getpid(), ooc_serial, (long)g_a);
+        o->fd = open(o->fname, O_RDWR|O_CREAT|O_TRUNC, 0600);
+        if (o->fd < 0) pnga_error("ga_ooc: cannot create backing file", errno);
+        if (ftruncate(o->fd, (off_t)bytes))
+            pnga_error("ga_ooc: cannot size backing file", errno);
+    }
+    ooc_serial++;
+    pnga_pgroup_brdcst(grp, GA_TYPE_BRD, o->fname, GA_OOC_NAME, 0);
+    pnga_pgroup_sync(grp);
+    if (me != 0) {
+        o->fd = open(o->fname, O_RDWR);
+        if (o->fd < 0) pnga_error("ga_ooc: cannot open backing file", errno);
+    }
+
+    o->next = ooc_list;
+    ooc_list = o;
+    GA[handle].ooc = o;
+}
+
+
+/**
+ * Close and remove the backing file of out-of-core array g_a. Called by
+ * pnga_destroy after the group has synchronized.
+ */
+void gai_ooc_destroy(Integer g_a)
+{
+    Integer handle = GA_OFFSET + g_a;
+    ooc_t *o = OOC(g_a), **q;
+    ooc_access_t *a;
+    long i;
+
+    if (!o) return;
+    for (q = &ooc_list; *q != o; q = &(*q)->next);
+    *q = o->next;
+    while ((a = o->access)) {
+        o->access = a->next;
+        free(a->buf);
+        free(a);
+    }
+    close(o->fd);
+    if (pnga_pgroup_nodeid(GA[handle].p_handle) == 0) unlink(o->fname);
+    for (i=0; i<o->nslots; i++) {
+        free(o->slot[i].data);
+        free(o->slot[i].dirty);
+    }
+    free(o->slot);
+    free(o->bucket);
+    free(o);
+    GA[handle].ooc = NULL;
+}
+
+
+/**
+ * Write back all dirty elements and drop the page caches of all out-of-core
+ * arrays. Called on entry to every sync, before the barrier.
+ */
+void gai_ooc_sync()
+{
+    ooc_t *o;
+    long i;
+    for (o = ooc_list; o; o = o->next)
+        for (i=0; i<o->nslots; i++)
+            if (o->slot[i].page >= 0) ooc_page_drop(o, &o->slot[i]);
+}
+
+
+/**
+ * Write back the dirty elements of all out-of-core arrays but keep the
+ * cached pages. Called by pnga_fence.
+ */
+void gai_ooc_flush()
+{
+    ooc_t *o;
+    long i;
+    for (o = ooc_list; o; o = o->next)
+        for (i=0; i<o->nslots; i++)
+            if (o->slot[i].page >= 0) ooc_page_flush(o, &o->slot[i]);
+}
+
+
+void gai_ooc_get(Integer g_a, Integer *lo, Integer *hi, void *buf,
+        Integer *ld)
+{
+    ooc_patch(OOC(g_a), OOC_OP_GET, lo, hi, (char*)buf, ld, NULL);
+}
+
+
+void gai_ooc_put(Integer g_a, Integer *lo, Integer *hi, void *buf,
+        Integer *ld)
+{
+    ooc_patch(OOC(g_a), OOC_OP_PUT, lo, hi, (char*)buf, ld, NULL);
+}
+
+
+void gai_ooc_acc(Integer g_a, Integer *lo, Integer *hi, void *buf,
+        Integer *ld, void *alpha)
+{
+    ooc_patch(OOC(g_a), OOC_OP_ACC, lo, hi, (char*)buf, ld, alpha);
+}
+
+
+/**
+ * Set the part of g_a held by the calling process to val.
+ */
+void gai_ooc_fill(Integer g_a, void *val)
+{
+    ooc_t *o = OOC(g_a);
+    Integer lo[MAXDIM], hi[MAXDIM];
+    int i;
+
+    pnga_distribution(g_a,
+            pnga_pgroup_nodeid(GA[GA_OFFSET + g_a].p_handle), lo, hi);
+    for (i=0; i<o->ndim; i++) if (hi[i] < lo[i]) return;
+    ooc_patch(o, OOC_OP_FILL, lo, hi, (char*)val, NULL, NULL);
+}
+
+
+/**
+ * Atomically add inc to element subscript of integer array g_a and return
+ * its old value. Like accumulate this updates the file under lock.
+ */
+Integer gai_ooc_read_inc(Integer g_a, Integer *subscript, Integer inc)
+{
+    ooc_t *o = OOC(g_a);
+    ooc_page_t *p;
+    long e, es = o->elemsize;
+    int i, ival;
+    long lval;
+    long long llval;
+    Integer value = 0;
+
+    for (i=o->ndim-1, e=0; i>=0; i--) {
+        if (subscript[i] < 1 || subscript[i] > o->dims[i])
+            pnga_error("ga_ooc: invalid subscript", i);
+        e = e*o->dims[i] + subscript[i] - 1;
+    }
+    p = ooc_page_find(o, e / o->page_elems);
+    if (p) ooc_page_drop(o, p);
+    ooc_lock(o, F_WRLCK, es, e*es);
+    switch (o->type) {
+        case C_INT:
+            ooc_pread(o, (char*)&ival, es, e*es);
+            value = (Integer)ival;
+            ival += (int)inc;
+            ooc_pwrite(o, (char*)&ival, es, e*es);
+            break;
+        case C_LONG:
+            ooc_pread(o, (char*)&lval, es, e*es);
+            value = (Integer)lval;
+            lval += (long)inc;
+            ooc_pwrite(o, (char*)&lval, es, e*es);
+            break;
+        case C_LONGLONG:
+            ooc_pread(o, (char*)&llval, es, e*es);
+            value = (Integer)llval;
+            llval += (long long)inc;
+            ooc_pwrite(o, (char*)&llval, es, e*es);
+            break;
+        default: pnga_error("ga_ooc: type must be integer", o->type);
+    }
+    ooc_lock(o, F_UNLCK, es, e*es);
+    return value;
+}
+
+
+/**
+ * Return a private copy of patch lo:hi in ptr, with leading dimensions ld.
+ * The copy lives until pnga_release or pnga_release_update of the same patch.
+ */
+void gai_ooc_access(Integer g_a, Integer *lo, Integer *hi, void *ptr,
+        Integer *ld)
+{
+    ooc_t *o = OOC(g_a);
+    ooc_access_t *a;
+    long n = o->elemsize;
+    int i;
+
+    for (i=0; i<o->ndim; i++) {
+        if (i < o->ndim-1) ld[i] = hi[i] - lo[i] + 1;
+        n *= hi[i] - lo[i] + 1;
+    }
+    a = (ooc_access_t*)malloc(sizeof(ooc_access_t));
+    if (a) a->buf = (char*)malloc((size_t)n);
+    if (!a || !a->buf) pnga_error("ga_ooc: cannot allocate patch copy", n);
+    for (i=0; i<o->ndim; i++) {
+        a->lo[i] = lo[i];
+        a->hi[i] = hi[i];
+    }
+    ooc_patch(o, OOC_OP_GET, lo, hi, a->buf, ld, NULL);
+    a->next = o->access;
+    o->access = a;
+    *(char**)ptr = a->buf;
+}
+
+
+/**
+ * End access to patch lo:hi, writing the copy back first if update is set.
+ */
+void gai_ooc_release(Integer g_a, Integer *lo, Integer *hi, int update)
+{
+    ooc_t *o = OOC(g_a);
+    ooc_access_t *a, **q;
+    Integer ld[MAXDIM];
+    int i;
+
+    for (q = &o->access; (a = *q); q = &a->next) {
+        for (i=0; i<o->ndim; i++)
+            if (a->lo[i] != lo[i] || a->hi[i] != hi[i]) break;
+        if (i == o->ndim) break;
+    }
+    if (!a) return;
+    *q = a->next;
+    if (update) {
+        for (i=0; i<o->ndim-1; i++) ld[i] = hi[i] - lo[i] + 1;
+        ooc_patch(o, OOC_OP_PUT, lo, hi, a->buf, ld, NULL);
+    }
+    free(a->buf);
+    free(a);
+}
+
+
+/**
+ * Hint that patch lo:hi of g_a will be read soon. The file system is asked
+ * to start reading the patch in the background; for arrays that are not out
+ * of core this is a no-op.
+ */
+#if HAVE_SYS_WEAK_ALIAS_PRAGMA
+#   pragma weak wnga_prefetch = pnga_prefetch
+#endif
+
+void pnga_prefetch(Integer g_a, Integer *lo, Integer *hi)
+{
+    ooc_t *o;
+    Integer idx[MAXDIM];
+    long e, first = -1, last = -1, n;
+    int i;
+
+    ga_check_handleM(g_a, "pnga_prefetch");
+    o = OOC(g_a);
+    if (!o) return;
+
+    for (i=0; i<o->ndim; i++) {
+        if (lo[i] < 1 || hi[i] > o->dims[i] || lo[i] > hi[i]) return;
+        idx[i] = lo[i];
+    }
+    n = hi[0] - lo[0] + 1;
+    while (1) {
+        for (i=o->ndim-1, e=0; i>=0; i--) e = e*o->dims[i] + idx[i] - 1;
+        /* coalesce runs that are adjacent in the file */
+        if (e != last) {
+#if defined(POSIX_FADV_WILLNEED)
+            if (first >= 0) posix_fadvise(o->fd, (off_t)(first*o->elemsize),
+                    (off_t)((last-first)*o->elemsize), POSIX_FADV_WILLNEED);
+#endif
+            first = e;
+        }
+        last = e + n;
+        for (i=1; i<o->ndim; i++) {
+            if (++idx[i] <= hi[i]) break;
+            idx[i] = lo[i];
+        }
+        if (i >= o->ndim) break;
+    }
+#if defined(POSIX_FADV_WILLNEED)
+    posix_fadvise(o->fd, (off_t)(first*o->elemsize),
+            (off_t)((last-first)*o->elemsize), POSIX_FADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,206 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* reuse of the shared memory of destroyed global arrays
+ *
+ * When GA_ARRAY_POOL is set to n > 0, pnga_destroy keeps the memory of up
+ * to n destroyed arrays per group instead of returning it to ARMCI, and
+ * pnga_allocate and pnga_duplicate take the memory for a new array from
+ * this pool when they can. Reusing a segment avoids the collective
+ * ARMCI_Malloc, the exchange of addresses and the registration of new
+ * memory; it costs one reduction of a few integers over the array's group
+ * instead.
+ *
+ * A segment can be reused for an array of the same group and data type
+ * whose local size on every process of the group is at least half the
+ * size of the segment's local block and no larger than it. Since arrays
+ * are created and destroyed collectively, all processes of a group add
+ * segments to the pool in the same order; the reduction tells them which
+ * segments fit on every process, and all of them take the first of those.
+ * When the pool of a group is full its oldest segment is freed. Pooled
+ * memory is not counted against GA_Set_memory_limit. The segments of a
+ * group are freed when the group is destroyed, and all segments by
+ * GA_Terminate.
+ */
+
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+
+#include "globalp.h"
+#include "base.h"
+#include "armci.h"
+#include "ga-papi.h"
+#include "ga-wapi.h"
+
+typedef struct pool_seg_s {
+    int grp_id;
+    int type;
+    long size;                      /**< local bytes */
+    long id;                        /**< alignment adjustment of ptr */
+    char **ptr;                     /**< addresses of the blocks of the group */
+    struct pool_seg_s *next;
+} pool_seg_t;
+
+static pool_seg_t *pool_head = NULL; /**< oldest segment first */
+static int pool_max = -1;           /**< GA_ARRAY_POOL */
+
+
+static int pool_limit()
+{
+    char *val;
+
+    if (pool_max < 0) {
+        val = getenv("GA_ARRAY_POOL");
+        pool_max = val ? atoi(val) : 0;
+        if (pool_max < 0) pool_max = 0;
+    }
+    return pool_max;
+}
+
+
+/* is the memory of arrays on the group allocated by ARMCI, see gai_getmem */
+static int pool_shm(int grp_id)
+{
+#ifdef AVOID_MA_STORAGE
+    return 1;
+#else
+    return gai_uses_shm(grp_id);
+#endif
+}
+
+
+/* return the memory of seg to ARMCI, collective over its group */
+static void pool_release(pool_seg_t *seg)
+{
+    int grp_me = GAme;
+
+    if (seg->grp_id > 0) grp_me = PGRP_LIST[seg->grp_id].map_proc_list[GAme];
+    if (seg->ptr[grp_me] != NULL) {
+#ifdef MSG_COMMS_MPI
+        if (seg->grp_id > 0)
+            ARMCI_Free_group(seg->ptr[grp_me] - seg->id,
+                             &PGRP_LIST[seg->grp_id].group);
+        else
+#endif
+            ARMCI_Free(seg->ptr[grp_me] - seg->id);
+    }
+    free(seg->ptr);
+    free(seg);
+}
+
+
+/**
+ *  Take memory of size bytes for an array of the given type and group from
+ *  the pool. Returns 1 and sets ptr_arr and id if a segment was reused, 0
+ *  if the memory has to be allocated. Collective over the group.
+ */
+int gai_pool_get(char **ptr_arr, long bytes, int type, long *id,
+                 int grp_id)
+{
+    pool_seg_t *seg, *prev;
+    Integer *fit;
+    int n, i;
+
+    if (!pool_limit() || !pool_shm(grp_id)) return 0;
+    for (n = 0, seg = pool_head; seg; seg = seg->next)
+        if (seg->grp_id == grp_id && seg->type == type) n++;
+    if (n == 0) return 0;
+
+    fit = (Integer*)malloc(n*sizeof(Integer));
+    if (!fit) pnga_error("gai_pool_get: malloc failed", n);
+    for (i = 0, seg = pool_head; seg; seg = seg->next)
+        if (seg->grp_id == grp_id && seg->type == type)
+            fit[i++] = seg->size >= bytes && seg->size - bytes <= bytes;
+    pnga_pgroup_gop(grp_id, pnga_type_f2c(MT_F_INT), fit, n, "min");
+
+    for (i = 0, prev = NULL, seg = pool_head; seg; prev = seg, seg = seg->next)
+        if (seg->grp_id == grp_id && seg->type == type && fit[i++]) break;
+    free(fit);
+    if (!seg) return 0;
+
+    if (prev) prev->next = seg->next;
+    else pool_head = seg->next;
+    memcpy(ptr_arr, seg->ptr, GAnproc*sizeof(char*));
+    *id = seg->id;
+    free(seg->ptr);
+    free(seg);
+    return 1;
+}
+
+
+/**
+ *  Keep the memory of a destroyed array in the pool. Returns 1 if it was
+ *  kept, 0 if the caller has to free it. Collective over the group.
+ */
+int gai_pool_put(char **ptr_arr, long bytes, int type, long id,
+                 int grp_id)
+{
+    pool_seg_t *seg, *prev, **last;
+    int n = 0;
+
+    if (!pool_limit() || !pool_shm(grp_id)) return 0;
+
+    seg = (pool_seg_t*)malloc(sizeof(pool_seg_t));
+    if (seg) seg->ptr = (char**)malloc(GAnproc*sizeof(char*));
+    if (!seg || !seg->ptr) pnga_error("gai_pool_put: malloc failed", 0);
+    seg->grp_id = grp_id;
+    seg->type = type;
+    seg->size = bytes;
+    seg->id = id;
+    memcpy(seg->ptr, ptr_arr, GAnproc*sizeof(char*));
+    seg->next = NULL;
+    for (last = &pool_head; *last; last = &(*last)->next)
+        if ((*last)->grp_id == grp_id) n++;
+    *last = seg;
+
+    /* only the members of the group take part, so evict from the group */
+    if (n >= pool_max) {
+        for (prev = NULL, seg = pool_head; seg->grp_id != grp_id;
+             prev = seg, seg = seg->next) ;
+        if (prev) prev->next = seg->next;
+        else pool_head = seg->next;
+        pool_release(seg);
+    }
+    return 1;
+}
+
+
+/**
+ *  Free the pooled segments of group grp_id. Collective over the group.
+ */
+void gai_pool_flush(int grp_id)
+{
+    pool_seg_t *seg, **link = &pool_head;
+
+    while ((seg = *link) != NULL) {
+        if (seg->grp_id == grp_id) {
+            *link = seg->next;
+            pool_release(seg);
+        } else {
+            link = &seg->next;
+        }
+    }
+}
+
+
+/**
+ *  Free all pooled segments. Groups are done in the order of their handles
+ *  so that processes in several groups free the segments in the same order.
+ */
+void gai_pool_finalize()
+{
+    pool_seg_t *seg;
+    int grp_id;
+
+    while (pool_head) {
+        grp_id = pool_head->grp_id;
+        for (seg = pool_head; seg; seg = seg->next)
+            if (seg->grp_id < grp_id) grp_id = seg->grp_id;
+        gai_pool_flush(grp_id);
+    }
+}
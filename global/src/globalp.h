@@ -140,6 +140,7 @@ extern char ***_ga_argv;
 
 extern void    ga_free(void *ptr);
 extern void*   ga_malloc(Integer nelem, int type, char *name);
+extern void    ga_malloc_init();
 extern void    gai_init_onesided();
 extern void    gai_finalize_onesided();
 extern void    gai_print_subscript(char *pre,int ndim, Integer subscript[], char* post);
@@ -158,6 +159,25 @@ extern int     ga_icheckpoint_finalize(int g_a);
 extern void    ga_checkpoint_arrays(Integer *gas,int num);
 extern int     ga_recover_arrays(Integer *gas, int num);
 extern void    set_ga_group_is_for_ft(int val);
+extern int     gai_parse_mem_hints(char *hints);
+extern int     gai_default_mem_hints();
+extern void    gai_apply_mem_hints(char *ptr, long bytes, int flags);
+extern int     gai_uses_shm(int grp_id);
+extern int     gai_pool_get(char **ptr_arr, long bytes, int type, long *id, int grp_id);
+extern int     gai_pool_put(char **ptr_arr, long bytes, int type, long id, int grp_id);
+extern void    gai_pool_flush(int grp_id);
+extern void    gai_pool_finalize();
+extern void    gai_ooc_create(Integer g_a);
+extern void    gai_ooc_destroy(Integer g_a);
+extern void    gai_ooc_sync();
+extern void    gai_ooc_flush();
+extern void    gai_ooc_get(Integer g_a, Integer *lo, Integer *hi, void *buf, Integer *ld);
+extern void    gai_ooc_put(Integer g_a, Integer *lo, Integer *hi, void *buf, Integer *ld);
+extern void    gai_ooc_acc(Integer g_a, Integer *lo, Integer *hi, void *buf, Integer *ld, void *alpha);
+extern void    gai_ooc_access(Integer g_a, Integer *lo, Integer *hi, void *ptr, Integer *ld);
+extern void    gai_ooc_release(Integer g_a, Integer *lo, Integer *hi, int update);
+extern void    gai_ooc_fill(Integer g_a, void *val);
+extern Integer gai_ooc_read_inc(Integer g_a, Integer *subscript, Integer inc);
 extern void    ga_set_spare_procs(int *spare);
 
 #endif /* _GLOBALP_H_ */
@@ -81,21 +81,15 @@ unsigned int get_next_tag(){
     return((++ga_nb_tag));
 }
 
-/*\ the only way to complete a list element! 
- *  does the basic list operation: remove element, update previous and next
+/*\ does the basic list operation: remove element, update previous and next
  *  links of the previous and next elements in the linked list
  *  prev==null => this was the element pointed by the head(ie, first element).
+ *  The armci request of the element must have completed.
 \*/
-static void clear_list_element(int index){
+static void unlink_list_element(int index){
 ga_armcihdl_t *listele,*prev,*next;
-    if(DEBUG){
-       printf("\n%ld:clearing handle %d\n",(long)GAme,index);fflush(stdout);
-    }
     listele = &(list_element_array[index]);
 
-    /*first wait for the armci handle */
-    ARMCI_Wait(listele->handle);
-
     /*set prev and next links of my prev element and my next element*/
     prev=listele->previous;
     next = listele->next;
@@ -117,6 +111,20 @@ ga_armcihdl_t *listele,*prev,*next;
 }
 
 
+/*\ the only way to complete a list element! 
+ *  waits for its armci request and removes it from the list
+\*/
+static void clear_list_element(int index){
+    if(DEBUG){
+       printf("\n%ld:clearing handle %d\n",(long)GAme,index);fflush(stdout);
+    }
+
+    /*first wait for the armci handle */
+    ARMCI_Wait(list_element_array[index].handle);
+    unlink_list_element(index);
+}
+
+
 /*\ Get the next available list element from the list element array, if 
  *  nothing is available, free element with index nextLEAelement
 \*/
@@ -245,39 +253,52 @@ int retval = 0;
 }
 
 
+/*\ returns 1 if the armci request of list element index has completed
+\*/
 static int test_list_element(int index){
 ga_armcihdl_t *listele;
     if(DEBUG){
-       printf("\n%ld:clearing handle %d\n",(long)GAme,index);fflush(stdout);
+       printf("\n%ld:testing handle %d\n",(long)GAme,index);fflush(stdout);
     }
     listele = &(list_element_array[index]);
 
-    return (ARMCI_Test(listele->handle));
+    /*ARMCI_Test returns 0 for a completed request*/
+    return (ARMCI_Test(listele->handle) == 0);
 }
 
+/*\ tests the elements of the list. An armci request that tests complete
+ *  has already been released by armci, so its element is removed from the
+ *  list without waiting for it again, and once the list is empty the head
+ *  is released as well. Returns 1 if all requests have completed.
+\*/
 static int test_armci_handle_list(int elementtofree){
 ga_armcihdl_t *first = ga_ihdl_array[elementtofree].ahandle,*next;
- int done = 1; 
-    /*call clear_list_element for every element in the list*/
     while(first!=NULL){
        next=first->next;
-       if (test_list_element(first->index) == 0) {
-	 done = 0;
-	 break;
-       }
+       if (test_list_element(first->index) == 0) return 0;
+       unlink_list_element(first->index);
        first=next;
     }
-    return (done);
+
+    /*reset the head of the list for reuse, as free_armci_handle_list does*/
+    ga_ihdl_array[elementtofree].count=0;
+    ga_ihdl_array[elementtofree].ga_nbtag=0;
+    ga_ihdl_array[elementtofree].ahandle=NULL;
+    ihdl_array_avail[elementtofree]=1;
+    return 1;
 }
 
-/*\ the test routine which is called inside nga_nbtest
+/*\ the test routine which is called inside nga_nbtest, returns 1 if the
+ *  request has completed. A handle that never needed armci requests (a
+ *  purely local patch) or that was recycled, which completes it, counts
+ *  as completed.
 \*/ 
 int nga_test_internal(Integer *nbhandle){
 gai_nbhdl_t *inbhandle = (gai_nbhdl_t *)nbhandle;
-int retval = 0;
-    if(inbhandle->ihdl_index==(NUM_HDLS+1))retval=0;
+int retval = 1;
+    if(inbhandle->ihdl_index==(NUM_HDLS+1))retval=1;
     else if(inbhandle->ga_nbtag !=ga_ihdl_array[inbhandle->ihdl_index].ga_nbtag)
-       retval=0;
+       retval=1;
     else
        return (test_armci_handle_list(inbhandle->ihdl_index));
     
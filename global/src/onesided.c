@@ -114,6 +114,7 @@ void pnga_pgroup_sync(Integer grp_id)
 #endif
 
   /*    printf("p[%d] calling ga_pgroup_sync on group: %d\n",GAme,*grp_id); */
+  gai_ooc_sync();
 #ifdef USE_ARMCI_GROUP_FENCE
     int grp = (int)grp_id;
     ARMCI_GroupFence(&grp);
@@ -157,6 +158,8 @@ void pnga_sync()
   Integer status;
 #endif
 
+  gai_ooc_sync();
+
 #ifdef USE_ARMCI_GROUP_FENCE
   if (GA_Default_Proc_Group == -1) {
     int grp_id = (int)GA_Default_Proc_Group;
@@ -196,6 +199,7 @@ void pnga_fence()
     int proc;
     if(GA_fence_set<1)pnga_error("ga_fence: fence not initialized",0);
     GA_fence_set--;
+    gai_ooc_flush();
     for(proc=0;proc<GAnproc;proc++)if(fence_array[proc])ARMCI_Fence(proc);
     bzero(fence_array,(int)GAnproc);
 }
@@ -564,6 +568,14 @@ void ngai_put_common(Integer g_a,
 
   ga_check_handleM(g_a, "ngai_put_common");
 
+  if (GA[handle].property == OUT_OF_CORE) {
+    if (field_size >= 0 && field_size != GA[handle].elemsize)
+      pnga_error("field put not supported for out-of-core arrays",g_a);
+    if(nbhandle)ga_init_nbhandle(nbhandle);
+    gai_ooc_put(g_a, lo, hi, buf, ld);
+    return;
+  }
+
   size = GA[handle].elemsize;
   ndim = GA[handle].ndim;
   p_handle = GA[handle].p_handle;
@@ -939,6 +951,14 @@ void ngai_get_common(Integer g_a,
 
   ga_check_handleM(g_a, "ngai_get_common");
 
+  if (GA[handle].property == OUT_OF_CORE) {
+    if (field_size >= 0 && field_size != GA[handle].elemsize)
+      pnga_error("field get not supported for out-of-core arrays",g_a);
+    if(nbhandle)ga_init_nbhandle(nbhandle);
+    gai_ooc_get(g_a, lo, hi, buf, ld);
+    return;
+  }
+
   size = GA[handle].elemsize;
   ndim = GA[handle].ndim;
   p_handle = (Integer)GA[handle].p_handle;
@@ -1129,6 +1149,13 @@ void ngai_acc_common(Integer g_a,
 
   ga_check_handleM(g_a, "ngai_acc_common");
 
+  if (GA[handle].property == OUT_OF_CORE) {
+    if(nbhandle)ga_init_nbhandle(nbhandle);
+    gai_ooc_acc(g_a, lo, hi, buf, ld, alpha);
+    GA_Internal_Threadsafe_Unlock();
+    return;
+  }
+
   size = GA[handle].elemsize;
   type = GA[handle].type;
   ndim = GA[handle].ndim;
@@ -1299,6 +1326,11 @@ Integer  ow,i,p_handle;
            ga_RegionError(GA[handle].ndim, lo, hi, g_a);
        }
 
+   if (GA[handle].property == OUT_OF_CORE) {
+      gai_ooc_access(g_a, lo, hi, ptr, ld);
+      return;
+   }
+
    if (p_handle >= 0) {
      ow = PGRP_LIST[p_handle].map_proc_list[ow];
    }
@@ -1339,6 +1371,8 @@ void pnga_access_block_grid_ptr(Integer g_a, Integer *index, void* ptr, Integer
 
   
   /*p_handle = GA[handle].p_handle;*/
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("block access not supported for out-of-core arrays",g_a);
   if (GA[handle].distr_type != SCALAPACK && GA[handle].distr_type != TILED) {
     pnga_error("Array is not using ScaLAPACK or tiled data distribution",0);
   }
@@ -1493,6 +1527,8 @@ void pnga_access_block_ptr(Integer g_a, Integer idx, void* ptr, Integer *ld)
 
   
   /*p_handle = GA[handle].p_handle;*/
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("block access not supported for out-of-core arrays",g_a);
   nblocks = GA[handle].block_total;
   ndim = GA[handle].ndim;
   index = idx;
@@ -1552,6 +1588,8 @@ void pnga_access_block_segment_ptr(Integer g_a, Integer proc, void* ptr, Integer
   /*p_handle = GA[handle].p_handle;*/
   /*nblocks = GA[handle].block_total;*/
   /*ndim = GA[handle].ndim;*/
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("block access not supported for out-of-core arrays",g_a);
   index = proc;
   if (index < 0 || index >= GAnproc)
     pnga_error("processor index outside allowed values",index);
@@ -1581,6 +1619,8 @@ unsigned long    elemsize;
 unsigned long    lref=0, lptr;
 
    
+   if (GA[handle].property == OUT_OF_CORE)
+      pnga_error("index access not supported for out-of-core arrays",g_a);
    p_handle = GA[handle].p_handle;
    if(!pnga_locate(g_a,lo,&ow))pnga_error("locate top failed",0);
    if (p_handle != -1)
@@ -1897,7 +1937,10 @@ unsigned long    lref=0, lptr;
 #endif
 
 void pnga_release(Integer g_a, Integer *lo, Integer *hi)
-{}
+{
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE)
+    gai_ooc_release(g_a, lo, hi, 0);
+}
 
 /**
  *  Release access and update a patch of a Global Array
@@ -1907,7 +1950,10 @@ void pnga_release(Integer g_a, Integer *lo, Integer *hi)
 #endif
 
 void pnga_release_update(Integer g_a, Integer *lo, Integer *hi)
-{}
+{
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE)
+    gai_ooc_release(g_a, lo, hi, 1);
+}
 
 /**
  *  Release access to a block in a block-cyclic Global Array
@@ -2119,6 +2165,15 @@ void pnga_scatter2d(Integer g_a, void *v, Integer *i, Integer *j, Integer nv)
     if (nv < 1) return;
     
     ga_check_handleM(g_a, "ga_scatter");
+
+    if (GA[handle].property == OUT_OF_CORE) {
+      for (k=0; k<nv; k++) {
+        subscrpt[0] = i[k]; subscrpt[1] = j[k];
+        gai_ooc_put(g_a, subscrpt, subscrpt,
+            (char*)v + k*GA[handle].elemsize, subscrpt);
+      }
+      return;
+    }
     
     GAstat.numsca++;
     /* determine how many processors are associated with array */
@@ -2393,6 +2448,15 @@ Integer subscrpt[2];
   if (nv < 1) return;
 
   ga_check_handleM(g_a, "ga_scatter_acc");
+
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE) {
+    for (k=0; k<nv; k++) {
+      subscrpt[0] = i[k]; subscrpt[1] = j[k];
+      gai_ooc_acc(g_a, subscrpt, subscrpt,
+          (char*)v + k*GA[GA_OFFSET + g_a].elemsize, subscrpt, alpha);
+    }
+    return;
+  }
   
   GAstat.numsca++;
 
@@ -3072,6 +3136,36 @@ void pnga_free_gatscat_buf()
   }                                                  \
 }
 
+/*\ GATHER/SCATTER OPERATION on an out-of-core array, element by element
+ *  through its page cache
+\*/
+static void gai_ooc_gatscat(int op, Integer g_a, void* v, void *subscript,
+                            Integer c_flag, Integer nv, void *alpha)
+{
+  Integer k, ndim, index[MAXDIM], *subscript_ptr;
+  char *buf = (char*)v;
+  int item_size;
+
+  ndim = GA[GA_OFFSET + g_a].ndim;
+  item_size = GA[GA_OFFSET + g_a].elemsize;
+  for (k=0; k<nv; k++, buf += item_size) {
+    if (c_flag) {
+      gam_c2f_index(((int**)subscript)[k], index, ndim);
+      subscript_ptr = index;
+    } else {
+      subscript_ptr = ((Integer*)subscript)+k*ndim;
+    }
+    /* a single element has no leading dimensions, any ld will do */
+    if (op == GATHER)
+      gai_ooc_get(g_a, subscript_ptr, subscript_ptr, buf, subscript_ptr);
+    else if (op == SCATTER)
+      gai_ooc_put(g_a, subscript_ptr, subscript_ptr, buf, subscript_ptr);
+    else
+      gai_ooc_acc(g_a, subscript_ptr, subscript_ptr, buf, subscript_ptr,
+                  alpha);
+  }
+}
+
 /*\ GATHER OPERATION elements from the global array into v
 \*/
 void gai_gatscat_new(int op, Integer g_a, void* v, void *subscript,
@@ -3304,6 +3398,11 @@ void pnga_gather(Integer g_a, void* v, void *subscript, Integer c_flag, Integer
   
   GAstat.numgat++;
 
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE) {
+    gai_ooc_gatscat(GATHER,g_a,v,subscript,c_flag,nv,NULL);
+    return;
+  }
+
 #ifdef USE_GATSCAT_NEW
   gai_gatscat_new(GATHER,g_a,v,subscript,c_flag,nv,&GAbytes.gattot,&GAbytes.gatloc, NULL);
 #else
@@ -3328,6 +3427,11 @@ void pnga_scatter(Integer g_a, void* v, void *subscript, Integer c_flag, Integer
   
   GAstat.numsca++;
 
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE) {
+    gai_ooc_gatscat(SCATTER,g_a,v,subscript,c_flag,nv,NULL);
+    return;
+  }
+
 #ifdef USE_GATSCAT_NEW
   gai_gatscat_new(SCATTER,g_a,v,subscript,c_flag,nv,&GAbytes.scatot,&GAbytes.scaloc, NULL);
 #else
@@ -3353,6 +3457,11 @@ void pnga_scatter_acc(Integer g_a, void* v, void *subscript, Integer c_flag,
   
   GAstat.numsca++;
 
+  if (GA[GA_OFFSET + g_a].property == OUT_OF_CORE) {
+    gai_ooc_gatscat(SCATTER_ACC,g_a,v,subscript,c_flag,nv,alpha);
+    return;
+  }
+
 #ifdef USE_GATSCAT_NEW
   gai_gatscat_new(SCATTER_ACC, g_a, v, subscript, c_flag, nv, &GAbytes.scatot,
               &GAbytes.scaloc, alpha);
@@ -3395,6 +3504,15 @@ void pnga_gather2d(Integer g_a, void *v, Integer *i, Integer *j,
     if (nv < 1) return;
 
     ga_check_handleM(g_a, "ga_gather");
+
+    if (GA[handle].property == OUT_OF_CORE) {
+      for (k=0; k<nv; k++) {
+        subscrpt[0] = i[k]; subscrpt[1] = j[k];
+        gai_ooc_get(g_a, subscrpt, subscrpt,
+            (char*)v + k*GA[handle].elemsize, subscrpt);
+      }
+      return;
+    }
     
     GAstat.numgat++;
 
@@ -3671,6 +3789,13 @@ void *pval;
 
     GAstat.numrdi++;
     GAbytes.rditot += (double)sizeof(Integer);
+
+    if (GA[handle].property == OUT_OF_CORE) {
+      Integer value = gai_ooc_read_inc(g_a, subscript, inc);
+      GA_Internal_Threadsafe_Unlock();
+      return value;
+    }
+
     p_handle = GA[handle].p_handle;
     ndim = GA[handle].ndim;
 
@@ -3940,6 +4065,8 @@ void pnga_strided_put(Integer g_a, Integer *lo, Integer *hi, Integer *skip,
   int i, proc, ndim;
   _iterator_hdl it_hdl;
 
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("strided put not supported for out-of-core arrays",g_a);
   size = GA[handle].elemsize;
   ndim = GA[handle].ndim;
   nproc = pnga_nnodes();
@@ -4020,6 +4147,8 @@ void pnga_strided_get(Integer g_a, Integer *lo, Integer *hi, Integer *skip,
   int count[2*MAXDIM], stride_rem[2*MAXDIM], stride_loc[2*MAXDIM];
   _iterator_hdl it_hdl;
 
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("strided get not supported for out-of-core arrays",g_a);
   size = GA[handle].elemsize;
   ndim = GA[handle].ndim;
   nproc = pnga_nnodes();
@@ -4103,6 +4232,8 @@ void pnga_strided_acc(Integer g_a, Integer *lo, Integer *hi, Integer *skip,
   int count[2*MAXDIM], stride_rem[2*MAXDIM], stride_loc[2*MAXDIM];
   _iterator_hdl it_hdl;
 
+  if (GA[handle].property == OUT_OF_CORE)
+    pnga_error("strided acc not supported for out-of-core arrays",g_a);
   size = GA[handle].elemsize;
   ndim = GA[handle].ndim;
   type = GA[handle].type;
@@ -0,0 +1,134 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* checkpoint/restart round trip, with an incremental checkpoint and arrays
+ * that are modified while the checkpoint is being written */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_UNISTD_H
+#   include <unistd.h>
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "testutil.h"
+
+#define N     512
+#define M     300
+#define LEN   100000
+#define PATH  "ga_checkpoint_test"
+
+static int me, nproc;
+
+/* set g_d(i,j) = i + j*N + shift and g_i(k) = k - shift on this process */
+static void init(int g_d, int g_i, int shift)
+{
+    int lo[2], hi[2], ld[1], i, j, k;
+    double *d;
+    int *v;
+
+    NGA_Distribution(g_d, me, lo, hi);
+    if (lo[0] >= 0 && lo[0] <= hi[0]) {
+        NGA_Access(g_d, lo, hi, &d, ld);
+        for (i=lo[0]; i<=hi[0]; i++)
+            for (j=lo[1]; j<=hi[1]; j++)
+                d[(i-lo[0])*ld[0] + j-lo[1]] = (double)(i + j*N + shift);
+        NGA_Release_update(g_d, lo, hi);
+    }
+    NGA_Distribution(g_i, me, lo, hi);
+    if (lo[0] >= 0 && lo[0] <= hi[0]) {
+        NGA_Access(g_i, lo, hi, &v, ld);
+        for (k=lo[0]; k<=hi[0]; k++) v[k-lo[0]] = k - shift;
+        NGA_Release_update(g_i, lo, hi);
+    }
+    GA_Sync();
+}
+
+/* a few elements in every 64 KB page of one process */
+static void touch(int g_d, int owner)
+{
+    int lo[2], hi[2], ld[1], i;
+    double *d;
+
+    NGA_Distribution(g_d, owner, lo, hi);
+    if (me == owner && lo[0] >= 0 && lo[0] <= hi[0]) {
+        NGA_Access(g_d, lo, hi, &d, ld);
+        for (i=0; i<(hi[0]-lo[0]+1)*ld[0]; i+=5000) d[i] = -1.0;
+        NGA_Release_update(g_d, lo, hi);
+    }
+    GA_Sync();
+}
+
+/* g - h is zero, overwrites h */
+static int compare(int g_d, int g_i, int h_d, int h_i)
+{
+    double one = 1.0, mone = -1.0;
+    int ione = 1, imone = -1;
+
+    GA_Add(&one, g_d, &mone, h_d, h_d);
+    GA_Add(&ione, g_i, &imone, h_i, h_i);
+    return GA_Ddot(h_d, h_d) == 0.0 && GA_Idot(h_i, h_i) == 0;
+}
+
+int main(int argc, char **argv)
+{
+    int dims[2] = {N, M}, len = LEN;
+    int g_d, g_i, h_d, h_i, g[2];
+    char fname[64];
+
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (me == 0) printf("Testing checkpoint/restart on %d processes\n", nproc);
+
+    g_d = NGA_Create(C_DBL, 2, dims, "d", NULL);
+    g_i = NGA_Create(C_INT, 1, &len, "i", NULL);
+    h_d = NGA_Create(C_DBL, 2, dims, "d copy", NULL);
+    h_i = NGA_Create(C_INT, 1, &len, "i copy", NULL);
+    g[0] = g_d; g[1] = g_i;
+
+    /* full checkpoint */
+    init(g_d, g_i, 0);
+    GA_Checkpoint_arrays(g, 2, PATH);
+    GA_Checkpoint_wait();
+
+    /* incremental checkpoint of a few modified pages, then modify the arrays
+     * while the checkpoint is drained */
+    touch(g_d, nproc-1);
+    GA_Copy(g_d, h_d);
+    GA_Copy(g_i, h_i);
+    GA_Checkpoint_arrays(g, 2, PATH);
+    init(g_d, g_i, 7);
+    GA_Checkpoint_wait();
+
+    GA_Restart_arrays(g, 2, PATH);
+    test_check(compare(g_d, g_i, h_d, h_i),
+            "restart after incremental checkpoint");
+
+    /* a restart forces the next checkpoint to rewrite the whole file */
+    init(g_d, g_i, 3);
+    GA_Copy(g_d, h_d);
+    GA_Copy(g_i, h_i);
+    GA_Checkpoint_arrays(g, 2, PATH);
+    GA_Zero(g_d);
+    GA_Zero(g_i);
+    GA_Restart_arrays(g, 2, PATH);
+    test_check(compare(g_d, g_i, h_d, h_i), "restart after full checkpoint");
+
+    GA_Sync();
+    sprintf(fname, "%s.%d", PATH, me);
+    unlink(fname);
+    GA_Destroy(h_i);
+    GA_Destroy(h_d);
+    GA_Destroy(g_i);
+    GA_Destroy(g_d);
+
+    test_finalize();
+    return 0;
+}
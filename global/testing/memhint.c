@@ -0,0 +1,152 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* memory hints for the local blocks of arrays: parsing of hint lists,
+ * including rejection of unknown hints, the default from GA_MEMORY_HINTS,
+ * hints set per array and inherited by duplicates, and the contents of
+ * arrays allocated with every hint */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "testutil.h"
+#include "../src/globalp.h"
+#include "../src/base.h"
+
+#define N 500
+
+#define HP GA_MEMHINT_HUGEPAGES
+#define BD GA_MEMHINT_BIND
+#define FT GA_MEMHINT_TOUCH
+
+static int me, nproc;
+
+static struct {
+    char *hints;
+    int flags;
+} cases[] = {
+    {"",                            0},
+    {"none",                        0},
+    {"hugepages",                   HP},
+    {"bind",                        BD},
+    {"first_touch",                 FT},
+    {"hugepages,bind,first_touch",  HP|BD|FT},
+    {" bind , first_touch,",        BD|FT},
+    {"hugepages bind",              HP|BD},
+    {"bind,,bind",                  BD},
+    {"hugepages,none",              0},
+    {"none,first_touch",            FT},
+    {"hugepage",                    -1},
+    {"hugepages,numa",              -1},
+    {"Bind",                        -1},
+    {"first-touch",                 -1},
+    {"first_touch_all_pages_of_the_array_now", -1},
+    {NULL,                          0}
+};
+
+static int flags_of(int g_a)
+{
+    return GA[GA_OFFSET + g_a].mem_hints;
+}
+
+/* every element of g_a is val */
+static void check_filled(int g_a, double val, const char *what)
+{
+    int lo[2], hi[2], ld[1], i, j, ok = 1;
+    double *ptr;
+
+    NGA_Distribution(g_a, me, lo, hi);
+    if (lo[0] < 0 || lo[0] > hi[0]) return;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    for (i=0; i<=hi[0]-lo[0]; i++)
+        for (j=0; j<=hi[1]-lo[1]; j++)
+            ok = ok && ptr[i*ld[0]+j] == val;
+    NGA_Release(g_a, lo, hi);
+    test_check(ok, what);
+}
+
+static void test_parse(void)
+{
+    int i;
+
+    for (i=0; cases[i].hints; i++) {
+        if (gai_parse_mem_hints(cases[i].hints) != cases[i].flags) {
+            printf("%d: hints \"%s\" parsed to %d, expected %d\n", me,
+                    cases[i].hints, gai_parse_mem_hints(cases[i].hints),
+                    cases[i].flags);
+            test_check(0, "parsing hints");
+        }
+    }
+    test_check(gai_parse_mem_hints(NULL) == 0, "parsing no hints");
+}
+
+/* arrays created with each valid list of hints, duplicated, filled and read
+ * back; remote access goes through the hinted memory too */
+static void test_arrays(void)
+{
+    int dims[2] = {N, N}, lo[2], hi[2], ld[1] = {1};
+    int g_a, g_b, i;
+    double val, x;
+
+    for (i=0; cases[i].hints; i++) {
+        if (cases[i].flags < 0) continue;
+        g_a = NGA_Create_handle();
+        NGA_Set_data(g_a, 2, dims, C_DBL);
+        NGA_Set_memory_hints(g_a, cases[i].hints);
+        test_check(flags_of(g_a) == cases[i].flags, "hints of a new array");
+        test_check(NGA_Allocate(g_a), "allocating an array with hints");
+        g_b = GA_Duplicate(g_a, "dup");
+        test_check(flags_of(g_b) == cases[i].flags, "hints of a duplicate");
+
+        val = 1.0 + i;
+        GA_Fill(g_a, &val);
+        GA_Copy(g_a, g_b);
+        GA_Sync();
+        check_filled(g_a, val, "array with hints");
+        check_filled(g_b, val, "duplicate with hints");
+
+        /* an element owned by the next process */
+        NGA_Distribution(g_a, (me + 1) % nproc, lo, hi);
+        if (lo[0] >= 0 && lo[0] <= hi[0]) {
+            NGA_Get(g_b, lo, lo, &x, ld);
+            test_check(x == val, "remote element");
+        }
+        GA_Sync();
+        GA_Destroy(g_b);
+        GA_Destroy(g_a);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int dims[2] = {N, N}, g_a;
+    double val = 3.0;
+
+    setenv("GA_MEMORY_HINTS", "hugepages,first_touch", 1);
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (me == 0) printf("Testing memory hints on %d processes\n", nproc);
+
+    test_parse();
+
+    /* the default, which hints set per array replace */
+    g_a = NGA_Create(C_DBL, 2, dims, "default", NULL);
+    test_check(flags_of(g_a) == (HP|FT), "default hints");
+    GA_Fill(g_a, &val);
+    GA_Sync();
+    check_filled(g_a, val, "array with default hints");
+    GA_Destroy(g_a);
+
+    test_arrays();
+
+    test_finalize();
+    return 0;
+}
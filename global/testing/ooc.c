@@ -0,0 +1,194 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* operations on out-of-core arrays, with a page cache small enough that the
+ * arrays do not fit in it */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "testutil.h"
+
+#define N     300
+#define M     500               /* N*M doubles do not fit in a 1 MB cache */
+#define NV    1000
+#define NINC  50
+
+static int me, nproc;
+
+static int create_ooc(int type, int *dims, char *name)
+{
+    int g_a = GA_Create_handle();
+    GA_Set_data(g_a, 2, dims, type);
+    GA_Set_array_name(g_a, name);
+    GA_Set_property(g_a, "out_of_core");
+    if (!GA_Allocate(g_a)) GA_Error("ooc: allocate failed", 0);
+    return g_a;
+}
+
+static double value(int i, int j)
+{
+    return (double)(i + j*N);
+}
+
+/* fill, then put/get of each process's patch and of the whole array */
+static void test_put_get(int g_a, double *buf)
+{
+    int lo[2], hi[2], ld[1], i, j, ok;
+    double val = 1.5;
+
+    GA_Fill(g_a, &val);
+    lo[0] = 0; lo[1] = 0; hi[0] = N-1; hi[1] = M-1; ld[0] = M;
+    NGA_Get(g_a, lo, hi, buf, ld);
+    for (i=0, ok=1; i<N*M; i++) ok = ok && buf[i] == 1.5;
+    test_check(ok, "fill");
+    GA_Sync();
+
+    NGA_Distribution(g_a, me, lo, hi);
+    if (lo[0] >= 0 && lo[0] <= hi[0]) {
+        ld[0] = hi[1] - lo[1] + 1;
+        for (i=lo[0]; i<=hi[0]; i++)
+            for (j=lo[1]; j<=hi[1]; j++)
+                buf[(i-lo[0])*ld[0] + j-lo[1]] = value(i, j);
+        NGA_Put(g_a, lo, hi, buf, ld);
+    }
+    GA_Sync();
+
+    lo[0] = 0; lo[1] = 0; hi[0] = N-1; hi[1] = M-1; ld[0] = M;
+    NGA_Get(g_a, lo, hi, buf, ld);
+    for (i=0, ok=1; i<N; i++)
+        for (j=0; j<M; j++) ok = ok && buf[i*M + j] == value(i, j);
+    test_check(ok, "put/get");
+    GA_Sync();
+}
+
+static void test_gather_scatter(int g_a)
+{
+    int *subs[NV], idx[NV][2], k, ok;
+    double v[NV], alpha = 2.0;
+
+    for (k=0; k<NV; k++) {
+        /* distinct elements on each process */
+        idx[k][0] = (k*nproc + me) % N;
+        idx[k][1] = (k*nproc + me) / N % M;
+        subs[k] = idx[k];
+    }
+    NGA_Gather(g_a, v, subs, NV);
+    for (k=0, ok=1; k<NV; k++) ok = ok && v[k] == value(idx[k][0],idx[k][1]);
+    test_check(ok, "gather");
+    GA_Sync();
+
+    for (k=0; k<NV; k++) v[k] = -value(idx[k][0], idx[k][1]);
+    NGA_Scatter(g_a, v, subs, NV);
+    GA_Sync();
+    for (k=0; k<NV; k++) v[k] = 1.0;
+    NGA_Scatter_acc(g_a, v, subs, NV, &alpha);
+    GA_Sync();
+    NGA_Gather(g_a, v, subs, NV);
+    for (k=0, ok=1; k<NV; k++)
+        ok = ok && v[k] == 2.0 - value(idx[k][0], idx[k][1]);
+    test_check(ok, "scatter/scatter_acc");
+    GA_Sync();
+}
+
+/* a patch that wraps around the upper corner of the array */
+static void test_periodic(int g_a)
+{
+    int lo[2] = {N-2, M-3}, hi[2] = {N+1, M+2}, ld[1] = {6};
+    double buf[4*6];
+    int i, j, ok;
+
+    for (i=0; i<N; i++) {
+        int plo[2] = {i, 0}, phi[2] = {i, M-1}, pld[1] = {M};
+        double row[M];
+        if (i % nproc != me) continue;
+        for (j=0; j<M; j++) row[j] = value(i, j);
+        NGA_Put(g_a, plo, phi, row, pld);
+    }
+    GA_Sync();
+    NGA_Periodic_get(g_a, lo, hi, buf, ld);
+    for (i=0, ok=1; i<4; i++)
+        for (j=0; j<6; j++)
+            ok = ok && buf[i*6 + j] == value((lo[0]+i) % N, (lo[1]+j) % M);
+    test_check(ok, "periodic get");
+    GA_Sync();
+}
+
+/* read_inc, and updates made under a mutex */
+static void test_counters(void)
+{
+    int dims[2] = {4, 4}, sub[2] = {1, 2}, lo[2] = {3, 3}, ld[1] = {1};
+    int g_c, i, val, dummy = 0;
+    long sum, total;
+
+    g_c = create_ooc(C_INT, dims, "counters");
+    GA_Zero(g_c);
+    for (i=0, sum=0; i<NINC; i++) sum += NGA_Read_inc(g_c, sub, 1);
+    GA_Sync();
+    NGA_Get(g_c, sub, sub, &val, ld);
+    test_check(val == nproc*NINC, "read_inc total");
+    /* every value 0..nproc*NINC-1 was returned exactly once */
+    total = sum;
+    GA_Lgop(&total, 1, "+");
+    test_check(total == (long)nproc*NINC*(nproc*NINC-1)/2, "read_inc values");
+    GA_Sync();
+
+    if (!GA_Create_mutexes(1)) GA_Error("ooc: create mutexes failed", 0);
+    for (i=0; i<NINC; i++) {
+        GA_Lock(0);
+        NGA_Get(g_c, lo, lo, &val, ld);
+        val++;
+        NGA_Put(g_c, lo, lo, &val, ld);
+        GA_Unlock(0);
+    }
+    GA_Sync();
+    NGA_Get(g_c, lo, lo, &val, ld);
+    test_check(val == nproc*NINC, "lock/unlock");
+    GA_Destroy_mutexes();
+    GA_Sync();
+
+    /* a fence makes a put visible without a sync; GA_Igop only orders the
+     * processes */
+    if (me == 0) {
+        val = 42;
+        GA_Init_fence();
+        NGA_Put(g_c, lo, lo, &val, ld);
+        GA_Fence();
+    }
+    GA_Igop(&dummy, 1, "+");
+    NGA_Get(g_c, lo, lo, &val, ld);
+    test_check(val == 42, "fence");
+    GA_Destroy(g_c);
+}
+
+int main(int argc, char **argv)
+{
+    int dims[2] = {N, M}, g_a;
+    double *buf;
+
+    setenv("GA_OOC_CACHE_MB", "1", 1);
+    setenv("GA_OOC_PAGE_KB", "4", 1);
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (me == 0) printf("Testing out-of-core arrays on %d processes\n", nproc);
+
+    buf = (double*)malloc(sizeof(double)*N*M);
+    g_a = create_ooc(C_DBL, dims, "ooc");
+    test_put_get(g_a, buf);
+    test_gather_scatter(g_a);
+    test_periodic(g_a);
+    GA_Destroy(g_a);
+    free(buf);
+    test_counters();
+
+    test_finalize();
+    return 0;
+}
@@ -0,0 +1,186 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* reuse of the memory of destroyed arrays with GA_ARRAY_POOL: contents of
+ * arrays created and duplicated from pooled memory, arrays on a subgroup,
+ * eviction from a full pool, and destroying a group or terminating with
+ * memory still in the pool */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "testutil.h"
+
+#define POOL  2
+#define N     200
+#define NITER 20
+
+static int me, nproc;
+
+/* address of the local block of g_a on process proc of its group */
+static void *local_ptr(int g_a, int proc)
+{
+    int lo[2], hi[2], ld[1];
+    void *ptr = NULL;
+
+    NGA_Distribution(g_a, proc, lo, hi);
+    if (lo[0] < 0 || lo[0] > hi[0]) return NULL;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    NGA_Release(g_a, lo, hi);
+    return ptr;
+}
+
+/* every element of the local block of g_a is val */
+static int filled(int g_a, int proc, double val)
+{
+    int lo[2], hi[2], ld[1], type, ndim, dims[2], i, j, ok = 1;
+    void *ptr;
+
+    NGA_Inquire(g_a, &type, &ndim, dims);
+    NGA_Distribution(g_a, proc, lo, hi);
+    if (lo[0] < 0 || lo[0] > hi[0]) return 1;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    for (i=0; i<=hi[0]-lo[0]; i++)
+        for (j=0; j<=hi[1]-lo[1]; j++) {
+            if (type == C_DBL) ok = ok && ((double*)ptr)[i*ld[0]+j] == val;
+            else ok = ok && ((int*)ptr)[i*ld[0]+j] == (int)val;
+        }
+    NGA_Release(g_a, lo, hi);
+    return ok;
+}
+
+static void fill(int g_a, double val)
+{
+    int type, ndim, dims[2], ival = (int)val;
+
+    NGA_Inquire(g_a, &type, &ndim, dims);
+    if (type == C_DBL) GA_Fill(g_a, &val);
+    else GA_Fill(g_a, &ival);
+}
+
+/* arrays of two sizes created, duplicated and destroyed in a loop, so that
+ * most of them are built from pooled memory */
+static void test_cycles(void)
+{
+    int dims[2] = {N, N}, sdims[2] = {N, 3*N/4};
+    int g_a, g_b, g_c, it;
+
+    for (it=0; it<NITER; it++) {
+        g_a = NGA_Create(C_DBL, 2, dims, "a", NULL);
+        fill(g_a, it);
+        g_b = GA_Duplicate(g_a, "b");
+        fill(g_b, -it);
+        g_c = NGA_Create(C_DBL, 2, sdims, "c", NULL);
+        fill(g_c, 0.5*it);
+        GA_Sync();
+        test_check(filled(g_a, me, it), "created array");
+        test_check(filled(g_b, me, -it), "duplicated array");
+        test_check(filled(g_c, me, 0.5*it), "smaller array");
+        GA_Sync();
+        if (it % 2) {
+            GA_Destroy(g_a);
+            GA_Destroy(g_b);
+            GA_Destroy(g_c);
+        } else {
+            GA_Destroy(g_c);
+            GA_Destroy(g_b);
+            GA_Destroy(g_a);
+        }
+    }
+}
+
+/* of three destroyed arrays the pool keeps the last two, which the next two
+ * arrays reuse in the order they were destroyed */
+static void test_eviction(void)
+{
+    int dims[2] = {N, N}, g[3], h[3], i;
+    void *ptr[3];
+
+    for (i=0; i<3; i++) {
+        g[i] = NGA_Create(C_INT, 2, dims, "g", NULL);
+        ptr[i] = local_ptr(g[i], me);
+    }
+    for (i=0; i<3; i++) GA_Destroy(g[i]);
+
+    h[0] = NGA_Create(C_INT, 2, dims, "h0", NULL);
+    h[1] = GA_Duplicate(h[0], "h1");
+    h[2] = NGA_Create(C_INT, 2, dims, "h2", NULL);
+    test_check(local_ptr(h[0], me) == ptr[1],
+            "reuse of the oldest kept segment");
+    test_check(local_ptr(h[1], me) == ptr[2], "reuse by a duplicate");
+    for (i=0; i<3; i++) fill(h[i], 10 + i);
+    GA_Sync();
+    for (i=0; i<3; i++) test_check(filled(h[i], me, 10 + i), "reused contents");
+    GA_Sync();
+    for (i=0; i<3; i++) GA_Destroy(h[i]);
+}
+
+/* arrays on a group of the first half of the processes (at least two); the
+ * group is destroyed with memory in its pool, then another one is left for
+ * GA_Terminate */
+static void test_subgroup(void)
+{
+    int dims[2] = {N, N}, *plist, n, i, p, q, gme;
+    int g_a, g_b, g_c;
+    void *ptr;
+
+    plist = (int*)malloc(nproc*sizeof(int));
+    n = (nproc/2 < 2) ? 2 : nproc/2;
+    if (n > nproc) n = nproc;
+    for (i=0; i<n; i++) plist[i] = i;
+
+    for (q=0; q<2; q++) {
+        p = GA_Pgroup_create(plist, n);
+        if (me < n) {
+            gme = GA_Pgroup_nodeid(p);
+            g_a = NGA_Create_config(C_DBL, 2, dims, "sub a", NULL, p);
+            ptr = local_ptr(g_a, gme);
+            GA_Destroy(g_a);
+            g_b = NGA_Create_config(C_DBL, 2, dims, "sub b", NULL, p);
+            test_check(local_ptr(g_b, gme) == ptr, "reuse on a group");
+            fill(g_b, 7.0);
+            g_c = GA_Duplicate(g_b, "sub c");
+            fill(g_c, 8.0);
+            GA_Pgroup_sync(p);
+            test_check(filled(g_b, gme, 7.0), "array on a group");
+            test_check(filled(g_c, gme, 8.0), "duplicate on a group");
+            GA_Pgroup_sync(p);
+            GA_Destroy(g_c);
+            GA_Destroy(g_b);
+        }
+        GA_Sync();
+        if (q == 0) GA_Pgroup_destroy(p);
+    }
+    free(plist);
+}
+
+int main(int argc, char **argv)
+{
+    int dims[2] = {N, N}, g_a;
+    char pool[16];
+
+    sprintf(pool, "%d", POOL);
+    setenv("GA_ARRAY_POOL", pool, 1);
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (me == 0) printf("Testing the array pool on %d processes\n", nproc);
+
+    test_cycles();
+    test_eviction();
+    test_subgroup();
+
+    /* leave memory in the pool of the world group too */
+    g_a = NGA_Create(C_DBL, 2, dims, "last", NULL);
+    GA_Destroy(g_a);
+
+    test_finalize();
+    return 0;
+}
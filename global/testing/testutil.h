@@ -2,3 +2,6 @@
 /* extern void new_range(int ndim, int dims[], int lo[], int hi[], int new_lo[], int new_hi[]); */
 extern void print_subscript(char *pre,int ndim, int subscript[], char* post);
 /* extern void print_distribution(int g_a); */
+extern void test_init(int *argc, char ***argv);
+extern void test_finalize(void);
+extern void test_check(int ok, const char *what);
@@ -0,0 +1,88 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* ga_malloc/ga_free called concurrently from OpenMP threads: the main
+ * thread allocates from the MA stack while the others use their arenas,
+ * or malloc once the few arenas made available here are taken */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if defined(_OPENMP)
+#   include "omp.h"
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "mp3.h"
+#include "../src/globalp.h"
+
+#define NITER  1000
+#define NDEPTH 8
+#define BIG    (1<<20)   /* doubles; larger than the default arena */
+
+static int me;
+
+static void check(int ok, const char *what, int thread)
+{
+    if (!ok) {
+        printf("%d: thread %d: %s failed\n", me, thread, what);
+        GA_Error("thread_malloc: check failed", 0);
+    }
+}
+
+/* nested allocations of various sizes, freed in reverse order */
+static void work(int thread)
+{
+    double *buf[NDEPTH];
+    Integer len[NDEPTH];
+    int it, d, i;
+
+    for (it = 0; it < NITER; it++) {
+        for (d = 0; d < NDEPTH; d++) {
+            len[d] = 1 + (it*7 + d*131 + thread*17) % 5000;
+            if (d == NDEPTH-1 && it % 100 == 0) len[d] = BIG;
+            buf[d] = (double*)ga_malloc(len[d], MT_F_DBL, "thread_malloc");
+            check(((unsigned long)buf[d]) % sizeof(DoubleComplex) == 0,
+                  "alignment", thread);
+            for (i = 0; i < len[d]; i++) buf[d][i] = thread + d;
+        }
+        for (d = NDEPTH-1; d >= 0; d--) {
+            check(buf[d][0] == thread + d && buf[d][len[d]-1] == thread + d,
+                  "contents", thread);
+            ga_free(buf[d]);
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int nthread = 1;
+
+    setenv("GA_THREAD_ARENAS", "2", 0);
+    MP_INIT(argc,argv);
+    GA_Initialize();
+    if (!MA_init(MT_F_DBL, 100000, 4*BIG + 8*(1<<20))) {
+        GA_Error("MA_init failed", 0);
+    }
+    me = GA_Nodeid();
+#if defined(_OPENMP)
+    nthread = omp_get_max_threads();
+#endif
+    if (me == 0) printf("Testing ga_malloc from %d threads\n", nthread);
+
+    work(0);
+#if defined(_OPENMP)
+#   pragma omp parallel
+    work(omp_get_thread_num());
+#endif
+    GA_Sync();
+    if (me == 0) printf("\nSuccessfull\n\n");
+    GA_Terminate();
+    MP_FINALIZE();
+    return 0;
+}
@@ -462,3 +462,29 @@ void FATR set_ma_use_armci_mem_()
 #endif          
        GA_Error("setenv failed: insufficient space in the environment",1);
 }
+
+/* MPI, GA and an MA stack and heap of 100000 doubles each, for the C tests
+ * that need nothing else */
+void test_init(int *argc, char ***argv)
+{
+    MP_INIT(*argc,*argv);
+    GA_Initialize();
+    if (!MA_init(MT_F_DBL, 100000, 100000)) GA_Error("MA_init failed", 0);
+}
+
+/* report success on process 0 and shut down what test_init started */
+void test_finalize(void)
+{
+    if (GA_Nodeid() == 0) printf("No errors detected\n");
+    GA_Terminate();
+    MP_FINALIZE();
+}
+
+/* a failed check names itself on the process that saw it and aborts all */
+void test_check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("%d: %s: failure detected\n", GA_Nodeid(), what);
+        GA_Error("check failed", 0);
+    }
+}
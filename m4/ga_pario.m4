@@ -80,6 +80,12 @@ if test x$NOAIO != x ; then
   PARIO_CPPFLAGS="$PARIO_CPPFLAGS -DNOAIO"
 fi
 
+dnl on Linux without USE_LINUXAIO asynchronous requests are served by a pool
+dnl of I/O threads; define NOTHREADAIO to fall back to blocking I/O
+if test x$NOTHREADAIO != x ; then
+  PARIO_CPPFLAGS="$PARIO_CPPFLAGS -DNOTHREADAIO"
+fi
+
 if test x$PABLO != x ; then
   PARIO_CPPFLAGS="$PARIO_CPPFLAGS -DPABLO"
 fi
@@ -0,0 +1,195 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/*
+ * Latency of MA_allocate_heap/MA_free_heap on a fragmented heap,
+ * compared with malloc/free doing the same sequence of requests.
+ *
+ * usage: bench-heap [iterations]
+ *
+ * For each number of live blocks, the heap is first filled with that
+ * many blocks of random datatype and length, then each iteration frees
+ * a random live block and allocates a new one in its place.  Freed
+ * blocks are checked for the fill pattern written at allocation.
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#include <string.h>
+#include <time.h>
+#include "macdecls.h"
+
+#define MAXLIVE   16384
+#define MAXBYTES  4096
+#define NTYPES    4
+
+static Integer types[NTYPES] = {MT_CHAR, MT_INT, MT_DBL, MT_DCPL};
+static int sizes[NTYPES] = {1, sizeof(int), sizeof(double), 2*sizeof(double)};
+
+static Integer handle[MAXLIVE];
+static void *pointer[MAXLIVE];
+static int length[MAXLIVE];
+static int type[MAXLIVE];
+
+static unsigned long seed;
+
+static int rnd(int n)
+{
+    seed = seed * 1103515245UL + 12345UL;
+    return (int)((seed >> 16) % (unsigned long)n);
+}
+
+/* random request of up to MAXBYTES bytes, mostly small */
+static void request(int i)
+{
+    int bytes = rnd(4) ? 8 + rnd(256) : 8 + rnd(MAXBYTES);
+
+    type[i] = rnd(NTYPES);
+    length[i] = bytes / sizes[type[i]] + 1;
+}
+
+static int ma_alloc(int i)
+{
+    if (!MA_allocate_heap(types[type[i]], length[i], "bench", &handle[i]))
+        return 0;
+    if (!MA_get_pointer(handle[i], &pointer[i]))
+        return 0;
+    memset(pointer[i], i & 0xff, (size_t)length[i] * sizes[type[i]]);
+    return 1;
+}
+
+static int ma_free(int i)
+{
+    unsigned char *p = (unsigned char *)pointer[i];
+
+    if (p[0] != (i & 0xff)
+            || p[(size_t)length[i] * sizes[type[i]] - 1] != (i & 0xff))
+    {
+        (void)fprintf(stderr, "block %d overwritten\n", i);
+        return 0;
+    }
+    return MA_free_heap(handle[i]);
+}
+
+/* returns seconds per alloc/free pair, or -1 upon failure */
+static double run_ma(int nlive, int iterations)
+{
+    clock_t start;
+    Integer avail;
+    int i, it;
+
+    avail = MA_inquire_heap(MT_CHAR);
+    seed = 1;
+    for (i = 0; i < nlive; i++)
+    {
+        request(i);
+        if (!ma_alloc(i)) return -1.0;
+    }
+    /* free every other block to fragment the heap */
+    for (i = 0; i < nlive; i += 2)
+        if (!ma_free(i)) return -1.0;
+    for (i = 0; i < nlive; i += 2)
+    {
+        request(i);
+        if (!ma_alloc(i)) return -1.0;
+    }
+
+    start = clock();
+    for (it = 0; it < iterations; it++)
+    {
+        i = rnd(nlive);
+        if (!ma_free(i)) return -1.0;
+        request(i);
+        if (!ma_alloc(i)) return -1.0;
+    }
+    start = clock() - start;
+
+#ifdef VERIFY
+    if (!MA_verify_allocator_stuff()) return -1.0;
+#endif /* VERIFY */
+    for (i = 0; i < nlive; i++)
+        if (!ma_free(i)) return -1.0;
+
+    /* all blocks freed and coalesced back into the free space */
+    if (MA_inquire_heap(MT_CHAR) != avail)
+    {
+        (void)fprintf(stderr, "heap space %ld after the run, %ld before\n",
+            (long)MA_inquire_heap(MT_CHAR), (long)avail);
+        return -1.0;
+    }
+
+    return (double)start / CLOCKS_PER_SEC / iterations;
+}
+
+static double run_malloc(int nlive, int iterations)
+{
+    clock_t start;
+    int i, it;
+
+    seed = 1;
+    for (i = 0; i < nlive; i++)
+    {
+        request(i);
+        pointer[i] = malloc((size_t)length[i] * sizes[type[i]]);
+    }
+    for (i = 0; i < nlive; i += 2)
+    {
+        free(pointer[i]);
+        request(i);
+        pointer[i] = malloc((size_t)length[i] * sizes[type[i]]);
+    }
+
+    start = clock();
+    for (it = 0; it < iterations; it++)
+    {
+        i = rnd(nlive);
+        free(pointer[i]);
+        request(i);
+        pointer[i] = malloc((size_t)length[i] * sizes[type[i]]);
+    }
+    start = clock() - start;
+
+    for (i = 0; i < nlive; i++)
+        free(pointer[i]);
+
+    return (double)start / CLOCKS_PER_SEC / iterations;
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 100000;
+    int nlive;
+    double t_ma, t_malloc;
+
+    if (argc > 1)
+        iterations = atoi(argv[1]);
+
+    /* room for MAXLIVE blocks of MAXBYTES, plus overhead */
+    if (!MA_init(MT_CHAR, 0, (Integer)MAXLIVE * (MAXBYTES + 1024)))
+    {
+        (void)fprintf(stderr, "MA_init failed; punting\n");
+        exit(1);
+    }
+
+    (void)printf("%10s %20s %20s\n",
+        "live", "MA alloc+free (ns)", "malloc+free (ns)");
+    for (nlive = 64; nlive <= MAXLIVE; nlive *= 4)
+    {
+        t_ma = run_ma(nlive, iterations);
+        if (t_ma < 0.0)
+        {
+            (void)fprintf(stderr, "MA failed with %d live blocks\n", nlive);
+            exit(1);
+        }
+        t_malloc = run_malloc(nlive, iterations);
+        (void)printf("%10d %20.1f %20.1f\n", nlive, t_ma*1e9, t_malloc*1e9);
+    }
+
+    MA_print_stats(MA_FALSE);
+    return 0;
+}
@@ -59,6 +59,13 @@ extern void* ARMCI_Malloc_local(long bytes);
  * AD); and two gaps, each zero or more bytes long, to satisfy
  * alignment constraints (specifically, to ensure that AD and
  * client_space are aligned properly).
+ *
+ * Heap blocks not in use are kept on segregated free lists, one per
+ * size class.  Size classes split each power of two into SL_COUNT
+ * equal ranges, and bitmaps record which lists are nonempty, so that
+ * a block big enough for a request is found without searching.  Each
+ * heap block also points to its left neighbor, so that a deallocated
+ * block is merged with adjacent free blocks in constant time.
  */
 
 /**
@@ -105,6 +112,14 @@ extern void* ARMCI_Malloc_local(long bytes);
 #define MINBLOCKSIZE mai_round((long)(ALIGNMENT + BLOCK_OVERHEAD_FIXED), \
         (ulongi)ALIGNMENT)
 
+/* size classes of the heap free lists */
+#define SL_LOG2  3
+#define SL_COUNT (1 << SL_LOG2)               /* ranges per power of two */
+#define FL_COUNT ((int)(8 * sizeof(ulongi)))  /* powers of two */
+
+/* datatype of blocks on the heap free lists */
+#define FREE_BLOCK (Integer)-1
+
 /* signatures for guard words */
 #define GUARD1 (Guard)0xaaaaaaaa /* start signature */
 #define GUARD2 (Guard)0x55555555 /* stop signature */
@@ -132,6 +147,8 @@ typedef struct _AD
     Pointer     client_space;      /* start of client space */
     ulongi      nbytes;            /* total # of bytes */
     struct _AD *next;              /* AD in linked list */
+    struct _AD *prev;              /* AD in doubly linked heap lists */
+    struct _AD *left;              /* adjacent heap block at lower address */
     ulongi      checksum;          /* of AD */
 } AD;
 
@@ -150,12 +167,15 @@ typedef enum
 
 private Boolean ad_big_enough(AD *ad, Pointer ar);
 private Boolean ad_eq(AD *ad, Pointer ad_target);
-private Boolean ad_gt(AD *ad, Pointer ad_target);
+private Boolean ad_in_heap(AD *ad);
 private Boolean ad_le(AD *ad, Pointer ad_target);
-private Boolean ad_lt(AD *ad, Pointer ad_target);
 private void ad_print(AD *ad, char *block_type);
 private void balloc_after(AR *ar, Pointer address, Pointer *client_space, ulongi *nbytes);
 private void balloc_before(AR *ar, Pointer address, Pointer *client_space, ulongi *nbytes);
+private void bin_delete(AD *ad);
+private void bin_insert(AD *ad);
+private void bin_map(ulongi nbytes, int *fl, int *sl);
+private AD *bin_search(AR *ar);
 private void block_free_heap(AD *ad);
 private AD *block_split(AD *ad, ulongi bytes_needed, Boolean insert_free);
 private ulongi checksum(AD *ad);
@@ -164,14 +184,14 @@ private ulongi checksum(AD *ad);
 private void debug_ad_print(AD *ad);
 #endif /* DEBUG */
 
+private void dlist_delete(AD *ad, AD **list);
+private void dlist_insert(AD *ad, AD **list);
 private Boolean guard_check(AD *ad);
 private void guard_set(AD *ad);
-private void list_coalesce(AD *list);
 private AD *list_delete(AD *ad, AD **list);
 private int list_delete_many(AD **list, Boolean (*pred)(), Pointer closure, void (*action)());
 private AD *list_delete_one(AD **list, Boolean (*pred)(), Pointer closure);
 private void list_insert(AD *ad, AD **list);
-private void list_insert_ordered(AD *ad, AD **list, Boolean (*pred)());
 private Boolean list_member(AD *ad, AD *list);
 private int list_print(AD *list, char *block_type, int index_base);
 private void list_verify(AD *list, char *block_type, char *preamble, int *blocks, int *bad_blocks, int *bad_checksums, int *bad_lguards, int *bad_rguards);
@@ -180,6 +200,8 @@ private Integer ma_nelem(Pointer address, ulongi length, Integer datatype);
 private void ma_preinitialize(char *caller);
 private Boolean mh2ad(Integer memhandle, AD **adout, BlockLocation location, char *caller);
 private void mh_free(AD *ad);
+private int mai_ffs(ulongi value);
+private int mai_fls(ulongi value);
 private long mai_round(long value, ulongi unit);
 private void str_ncopy(char *to, char *from, int maxchars);
 
@@ -284,7 +306,10 @@ private Pointer ma_eos;       /* end of segment */
 private Pointer ma_hp;        /* heap pointer */
 private Pointer ma_sp;        /* stack pointer */
 
-private AD *ma_hfree;         /* free list for heap */
+private AD *ma_hbins[FL_COUNT][SL_COUNT]; /* free lists for heap */
+private ulongi ma_hfl_map;                /* nonempty rows of ma_hbins */
+private unsigned int ma_hsl_map[FL_COUNT];/* nonempty lists per row */
+private AD *ma_htop;          /* rightmost block in heap */
 private AD *ma_hused;         /* used list for heap */
 private AD *ma_sused;         /* used list for stack */
 
@@ -442,6 +467,8 @@ typedef struct
     ulongi    sblocks_max;       /* max # of stack blocks */
     ulongi    sbytes;            /* current # of stack bytes */
     ulongi    sbytes_max;        /* max # of stack bytes */
+    ulongi    hfrags;            /* current # of heap free list blocks */
+    ulongi    hfrags_max;        /* max # of heap free list blocks */
     ulongi    calls[NUMROUTINES];/* # of calls to each routine */
 } Stats;
 
@@ -541,15 +568,16 @@ private Boolean ad_eq(ad, ad_target)
 
 /* ------------------------------------------------------------------------- */
 /*
- * Return MA_TRUE if ad > ad_target, else return MA_FALSE.
+ * Return MA_TRUE if ad is a block in use in the heap region, else
+ * return MA_FALSE.
  */
 /* ------------------------------------------------------------------------- */
 
-private Boolean ad_gt(ad, ad_target)
+private Boolean ad_in_heap(ad)
     AD        *ad;        /* the AD to test */
-    Pointer    ad_target;    /* the AD to match */
 {
-    return (ad > (AD *)ad_target) ? MA_TRUE : MA_FALSE;
+    return (((Pointer)ad >= ma_segment) && ((Pointer)ad < ma_hp)
+        && (ad->datatype != FREE_BLOCK)) ? MA_TRUE : MA_FALSE;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -565,19 +593,6 @@ private Boolean ad_le(ad, ad_target)
     return (ad <= (AD *)ad_target) ? MA_TRUE : MA_FALSE;
 }
 
-/* ------------------------------------------------------------------------- */
-/*
- * Return MA_TRUE if ad < ad_target, else return MA_FALSE.
- */
-/* ------------------------------------------------------------------------- */
-
-private Boolean ad_lt(ad, ad_target)
-    AD        *ad;        /* the AD to test */
-    Pointer    ad_target;    /* the AD to match */
-{
-    return (ad < (AD *)ad_target) ? MA_TRUE : MA_FALSE;
-}
-
 /* ------------------------------------------------------------------------- */
 /*
  * Print identifying information about the given AD to stdout.
@@ -834,53 +849,190 @@ private void balloc_before(ar, address, client_space, nbytes)
 
 /* ------------------------------------------------------------------------- */
 /*
- * Reclaim the given block by updating ma_hp and ma_hfree.
+ * Delete ad from its heap free list.
  */
 /* ------------------------------------------------------------------------- */
 
-private void block_free_heap(ad)
-    AD        *ad;        /* AD to free */
+private void bin_delete(ad)
+    AD        *ad;        /* AD to delete */
 {
-    AD        *ad2;        /* traversal pointer */
-    AD        *max_ad;    /* rightmost AD */
+    int        fl, sl;        /* size class of ad */
 
-    /* find rightmost heap block */
-    for (max_ad = (AD *)NULL, ad2 = ma_hused; ad2; ad2 = ad2->next)
+    bin_map(ad->nbytes, &fl, &sl);
+    dlist_delete(ad, &ma_hbins[fl][sl]);
+
+    /* clear the bitmaps if the list became empty */
+    if (ma_hbins[fl][sl] == (AD *)NULL)
     {
-        if (ad2 > max_ad)
-            max_ad = ad2;
+        ma_hsl_map[fl] &= ~(1U << sl);
+        if (ma_hsl_map[fl] == 0)
+            ma_hfl_map &= ~((ulongi)1 << fl);
     }
 
-    if (max_ad)
-    {
-        /* at least 1 block is in use */
+#ifdef STATS
+    ma_stats.hfrags--;
+#endif /* STATS */
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ * Mark ad free and insert it in the heap free list of its size class.
+ */
+/* ------------------------------------------------------------------------- */
+
+private void bin_insert(ad)
+    AD        *ad;        /* AD to insert */
+{
+    int        fl, sl;        /* size class of ad */
+
+    ad->datatype = FREE_BLOCK;
+    bin_map(ad->nbytes, &fl, &sl);
+    dlist_insert(ad, &ma_hbins[fl][sl]);
+    ma_hsl_map[fl] |= (1U << sl);
+    ma_hfl_map |= ((ulongi)1 << fl);
 
-        /* set ma_hp to first address past end of max_ad */
-        ma_hp = (Pointer)max_ad + max_ad->nbytes;
+#ifdef STATS
+    ma_stats.hfrags++;
+    ma_stats.hfrags_max = max(ma_stats.hfrags, ma_stats.hfrags_max);
+#endif /* STATS */
+}
 
-        /* delete any free list blocks that are no longer in heap region */
-        (void)list_delete_many(
-            &ma_hfree,
-            ad_gt,
-            (Pointer)max_ad,
-            (void (*)())NULL);
+/* ------------------------------------------------------------------------- */
+/*
+ * Compute the size class of a block of nbytes bytes: fl is the position
+ * of the highest bit of nbytes and sl the value of the SL_LOG2 bits
+ * below it.
+ */
+/* ------------------------------------------------------------------------- */
+
+private void bin_map(nbytes, fl, sl)
+    ulongi    nbytes;        /* length of block */
+    int        *fl;        /* RETURN: power of two */
+    int        *sl;        /* RETURN: range within power of two */
+{
+    *fl = mai_fls(nbytes);
+    if (*fl < SL_LOG2)
+        *sl = 0;
+    else
+        *sl = (int)(nbytes >> (*fl - SL_LOG2)) - SL_COUNT;
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ * Delete and return a heap free list block that can satisfy ar, after
+ * performing any splitting (see ad_big_enough).  If there is no such
+ * block, return NULL.
+ */
+/* ------------------------------------------------------------------------- */
+
+private AD *bin_search(ar)
+    AR        *ar;        /* allocation request */
+{
+    ulongi    nbytes;        /* upper bound on length of block for ar */
+    ulongi    map;        /* bitmap of candidate lists */
+    int        fl, sl;        /* size class */
+    AD        *ad;        /* traversal pointer */
+    Pointer    client_space;    /* location of client_space */
 
-        /* if ad is in the heap region, add it to free list */
-        if (ad < max_ad)
+    /* the gaps of balloc_after depend on where the block starts */
+    nbytes = ar->nelem * ma_sizeof[ar->datatype]
+        + BLOCK_OVERHEAD_FIXED
+        + ma_sizeof[ar->datatype]
+        + ALIGNMENT;
+    if (ma_numalign > 0)
+        nbytes += ((ulongi)1 << ma_numalign);
+
+    /*
+     * Every block in a class above the one containing nbytes is big
+     * enough, so take the first block of the smallest nonempty such
+     * class.
+     */
+
+    bin_map(nbytes, &fl, &sl);
+    if (fl >= SL_LOG2)
+    {
+        bin_map(nbytes + ((ulongi)1 << (fl - SL_LOG2)) - 1, &fl, &sl);
+    }
+    map = (sl < SL_COUNT - 1) ? (ma_hsl_map[fl] & (~0U << (sl + 1))) : 0;
+    if (map == 0)
+    {
+        map = (fl < FL_COUNT - 1) ? (ma_hfl_map & (~(ulongi)0 << (fl + 1))) : 0;
+        if (map)
         {
-            list_insert_ordered(ad, &ma_hfree, ad_lt);
-            list_coalesce(ma_hfree);
+            fl = mai_ffs(map);
+            map = ma_hsl_map[fl];
         }
     }
-    else
+    if (map)
     {
-        /* no blocks are in use */
+        sl = mai_ffs(map);
+        ad = ma_hbins[fl][sl];
+        bin_delete(ad);
+        if (ad_big_enough(ad, (Pointer)ar))
+            return ad;
+        bin_insert(ad);
+    }
 
-        /* set ma_hp to start of segment */
-        ma_hp = ma_segment;
+    /* otherwise search the class containing nbytes */
+    bin_map(nbytes, &fl, &sl);
+    for (ad = ma_hbins[fl][sl]; ad; ad = ad->next)
+    {
+        /* perform trial allocation to determine size */
+        balloc_after(ar, (Pointer)ad, &client_space, &nbytes);
+        if (nbytes <= ad->nbytes)
+        {
+            bin_delete(ad);
+            (void)ad_big_enough(ad, (Pointer)ar);
+            return ad;
+        }
+    }
+
+    /* failure */
+    return (AD *)NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ * Reclaim the given block by merging it with free neighbors and either
+ * putting it on a heap free list or, if it is the rightmost block,
+ * lowering ma_hp.
+ */
+/* ------------------------------------------------------------------------- */
 
-        /* clear the free list */
-        ma_hfree = (AD *)NULL;
+private void block_free_heap(ad)
+    AD        *ad;        /* AD to free */
+{
+    AD        *ad2;        /* neighbor of ad */
+
+    /* merge with right neighbor if it is free */
+    ad2 = (AD *)((Pointer)ad + ad->nbytes);
+    if (((Pointer)ad2 < ma_hp) && (ad2->datatype == FREE_BLOCK))
+    {
+        bin_delete(ad2);
+        ad->nbytes += ad2->nbytes;
+    }
+
+    /* merge with left neighbor if it is free */
+    ad2 = ad->left;
+    if (ad2 && (ad2->datatype == FREE_BLOCK))
+    {
+        bin_delete(ad2);
+        ad2->nbytes += ad->nbytes;
+        ad = ad2;
+    }
+
+    ad2 = (AD *)((Pointer)ad + ad->nbytes);
+    if ((Pointer)ad2 < ma_hp)
+    {
+        /* ad is inside the heap region; add it to free list */
+        ad2->left = ad;
+        bin_insert(ad);
+    }
+    else
+    {
+        /* ad is rightmost; its left neighbor (if any) is in use */
+        ma_hp = (Pointer)ad;
+        ma_htop = ad->left;
     }
 }
 
@@ -913,10 +1065,17 @@ private AD *block_split(ad, bytes_needed, insert_free)
         /* set the length of ad2 */
         ad2->nbytes = bytes_extra;
 
+        /* link ad2 between ad and its right neighbor */
+        ad2->left = ad;
+        if ((Pointer)ad2 + bytes_extra < ma_hp)
+            ((AD *)((Pointer)ad2 + bytes_extra))->left = ad2;
+        else if (ad == ma_htop)
+            ma_htop = ad2;
+
         if (insert_free)
         {
             /* insert ad2 into free list */
-            list_insert_ordered(ad2, &ma_hfree, ad_lt);
+            bin_insert(ad2);
         }
 
         /* set the length of ad */
@@ -967,7 +1126,7 @@ private ulongi checksum(ad)
 private void debug_ad_print(ad)
     AD        *ad;        /* the AD to print */
 {
-#define NUMADFIELDS 7
+#define NUMADFIELDS 9
 
     char    *fn[NUMADFIELDS];    /* field names */
     long    fa[NUMADFIELDS];    /* field addresses */
@@ -981,7 +1140,9 @@ private void debug_ad_print(ad)
     fn[3] = "client_space";
     fn[4] = "nbytes";
     fn[5] = "next";
-    fn[6] = "checksum";
+    fn[6] = "prev";
+    fn[7] = "left";
+    fn[8] = "checksum";
 
     /* set field addresses */
     fa[0] = (long)(&(ad->datatype));
@@ -990,7 +1151,9 @@ private void debug_ad_print(ad)
     fa[3] = (long)(&(ad->client_space));
     fa[4] = (long)(&(ad->nbytes));
     fa[5] = (long)(&(ad->next));
-    fa[6] = (long)(&(ad->checksum));
+    fa[6] = (long)(&(ad->prev));
+    fa[7] = (long)(&(ad->left));
+    fa[8] = (long)(&(ad->checksum));
 
     /* print AD fields to stderr */
     (void)fprintf(stderr, "debug_ad_print:\n");
@@ -1027,6 +1190,42 @@ private void debug_ad_print(ad)
 
 #endif /* DEBUG */
 
+/* ------------------------------------------------------------------------- */
+/*
+ * Delete ad from the doubly linked list.
+ */
+/* ------------------------------------------------------------------------- */
+
+private void dlist_delete(ad, list)
+    AD        *ad;        /* the AD to delete */
+    AD        **list;        /* the list to delete from */
+{
+    if (ad->prev)
+        ad->prev->next = ad->next;
+    else
+        *list = ad->next;
+    if (ad->next)
+        ad->next->prev = ad->prev;
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ * Insert ad into the doubly linked list.
+ */
+/* ------------------------------------------------------------------------- */
+
+private void dlist_insert(ad, list)
+    AD        *ad;        /* the AD to insert */
+    AD        **list;        /* the list to insert into */
+{
+    /* push ad onto list */
+    ad->prev = (AD *)NULL;
+    ad->next = *list;
+    if (*list)
+        (*list)->prev = ad;
+    *list = ad;
+}
+
 /* ------------------------------------------------------------------------- */
 /*
  * Return MA_TRUE if the guards associated with ad contain valid signatures,
@@ -1075,40 +1274,6 @@ private void guard_set(ad)
     guard_write(guard, &signature);
 }
 
-/* ------------------------------------------------------------------------- */
-/*
- * Coalesce list by merging any adjacent elements that are contiguous.
- * The list is assumed to be ordered by increasing addresses, i.e.,
- * addressOf(element i) < addressOf(element i+1).
- */
-/* ------------------------------------------------------------------------- */
-
-private void list_coalesce(list)
-    AD        *list;        /* the list to coalesce */
-{
-    AD        *ad1;        /* lead traversal pointer */
-    AD        *ad2;        /* trailing traversal pointer */
-
-    for (ad2 = list; ad2;)
-    {
-        /* compute first address beyond ad2 */
-        ad1 = (AD *)((Pointer)ad2 + ad2->nbytes);
-
-        /* are ad2 and ad1 contiguous? */
-        if (ad1 == ad2->next)
-        {
-            /* yes; merge ad1 into ad2 */
-            ad2->nbytes += ad1->nbytes;
-            ad2->next = ad1->next;
-        }
-        else
-        {
-            /* no; advance ad2 */
-            ad2 = ad2->next;
-        }
-    }
-}
-
 /* ------------------------------------------------------------------------- */
 /*
  * Delete and return the first occurrence of ad from list.  If ad is not
@@ -1230,59 +1395,6 @@ private void list_insert(ad, list)
     *list = ad;
 }
 
-/* ------------------------------------------------------------------------- */
-/*
- * Insert ad into list, immediately before the first element e
- * for which pred(ad, e) returns true.  If there is no such element,
- * insert ad after the last element of list.
- */
-/* ------------------------------------------------------------------------- */
-
-private void list_insert_ordered(ad, list, pred)
-    AD        *ad;        /* the AD to insert */
-    AD        **list;        /* the list to insert into */
-    Boolean    (*pred)();    /* predicate */
-{
-    AD        *ad1;        /* lead traversal pointer */
-    AD        *ad2;        /* trailing traversal pointer */
-
-    if (*list == (AD *)NULL)
-    {
-        /* empty list */
-        ad->next = (AD *)NULL;
-        *list = ad;
-        return;
-    }
-
-    /* list has at least one element */
-    for (ad2 = (AD *)NULL, ad1 = *list; ad1; ad2 = ad1, ad1 = ad1->next)
-    {
-        /* does ad1 match? */
-        if ((*pred)(ad, ad1))
-        {
-            /* yes; insert ad before ad1 */
-            if (ad2)
-            {
-                /* ad1 is second or later element */
-                ad2->next = ad;
-            }
-            else
-            {
-                /* ad1 is first element */
-                *list = ad;
-            }
-            ad->next = ad1;
-
-            /* success */
-            return;
-        }
-    }
-
-    /* append ad to list */
-    ad2->next = ad;
-    ad->next = (AD *)NULL;
-}
-
 /* ------------------------------------------------------------------------- */
 /*
  * Return MA_TRUE if ad is a member of list, else return MA_FALSE.
@@ -1472,6 +1584,7 @@ private Integer ma_max_heap_frag_nelem(datatype, min_nelem)
 {
     ulongi    min_bytes;    /* for fragment to be considered */
     AD        *ad;        /* traversal pointer */
+    int        fl, sl;        /* size class */
     ulongi    nbytes;        /* in current fragment */
     Integer    nelem;        /* in current fragment */
     Integer    max_nelem;    /* result */
@@ -1479,9 +1592,11 @@ private Integer ma_max_heap_frag_nelem(datatype, min_nelem)
     /* set the threshold */
     min_bytes = (min_nelem * ma_sizeof[datatype]) + BLOCK_OVERHEAD_FIXED;
 
-    /* search the heap free list */
+    /* search the heap free lists */
     max_nelem = 0;
-    for (ad = ma_hfree; ad; ad = ad->next)
+    for (fl = 0; fl < FL_COUNT; fl++)
+    for (sl = 0; sl < SL_COUNT; sl++)
+    for (ad = ma_hbins[fl][sl]; ad; ad = ad->next)
     {
         /*
          * There are 3 cases to consider:
@@ -1672,7 +1787,7 @@ private Boolean mh2ad(memhandle, adout, location, caller)
 
     if (check_heap)
     {
-        if (!list_member(ad, ma_hused))
+        if (!ad_in_heap(ad))
         {
             (void)sprintf(ma_ebuf,
                 "memhandle %ld (name: '%s') not in heap",
@@ -1716,7 +1831,7 @@ private Boolean mh2ad(memhandle, adout, location, caller)
     }
     else if (check_heapandstack)
     {
-        if ((!list_member(ad, ma_hused)) && (!list_member(ad, ma_sused)))
+        if ((!ad_in_heap(ad)) && (!list_member(ad, ma_sused)))
         {
             (void)sprintf(ma_ebuf,
                 "memhandle %ld (name: '%s') not in heap or stack",
@@ -1755,6 +1870,49 @@ private void mh_free(ad)
         ma_table_deallocate(memhandle);
 }
 
+/* ------------------------------------------------------------------------- */
+/*
+ * Return the position of the lowest set bit of value, which is nonzero.
+ */
+/* ------------------------------------------------------------------------- */
+
+private int mai_ffs(value)
+    ulongi    value;        /* to search */
+{
+#if defined(__GNUC__)
+    return __builtin_ctzl(value);
+#else
+    int        bit = 0;
+
+    while (!(value & 1))
+    {
+        value >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/* ------------------------------------------------------------------------- */
+/*
+ * Return the position of the highest set bit of value, or 0 if value is 0.
+ */
+/* ------------------------------------------------------------------------- */
+
+private int mai_fls(value)
+    ulongi    value;        /* to search */
+{
+#if defined(__GNUC__)
+    return value ? FL_COUNT - 1 - __builtin_clzl(value) : 0;
+#else
+    int        bit = 0;
+
+    while (value >>= 1)
+        bit++;
+    return bit;
+#endif
+}
+
 /* ------------------------------------------------------------------------- */
 /*
  * Return the first multiple of unit which is >= value.
@@ -2007,8 +2165,8 @@ public Boolean MA_allocate_heap(
     ar.datatype = datatype;
     ar.nelem = nelem;
 
-    /* search the free list */
-    ad = list_delete_one(&ma_hfree, ad_big_enough, (Pointer)&ar);
+    /* search the free lists */
+    ad = bin_search(&ar);
 
     /* if search of free list failed, try expanding heap region */
     if (ad == (AD *)NULL)
@@ -2033,6 +2191,8 @@ public Boolean MA_allocate_heap(
             /* set fields appropriately */
             ad->client_space = client_space;
             ad->nbytes = nbytes;
+            ad->left = ma_htop;
+            ma_htop = ad;
         }
     }
 
@@ -2046,7 +2206,8 @@ public Boolean MA_allocate_heap(
     str_ncopy(ad->name, (char*)name, MA_NAMESIZE);
     /* ad->client_space is already set */
     /* ad->nbytes is already set */
-    list_insert(ad, &ma_hused);
+    /* ad->left is already set */
+    dlist_insert(ad, &ma_hused);
     ad->checksum = checksum(ad);
 
     /* set the guards */
@@ -2152,14 +2313,7 @@ public Boolean MA_free_heap(Integer memhandle) /* the block to deallocate */
     (void)printf("MA: freeing '%s'\n", ad->name);
 
     /* delete block from used list */
-    if (list_delete(ad, &ma_hused) != ad)
-    {
-        (void)sprintf(ma_ebuf,
-            "memhandle %ld (name: '%s') not on heap used list",
-            (long)memhandle, ad->name);
-        ma_error(EL_Nonfatal, ET_Internal, "MA_free_heap", ma_ebuf);
-        return MA_FALSE;
-    }
+    dlist_delete(ad, &ma_hused);
 
 #ifdef STATS
     ma_stats.hblocks--;
@@ -2445,6 +2599,7 @@ public Boolean MA_init(
     ulongi    heap_bytes;    /* # of bytes for heap */
     ulongi    stack_bytes;    /* # of bytes for stack */
     ulongi    total_bytes;    /* total # of bytes */
+    int        i, j;        /* loop indices */
 
 #ifdef STATS
     ma_stats.calls[(int)FID_MA_init]++;
@@ -2543,7 +2698,14 @@ public Boolean MA_init(
     ma_sp = ma_eos;
 
     /* lists are all initially empty */
-    ma_hfree = (AD *)NULL;
+    for (i = 0; i < FL_COUNT; i++)
+    {
+        for (j = 0; j < SL_COUNT; j++)
+            ma_hbins[i][j] = (AD *)NULL;
+        ma_hsl_map[i] = 0;
+    }
+    ma_hfl_map = 0;
+    ma_htop = (AD *)NULL;
     ma_hused = (AD *)NULL;
     ma_sused = (AD *)NULL;
 
@@ -3164,6 +3326,10 @@ public void MA_print_stats(Boolean printroutines)
     (void)printf("\tmaximum total M-bytes\t\t%10lu\t%10lu\n",
         ((ma_stats.hbytes_max+999999)/1000000),
         ((ma_stats.sbytes_max+999999)/1000000));
+    (void)printf("\tcurrent free fragments\t\t%10lu\n",
+        ma_stats.hfrags);
+    (void)printf("\tmaximum free fragments\t\t%10lu\n",
+        ma_stats.hfrags_max);
     if (printroutines)
     {
         (void)printf("\n\tcalls per routine:\n");
@@ -87,8 +87,11 @@ public Integer ma_table_allocate(data)
     Integer    i;
     Integer    slots_examined;
 
-    /* expand the table if necessary */
-    if (ma_table_entries >= ma_table_capacity)
+    /*
+     * expand the table if necessary; keeping it at most half full
+     * bounds the expected length of the search for a free slot
+     */
+    if (2 * ma_table_entries >= ma_table_capacity)
     {
         /* increase table capacity */
         if (ma_table_capacity == 0)
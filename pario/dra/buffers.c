@@ -83,7 +83,9 @@ void buffer_init(
     for (i = 0; i < nbuf; i++) {
         ctxt->buf[i].active = 0;
         ctxt->buf[i].group_id = 0;
+        ctxt->buf[i].call_id = -1;
     }
+    ctxt->last_buf = nbuf - 1;
 #ifdef DEBUG
     printf("Created a context\n\n");
 #endif
@@ -11,7 +11,7 @@
 /* alignment factor for the internal buffer */
 #define ALIGN 16
 
-#define MAXBUF 16 /* max # of buffers that can be used */
+#define MAXBUF 64 /* max # of buffers that can be used */
 #define DEFBUF 4 /* default # of buffers */
 
 /** internal buffer structure */
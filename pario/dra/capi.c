@@ -273,6 +273,29 @@ int DRA_Close(int d_a)
     return (int)status;
 }
 
+int DRA_Matmul(int d_a, int d_b, int d_c)
+{
+    Integer dd_a, dd_b, dd_c, status;
+    dd_a = (Integer)d_a;
+    dd_b = (Integer)d_b;
+    dd_c = (Integer)d_c;
+#ifdef USE_FAPI
+    status = dra_matmul_(&dd_a, &dd_b, &dd_c);
+#else
+    /* C arrays are stored transposed, so C = A*B is C' = B'*A' on disk */
+    status = dra_matmul_(&dd_b, &dd_a, &dd_c);
+#endif
+    return (int)status;
+}
+
+void DRA_Matmul_bytes(double *nread, double *nwritten)
+{
+    DoublePrecision rd, wr;
+    dra_matmul_bytes_(&rd, &wr);
+    *nread = (double)rd;
+    *nwritten = (double)wr;
+}
+
 void DRA_Flick()
 {
     dra_flick_();
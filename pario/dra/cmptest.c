@@ -0,0 +1,214 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* chunk compressed disk arrays (DRA_COMPRESS=1): mostly zero arrays with
+ * incompressible and constant regions are written, read back and updated
+ * with sections that do not line up with the chunks, so that chunks become
+ * zero, grow out of their records and are rewritten in place. Done for
+ * doubles and integers, with one file and with one file per process. */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#include <sys/stat.h>
+
+#include "dra.h"
+#include "ga.h"
+#include "macdecls.h"
+#include "mp3.h"
+#include "testutil.h"
+
+#define FNAME "dra_cmp"
+#define N     300
+#define CHUNK 40
+
+static int me, nproc;
+
+/* pseudo-random values that do not compress */
+static double noise(int i, int j)
+{
+    unsigned long h = (unsigned long)(i*N + j + 1) * 2654435761UL;
+
+    return (double)((h >> 7) % 100000) - 50000.0;
+}
+
+/* noise in the upper left corner, a constant in the lower right one, zeros
+ * everywhere else */
+static double value(int i, int j)
+{
+    if (i < N/3 && j < N/3) return noise(i, j);
+    if (i >= N/2 && j >= N/2) return 3.0;
+    return 0.0;
+}
+
+static void set_local(int g_a, double (*f)(int, int))
+{
+    int lo[2], hi[2], ld[1], type, ndim, dims[2], i, j;
+    void *ptr;
+
+    NGA_Inquire(g_a, &type, &ndim, dims);
+    NGA_Distribution(g_a, me, lo, hi);
+    if (lo[0] < 0 || lo[0] > hi[0]) return;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    for (i=lo[0]; i<=hi[0]; i++)
+        for (j=lo[1]; j<=hi[1]; j++) {
+            double v = f(i, j);
+            if (type == C_DBL)
+                ((double*)ptr)[(i-lo[0])*ld[0] + j-lo[1]] = v;
+            else
+                ((int*)ptr)[(i-lo[0])*ld[0] + j-lo[1]] = (int)v;
+        }
+    NGA_Release_update(g_a, lo, hi);
+}
+
+/* g_a and g_b have the same distribution and contents */
+static int same(int g_a, int g_b)
+{
+    int lo[2], hi[2], lda[1], ldb[1], type, ndim, dims[2], i, j, ok = 1;
+    void *pa, *pb;
+
+    NGA_Inquire(g_a, &type, &ndim, dims);
+    NGA_Distribution(g_a, me, lo, hi);
+    if (lo[0] >= 0 && lo[0] <= hi[0]) {
+        NGA_Access(g_a, lo, hi, &pa, lda);
+        NGA_Access(g_b, lo, hi, &pb, ldb);
+        for (i=0; i<=hi[0]-lo[0]; i++)
+            for (j=0; j<=hi[1]-lo[1]; j++) {
+                if (type == C_DBL)
+                    ok = ok && ((double*)pa)[i*lda[0]+j]
+                        == ((double*)pb)[i*ldb[0]+j];
+                else
+                    ok = ok && ((int*)pa)[i*lda[0]+j] == ((int*)pb)[i*ldb[0]+j];
+            }
+        NGA_Release(g_b, lo, hi);
+        NGA_Release(g_a, lo, hi);
+    }
+    GA_Igop(&ok, 1, "min");
+    return ok;
+}
+
+/* bytes on disk of the array in fname, in one file or one per process */
+static long footprint(const char *fname)
+{
+    char name[256];
+    struct stat st;
+    long bytes = 0;
+    int p;
+
+    if (stat(fname, &st) == 0) bytes += (long)st.st_size;
+    for (p=0; p<nproc; p++) {
+        sprintf(name, "%s.%d", fname, p);
+        if (stat(name, &st) == 0) bytes += (long)st.st_size;
+    }
+    return bytes;
+}
+
+/* write g_src[glo:ghi] to the same section of d_a and of the reference g_ref */
+static void write_section(int g_src, int g_ref, int d_a, int lo0, int hi0,
+        int lo1, int hi1)
+{
+    int glo[2], ghi[2], req;
+    dra_size_t dlo[2], dhi[2];
+
+    glo[0] = lo0; ghi[0] = hi0; glo[1] = lo1; ghi[1] = hi1;
+    dlo[0] = lo0; dhi[0] = hi0; dlo[1] = lo1; dhi[1] = hi1;
+    test_check(NDRA_Write_section(0, g_src, glo, ghi, d_a, dlo, dhi, &req) == 0,
+            "NDRA_Write_section");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    NGA_Copy_patch('n', g_src, glo, ghi, g_ref, glo, ghi);
+}
+
+static void test(int type, const char *what)
+{
+    int dims[2] = {N, N}, g_a, g_b, g_c, d_a, req, ione = -1;
+    double done = -1.0;
+    dra_size_t ddims[2] = {N, N}, reqdims[2] = {CHUNK, CHUNK};
+    char fname[80];
+    long dense, bytes;
+
+    if (me == 0) printf("%s\n", what);
+    sprintf(fname, "%s.%d", FNAME, type);
+    g_a = NGA_Create(type, 2, dims, "a", NULL);
+    g_b = GA_Duplicate(g_a, "b");
+    g_c = GA_Duplicate(g_a, "c");
+    set_local(g_a, value);
+    set_local(g_c, noise);
+    GA_Sync();
+
+    /* whole array, most chunks zero */
+    test_check(NDRA_Create(type, 2, ddims, "compressed", fname, DRA_RW, reqdims,
+                &d_a) == 0, "NDRA_Create");
+    test_check(NDRA_Write(g_a, d_a, &req) == 0, "NDRA_Write");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    test_check(DRA_Close(d_a) == 0, "DRA_Close");
+    GA_Sync();
+    dense = (long)N*N*(type == C_DBL ? sizeof(double) : sizeof(int));
+    bytes = footprint(fname);
+    if (me == 0) printf("  %ld bytes on disk, %ld dense\n", bytes, dense);
+    test_check(bytes > 0 && bytes < dense/2, "size on disk");
+
+    test_check(DRA_Open(fname, DRA_RW, &d_a) == 0, "DRA_Open");
+    if (type == C_DBL) GA_Fill(g_b, &done);
+    else GA_Fill(g_b, &ione);
+    test_check(NDRA_Read(g_b, d_a, &req) == 0, "NDRA_Read");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    test_check(same(g_a, g_b), "read after write");
+
+    /* noise into zero chunks, into constant chunks (the records grow and
+     * move) and over part of the noise (rewritten in place), then zeros over
+     * a region that covers whole chunks */
+    write_section(g_c, g_a, d_a, N/3 - 7, N/3 + 25, 3, N/4);
+    write_section(g_c, g_a, d_a, N/2 + 11, N - 1, N/2 + 5, N/2 + 60);
+    write_section(g_c, g_a, d_a, 10, 17, 13, 30);
+    GA_Zero(g_b);
+    write_section(g_b, g_a, d_a, 0, N/3 - 1, 0, 2*CHUNK + 5);
+    test_check(DRA_Close(d_a) == 0, "DRA_Close");
+
+    /* read back by sections and as a whole after reopening */
+    test_check(DRA_Open(fname, DRA_R, &d_a) == 0, "DRA_Open");
+    GA_Zero(g_b);
+    test_check(NDRA_Read(g_b, d_a, &req) == 0, "NDRA_Read");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    test_check(same(g_a, g_b), "read after section writes");
+    {
+        int glo[2] = {N/4, 7}, ghi[2] = {N - 9, N/2 + 70};
+        dra_size_t dlo[2], dhi[2];
+
+        dlo[0] = glo[0]; dhi[0] = ghi[0]; dlo[1] = glo[1]; dhi[1] = ghi[1];
+        GA_Zero(g_b);
+        GA_Zero(g_c);
+        NGA_Copy_patch('n', g_a, glo, ghi, g_c, glo, ghi);
+        test_check(NDRA_Read_section(0, g_b, glo, ghi, d_a, dlo, dhi,
+                    &req) == 0, "NDRA_Read_section");
+        test_check(DRA_Wait(req) == 0, "DRA_Wait");
+        test_check(same(g_b, g_c), "section read");
+    }
+    test_check(DRA_Delete(d_a) == 0, "DRA_Delete");
+
+    GA_Destroy(g_c);
+    GA_Destroy(g_b);
+    GA_Destroy(g_a);
+}
+
+int main(int argc, char **argv)
+{
+    setenv("DRA_COMPRESS", "1", 1);
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (DRA_Init(4, 1e8, 1e10, 1e6) != 0) GA_Error("DRA_Init failed", 0);
+
+    test(C_DBL, "doubles, default files");
+    test(C_INT, "integers, default files");
+    DRA_Set_default_config(nproc, nproc);
+    test(C_DBL, "doubles, one file per process");
+    test(C_INT, "integers, one file per process");
+
+    DRA_Terminate();
+    test_finalize();
+    return 0;
+}
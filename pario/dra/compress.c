@@ -0,0 +1,427 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/** @file
+ * Chunk compressed storage format for disk resident arrays.
+ *
+ * Instead of the dense chunked image computed by ndai_file_location, every
+ * chunk owned by an I/O process is stored as a variable length record in
+ * that process' file. A chunk index kept in memory while the array is open
+ * maps each chunk to its record; chunks that contain only zeros are marked
+ * in a bitmap and take no space at all. Records are compressed by
+ * shuffling the bytes of the elements (so that e.g. the exponents of
+ * doubles end up next to each other) followed by run-length encoding, and
+ * are stored raw whenever that does not pay off.
+ *
+ * File layout: records, chunk index, trailer. The trailer is the last
+ * DAI_CMP_TRAILER bytes of the file and locates the index. A record is
+ * rewritten in place if it still fits, otherwise it is appended after the
+ * last record, overwriting the index which is written again on close.
+ *
+ * Each file has a single writer, so the I/O processes compress and
+ * decompress their chunks independently and in parallel.
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+
+#include "drap.h"
+#include "ga-papi.h"
+#include "macdecls.h"
+
+#define DAI_CMP_MAGIC   4711.0417 /**< marks a valid trailer */
+#define DAI_CMP_TRAILER (3*sizeof(Off_t))
+
+#define CODEC_RAW 0     /**< record holds the chunk as is */
+#define CODEC_RLE 1     /**< record holds the shuffled, run-length encoded chunk */
+
+#define RLE_MAX_LIT 128 /**< longest literal sequence of the encoder */
+#define RLE_MIN_RUN 3   /**< shortest run of the encoder */
+#define RLE_MAX_RUN (RLE_MIN_RUN + 127)
+
+#define dai_sizeofM(_type) MA_sizeof(_type, 1, MT_C_CHAR)
+
+/** chunk index of one DRA file, see file comment */
+typedef struct {
+    Integer nblocks;        /**< number of chunks stored in this file */
+    Off_t   end;            /**< end of the last record in the file */
+    Off_t   *offset;        /**< file offset of the record of each chunk */
+    Off_t   *length;        /**< length of the record, 0 if never written */
+    Off_t   *capacity;      /**< bytes reserved for the record */
+    unsigned char *codec;   /**< CODEC_RAW or CODEC_RLE */
+    unsigned char *zero;    /**< bitmap of chunks that contain only zeros */
+    char    *raw;           /**< scratch for one uncompressed chunk */
+    char    *shuf;          /**< scratch for one shuffled chunk */
+    char    *packed;        /**< scratch for one compressed chunk */
+    int     dirty;          /**< index differs from the one on disk ? */
+} dai_cmp_t;
+
+#define ZERO_TEST(c,k)  ((c)->zero[(k)>>3] &   (1<<((k)&7)))
+#define ZERO_SET(c,k)   ((c)->zero[(k)>>3] |=  (1<<((k)&7)))
+#define ZERO_CLEAR(c,k) ((c)->zero[(k)>>3] &= ~(1<<((k)&7)))
+
+
+/**
+ * transpose the bytes of n elements of size bytes each
+ */
+static void dai_shuffle(const char *in, char *out, Size_t n, int size)
+{
+    Size_t i;
+    int b;
+
+    for (b=0; b<size; b++)
+        for (i=0; i<n; i++) out[b*n+i] = in[i*size+b];
+}
+
+
+/**
+ * inverse of dai_shuffle
+ */
+static void dai_unshuffle(const char *in, char *out, Size_t n, int size)
+{
+    Size_t i;
+    int b;
+
+    for (b=0; b<size; b++)
+        for (i=0; i<n; i++) out[i*size+b] = in[b*n+i];
+}
+
+
+/**
+ * Run-length encode n bytes. A control byte c < 128 is followed by c+1
+ * literal bytes, otherwise the next byte is repeated c-128+RLE_MIN_RUN
+ * times. Returns the encoded length or 0 if it would exceed max.
+ */
+static Size_t dai_rle_encode(const unsigned char *in, Size_t n,
+        unsigned char *out, Size_t max)
+{
+    Size_t i=0, o=0, run, lit, start;
+
+    while (i < n) {
+        run = 1;
+        while (i+run < n && run < RLE_MAX_RUN && in[i+run] == in[i]) run++;
+        if (run >= RLE_MIN_RUN) {
+            if (o+2 > max) return 0;
+            out[o++] = (unsigned char)(128 + run - RLE_MIN_RUN);
+            out[o++] = in[i];
+            i += run;
+        } else {
+            /* literals extend up to the start of the next run */
+            start = i;
+            lit = 0;
+            while (i < n && lit < RLE_MAX_LIT) {
+                if (i+2 < n && in[i] == in[i+1] && in[i] == in[i+2]) break;
+                i++;
+                lit++;
+            }
+            if (o+1+lit > max) return 0;
+            out[o++] = (unsigned char)(lit-1);
+            memcpy(out+o, in+start, lit);
+            o += lit;
+        }
+    }
+    return o;
+}
+
+
+/**
+ * decode n bytes run-length encoded by dai_rle_encode
+ */
+static void dai_rle_decode(const unsigned char *in, Size_t len,
+        unsigned char *out, Size_t n)
+{
+    Size_t i=0, o=0, cnt;
+
+    while (i < len) {
+        if (in[i] < 128) {
+            cnt = (Size_t)in[i] + 1;
+            if (i+1+cnt > len || o+cnt > n)
+                dai_error("dai_rle_decode: corrupt record",(Integer)i);
+            memcpy(out+o, in+i+1, cnt);
+            i += 1+cnt;
+        } else {
+            cnt = (Size_t)in[i] - 128 + RLE_MIN_RUN;
+            if (i+2 > len || o+cnt > n)
+                dai_error("dai_rle_decode: corrupt record",(Integer)i);
+            memset(out+o, in[i+1], cnt);
+            i += 2;
+        }
+        o += cnt;
+    }
+    if (o != n) dai_error("dai_rle_decode: short record",(Integer)o);
+}
+
+
+/**
+ * check whether buffer contains only zero bytes
+ */
+static int dai_all_zero(const char *buf, Size_t bytes)
+{
+    Size_t i;
+
+    for (i=0; i<bytes; i++) if (buf[i]) return 0;
+    return 1;
+}
+
+
+/**
+ * Find chunk of the file that contains the aligned section ds_a.
+ *
+ * @param ds_a[in]    section within one chunk
+ * @param k[out]      index of the chunk in the file
+ * @param chunk[out]  bytes of the chunk
+ * @param off[out]    offset of the section within the chunk
+ * @param bytes[out]  bytes of the section
+ */
+static void dai_cmp_locate(section_t ds_a, Integer *k, Size_t *chunk,
+        Size_t *off, Size_t *bytes)
+{
+    Integer handle = ds_a.handle+DRA_OFFSET, ndim = DRA[handle].ndim, i;
+    Integer CR = 0, b, nb, ext, ioprocs = dai_io_procs(ds_a.handle);
+    Integer nchunk = 1, nsect = 1, nslab = 1;
+    Integer size = dai_sizeofM(DRA[handle].type);
+
+    for (i=ndim-1; i>=0; i--) {
+        b  = (ds_a.lo[i]-1)/DRA[handle].chunk[i];
+        nb = (DRA[handle].dims[i]+DRA[handle].chunk[i]-1)/DRA[handle].chunk[i];
+        CR = CR*nb + b;
+    }
+    for (i=0; i<ndim; i++) {
+        b   = (ds_a.lo[i]-1)/DRA[handle].chunk[i];
+        ext = DRA[handle].dims[i] - b*DRA[handle].chunk[i];
+        if (ext > DRA[handle].chunk[i]) ext = DRA[handle].chunk[i];
+        nchunk *= ext;
+        nsect  *= ds_a.hi[i] - ds_a.lo[i] + 1;
+        if (i < ndim-1) nslab *= ext;
+    }
+    if (CR%ioprocs != dai_io_nodeid(ds_a.handle))
+        dai_error("dai_cmp_locate: chunk owned by another process",CR);
+
+    *k     = CR/ioprocs;
+    *chunk = (Size_t)(nchunk*size);
+    *off   = (Size_t)(nslab*((ds_a.lo[ndim-1]-1)%DRA[handle].chunk[ndim-1])*size);
+    *bytes = (Size_t)(nsect*size);
+}
+
+
+/**
+ * read chunk k of disk array handle into buf
+ */
+static void dai_cmp_load(Integer handle, Integer k, char *buf, Size_t bytes)
+{
+    dai_cmp_t *cmp = (dai_cmp_t*)DRA[handle].cmp;
+    Size_t len = (Size_t)cmp->length[k];
+    Size_t n = bytes/dai_sizeofM(DRA[handle].type);
+
+    if (ZERO_TEST(cmp,k) || len == 0) {
+        memset(buf, 0, bytes);
+        return;
+    }
+    if (cmp->codec[k] == CODEC_RAW) {
+        if (len != bytes) dai_error("dai_cmp_load: bad record length",k);
+        if (elio_read(DRA[handle].fd, cmp->offset[k], buf, len) != len)
+            dai_error("dai_cmp_load: read failed",k);
+    } else {
+        if (elio_read(DRA[handle].fd, cmp->offset[k], cmp->packed, len) != len)
+            dai_error("dai_cmp_load: read failed",k);
+        dai_rle_decode((unsigned char*)cmp->packed, len,
+                (unsigned char*)cmp->shuf, bytes);
+        dai_unshuffle(cmp->shuf, buf, n, (int)dai_sizeofM(DRA[handle].type));
+    }
+}
+
+
+/**
+ * compress chunk k of disk array handle from buf and write it to the file
+ */
+static void dai_cmp_store(Integer handle, Integer k, char *buf, Size_t bytes)
+{
+    dai_cmp_t *cmp = (dai_cmp_t*)DRA[handle].cmp;
+    Size_t n = bytes/dai_sizeofM(DRA[handle].type), len;
+    char *rec;
+
+    cmp->dirty = 1;
+    if (dai_all_zero(buf, bytes)) {
+        ZERO_SET(cmp,k);
+        cmp->length[k] = 0;
+        return;
+    }
+    ZERO_CLEAR(cmp,k);
+
+    dai_shuffle(buf, cmp->shuf, n, (int)dai_sizeofM(DRA[handle].type));
+    len = dai_rle_encode((unsigned char*)cmp->shuf, bytes,
+            (unsigned char*)cmp->packed, bytes-1);
+    if (len) {
+        cmp->codec[k] = CODEC_RLE;
+        rec = cmp->packed;
+    } else {
+        cmp->codec[k] = CODEC_RAW;
+        rec = buf;
+        len = bytes;
+    }
+
+    /* reuse the old record if the new one fits, append otherwise */
+    if ((Off_t)len > cmp->capacity[k]) {
+        cmp->offset[k] = cmp->end;
+        cmp->capacity[k] = (Off_t)len;
+        cmp->end += (Off_t)len;
+    }
+    cmp->length[k] = (Off_t)len;
+    if (elio_write(DRA[handle].fd, cmp->offset[k], rec, len) != len)
+        dai_error("dai_cmp_store: write failed",k);
+}
+
+
+/**
+ * write aligned section ds_a of a compressed disk array from buf
+ */
+void dai_cmp_put(section_t ds_a, void *buf)
+{
+    Integer handle = ds_a.handle+DRA_OFFSET, k;
+    dai_cmp_t *cmp = (dai_cmp_t*)DRA[handle].cmp;
+    Size_t chunk, off, bytes;
+
+    dai_cmp_locate(ds_a, &k, &chunk, &off, &bytes);
+    if (bytes == chunk) {
+        dai_cmp_store(handle, k, (char*)buf, chunk);
+    } else {
+        /* section is a slab of the chunk: read, modify, write */
+        dai_cmp_load(handle, k, cmp->raw, chunk);
+        memcpy(cmp->raw+off, buf, bytes);
+        dai_cmp_store(handle, k, cmp->raw, chunk);
+    }
+}
+
+
+/**
+ * read aligned section ds_a of a compressed disk array into buf
+ */
+void dai_cmp_get(section_t ds_a, void *buf)
+{
+    Integer handle = ds_a.handle+DRA_OFFSET, k;
+    dai_cmp_t *cmp = (dai_cmp_t*)DRA[handle].cmp;
+    Size_t chunk, off, bytes;
+
+    dai_cmp_locate(ds_a, &k, &chunk, &off, &bytes);
+    if (bytes == chunk) {
+        dai_cmp_load(handle, k, (char*)buf, chunk);
+    } else {
+        dai_cmp_load(handle, k, cmp->raw, chunk);
+        memcpy(buf, cmp->raw+off, bytes);
+    }
+}
+
+
+/**
+ * Set up the chunk index of disk array handle after its file was opened
+ * by this I/O process.
+ *
+ * @param handle[in] DRA handle + DRA_OFFSET
+ * @param fresh[in]  file is new: discard whatever it contains
+ */
+void dai_cmp_open(Integer handle, int fresh)
+{
+    Integer d_a = handle-DRA_OFFSET, ndim = DRA[handle].ndim, i, n;
+    Integer ioprocs = dai_io_procs(d_a), iome = dai_io_nodeid(d_a);
+    Integer nblocks = 1, bytes = dai_sizeofM(DRA[handle].type);
+    Off_t   trailer[3], length, nbytes;
+    dai_cmp_t *cmp;
+    char *p;
+
+    for (i=0; i<ndim; i++) {
+        nblocks *= (DRA[handle].dims[i]+DRA[handle].chunk[i]-1)
+            / DRA[handle].chunk[i];
+        bytes *= DRA[handle].chunk[i];
+    }
+    n = (nblocks - iome + ioprocs - 1)/ioprocs; /* chunks owned by iome */
+
+    cmp = (dai_cmp_t*)calloc(1, sizeof(dai_cmp_t));
+    if (!cmp) dai_error("dai_cmp_open: memory allocation failed",0);
+    cmp->nblocks  = n;
+    cmp->offset   = (Off_t*)calloc(3*n+1, sizeof(Off_t));
+    cmp->length   = cmp->offset + n;
+    cmp->capacity = cmp->length + n;
+    cmp->codec    = (unsigned char*)calloc(n+(n+7)/8+1, 1);
+    cmp->zero     = cmp->codec + n;
+    cmp->raw      = (char*)malloc(3*(size_t)bytes);
+    if (!cmp->offset || !cmp->codec || !cmp->raw)
+        dai_error("dai_cmp_open: memory allocation failed",bytes);
+    cmp->shuf     = cmp->raw + bytes;
+    cmp->packed   = cmp->shuf + bytes;
+    DRA[handle].cmp = cmp;
+
+    if (fresh) {
+        cmp->dirty = 1;
+        return;
+    }
+
+    /* locate and read the index of an existing file */
+    nbytes = (Off_t)(3*n*sizeof(Off_t) + n + (n+7)/8);
+    if (elio_length(DRA[handle].fd, &length) != ELIO_OK)
+        dai_error("dai_cmp_open: cannot get file length",0);
+    if (length < (Off_t)DAI_CMP_TRAILER) {
+        if (length > 0) dai_error("dai_cmp_open: file has no chunk index",0);
+        return; /* nothing was ever written by this process */
+    }
+    if (elio_read(DRA[handle].fd, length-DAI_CMP_TRAILER, trailer,
+                DAI_CMP_TRAILER) != (Size_t)DAI_CMP_TRAILER ||
+            trailer[2] != DAI_CMP_MAGIC || trailer[1] != (Off_t)n ||
+            trailer[0] + nbytes + DAI_CMP_TRAILER != length)
+        dai_error("dai_cmp_open: invalid chunk index",0);
+
+    p = (char*)malloc((size_t)nbytes);
+    if (!p) dai_error("dai_cmp_open: memory allocation failed",0);
+    if (elio_read(DRA[handle].fd, trailer[0], p, (Size_t)nbytes) != (Size_t)nbytes)
+        dai_error("dai_cmp_open: cannot read chunk index",0);
+    memcpy(cmp->offset, p, 3*n*sizeof(Off_t));
+    memcpy(cmp->codec, p + 3*n*sizeof(Off_t), n+(n+7)/8);
+    free(p);
+    cmp->end = trailer[0];
+}
+
+
+/**
+ * Release the chunk index of disk array handle. If save is set and the
+ * index changed, it is written after the last record of the file.
+ */
+void dai_cmp_close(Integer handle, int save)
+{
+    dai_cmp_t *cmp = (dai_cmp_t*)DRA[handle].cmp;
+    Integer n;
+    Off_t trailer[3];
+    Size_t bytes;
+
+    if (!cmp) return;
+    n = cmp->nblocks;
+    if (save && cmp->dirty) {
+        bytes = (Size_t)(3*n*sizeof(Off_t));
+        if (elio_write(DRA[handle].fd, cmp->end, cmp->offset, bytes) != bytes)
+            dai_error("dai_cmp_close: cannot write chunk index",0);
+        bytes = (Size_t)(n+(n+7)/8);
+        if (elio_write(DRA[handle].fd, cmp->end + 3*n*sizeof(Off_t),
+                    cmp->codec, bytes) != bytes)
+            dai_error("dai_cmp_close: cannot write chunk index",0);
+        trailer[0] = cmp->end;
+        trailer[1] = (Off_t)n;
+        trailer[2] = DAI_CMP_MAGIC;
+        if (elio_write(DRA[handle].fd, cmp->end + 3*n*sizeof(Off_t) + bytes,
+                    trailer, DAI_CMP_TRAILER) != (Size_t)DAI_CMP_TRAILER)
+            dai_error("dai_cmp_close: cannot write chunk index",0);
+        /* drop a stale tail left by a previous, longer version */
+        elio_truncate(DRA[handle].fd,
+                cmp->end + 3*n*sizeof(Off_t) + bytes + DAI_CMP_TRAILER);
+    }
+    free(cmp->offset);
+    free(cmp->codec);
+    free(cmp->raw);
+    free(cmp);
+    DRA[handle].cmp = NULL;
+}
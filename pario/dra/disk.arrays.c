@@ -42,6 +42,14 @@
 #if HAVE_STDIO_H
 #   include <stdio.h>
 #endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+#if !defined(WIN32) && !defined(NOUSE_MMAP)
+#   define DRA_MMAP 1
+#   include <sys/mman.h>
+#   include <unistd.h>
+#endif
 
 #include "buffers.h"
 #include "dra.h"
@@ -69,8 +77,6 @@
 #define JLO       2
 #define JHI       3
 
-#define DRA_OP_WRITE 777
-#define DRA_OP_READ  888
 #define PROBE 111
 #define WAIT 222
 
@@ -96,7 +102,8 @@
 #  define DRA_NUM_FILE_MGR DRA_NUM_IOPROCS
 #endif
 
-#define DRA_BUF_SIZE BUF_SIZE
+#define DRA_BUF_SIZE _dra_buf_size
+#define DRA_MAX_BUF_SIZE (16*BUF_SIZE)
 
 #define DEF_MAX_ARRAYS 16
 #define DRA_MAX_ARRAYS 1024
@@ -119,7 +126,13 @@ Integer _dra_number_of_files;
 disk_array_t *DRA;
 
 buf_context_t buf_ctxt; /**< buffer context handle */
-int nbuf = 4; /**< number of buffers to be used */
+int nbuf = DEFBUF; /**< number of buffers to be used */
+Integer _dra_buf_size = BUF_SIZE; /**< bytes of data per buffer */
+int _dra_report_rate = 0; /**< print bandwidth of each request */
+int _dra_use_mmap = 0;    /**< map independent files instead of ELIO I/O */
+int _dra_compress = 0;    /**< create arrays in chunk compressed format */
+int _dra_mpiio = 0;       /**< create arrays accessed through MPI-IO */
+double _dra_max_memory = -1; /**< memory per process given to dra_init */
 
 Integer _max_disk_array; /**< max number of disk arrays open at a time */
 logical dra_debug_flag;  /**< globally defined debug parameter */
@@ -137,15 +150,6 @@ int Dra_num_serv=DRA_NUM_IOPROCS;
 #define dai_check_typeM(_type)  if (_type != C_DBL && _type != C_INT \
      && _type != C_LONG && _type != C_DCPL && _type != C_FLOAT && _type != C_SCPL) \
                                   dai_error("invalid type ",_type)  
-#define dai_check_handleM(_handle, msg)                                    \
-{\
-        if((_handle+DRA_OFFSET)>=_max_disk_array || (_handle+DRA_OFFSET)<0) \
-        {fprintf(stderr,"%s, %ld --",msg, (long)_max_disk_array);\
-        dai_error("invalid DRA handle",_handle);}                           \
-        if( DRA[(_handle+DRA_OFFSET)].actv == 0)                            \
-        {fprintf(stderr,"%s:",msg);\
-        dai_error("disk array not active",_handle);}                       \
-}
         
 #define dai_check_rangeM(_lo, _hi, _dim, _err_msg)                         \
         if(_lo < (Integer)1   || _lo > _dim ||_hi < _lo || _hi > _dim)     \
@@ -568,7 +572,14 @@ Integer FATR dra_init_(
     _dra_number_of_files = pnga_cluster_nnodes();
 
     /* initialize Buffer Manager */
-    buf_size = sizeof (buf_info) + (int) DBL_BUF_SIZE;
+    nbuf = drai_get_num_buf();
+    _dra_report_rate = drai_get_report_rate();
+    _dra_use_mmap = drai_get_mmap();
+    _dra_compress = drai_get_compress();
+    _dra_mpiio = drai_get_mpiio();
+    _dra_max_memory = *max_memory;
+    _dra_buf_size = BUF_SIZE;
+    buf_size = sizeof (buf_info) + (int) (_dra_buf_size/sizeof(double));
     buffer_init(&buf_ctxt, nbuf, buf_size, &wait_buf);
 
     pnga_sync();
@@ -577,6 +588,48 @@ Integer FATR dra_init_(
 }
 
 
+/**
+ * Grow the I/O buffers so that they hold at least min_bytes and are a
+ * multiple of the block size reported by the file system holding filename
+ * (the stripe size on parallel file systems). Buffers never shrink, so
+ * arrays created earlier still fit. Collective.
+ *
+ * @param filename[in]  name of the disk array
+ * @param min_bytes[in] size of the largest chunk of the array
+ */
+void dai_fit_buffers(char *filename, Integer min_bytes)
+{
+    char dirname[DRA_MAX_FNAME+8];
+    stat_t statinfo;
+    Integer size, blksize = 0;
+    int i, buf_size;
+
+    if (elio_dirname(filename, dirname, DRA_MAX_FNAME+8) == ELIO_OK &&
+            elio_stat(dirname, &statinfo) == ELIO_OK)
+        blksize = (Integer) statinfo.blksize;
+
+    size = PARIO_MAX(_dra_buf_size, min_bytes);
+    if (blksize > 0 && size%blksize) {
+        Integer rounded = (size/blksize + 1)*blksize;
+        if (rounded <= DRA_MAX_BUF_SIZE) size = rounded;
+    }
+
+    /* every process has to chunk new arrays the same way */
+    pnga_gop(pnga_type_f2c(MT_F_INT), &size, (Integer)1, "max");
+    if (size <= _dra_buf_size) return;
+
+    /* drain outstanding transfers; their requests stay pending for dra_wait */
+    for (i=0; i<MAX_REQ; i++)
+        if (Requests[i].num_pending)
+            buf_complete_call(&buf_ctxt, Requests[i].call_id);
+
+    buf_terminate(&buf_ctxt);
+    _dra_buf_size = size;
+    buf_size = sizeof (buf_info) + (int) (_dra_buf_size/sizeof(double));
+    buffer_init(&buf_ctxt, nbuf, buf_size, &wait_buf);
+}
+
+
 /**
  * correct chunk size to fit the buffer and introduce allignment
  *
@@ -678,6 +731,13 @@ Integer dai_get_handle(void)
         if(!DRA[candidate].actv){ 
             dra_handle=candidate;
             DRA[candidate].actv =1;
+            DRA[candidate].usemap = _dra_use_mmap;
+            DRA[candidate].map = NULL;
+            DRA[candidate].maplen = 0;
+            DRA[candidate].compress = 0;
+            DRA[candidate].cmp = NULL;
+            DRA[candidate].mpiio = 0;
+            DRA[candidate].mpifh = NULL;
         }
         candidate++;
     }while(candidate < _max_disk_array && dra_handle == -1);
@@ -876,6 +936,25 @@ void dai_assign_request_handle(Integer* request)
     Requests[*request].call_id = *request;
     Requests[*request].num_pending = ON;
     Requests[*request].call_id = *request;
+    Requests[*request].nbytes = 0.0;
+    Requests[*request].start = pnga_wtime();
+}
+
+
+/**
+ * print effective bandwidth of a completed request if DRA_REPORT_RATE is set
+ */
+void dai_report_rate(Integer req)
+{
+    double elapsed;
+
+    if (!_dra_report_rate || pnga_nodeid() != 0) return;
+    elapsed = pnga_wtime() - Requests[req].start;
+    if (elapsed <= 0.0) return;
+    printf("DRA request %ld: %.3f MB in %.4f s, %.2f MB/s\n", (long)req,
+            Requests[req].nbytes/1048576.0, elapsed,
+            Requests[req].nbytes/1048576.0/elapsed);
+    fflush(stdout);
 }
 
 
@@ -906,9 +985,17 @@ Integer drai_open(char *filename, Integer *mode, Integer *d_a)
 
     if(dai_read_param(DRA[handle].fname, *d_a))return((Integer)-1);
 
+    /* make sure the chunks of this array fit in the I/O buffers */
+    {
+        Integer i, chunk_bytes = dai_sizeofM(DRA[handle].type);
+        for (i=0; i<DRA[handle].ndim; i++) chunk_bytes *= DRA[handle].chunk[i];
+        dai_fit_buffers(filename, chunk_bytes);
+    }
+
     DRA[handle].indep = dai_file_config(filename); /*check file configuration*/
 
-    if(dai_io_manage(*d_a)){ 
+    if(DRA[handle].mpiio) dai_mpiio_open(handle, 0);
+    else if(dai_io_manage(*d_a)){ 
 
         if (INDEPFILES(*d_a) || DRA[handle].numfiles > 1) {
 
@@ -924,6 +1011,8 @@ Integer drai_open(char *filename, Integer *mode, Integer *d_a)
                 pnga_nodeid());
         if(DRA[handle].fd->fd ==-1)dai_error("dra_open failed (-1)",
                 pnga_nodeid());  
+
+        if(DRA[handle].compress) dai_cmp_open(handle, 0);
     }
 
 
@@ -952,7 +1041,11 @@ Integer FATR dra_close_(Integer* d_a) /* input:DRA handle*/
     pnga_sync();
 
     dai_check_handleM(*d_a, "dra_close");
-    if(dai_io_manage(*d_a)) if(ELIO_OK != (rc=elio_close(DRA[handle].fd)))
+    dai_unmap(handle);
+    dai_cmp_close(handle, dai_write_allowed(*d_a));
+    dai_mpiio_close(handle);
+    if(!DRA[handle].mpiio && dai_io_manage(*d_a))
+        if(ELIO_OK != (rc=elio_close(DRA[handle].fd)))
         dai_error("dra_close: close failed",rc);
     dai_release_handle(d_a); 
 
@@ -1396,6 +1489,7 @@ void nga_move(int op, int trans, section_t gs_a, section_t ds_a,
             for (i=0; i<ndim; i++) ldg[i] = gs_chunk.hi[i] - gs_chunk.lo[i] + 1;
             /* copy data from global array to temporary buffer */
             nga_get_sectM(gs_chunk, base_addr, ldg, ga_movhdl); 
+            if (ga_movhdl != NULL) pnga_nbwait(ga_movhdl);
             for (i=0; i<nelem1; i++ ) {
                 /* find indices of elements in MA buffer */
                 if (ndim > 1) {
@@ -1504,6 +1598,8 @@ void nga_move(int op, int trans, section_t gs_a, section_t ds_a,
                 }
             }
             nga_put_sectM(gs_chunk, base_addr, ldt, ga_movhdl); 
+            /* the temporary array is released below */
+            if (ga_movhdl != NULL) pnga_nbwait(ga_movhdl);
         }
         MA_pop_stack(vhandle);
     } else {
@@ -1596,6 +1692,7 @@ Integer FATR dra_wait_(Integer* request)
     Requests[*request].num_pending=0;
 
     pnga_sync();
+    dai_report_rate(*request);
 
     return(ELIO_OK);
 
@@ -1699,6 +1796,8 @@ Integer FATR dra_probe_(
 
     if(done){
         *status = ELIO_DONE;
+        if (*request != DRA_REQ_INVALID && Requests[*request].num_pending)
+            dai_report_rate(*request);
         Requests[*request].num_pending = 0;
     }
     else {
@@ -1769,10 +1868,16 @@ Integer FATR dra_delete_(Integer* d_a)
     dai_check_handleM(*d_a,"dra_delete");
     dai_delete_param(DRA[handle].fname,*d_a);
 
-    if(dai_io_manage(*d_a)) if(ELIO_OK != (rc=elio_close(DRA[handle].fd)))
-        dai_error("dra_close: close failed",rc);
+    dai_unmap(handle);
+    dai_cmp_close(handle, 0);
+    dai_mpiio_close(handle);
+    if(!DRA[handle].mpiio && dai_io_manage(*d_a))
+        if(ELIO_OK != (rc=elio_close(DRA[handle].fd)))
+            dai_error("dra_close: close failed",rc);
 
-    if(dai_file_master(*d_a)) {
+    if(DRA[handle].mpiio) {
+        if(pnga_nodeid() == 0) elio_delete(DRA[handle].fname);
+    } else if(dai_file_master(*d_a)) {
         if(INDEPFILES(*d_a) || DRA[handle].numfiles > 1){ 
             sprintf(dummy_fname,"%s.%ld",DRA[handle].fname,(long)dai_io_nodeid(*d_a));
             elio_delete(dummy_fname);
@@ -2197,6 +2302,7 @@ Integer ndrai_create_config(Integer *type, Integer *ndim, Integer dims[],
 
     /* determine disk array decomposition */ 
     elem_size = dai_sizeofM(ctype);
+    dai_fit_buffers(filename, (Integer)0);
     ndai_chunking( elem_size, *ndim, reqdims, dims, DRA[handle].chunk);
 
     /* determine layout -- by row or column */
@@ -2210,11 +2316,22 @@ Integer ndrai_create_config(Integer *type, Integer *ndim, Integer dims[],
     strncpy (DRA[handle].fname, filename,  DRA_MAX_FNAME);
     strncpy(DRA[handle].name, name, DRA_MAX_NAME );
 
+    /* MPI-IO opens a single file and needs the same name everywhere */
+    DRA[handle].mpiio = _dra_mpiio && dai_mpiio_same_file(handle);
+    DRA[handle].compress = DRA[handle].mpiio ? 0 : _dra_compress;
     dai_write_param(DRA[handle].fname, *d_a);      /* create param file */
     DRA[handle].indep = dai_file_config(filename); /*check file configuration*/
 
+    /* chunk index of a compressed file needs a single writer per file */
+    if (DRA[handle].compress && !(INDEPFILES(*d_a) || DRA[handle].numfiles > 1)
+            && dai_io_procs(*d_a) > 1) {
+        DRA[handle].compress = 0;
+        dai_write_param(DRA[handle].fname, *d_a);
+    }
+
     /* create file */
-    if(dai_io_manage(*d_a)){ 
+    if(DRA[handle].mpiio) dai_mpiio_open(handle, 1);
+    else if(dai_io_manage(*d_a)){ 
 
         if (INDEPFILES(*d_a) || DRA[handle].numfiles > 1) {
 
@@ -2227,6 +2344,8 @@ Integer ndrai_create_config(Integer *type, Integer *ndim, Integer dims[],
 
         if(DRA[handle].fd==NULL)dai_error("ndra_create:failed to open file",0);
         if(DRA[handle].fd->fd==-1)dai_error("ndra_create:failed to open file",-1);
+
+        if(DRA[handle].compress) dai_cmp_open(handle, 1);
     }
 
     /*
@@ -2238,7 +2357,8 @@ Integer ndrai_create_config(Integer *type, Integer *ndim, Integer dims[],
      */
     pnga_sync();
 
-    if(dai_file_master(*d_a) && dai_write_allowed(*d_a)) ndai_zero_eof(*d_a);
+    if(dai_file_master(*d_a) && dai_write_allowed(*d_a) &&
+            !DRA[handle].compress && !DRA[handle].mpiio) ndai_zero_eof(*d_a);
 
     pnga_sync();
 
@@ -2369,6 +2489,112 @@ Integer drai_create(Integer *type, Integer *dim1, Integer *dim2, char *name,
 }
 
 
+/**
+ * Return address of the file data at offset for disk array handle, mapping
+ * the file into memory on first use. Only independent files, which are
+ * private to the I/O process and were extended to their full length by
+ * ndai_zero_eof, are mapped. Returns NULL if the array is not mapped or
+ * [offset, offset+bytes) lies outside of the mapping, in which case the
+ * caller falls back to ELIO.
+ *
+ * @param handle[in] DRA handle + DRA_OFFSET
+ * @param offset[in] byte offset in the file
+ * @param bytes[in]  length of the access
+ */
+static char* dai_map_address(Integer handle, Off_t offset, Size_t bytes)
+{
+#if DRA_MMAP
+    Off_t length;
+    void *map;
+    int prot;
+
+    if (!DRA[handle].usemap || DRA[handle].compress) return NULL;
+    if (DRA[handle].map == NULL) {
+        /* whatever happens below, try only once */
+        DRA[handle].usemap = 0;
+        if (!(INDEPFILES(handle-DRA_OFFSET) || DRA[handle].numfiles > 1))
+            return NULL;
+        if (DRA[handle].fd->next != NULL) return NULL; /* multiple extents */
+        if (elio_length(DRA[handle].fd, &length) != ELIO_OK || length <= 0)
+            return NULL;
+        prot = PROT_READ;
+        if (dai_write_allowed(handle-DRA_OFFSET)) prot |= PROT_WRITE;
+        map = mmap(NULL, (size_t)length, prot, MAP_SHARED,
+                DRA[handle].fd->fd, 0);
+        if (map == MAP_FAILED) return NULL;
+        DRA[handle].map = (char*)map;
+        DRA[handle].maplen = length;
+        DRA[handle].usemap = 1;
+    }
+    if (offset + (Off_t)bytes > DRA[handle].maplen) return NULL;
+    return DRA[handle].map + (size_t)offset;
+#else
+    return NULL;
+#endif
+}
+
+
+/**
+ * release the memory mapping of disk array handle, if there is one
+ */
+void dai_unmap(Integer handle)
+{
+#if DRA_MMAP
+    if (DRA[handle].map != NULL) {
+        if (dai_write_allowed(handle-DRA_OFFSET))
+            msync(DRA[handle].map, (size_t)DRA[handle].maplen, MS_SYNC);
+        munmap(DRA[handle].map, (size_t)DRA[handle].maplen);
+    }
+#endif
+    DRA[handle].map = NULL;
+    DRA[handle].maplen = 0;
+    DRA[handle].usemap = 0;
+}
+
+
+/**
+ * Ask the kernel to start reading the file range of the chunk that follows
+ * ds_chunk in list and belongs to this I/O process, so that it is resident
+ * by the time the next loop iteration of the transfer touches it.
+ *
+ * @param req[in]      request handle
+ * @param list[in]     list of sections processed by the transfer loop
+ * @param ds_chunk[in] current chunk
+ */
+void ndai_prefetch_next(Integer req, Integer* list, section_t ds_chunk)
+{
+#if DRA_MMAP
+    Integer handle = ds_chunk.handle + DRA_OFFSET, i, elem, turn;
+    Integer ioprocs, iome;
+    Off_t   offset, start;
+    Size_t  bytes;
+    long    page;
+
+    if (DRA[handle].map == NULL) return;
+    ioprocs = dai_io_procs(ds_chunk.handle);
+    iome    = dai_io_nodeid(ds_chunk.handle);
+    while (ndai_next_chunk(req, list, &ds_chunk)) {
+        nsect_to_blockM(ds_chunk, &turn);
+        if ((turn%ioprocs) != iome) continue;
+
+        ndai_file_location(ds_chunk, &offset);
+        elem = 1;
+        for (i=0; i<ds_chunk.ndim; i++)
+            elem *= (ds_chunk.hi[i]-ds_chunk.lo[i]+1);
+        bytes = (Size_t) elem * dai_sizeofM(DRA[handle].type);
+        if (offset + (Off_t)bytes > DRA[handle].maplen) return;
+
+        /* madvise wants a page aligned address */
+        page  = sysconf(_SC_PAGESIZE);
+        start = (Off_t)(((long)offset/page)*page);
+        madvise(DRA[handle].map + (size_t)start,
+                (size_t)(offset - start) + (size_t)bytes, MADV_WILLNEED);
+        return;
+    }
+#endif
+}
+
+
 /**
  * write N-dimensional aligned block of data from memory buffer to d_a
  *
@@ -2383,6 +2609,7 @@ void ndai_put(section_t ds_a, void *buf, Integer ld[], io_request_t *id)
     Integer ndim = ds_a.ndim;
     Off_t   offset;
     Size_t  bytes;
+    char    *ptr;
 #if WALLTIME
     double ss0,tt0,tt1;
 #endif
@@ -2396,6 +2623,16 @@ void ndai_put(section_t ds_a, void *buf, Integer ld[], io_request_t *id)
     elem = 1;
     for (i=0; i<ndim; i++) elem *= (ds_a.hi[i]-ds_a.lo[i]+1);
     bytes= (Size_t) elem * dai_sizeofM(DRA[handle].type);
+    if (DRA[handle].compress) {
+        dai_cmp_put(ds_a, buf);
+        *id = ELIO_DONE;
+        return;
+    }
+    if ((ptr = dai_map_address(handle, offset, bytes)) != NULL) {
+        memcpy(ptr, buf, (size_t)bytes);
+        *id = ELIO_DONE;
+        return;
+    }
 #if WALLTIME
     walltime_(&ss0,&tt0);
 #endif
@@ -2423,6 +2660,7 @@ void ndai_get(section_t ds_a, void *buf, Integer ld[], io_request_t *id)
     Integer ndim = DRA[handle].ndim, i;
     Off_t   offset;
     Size_t  bytes;
+    char    *ptr;
 #if WALLTIME
     double ss0,tt0,tt1;
 #endif
@@ -2440,6 +2678,16 @@ void ndai_get(section_t ds_a, void *buf, Integer ld[], io_request_t *id)
     elem = 1;
     for (i=0; i<ndim; i++) elem *= (ds_a.hi[i]-ds_a.lo[i]+1);
     bytes= (Size_t) elem * dai_sizeofM(DRA[handle].type);
+    if (DRA[handle].compress) {
+        dai_cmp_get(ds_a, buf);
+        *id = ELIO_DONE;
+        return;
+    }
+    if ((ptr = dai_map_address(handle, offset, bytes)) != NULL) {
+        memcpy(buf, ptr, (size_t)bytes);
+        *id = ELIO_DONE;
+        return;
+    }
 #if WALLTIME
     walltime_(&ss0,&tt0);
 #endif
@@ -2827,7 +3075,11 @@ void wait_buf(char *buf)
                 pnga_nbwait(ga_movhdl);
             else {
                 elio_wait(io_req);
-                dai_exec_callback(buf, WAIT);
+                /* the move to g_a may already be in flight */
+                if (bi->callback == ON)
+                    dai_exec_callback(buf, WAIT);
+                else
+                    pnga_nbwait(ga_movhdl);
             }
             break;
 
@@ -2900,6 +3152,8 @@ void ndai_transfer_unlgn(
 
             if(dai_myturn(ds_chunk)){
 
+                ndai_prefetch_next(req, Requests[req].list_cover[next], ds_chunk);
+
                 /*find corresponding to chunk of 'cover' unaligned sub-subsection*/
                 for (i=0; i<ndim; i++) {
                     ds_unlg.lo[i] = Requests[req].list_unlgn[next][2*i];
@@ -2998,11 +3252,17 @@ void ndai_transfer_algn(
     Integer  next, chunk_ld[MAXDIM], ndim = ds_a.ndim;
     Integer i;
     section_t ds_chunk = ds_a;
-    char *buf, *buffer;
+    char *buf, *buffer, *prev = NULL;
     Integer *ga_movhdl;
     io_request_t *io_req;
     buf_info *bi;
 
+    /*
+     * Chunks are pipelined through the nbuf I/O buffers. For a write the
+     * disk write of a chunk is left in flight while g_a is read into the
+     * next buffer. For a read, once the disk read of the next chunk has
+     * been issued, the previous chunk is moved to g_a.
+     */
     for(next = 0; next < Requests[req].na; next++){
         for (i=0; i<ndim; i++) ds_chunk.lo[i] = 0; /*initialize */
 
@@ -3032,6 +3292,9 @@ void ndai_transfer_algn(
                 buffer = buf;
                 buf = buf + sizeof(buf_info);
 
+                /* for a mapped file, fault in the next chunk in background */
+                ndai_prefetch_next(req, Requests[req].list_algn[next], ds_chunk);
+
                 switch (opcode){
 
                     case DRA_OP_WRITE:
@@ -3053,6 +3316,14 @@ void ndai_transfer_algn(
                         /* copy data from DRA buffer to g_a */
                         /* nga_move(STORE, transp, gs_a, ds_a, ds_chunk, buf, chunk_ld, ga_movhdl); */
                         dai_callback(STORE, transp, gs_a, ds_a, ds_chunk, chunk_ld, buffer, req);
+
+                        /* start moving the previous chunk to g_a */
+                        if (prev != NULL && prev != buffer &&
+                                ((buf_info*)prev)->callback == ON) {
+                            elio_wait(&(((buf_info*)prev)->io_req));
+                            dai_exec_callback(prev, PROBE);
+                        }
+                        prev = buffer;
                         break;
 
                     default:
@@ -3124,6 +3395,7 @@ Integer FATR ndra_write_section_(logical *transp,
         dai_error("ndra_write_sect: d_a and g_a sections do not match ", 0L);
 
     dai_assign_request_handle(request);
+    Requests[*request].nbytes = (double)delem * dai_sizeofM(DRA[handle].type);
 
     /* decompose d_a section into aligned and unaligned subsections
      * -- with respect to underlying array layout on the disk
@@ -3135,6 +3407,13 @@ Integer FATR ndra_write_section_(logical *transp,
     nfill_sectionM(d_sect, *d_a, DRA[handle].ndim, dlo, dhi); 
     nfill_sectionM(g_sect, *g_a, ndim, glo, ghi); 
 
+    /* MPI-IO arrays are written by one collective call */
+    if (DRA[handle].mpiio) {
+        dai_mpiio_transfer(DRA_OP_WRITE, (int)*transp, d_sect, g_sect);
+        pnga_sync();
+        return(ELIO_OK);
+    }
+
     ndai_decomp_section(d_sect,
             Requests[*request].list_algn, 
             &Requests[*request].na,
@@ -3241,6 +3520,7 @@ Integer FATR ndra_read_section_(logical *transp,
         dai_error("ndra_read_sect: d_a and g_a sections do not match ", 0L);
 
     dai_assign_request_handle(request);
+    Requests[*request].nbytes = (double)delem * dai_sizeofM(DRA[handle].type);
 
     /* decompose d_a section into aligned and unaligned subsections
      * -- with respect to underlying array layout on the disk
@@ -3267,6 +3547,12 @@ Integer FATR ndra_read_section_(logical *transp,
     nfill_sectionM(d_sect, *d_a, DRA[handle].ndim, dlo, dhi); 
     nfill_sectionM(g_sect, *g_a, ndim, glo, ghi); 
 
+    /* MPI-IO arrays are read by one collective call */
+    if (DRA[handle].mpiio) {
+        dai_mpiio_transfer(DRA_OP_READ, (int)*transp, d_sect, g_sect);
+        return(ELIO_OK);
+    }
+
     ndai_decomp_section(d_sect,
             Requests[*request].list_algn, 
             &Requests[*request].na,
@@ -82,7 +82,7 @@ int dai_read_param(char* filename,Integer d_a)
     Integer len, i, ndim;
     Integer me=pnga_nodeid();
     Integer brd_type=DRA_BRD_TYPE, orig, dra_hndl=d_a+DRA_OFFSET;
-    long input;
+    long input, input2;
     int rc=0;
     char dummy[HDLEN];
 
@@ -123,7 +123,14 @@ int dai_read_param(char* filename,Integer d_a)
             if(!fscanf(fd,"%ld",&input))   dai_error("dai_read_param:ioprocs",0);
             DRA[dra_hndl].ioprocs = (Integer) input;
 
-            fgets(dummy,HDLEN,fd); /*advance to next line*/
+            /*advance to next line, files of older versions have no format*/
+            fgets(dummy,HDLEN,fd);
+            DRA[dra_hndl].compress = 0;
+            DRA[dra_hndl].mpiio = 0;
+            if(sscanf(dummy,"%ld %ld",&input,&input2) == 2)
+                DRA[dra_hndl].mpiio = (Integer) input2;
+            if(sscanf(dummy,"%ld",&input) == 1)
+                DRA[dra_hndl].compress = (Integer) input;
             if(!fgets(DRA[dra_hndl].name,DRA_MAX_NAME,fd))dai_error("dai_read_param:name",0);
 
             if(fclose(fd))dai_error("dai_read_param: fclose failed",0);
@@ -190,6 +197,10 @@ void dai_write_param(char* filename, Integer d_a)
             dai_error("dai_write_param:numfiles",0);
         if(!fprintf(fd,"%ld ",(long)DRA[dra_hndl].ioprocs)) 
             dai_error("dai_write_param:ioprocs",0);
+        if(!fprintf(fd,"%ld ",(long)DRA[dra_hndl].compress)) 
+            dai_error("dai_write_param:compress",0);
+        if(!fprintf(fd,"%ld ",(long)DRA[dra_hndl].mpiio)) 
+            dai_error("dai_write_param:mpiio",0);
 
         if(!fprintf(fd,"\n%s\n",DRA[dra_hndl].name))
             dai_error("dai_write_param:name",0);
@@ -85,6 +85,13 @@ extern int DRA_Delete(        int d_a);
 
 extern int DRA_Close(         int d_a);
 
+extern int DRA_Matmul(        int d_a,
+                              int d_b,
+                              int d_c);
+
+extern void DRA_Matmul_bytes(  double *nread,
+                              double *nwritten);
+
 extern void DRA_Flick();
 
 #ifdef __cplusplus
@@ -8,6 +8,8 @@
 #define dra_flick_           F77_FUNC_(dra_flick,DRA_FLICK)
 #define dra_init_            F77_FUNC_(dra_init,DRA_INIT)
 #define dra_inquire_         F77_FUNC_(dra_inquire,DRA_INQUIRE)
+#define dra_matmul_          F77_FUNC_(dra_matmul,DRA_MATMUL)
+#define dra_matmul_bytes_    F77_FUNC_(dra_matmul_bytes,DRA_MATMUL_BYTES)
 #define dra_open_            F77_FUNC_(dra_open,DRA_OPEN)
 #define dra_print_internals_ F77_FUNC_(dra_print_internals,DRA_PRINT_INTERNALS)
 #define dra_probe_           F77_FUNC_(dra_probe,DRA_PROBE)
@@ -41,8 +41,18 @@ typedef struct {                 /**< stores basic DRA info */
     Fd_t fd;                     /**< ELIO meta-file descriptor */
     Integer numfiles;            /**< # files on open file system */
     Integer ioprocs;             /**< number of IO procs per node */
+    int usemap;                  /**< access file through mmap ? */
+    char *map;                   /**< address of file mapping or NULL */
+    Off_t maplen;                /**< length of file mapping */
+    Integer compress;            /**< chunk compressed file format ? */
+    void *cmp;                   /**< chunk index if compressed, see compress.c */
+    Integer mpiio;               /**< dense file accessed through MPI-IO ? */
+    void *mpifh;                 /**< MPI_File if opened by dai_mpiio_open */
 } disk_array_t;
 
+#define DRA_OP_WRITE 777 /**< op code of write requests */
+#define DRA_OP_READ  888 /**< op code of read requests */
+
 #define MAX_ALGN  1                /**< max # aligned subsections   */ 
 #define MAX_UNLG  (2*(MAXDIM-1))   /**< max # unaligned subsections */
 
@@ -73,6 +83,8 @@ typedef struct {         /**< stores info associated with DRA request */
     int        nu;            
     int        na;
     int        call_id; /**< id of this request */
+    double     nbytes;  /**< size of the section moved by this request */
+    double     start;   /**< time the request was issued */
 } request_t;
 
 typedef struct {
@@ -87,6 +99,8 @@ typedef struct {
 
 extern disk_array_t *DRA;
 extern logical dra_debug_flag;
+extern Integer _max_disk_array;
+extern double _dra_max_memory;
 
 /**************************** common macros ********************************/
 #define PARIO_MAX(a,b) (((a) >= (b)) ? (a) : (b))
@@ -94,12 +108,43 @@ extern logical dra_debug_flag;
 
 #define dai_error pnga_error
 
+#define dai_check_handleM(_handle, msg)                                    \
+{\
+        if((_handle+DRA_OFFSET)>=_max_disk_array || (_handle+DRA_OFFSET)<0) \
+        {fprintf(stderr,"%s, %ld --",msg, (long)_max_disk_array);\
+        dai_error("invalid DRA handle",_handle);}                           \
+        if( DRA[(_handle+DRA_OFFSET)].actv == 0)                            \
+        {fprintf(stderr,"%s:",msg);\
+        dai_error("disk array not active",_handle);}                       \
+}
+
 extern int     dai_read_param(char* filename, Integer d_a);
 extern void    dai_write_param(char* filename, Integer d_a);
 extern void    dai_delete_param(char* filename, Integer d_a);
 extern int     dai_file_config(char* filename);
 extern logical dai_section_intersect(section_t sref, section_t* sadj);
 extern int     drai_get_num_serv(void);
+extern int     drai_get_num_buf(void);
+extern int     drai_get_report_rate(void);
+extern int     drai_get_mmap(void);
+extern int     drai_get_compress(void);
+extern int     drai_get_mpiio(void);
+extern int     dai_read_allowed(Integer d_a);
+extern int     dai_write_allowed(Integer d_a);
+extern void    dai_unmap(Integer handle);
+extern int     ndai_next_chunk(Integer req, Integer* list, section_t* ds_chunk);
+extern void    ndai_prefetch_next(Integer req, Integer* list, section_t ds_chunk);
+extern Integer dai_io_procs(Integer d_a);
+extern Integer dai_io_nodeid(Integer d_a);
+extern void    dai_cmp_open(Integer handle, int fresh);
+extern void    dai_cmp_close(Integer handle, int save);
+extern void    dai_cmp_put(section_t ds_a, void *buf);
+extern void    dai_cmp_get(section_t ds_a, void *buf);
+extern int     dai_mpiio_same_file(Integer handle);
+extern void    dai_mpiio_open(Integer handle, int fresh);
+extern void    dai_mpiio_close(Integer handle);
+extern void    dai_mpiio_transfer(int op, int transp, section_t ds_a,
+                                  section_t gs_a);
 
 /* internal fortran calls */
 extern Integer drai_create(Integer *type, Integer *dim1, Integer *dim2, 
@@ -213,3 +258,8 @@ extern Integer FATR dra_close_(Integer* d_a);
 extern void dra_flick_();
 
 extern Integer FATR dra_wait_(Integer* request);
+
+extern Integer FATR dra_matmul_(Integer *d_a, Integer *d_b, Integer *d_c);
+
+extern void FATR dra_matmul_bytes_(DoublePrecision *nread,
+        DoublePrecision *nwritten);
@@ -16,6 +16,8 @@
 #   include <string.h>
 #endif
 
+#include "buffers.h"
+
 #define MAX_NUM_SERV 64
 
 /**
@@ -34,3 +36,77 @@ int drai_get_num_serv()
     }
     return val;
 }  
+
+
+/**
+ * get number of I/O buffers, i.e. the depth of the transfer pipeline, from
+ * optional environmental variable DRA_NUM_BUFFERS
+ */
+int drai_get_num_buf()
+{
+    int  val=DEFBUF;
+    char *str;
+
+    str = getenv("DRA_NUM_BUFFERS");
+    if(str!=NULL){
+        val = atoi(str);
+        if(val<1 || val>MAXBUF)val = DEFBUF;
+    }
+    return val;
+}
+
+
+/**
+ * report bandwidth of every DRA request if optional environmental variable
+ * DRA_REPORT_RATE is set to a nonzero value
+ */
+int drai_get_report_rate()
+{
+    char *str;
+
+    str = getenv("DRA_REPORT_RATE");
+    if(str==NULL)return 0;
+    return atoi(str) != 0;
+}
+
+
+/**
+ * access independent DRA files through a memory mapping instead of ELIO
+ * if optional environmental variable DRA_MMAP is set to a nonzero value
+ */
+int drai_get_mmap()
+{
+    char *str;
+
+    str = getenv("DRA_MMAP");
+    if(str==NULL)return 0;
+    return atoi(str) != 0;
+}
+
+
+/**
+ * create disk arrays in the chunk compressed format if optional
+ * environmental variable DRA_COMPRESS is set to a nonzero value
+ */
+int drai_get_compress()
+{
+    char *str;
+
+    str = getenv("DRA_COMPRESS");
+    if(str==NULL)return 0;
+    return atoi(str) != 0;
+}
+
+
+/**
+ * create disk arrays as a single dense file accessed with collective MPI-IO
+ * if optional environmental variable DRA_MPIIO is set to a nonzero value
+ */
+int drai_get_mpiio()
+{
+    char *str;
+
+    str = getenv("DRA_MPIIO");
+    if(str==NULL)return 0;
+    return atoi(str) != 0;
+}
@@ -0,0 +1,215 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/** @file
+ * Out-of-core matrix multiply of disk resident arrays, C = A*B.
+ *
+ * The operands are cut into tiles that fit the memory given to DRA by
+ * dra_init (max_memory per process, DRA_MATMUL_MEM if that was -1). Tiles are
+ * held in global arrays, two for each of A and B and two for C, and every
+ * tile product is done by pnga_matmul_patch. The reads of the next pair of A
+ * and B tiles are issued before the current pair is multiplied, and a
+ * finished C tile is written back while the next one is being computed, so
+ * that disk I/O overlaps computation as far as the DRA layer is asynchronous.
+ */
+
+#if HAVE_MATH_H
+#   include <math.h>
+#endif
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+
+#include "dra.h"
+#include "draf2c.h"
+#include "drap.h"
+#include "ga-papi.h"
+#include "macdecls.h"
+
+#define DRA_MATMUL_MEM (64.0*1024*1024) /**< default tile memory per process */
+
+#define dai_sizeofM(_type) MA_sizeof(_type, 1, MT_C_CHAR)
+
+/* disk array bytes moved by the last dra_matmul, see dra_matmul_bytes */
+static double dai_matmul_nread = 0.0, dai_matmul_nwritten = 0.0;
+
+
+/* bounds of tile t of size b along a dimension of extent n */
+static void dai_tile(Integer t, Integer b, Integer n, Integer *lo, Integer *hi)
+{
+    *lo = t*b + 1;
+    *hi = PARIO_MIN((t+1)*b, n);
+}
+
+
+/* issue the reads of tiles A(ti,tk) and B(tk,tj) into tile buffers g_a, g_b */
+static void dai_matmul_read(Integer d_a, Integer d_b, Integer g_a, Integer g_b,
+        Integer ti, Integer tj, Integer tk, Integer *tb, Integer *dims,
+        Integer *ra, Integer *rb)
+{
+    logical transp = FALSE;
+    Integer glo[2], ghi[2], dlo[2], dhi[2];
+    double size = (double)dai_sizeofM(DRA[d_a+DRA_OFFSET].type);
+
+    /* A is dims[0] x dims[1], B is dims[1] x dims[2] */
+    dai_tile(ti, tb[0], dims[0], &dlo[0], &dhi[0]);
+    dai_tile(tk, tb[1], dims[1], &dlo[1], &dhi[1]);
+    glo[0] = glo[1] = 1;
+    ghi[0] = dhi[0] - dlo[0] + 1;
+    ghi[1] = dhi[1] - dlo[1] + 1;
+    ndra_read_section_(&transp, &g_a, glo, ghi, &d_a, dlo, dhi, ra);
+    dai_matmul_nread += size*ghi[0]*ghi[1];
+
+    dai_tile(tk, tb[1], dims[1], &dlo[0], &dhi[0]);
+    dai_tile(tj, tb[2], dims[2], &dlo[1], &dhi[1]);
+    ghi[0] = dhi[0] - dlo[0] + 1;
+    ghi[1] = dhi[1] - dlo[1] + 1;
+    ndra_read_section_(&transp, &g_b, glo, ghi, &d_b, dlo, dhi, rb);
+    dai_matmul_nread += size*ghi[0]*ghi[1];
+}
+
+
+/**
+ * Multiply disk arrays, C = A*B. A, B and C must be two-dimensional arrays
+ * of the same type (double, float, double or single complex), A and B open
+ * for reading and C open for writing. Collective.
+ *
+ * @param d_a[in] DRA handle of A (m x k)
+ * @param d_b[in] DRA handle of B (k x n)
+ * @param d_c[in] DRA handle of C (m x n)
+ */
+Integer FATR dra_matmul_(Integer *d_a, Integer *d_b, Integer *d_c)
+{
+    Integer ha = *d_a+DRA_OFFSET, hb = *d_b+DRA_OFFSET, hc = *d_c+DRA_OFFSET;
+    Integer dims[3], tb[3], nt[3], tdims[2];
+    Integer ga[2], gb[2], gc[2], ra[2], rb[2], rc[2];
+    Integer step, nstep, ti, tj, tk, cur, c, i, type;
+    Integer alo[2], ahi[2], blo[2], bhi[2], clo[2], chi[2], dlo[2], dhi[2];
+    logical transp = FALSE;
+    double one[2] = {1.0, 0.0}, zero[2] = {0.0, 0.0};
+    float fone[2] = {1.0f, 0.0f}, fzero[2] = {0.0f, 0.0f};
+    void *alpha, *beta0, *beta1;
+    double mem, tile;
+
+    dai_check_handleM(*d_a, "dra_matmul");
+    dai_check_handleM(*d_b, "dra_matmul");
+    dai_check_handleM(*d_c, "dra_matmul");
+    if (DRA[ha].ndim != 2 || DRA[hb].ndim != 2 || DRA[hc].ndim != 2)
+        dai_error("dra_matmul: arrays must be two-dimensional", 0);
+    type = DRA[ha].type;
+    if (DRA[hb].type != type || DRA[hc].type != type)
+        dai_error("dra_matmul: type mismatch", type);
+    if (DRA[ha].dims[1] != DRA[hb].dims[0] ||
+            DRA[ha].dims[0] != DRA[hc].dims[0] ||
+            DRA[hb].dims[1] != DRA[hc].dims[1])
+        dai_error("dra_matmul: dimension mismatch", 0);
+    if (!dai_read_allowed(*d_a) || !dai_read_allowed(*d_b))
+        dai_error("dra_matmul: A and B must be readable", 0);
+    if (!dai_write_allowed(*d_c))
+        dai_error("dra_matmul: C must be writable", *d_c);
+
+    switch (type) {
+        case C_DBL: case C_DCPL:
+            alpha = one; beta0 = zero; beta1 = one; break;
+        case C_FLOAT: case C_SCPL:
+            alpha = fone; beta0 = fzero; beta1 = fone; break;
+        default:
+            dai_error("dra_matmul: type not supported", type);
+            alpha = beta0 = beta1 = NULL;
+    }
+
+    dims[0] = DRA[ha].dims[0];
+    dims[1] = DRA[ha].dims[1];
+    dims[2] = DRA[hb].dims[1];
+
+    /* six square tiles share the memory of all processes */
+    mem = _dra_max_memory > 0 ? _dra_max_memory : DRA_MATMUL_MEM;
+    tile = sqrt(mem*pnga_nnodes()/(6.0*dai_sizeofM(type)));
+    for (i=0; i<3; i++) {
+        tb[i] = PARIO_MAX(1, PARIO_MIN((Integer)tile, dims[i]));
+        nt[i] = (dims[i] + tb[i] - 1)/tb[i];
+    }
+
+    for (i=0; i<2; i++) {
+        tdims[0] = tb[0]; tdims[1] = tb[1];
+        if (!pnga_create(type, 2, tdims, "dra_matmul_a", NULL, &ga[i]))
+            dai_error("dra_matmul: tile allocation failed", tb[0]*tb[1]);
+        tdims[0] = tb[1]; tdims[1] = tb[2];
+        if (!pnga_create(type, 2, tdims, "dra_matmul_b", NULL, &gb[i]))
+            dai_error("dra_matmul: tile allocation failed", tb[1]*tb[2]);
+        tdims[0] = tb[0]; tdims[1] = tb[2];
+        if (!pnga_create(type, 2, tdims, "dra_matmul_c", NULL, &gc[i]))
+            dai_error("dra_matmul: tile allocation failed", tb[0]*tb[2]);
+        rc[i] = DRA_REQ_INVALID;
+    }
+
+    /* steps run over C tiles row by row, and over k inside a C tile */
+    nstep = nt[0]*nt[2]*nt[1];
+    dai_matmul_nread = dai_matmul_nwritten = 0.0;
+    dai_matmul_read(*d_a, *d_b, ga[0], gb[0], 0, 0, 0, tb, dims, &ra[0],&rb[0]);
+    c = 0;
+    for (step=0; step<nstep; step++) {
+        cur = step%2;
+        ti = step/(nt[2]*nt[1]);
+        tj = (step/nt[1])%nt[2];
+        tk = step%nt[1];
+
+        dra_wait_(&ra[cur]);
+        dra_wait_(&rb[cur]);
+        if (step+1 < nstep)
+            dai_matmul_read(*d_a, *d_b, ga[1-cur], gb[1-cur],
+                    (step+1)/(nt[2]*nt[1]), ((step+1)/nt[1])%nt[2],
+                    (step+1)%nt[1], tb, dims, &ra[1-cur], &rb[1-cur]);
+
+        /* the C tile buffer may still be draining to disk */
+        if (tk == 0 && rc[c] != DRA_REQ_INVALID) {
+            dra_wait_(&rc[c]);
+            rc[c] = DRA_REQ_INVALID;
+        }
+
+        dai_tile(ti, tb[0], dims[0], &dlo[0], &dhi[0]);
+        dai_tile(tk, tb[1], dims[1], &dlo[1], &dhi[1]);
+        alo[0] = alo[1] = blo[0] = blo[1] = clo[0] = clo[1] = 1;
+        ahi[0] = chi[0] = dhi[0] - dlo[0] + 1;
+        ahi[1] = bhi[0] = dhi[1] - dlo[1] + 1;
+        dai_tile(tj, tb[2], dims[2], &dlo[1], &dhi[1]);
+        bhi[1] = chi[1] = dhi[1] - dlo[1] + 1;
+        pnga_matmul_patch("N", "N", alpha, tk == 0 ? beta0 : beta1,
+                ga[cur], alo, ahi, gb[cur], blo, bhi, gc[c], clo, chi);
+
+        if (tk == nt[1]-1) {
+            dai_tile(ti, tb[0], dims[0], &dlo[0], &dhi[0]);
+            ndra_write_section_(&transp, &gc[c], clo, chi, d_c, dlo, dhi,
+                    &rc[c]);
+            dai_matmul_nwritten += (double)chi[0]*chi[1]*dai_sizeofM(type);
+            c = 1-c;
+        }
+    }
+
+    for (i=0; i<2; i++) {
+        if (rc[i] != DRA_REQ_INVALID) dra_wait_(&rc[i]);
+        pnga_destroy(ga[i]);
+        pnga_destroy(gb[i]);
+        pnga_destroy(gc[i]);
+    }
+    return ELIO_OK;
+}
+
+
+/**
+ * Bytes of disk array data read and written by the last dra_matmul. A and
+ * B are read once for every tile column and tile row of C respectively, so
+ * this is more than the size of the operands unless they fit in one tile.
+ *
+ * @param nread[out]    bytes read from A and B
+ * @param nwritten[out] bytes written to C
+ */
+void FATR dra_matmul_bytes_(DoublePrecision *nread, DoublePrecision *nwritten)
+{
+    *nread = dai_matmul_nread;
+    *nwritten = dai_matmul_nwritten;
+}
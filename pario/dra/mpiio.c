@@ -0,0 +1,270 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/** @file
+ * MPI-IO backend for disk resident arrays.
+ *
+ * Arrays created with DRA_MPIIO set are stored as one dense column-major
+ * image of the whole array in the shared file fname, independently of the
+ * numfiles/ioprocs configuration. A section transfer is a single collective
+ * MPI_File_write_at_all/MPI_File_read_at_all: every process describes the
+ * part of the section held in its local block of the global array by a
+ * subarray file view and a subarray memory datatype over the block, and the
+ * aggregators of the MPI library take care of two-phase I/O and striping.
+ *
+ * Local blocks are accessed in place. Transposed transfers, sections whose
+ * shape differs from that of the disk section and block cyclic global arrays
+ * are staged through a temporary global array with the shape of the disk
+ * section.
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+
+#include "dra.h"
+#include "drap.h"
+#include "ga-papi.h"
+#include "macdecls.h"
+
+#ifdef MSG_COMMS_MPI
+#include "ga-mpi.h"
+
+#define dai_sizeofM(_type) MA_sizeof(_type, 1, MT_C_CHAR)
+
+
+/**
+ * Return nonzero if every process passed the same file name for disk array
+ * handle, which MPI_File_open requires. Collective.
+ *
+ * @param handle[in] DRA handle + DRA_OFFSET
+ */
+int dai_mpiio_same_file(Integer handle)
+{
+    char fname[DRA_MAX_FNAME+8];
+    Integer same;
+
+    strcpy(fname, DRA[handle].fname);
+    pnga_brdcst(DRA_BRD_TYPE, fname, (Integer)sizeof(fname), 0);
+    same = strcmp(fname, DRA[handle].fname) == 0;
+    pnga_gop(pnga_type_f2c(MT_F_INT), &same, (Integer)1, "min");
+    return (int)same;
+}
+
+
+/**
+ * Open the file of disk array handle collectively, creating it with the
+ * length of the full array image if fresh is set.
+ *
+ * @param handle[in] DRA handle + DRA_OFFSET
+ * @param fresh[in]  the array is being created
+ */
+void dai_mpiio_open(Integer handle, int fresh)
+{
+    MPI_File *fh;
+    MPI_Info info;
+    MPI_Offset size;
+    int amode, rc, i;
+
+    if (DRA[handle].mode == DRA_R) amode = MPI_MODE_RDONLY;
+    else if (DRA[handle].mode == DRA_W) amode = MPI_MODE_WRONLY;
+    else amode = MPI_MODE_RDWR;
+    if (fresh) amode |= MPI_MODE_CREATE;
+
+    fh = (MPI_File*) malloc(sizeof(MPI_File));
+    if (!fh) dai_error("dai_mpiio_open: malloc failed", 0);
+
+    /* ask for collective buffering, ROMIO does not always enable it */
+    MPI_Info_create(&info);
+    MPI_Info_set(info, "romio_cb_write", "enable");
+    MPI_Info_set(info, "romio_cb_read", "enable");
+
+    rc = MPI_File_open(GA_MPI_Comm_pgroup_default(), DRA[handle].fname,
+            amode, info, fh);
+    MPI_Info_free(&info);
+    if (rc != MPI_SUCCESS) dai_error("dai_mpiio_open: open failed", rc);
+
+    /* a fresh array reads as zeros, like the ELIO files stamped at EOF */
+    if (fresh && DRA[handle].mode != DRA_R) {
+        size = (MPI_Offset) dai_sizeofM(DRA[handle].type);
+        for (i=0; i<DRA[handle].ndim; i++) size *= DRA[handle].dims[i];
+        if (MPI_File_set_size(*fh, size) != MPI_SUCCESS)
+            dai_error("dai_mpiio_open: set size failed", 0);
+    }
+
+    DRA[handle].mpifh = fh;
+}
+
+
+/**
+ * Collectively close the file of disk array handle if it was opened by
+ * dai_mpiio_open.
+ *
+ * @param handle[in] DRA handle + DRA_OFFSET
+ */
+void dai_mpiio_close(Integer handle)
+{
+    MPI_File *fh = (MPI_File*) DRA[handle].mpifh;
+
+    if (!fh) return;
+    if (MPI_File_close(fh) != MPI_SUCCESS)
+        dai_error("dai_mpiio_close: close failed", 0);
+    free(fh);
+    DRA[handle].mpifh = NULL;
+}
+
+
+/**
+ * Collectively move gs_a between its global array and the disk section ds_a
+ * of the same shape. Each process contributes the intersection of gs_a with
+ * its local block; processes without data contribute zero bytes.
+ */
+static void dai_mpiio_move(int op, section_t gs_a, section_t ds_a)
+{
+    Integer handle = ds_a.handle + DRA_OFFSET;
+    Integer me = pnga_nodeid();
+    Integer lo[MAXDIM], hi[MAXDIM], ld[MAXDIM-1];
+    MPI_File fh = *(MPI_File*) DRA[handle].mpifh;
+    MPI_Datatype etype, ftype, mtype;
+    MPI_Status status;
+    int sizes[MAXDIM], subsizes[MAXDIM], starts[MAXDIM], msizes[MAXDIM];
+    int zeros[MAXDIM];
+    int i, ndim = (int) ds_a.ndim, count = 0, rc;
+    char *ptr = NULL;
+
+    MPI_Type_contiguous((int) dai_sizeofM(DRA[handle].type), MPI_BYTE, &etype);
+    MPI_Type_commit(&etype);
+
+    pnga_distribution(gs_a.handle, me, lo, hi);
+    for (i=0; i<ndim; i++) {
+        lo[i] = PARIO_MAX(lo[i], gs_a.lo[i]);
+        hi[i] = PARIO_MIN(hi[i], gs_a.hi[i]);
+        if (lo[i] > hi[i]) break;
+    }
+
+    if (i == ndim) {
+        pnga_access_ptr(gs_a.handle, lo, hi, &ptr, ld);
+        for (i=0; i<ndim; i++) {
+            sizes[i]    = (int) DRA[handle].dims[i];
+            subsizes[i] = (int) (hi[i] - lo[i] + 1);
+            starts[i]   = (int) (ds_a.lo[i] - 1 + lo[i] - gs_a.lo[i]);
+            msizes[i]   = (i < ndim-1) ? (int) ld[i] : subsizes[i];
+            zeros[i]    = 0;
+        }
+        MPI_Type_create_subarray(ndim, sizes, subsizes, starts,
+                MPI_ORDER_FORTRAN, etype, &ftype);
+        MPI_Type_create_subarray(ndim, msizes, subsizes, zeros,
+                MPI_ORDER_FORTRAN, etype, &mtype);
+        MPI_Type_commit(&mtype);
+        count = 1;
+    } else {
+        MPI_Type_dup(etype, &ftype);
+        MPI_Type_dup(etype, &mtype);
+        MPI_Type_commit(&mtype);
+    }
+    MPI_Type_commit(&ftype);
+
+    rc = MPI_File_set_view(fh, 0, etype, ftype, "native", MPI_INFO_NULL);
+    if (rc != MPI_SUCCESS) dai_error("dai_mpiio_move: set view failed", rc);
+
+    if (op == DRA_OP_WRITE)
+        rc = MPI_File_write_at_all(fh, 0, ptr, count, mtype, &status);
+    else
+        rc = MPI_File_read_at_all(fh, 0, ptr, count, mtype, &status);
+    if (rc != MPI_SUCCESS) dai_error("dai_mpiio_move: transfer failed", rc);
+
+    if (count) {
+        if (op == DRA_OP_WRITE) pnga_release(gs_a.handle, lo, hi);
+        else pnga_release_update(gs_a.handle, lo, hi);
+    }
+
+    MPI_Type_free(&mtype);
+    MPI_Type_free(&ftype);
+    MPI_Type_free(&etype);
+}
+
+
+/**
+ * Transfer section gs_a of a global array to/from section ds_a of a disk
+ * array stored in the MPI-IO format. Collective, completes before return.
+ *
+ * @param op[in]     DRA_OP_WRITE or DRA_OP_READ
+ * @param transp[in] transpose gs_a
+ * @param ds_a[in]   disk array section
+ * @param gs_a[in]   global array section
+ */
+void dai_mpiio_transfer(int op, int transp, section_t ds_a, section_t gs_a)
+{
+    Integer handle = ds_a.handle + DRA_OFFSET;
+    Integer dims[MAXDIM], g_b;
+    Integer i, ndim = ds_a.ndim;
+    section_t bs_a;
+    int direct;
+    char *trans = transp ? "T" : "N";
+
+    direct = !transp && gs_a.ndim == ds_a.ndim &&
+        pnga_total_blocks(gs_a.handle) <= 0 &&
+        pnga_get_pgroup(gs_a.handle) == pnga_pgroup_get_default();
+    for (i=0; direct && i<ndim; i++)
+        if (gs_a.hi[i]-gs_a.lo[i] != ds_a.hi[i]-ds_a.lo[i]) direct = 0;
+
+    if (direct) {
+        dai_mpiio_move(op, gs_a, ds_a);
+        return;
+    }
+
+    /* stage through a global array shaped like the disk section */
+    for (i=0; i<ndim; i++) dims[i] = ds_a.hi[i] - ds_a.lo[i] + 1;
+    if (!pnga_create(DRA[handle].type, ndim, dims, "dra_mpiio", NULL, &g_b))
+        dai_error("dai_mpiio_transfer: staging array create failed", 0);
+
+    bs_a.handle = g_b;
+    bs_a.ndim = ndim;
+    for (i=0; i<ndim; i++) {
+        bs_a.lo[i] = 1;
+        bs_a.hi[i] = dims[i];
+    }
+
+    if (op == DRA_OP_WRITE) {
+        pnga_copy_patch(trans, gs_a.handle, gs_a.lo, gs_a.hi,
+                g_b, bs_a.lo, bs_a.hi);
+        pnga_sync();
+    }
+    dai_mpiio_move(op, bs_a, ds_a);
+    if (op == DRA_OP_READ) {
+        pnga_sync();
+        pnga_copy_patch(trans, g_b, bs_a.lo, bs_a.hi,
+                gs_a.handle, gs_a.lo, gs_a.hi);
+    }
+    pnga_destroy(g_b);
+}
+
+#else
+
+int dai_mpiio_same_file(Integer handle)
+{
+    return 0;
+}
+
+void dai_mpiio_open(Integer handle, int fresh)
+{
+    dai_error("dai_mpiio_open: MPI-IO requires an MPI build", 0);
+}
+
+void dai_mpiio_close(Integer handle)
+{
+}
+
+void dai_mpiio_transfer(int op, int transp, section_t ds_a, section_t gs_a)
+{
+    dai_error("dai_mpiio_transfer: MPI-IO requires an MPI build", 0);
+}
+
+#endif
@@ -0,0 +1,220 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* disk arrays accessed through MPI-IO (DRA_MPIIO=1): the file must hold the
+ * dense image of the array, and sections written and read in place, with a
+ * different shape than on disk, transposed and into a block cyclic global
+ * array, which are staged, must agree with a reference array updated by
+ * NGA_Copy_patch. */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#include <sys/stat.h>
+
+#include "dra.h"
+#include "ga.h"
+#include "macdecls.h"
+#include "testutil.h"
+
+#define FNAME "dra_mpiio"
+#define N     120
+#define M     90
+
+static int me, nproc;
+
+static double value(int i, int j)
+{
+    return (double)(i*M + j + 1);
+}
+
+static void set_local(int g_a, double sign)
+{
+    int lo[2], hi[2], ld[1], i, j;
+    double *ptr;
+
+    NGA_Distribution(g_a, me, lo, hi);
+    if (lo[0] < 0 || lo[0] > hi[0]) return;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    for (i=lo[0]; i<=hi[0]; i++)
+        for (j=lo[1]; j<=hi[1]; j++)
+            ptr[(i-lo[0])*ld[0] + j-lo[1]] = sign*value(i, j);
+    NGA_Release_update(g_a, lo, hi);
+}
+
+/* g_a and g_b have the same contents, whatever their distributions */
+static int same(int g_a, int g_b)
+{
+    int lo[2] = {0, 0}, hi[2] = {N-1, M-1}, ld[1] = {M}, i, ok = 1;
+    double *a, *b;
+
+    a = (double*)malloc(sizeof(double)*N*M);
+    b = (double*)malloc(sizeof(double)*N*M);
+    NGA_Get(g_a, lo, hi, a, ld);
+    NGA_Get(g_b, lo, hi, b, ld);
+    for (i=0; i<N*M; i++) ok = ok && a[i] == b[i];
+    free(b);
+    free(a);
+    GA_Igop(&ok, 1, "min");
+    return ok;
+}
+
+static void set_range(int lo[], int hi[], dra_size_t dlo[], dra_size_t dhi[],
+        int lo0, int hi0, int lo1, int hi1)
+{
+    lo[0] = lo0; hi[0] = hi0; lo[1] = lo1; hi[1] = hi1;
+    if (dlo) {
+        dlo[0] = lo0; dhi[0] = hi0; dlo[1] = lo1; dhi[1] = hi1;
+    }
+}
+
+/* g_src[glo:ghi] to d_a[dlo:dhi], and the same to the reference g_ref */
+static void write_section(int transp, int g_src, int glo[], int ghi[],
+        int g_ref, int d_a, int lo[], int hi[], dra_size_t dlo[],
+        dra_size_t dhi[])
+{
+    int req;
+
+    test_check(NDRA_Write_section(transp, g_src, glo, ghi, d_a, dlo, dhi,
+                &req) == 0, "NDRA_Write_section");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    NGA_Copy_patch(transp ? 't' : 'n', g_src, glo, ghi, g_ref, lo, hi);
+}
+
+/* d_a[dlo:dhi] to g_dst[glo:ghi], compared with the same section of g_ref */
+static void read_section(int transp, int g_dst, int glo[], int ghi[],
+        int g_ref, int d_a, int lo[], int hi[], dra_size_t dlo[],
+        dra_size_t dhi[], int g_tmp, const char *what)
+{
+    int req;
+
+    GA_Zero(g_dst);
+    GA_Zero(g_tmp);
+    test_check(NDRA_Read_section(transp, g_dst, glo, ghi, d_a, dlo, dhi,
+                &req) == 0, "NDRA_Read_section");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    NGA_Copy_patch(transp ? 't' : 'n', g_ref, lo, hi, g_tmp, glo, ghi);
+    test_check(same(g_dst, g_tmp), what);
+}
+
+/* the file is the row major image of the reference, nothing more */
+static void check_file(int g_ref)
+{
+    int lo[2] = {0, 0}, hi[2] = {N-1, M-1}, ld[1] = {M}, i, ok = 1;
+    double *a, *b;
+    struct stat st;
+    FILE *fp;
+
+    GA_Sync();
+    a = (double*)malloc(sizeof(double)*N*M);
+    b = (double*)malloc(sizeof(double)*N*M);
+    NGA_Get(g_ref, lo, hi, a, ld);
+    if (me == 0) {
+        ok = stat(FNAME, &st) == 0
+            && st.st_size == (off_t)(sizeof(double)*N*M);
+        if (ok) {
+            fp = fopen(FNAME, "rb");
+            ok = fp && fread(b, sizeof(double), N*M, fp) == N*M;
+            if (fp) fclose(fp);
+        }
+        for (i=0; ok && i<N*M; i++) ok = a[i] == b[i];
+    }
+    free(b);
+    free(a);
+    GA_Igop(&ok, 1, "min");
+    test_check(ok, "dense image on disk");
+}
+
+int main(int argc, char **argv)
+{
+    int dims[2] = {N, M}, block[2] = {7, 11};
+    int g_a, g_b, g_c, g_r, g_k, d_a, req;
+    int glo[2], ghi[2], lo[2], hi[2];
+    dra_size_t ddims[2] = {N, M}, reqdims[2] = {N/2, M/2}, dlo[2], dhi[2];
+    struct stat st;
+
+    setenv("DRA_MPIIO", "1", 1);
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+    if (DRA_Init(4, 1e8, 1e10, 1e6) != 0) GA_Error("DRA_Init failed", 0);
+    if (me == 0) printf("Testing MPI-IO disk arrays on %d processes\n", nproc);
+
+    g_a = NGA_Create(C_DBL, 2, dims, "a", NULL);
+    g_b = GA_Duplicate(g_a, "b");
+    g_c = GA_Duplicate(g_a, "c");
+    g_r = GA_Duplicate(g_a, "reference");
+    g_k = NGA_Create_handle();
+    NGA_Set_data(g_k, 2, dims, C_DBL);
+    NGA_Set_block_cyclic(g_k, block);
+    test_check(NGA_Allocate(g_k), "block cyclic array");
+    set_local(g_a, 1.0);
+    set_local(g_c, -1.0);
+    GA_Sync();
+
+    /* whole array */
+    test_check(NDRA_Create(C_DBL, 2, ddims, "mpiio", FNAME, DRA_RW, reqdims,
+                &d_a) == 0, "NDRA_Create");
+    test_check(NDRA_Write(g_a, d_a, &req) == 0, "NDRA_Write");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    GA_Copy(g_a, g_r);
+    test_check(DRA_Close(d_a) == 0, "DRA_Close");
+    check_file(g_r);
+
+    /* in place at another offset, reshaped, and transposed */
+    test_check(DRA_Open(FNAME, DRA_RW, &d_a) == 0, "DRA_Open");
+    set_range(glo, ghi, NULL, NULL, 10, 49, 5, 40);
+    set_range(lo, hi, dlo, dhi, 60, 99, 40, 75);
+    write_section(0, g_c, glo, ghi, g_r, d_a, lo, hi, dlo, dhi);
+    set_range(glo, ghi, NULL, NULL, 0, 9, 0, 59);
+    set_range(lo, hi, dlo, dhi, 100, 119, 50, 79);
+    write_section(0, g_c, glo, ghi, g_r, d_a, lo, hi, dlo, dhi);
+    set_range(glo, ghi, NULL, NULL, 20, 49, 0, 9);
+    set_range(lo, hi, dlo, dhi, 0, 9, 60, 89);
+    write_section(1, g_c, glo, ghi, g_r, d_a, lo, hi, dlo, dhi);
+    test_check(DRA_Close(d_a) == 0, "DRA_Close");
+    check_file(g_r);
+
+    /* read back as a whole, into a block cyclic array and by sections */
+    test_check(DRA_Open(FNAME, DRA_R, &d_a) == 0, "DRA_Open");
+    GA_Zero(g_b);
+    test_check(NDRA_Read(g_b, d_a, &req) == 0, "NDRA_Read");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    test_check(same(g_b, g_r), "read after section writes");
+    GA_Zero(g_k);
+    test_check(NDRA_Read(g_k, d_a, &req) == 0, "NDRA_Read");
+    test_check(DRA_Wait(req) == 0, "DRA_Wait");
+    test_check(same(g_k, g_r), "read into a block cyclic array");
+    set_range(glo, ghi, NULL, NULL, 5, 44, 7, 50);
+    set_range(lo, hi, dlo, dhi, 70, 109, 30, 73);
+    read_section(0, g_b, glo, ghi, g_r, d_a, lo, hi, dlo, dhi, g_c,
+            "section read");
+    set_range(glo, ghi, NULL, NULL, 0, 29, 0, 19);
+    set_range(lo, hi, dlo, dhi, 50, 69, 10, 39);
+    read_section(1, g_b, glo, ghi, g_r, d_a, lo, hi, dlo, dhi, g_c,
+            "transposed section read");
+    set_range(glo, ghi, NULL, NULL, 3, 62, 1, 10);
+    set_range(lo, hi, dlo, dhi, 0, 19, 0, 29);
+    read_section(0, g_b, glo, ghi, g_r, d_a, lo, hi, dlo, dhi, g_c,
+            "reshaped section read");
+    set_range(glo, ghi, NULL, NULL, 13, 72, 9, 40);
+    set_range(lo, hi, dlo, dhi, 60, 119, 50, 81);
+    read_section(0, g_k, glo, ghi, g_r, d_a, lo, hi, dlo, dhi, g_c,
+            "section read into a block cyclic array");
+    test_check(DRA_Delete(d_a) == 0, "DRA_Delete");
+    GA_Sync();
+    test_check(stat(FNAME, &st) != 0, "file deleted");
+
+    GA_Destroy(g_k);
+    GA_Destroy(g_r);
+    GA_Destroy(g_c);
+    GA_Destroy(g_b);
+    GA_Destroy(g_a);
+    DRA_Terminate();
+    test_finalize();
+    return 0;
+}
@@ -0,0 +1,179 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* Benchmark of DRA_Matmul. Multiplies two N x N disk arrays with the memory
+ * budget given to DRA_Init and reports the sustained rate of the multiply
+ * and the disk data it moved, tiles of A and B being read several times,
+ * together with the raw bandwidth of whole array reads and writes, so that
+ * the two can be compared. Usage: time_mxmc [N [MB per process]]
+ */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_MATH_H
+#   include <math.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#define BASE_NAME  "mxmA.da"
+#define BASE_NAME1 "mxmB.da"
+#define BASE_NAME2 "mxmC.da"
+#ifdef  HPIODIR
+#   define FNAME  HPIODIR/*BASE_NAME*/
+#   define FNAME1 HPIODIR/*BASE_NAME1*/
+#   define FNAME2 HPIODIR/*BASE_NAME2*/
+#else
+#   define FNAME  BASE_NAME
+#   define FNAME1 BASE_NAME1
+#   define FNAME2 BASE_NAME2
+#endif
+
+#define SIZE    1000    /* default matrix dimension */
+#define MEMORY  4       /* default DRA memory per process, MB */
+#define MAXCHECK 2000   /* verify against GA_Dgemm up to this size */
+
+#include "dra.h"
+#include "ga.h"
+#include "macdecls.h"
+#include "mp3.h"
+
+
+/* fill local block of g_a with a(i,j) = 1/(i+j+shift) */
+void fill(int g_a, double shift)
+{
+    int lo[2], hi[2], ld[1], i, j;
+    double *ptr;
+
+    NGA_Distribution(g_a, GA_Nodeid(), lo, hi);
+    if (lo[0] > hi[0]) return;
+    NGA_Access(g_a, lo, hi, &ptr, ld);
+    for (i=lo[0]; i<=hi[0]; i++)
+        for (j=lo[1]; j<=hi[1]; j++)
+            ptr[(i-lo[0])*ld[0] + j-lo[1]] = 1.0/(i + j + shift);
+    NGA_Release_update(g_a, lo, hi);
+}
+
+
+double timed_wait(int req, double t0)
+{
+    double t;
+    if (DRA_Wait(req) != 0) GA_Error("DRA_Wait failed: ", req);
+    t = MP_TIMER() - t0;
+    GA_Dgop(&t, 1, "max");
+    return t;
+}
+
+
+void time_mxm(int n)
+{
+    int me = GA_Nodeid();
+    int dims[2], g_a, g_b, g_c, g_r, d_a, d_b, d_c, req;
+    dra_size_t ddims[2], reqdims[2];
+    double t0, twrite, tread, tmxm, mbytes, diff, one = 1.0, minus = -1.0;
+    double nread, nwritten;
+
+    dims[0] = dims[1] = n;
+    ddims[0] = ddims[1] = n;
+    reqdims[0] = reqdims[1] = n;
+
+    g_a = NGA_Create(C_DBL, 2, dims, "a", NULL);
+    g_b = NGA_Create(C_DBL, 2, dims, "b", NULL);
+    if (!g_a || !g_b) GA_Error("NGA_Create failed", n);
+    fill(g_a, 1.0);
+    fill(g_b, 2.0);
+    GA_Sync();
+
+    if (NDRA_Create(C_DBL, 2, ddims, "A", FNAME, DRA_RW, reqdims, &d_a) ||
+        NDRA_Create(C_DBL, 2, ddims, "B", FNAME1, DRA_RW, reqdims, &d_b) ||
+        NDRA_Create(C_DBL, 2, ddims, "C", FNAME2, DRA_RW, reqdims, &d_c))
+        GA_Error("NDRA_Create failed", n);
+
+    mbytes = 1.e-6*(double)n*n*sizeof(double);
+
+    t0 = MP_TIMER();
+    if (NDRA_Write(g_a, d_a, &req)) GA_Error("NDRA_Write failed", 0);
+    twrite = timed_wait(req, t0);
+    if (NDRA_Write(g_b, d_b, &req)) GA_Error("NDRA_Write failed", 0);
+    GA_Zero(g_a);
+    t0 = MP_TIMER();
+    if (NDRA_Read(g_a, d_a, &req)) GA_Error("NDRA_Read failed", 0);
+    tread = timed_wait(req, t0);
+
+    t0 = MP_TIMER();
+    if (DRA_Matmul(d_a, d_b, d_c)) GA_Error("DRA_Matmul failed", 0);
+    tmxm = MP_TIMER() - t0;
+    GA_Dgop(&tmxm, 1, "max");
+    DRA_Matmul_bytes(&nread, &nwritten);
+    nread *= 1.e-6;
+    nwritten *= 1.e-6;
+
+    if (me == 0) {
+        printf("write     %9.2f MB in %9.3f s: %10.2f MB/s\n",
+                mbytes, twrite, mbytes/twrite);
+        printf("read      %9.2f MB in %9.3f s: %10.2f MB/s\n",
+                mbytes, tread, mbytes/tread);
+        printf("matmul %6d x %-6d in %9.3f s: %10.3f GFLOP/s\n",
+                n, n, tmxm, 2.e-9*(double)n*n*n/tmxm);
+        printf("disk data %9.2f MB read, %9.2f MB written: %10.2f MB/s\n",
+                nread, nwritten, (nread + nwritten)/tmxm);
+        fflush(stdout);
+    }
+
+    if (n <= MAXCHECK) {
+        g_c = NGA_Create(C_DBL, 2, dims, "c", NULL);
+        g_r = NGA_Create(C_DBL, 2, dims, "r", NULL);
+        if (!g_c || !g_r) GA_Error("NGA_Create failed", n);
+        if (NDRA_Read(g_c, d_c, &req) || DRA_Wait(req))
+            GA_Error("NDRA_Read failed", 0);
+        GA_Dgemm('N', 'N', n, n, n, 1.0, g_a, g_b, 0.0, g_r);
+        GA_Add(&one, g_c, &minus, g_r, g_r);
+        diff = sqrt(GA_Ddot(g_r, g_r)/GA_Ddot(g_c, g_c));
+        if (me == 0) printf("relative error %e\n", diff);
+        if (diff > 1e-10) GA_Error("DRA_Matmul result is wrong", 0);
+        GA_Destroy(g_c);
+        GA_Destroy(g_r);
+    }
+
+    if (DRA_Delete(d_a) || DRA_Delete(d_b) || DRA_Delete(d_c))
+        GA_Error("DRA_Delete failed", 0);
+    GA_Destroy(g_a);
+    GA_Destroy(g_b);
+}
+
+
+int main(int argc, char **argv)
+{
+    int me, n = SIZE;
+    int max_arrays = 10;
+    double max_sz = 1e10, max_disk = 1e11, max_mem = MEMORY;
+    int heap = 4000000, stack = 4000000;
+
+    MP_INIT(argc,argv);
+    if (!MA_init(C_DBL, stack, heap)) GA_Error("MA_init failed", 0);
+    GA_Initialize();
+    me = GA_Nodeid();
+    if (argc > 1) n = atoi(argv[1]);
+    if (argc > 2) max_mem = atof(argv[2]);
+    max_mem *= 1024*1024;
+
+    if (DRA_Init(max_arrays, max_sz, max_disk, max_mem))
+        GA_Error("DRA_Init failed: ", 0);
+
+    if (me == 0) {
+        printf("DRA_Matmul of %d x %d matrices on %d processes,"
+                " %.1f MB of tiles per process\n\n", n, n, GA_Nnodes(),
+                max_mem/(1024*1024));
+        fflush(stdout);
+    }
+    time_mxm(n);
+
+    DRA_Terminate();
+    GA_Terminate();
+    if (me == 0) printf("all done ...\n");
+    MP_FINALIZE();
+    return 0;
+}
@@ -0,0 +1,96 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* EAF page cache: small sequential writes that are coalesced and written
+ * behind, sequential reads that trigger read-ahead, and random updates, on a
+ * file several times larger than the cache so that pages are evicted */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "eaf.h"
+#include "eaftest.h"
+
+#define FNAME  "eaf_cache_test"
+#define LEN    (1024*1024)      /* 4 MB of ints, the cache holds 1 MB */
+#define WREC   25               /* ints per record written */
+#define RREC   37               /* ints per record read */
+#define NUPD   20000
+
+static int *ref, *buf;
+
+/* read the whole file in records of RREC ints and compare it with ref */
+static void verify(int fd, const char *what)
+{
+    int i, n;
+
+    for (i=0; i<LEN; i+=RREC) {
+        n = (LEN - i < RREC) ? LEN - i : RREC;
+        eaf_test_rc(EAF_Read(fd, (eaf_off_t)i*sizeof(int), buf + i,
+                    n*sizeof(int)), what);
+    }
+    for (i=0; i<LEN; i++) eaf_test_check(buf[i] == ref[i], what);
+}
+
+int main(int argc, char **argv)
+{
+    eaf_off_t len;
+    unsigned long seed = 12345;
+    int fd, i, j, n, lo;
+
+    setenv("EAF_CACHE_MB", "1", 1);
+    setenv("EAF_CACHE_PAGE_KB", "4", 1);
+    ref = (int*)malloc(sizeof(int)*LEN);
+    buf = (int*)malloc(sizeof(int)*LEN);
+    for (i=0; i<LEN; i++) ref[i] = i;
+
+    eaf_test_rc(EAF_Open(FNAME, EAF_RW, &fd), "open");
+
+    /* write-behind of small records that do not line up with the pages */
+    for (i=0; i<LEN; i+=WREC) {
+        n = (LEN - i < WREC) ? LEN - i : WREC;
+        eaf_test_rc(EAF_Write(fd, (eaf_off_t)i*sizeof(int), ref + i,
+                    n*sizeof(int)), "sequential write");
+    }
+    eaf_test_rc(EAF_Length(fd, &len), "length");
+    eaf_test_check(len == (eaf_off_t)LEN*sizeof(int), "length");
+
+    /* sequential read with read-ahead */
+    verify(fd, "sequential read");
+
+    /* small updates and reads all over the file */
+    for (j=0; j<NUPD; j++) {
+        seed = seed*1103515245UL + 12345UL;
+        lo = (int)((seed >> 8) % LEN);
+        n = 1 + (int)((seed >> 4) % 100);
+        if (lo + n > LEN) n = LEN - lo;
+        if (j % 3) {
+            for (i=lo; i<lo+n; i++) ref[i] = -(i + j);
+            eaf_test_rc(EAF_Write(fd, (eaf_off_t)lo*sizeof(int), ref + lo,
+                        n*sizeof(int)), "random write");
+        } else {
+            eaf_test_rc(EAF_Read(fd, (eaf_off_t)lo*sizeof(int), buf,
+                        n*sizeof(int)), "random read");
+            for (i=0; i<n; i++)
+                eaf_test_check(buf[i] == ref[lo+i], "random read");
+        }
+    }
+    verify(fd, "read after random writes");
+    eaf_test_rc(EAF_Close(fd), "close");
+
+    /* everything written reached the file */
+    eaf_test_rc(EAF_Open(FNAME, EAF_R, &fd), "reopen");
+    verify(fd, "read after reopen");
+    eaf_test_rc(EAF_Close(fd), "close");
+    eaf_test_rc(EAF_Delete(FNAME), "delete");
+
+    free(buf);
+    free(ref);
+    printf("No errors detected\n");
+    return 0;
+}
@@ -68,6 +68,62 @@
 #   define EAF_MAX_FILES 1024
 #endif
 
+#define EAF_CACHE_PAGE_KB  1024 /**< default page size of the EAF cache */
+#define EAF_CACHE_READAHEAD   4  /**< max pages read ahead of a sequential read */
+
+#define EAF_PAGE_IDLE  0         /**< no I/O in flight on the page */
+#define EAF_PAGE_READ  1         /**< page is being read from disk */
+#define EAF_PAGE_WRITE 2         /**< dirty data is being written to disk */
+
+/** one page of the EAF cache */
+typedef struct {
+    long   pageno;               /**< page number in file, -1 if unused */
+    char   *data;                /**< page contents */
+    int    valid;                /**< contents loaded from disk ? */
+    size_t dlo, dhi;             /**< dirty byte range, empty if dlo==dhi */
+    size_t wend;                 /**< end of range being written */
+    int    pending;              /**< EAF_PAGE_READ/WRITE or EAF_PAGE_IDLE */
+    io_request_t req;            /**< ELIO request of pending I/O */
+    unsigned long stamp;         /**< time of last use, for LRU eviction */
+} eaf_page_t;
+
+/** 
+ * Bounded page cache of a regular EAF file. Sequential reads trigger
+ * asynchronous read-ahead, small writes are coalesced in their page and
+ * written back asynchronously once the page is full or when it is evicted.
+ */
+typedef struct {
+    eaf_page_t *page;            /**< npages pages */
+    int    npages;
+    int    readahead;            /**< pages to read ahead */
+    size_t psize;                /**< page size in bytes */
+    unsigned long clock;         /**< LRU clock */
+    Off_t  disk_len;             /**< bytes known to be on disk */
+    Off_t  end;                  /**< logical file length */
+    eaf_off_t next_seq;          /**< offset a sequential read starts at */
+    long   hits;                 /**< accesses served by resident pages */
+    long   misses;               /**< accesses that had to fetch a page */
+    long   prefetch;             /**< pages read ahead */
+    long   nwriteback;           /**< write-backs of dirty data */
+    double nb_writeback;         /**< bytes written back */
+} eaf_cache_t;
+
+#define EAF_MAX_STRIPES   64     /**< max files a striped file is spread on */
+#define EAF_STRIPE_KB   1024     /**< default stripe unit */
+#define EAF_STRIPE_REQS   32     /**< max stripe units in flight */
+
+/**
+ * A striped file: one logical file laid out round-robin in units of
+ * unit bytes over n ELIO files, typically on different devices.
+ */
+typedef struct {
+    int    n;                    /**< number of stripe files */
+    size_t unit;                 /**< stripe unit in bytes */
+    Fd_t   fd[EAF_MAX_STRIPES];  /**< stripe files */
+    Off_t  len[EAF_MAX_STRIPES]; /**< length of each stripe file */
+    Off_t  end;                  /**< logical file length */
+} eaf_stripe_t;
+
 static int eafhack_openfiles=0;
 
 static struct {
@@ -92,6 +148,8 @@ static struct {
     long handle;      /**< handle for MA hack */
     char *pointer;    /**< pointer for MA */
     long openma;      /**< open yes or no for MA to simulate file behavoir */
+    eaf_cache_t *cache; /**< page cache or NULL */
+    eaf_stripe_t *stripe; /**< stripe files or NULL */
 } file[EAF_MAX_FILES];
 
 
@@ -134,13 +192,594 @@ static double wall_time(void)
 }
 
 
+/**
+ * Hash of the directory of fname, made absolute with the current directory
+ * if fname is relative, so that files of the same name in different
+ * directories get different stripes in EAF_STRIPE_DIRS
+ */
+static unsigned long eaf_dir_hash(const char *fname)
+{
+    const char *base = strrchr(fname, '/'), *c;
+    unsigned long h = 2166136261UL;           /* FNV-1a */
+    char cwd[PATH_MAX];
+
+#ifndef WIN32
+    if (*fname != '/' && getcwd(cwd, sizeof(cwd)))
+        for (c=cwd; *c; c++) h = (h ^ (unsigned char)*c)*16777619UL;
+#endif
+    if (base)
+        for (c=fname; c<base; c++) h = (h ^ (unsigned char)*c)*16777619UL;
+    return h & 0xffffffffUL;
+}
+
+
+/**
+ * Name of stripe s of file fname. Stripes are placed in the directories
+ * listed in EAF_STRIPE_DIRS (separated by ':', empty entries are skipped),
+ * one per directory, or next to fname if only the number of stripes is
+ * given by EAF_STRIPES. In EAF_STRIPE_DIRS the stripe name includes a hash
+ * of the directory of fname. Returns the number of stripes, 0 if files are
+ * not striped.
+ */
+static int eaf_stripe_name(const char *fname, int s, char *name)
+{
+    const char *dirs = getenv("EAF_STRIPE_DIRS"), *base, *d, *e;
+    char *str;
+    int n = 0, len, i;
+
+    if (dirs && *dirs) {
+        for (d=dirs; *d; d=e) {
+            e = strchr(d, ':') ? strchr(d, ':') : d + strlen(d);
+            if (e > d) n++;
+            if (*e) e++;
+        }
+        if (n > EAF_MAX_STRIPES) n = EAF_MAX_STRIPES;
+        if (!name) return (n > 1) ? n : 0;
+
+        /* s-th non-empty directory of the list */
+        for (d=dirs, i=0; ; d=e+1) {
+            e = strchr(d, ':') ? strchr(d, ':') : d + strlen(d);
+            if (e > d && i++ == s) break;
+            if (!*e) return 0;
+        }
+        len = (int)(e - d);
+        base = strrchr(fname, '/');
+        base = base ? base+1 : fname;
+        if (len + strlen(base) + 32 > PATH_MAX) return 0;
+        sprintf(name, "%.*s/%s.%08lx.s%d", len, d, base,
+                eaf_dir_hash(fname), s);
+        return n;
+    }
+    if ((str = getenv("EAF_STRIPES"))) n = atoi(str);
+    if (n < 2) return 0;
+    if (n > EAF_MAX_STRIPES) n = EAF_MAX_STRIPES;
+    if (!name) return n;
+    if (strlen(fname) + 16 > PATH_MAX) return 0;
+    sprintf(name, "%s.s%d", fname, s);
+    return n;
+}
+
+
+/**
+ * Length of stripe s of a striped file of logical length end
+ */
+static Off_t eaf_stripe_len(eaf_stripe_t *st, int s, Off_t end)
+{
+    long long row = (long long)st->unit*st->n;
+    long long full = (long long)end/row;
+    long long rest = (long long)end - full*row - (long long)s*st->unit;
+
+    if (rest < 0) rest = 0;
+    if (rest > (long long)st->unit) rest = st->unit;
+    return (Off_t)(full*st->unit + rest);
+}
+
+
+/**
+ * Open the stripe files of fname. Returns NULL if fname is not to be
+ * striped, sets *rc in case of failure.
+ */
+static eaf_stripe_t *eaf_stripe_open(const char *fname, int type, int *rc)
+{
+    char name[PATH_MAX], *str;
+    eaf_stripe_t *st;
+    long long last;
+    Off_t end;
+    int n, s;
+
+    *rc = EAF_OK;
+    if (!(n = eaf_stripe_name(fname, 0, NULL))) return NULL;
+    if (!(st = (eaf_stripe_t*)calloc(1, sizeof(eaf_stripe_t)))) {
+        *rc = EAF_ERR_MEMORY;
+        return NULL;
+    }
+    st->n = n;
+    st->unit = (size_t)EAF_STRIPE_KB*1024;
+    if ((str = getenv("EAF_STRIPE_KB")) && atol(str) > 0)
+        st->unit = (size_t)atol(str)*1024;
+
+    for (s=0; s<n; s++) {
+        if (!eaf_stripe_name(fname, s, name) ||
+                !(st->fd[s] = elio_open(name, type, ELIO_PRIVATE))) {
+            while (s--) (void) elio_close(st->fd[s]);
+            free(st);
+            *rc = ELIO_PENDING_ERR;
+            return NULL;
+        }
+        if (elio_length(st->fd[s], &st->len[s]) != ELIO_OK) st->len[s] = 0;
+
+        /* logical end of the last byte in this stripe */
+        if (st->len[s] > 0) {
+            last = (long long)st->len[s] - 1;
+            end = (Off_t)(((last/st->unit)*n + s)*st->unit
+                    + last%st->unit + 1);
+            if (end > st->end) st->end = end;
+        }
+    }
+    return st;
+}
+
+
+/**
+ * Read or write bytes at offset of striped file st. The request is split
+ * into stripe units which are all issued asynchronously, so that the
+ * ELIO I/O threads serve the stripe files in parallel. Parts of a stripe
+ * file that were never written read as zeros, as holes in a plain file.
+ * Returns bytes or a negative error code.
+ */
+static Size_t eaf_stripe_io(eaf_stripe_t *st, int write, Off_t offset,
+        char *buf, Size_t bytes)
+{
+    io_request_t req[EAF_STRIPE_REQS];
+    long long o = (long long)offset, k;
+    Size_t left = bytes, cnt, avail;
+    Off_t foff;
+    int s, i, nreq = 0, rc = ELIO_OK, rc2, err = ELIO_OK;
+
+    if (!write && offset + bytes > st->end) return EAF_ERR_EOF;
+
+    while (left) {
+        k = o/st->unit;
+        s = (int)(k%st->n);
+        foff = (Off_t)((k/st->n)*st->unit + o%st->unit);
+        cnt = (Size_t)(st->unit - o%st->unit);
+        if (cnt > left) cnt = left;
+
+        req[nreq] = ELIO_DONE;
+        if (write) {
+            rc = elio_awrite(st->fd[s], foff, buf, cnt, req+nreq);
+            if (foff + cnt > st->len[s]) st->len[s] = foff + cnt;
+        } else {
+            avail = (st->len[s] > foff) ? (Size_t)(st->len[s] - foff) : 0;
+            if (avail > cnt) avail = cnt;
+            if (avail < cnt) memset(buf + avail, 0, cnt - avail);
+            if (avail) rc = elio_aread(st->fd[s], foff, buf, avail, req+nreq);
+        }
+        if (rc) break;
+        if (req[nreq] != ELIO_DONE) nreq++;
+        if (nreq == EAF_STRIPE_REQS) {
+            for (i=0; i<nreq; i++) if ((rc2 = elio_wait(req+i))) err = rc2;
+            nreq = 0;
+        }
+        o += cnt;
+        buf += cnt;
+        left -= cnt;
+    }
+    for (i=0; i<nreq; i++) if ((rc2 = elio_wait(req+i))) err = rc2;
+    if (rc) return (rc < 0) ? rc : -1;
+    if (err) return (err < 0) ? err : -1;
+
+    if (write && offset + bytes > st->end) st->end = offset + bytes;
+    return bytes;
+}
+
+
+/**
+ * Synchronous read or write of file fd, striped or not
+ */
+static Size_t eaf_io(int fd, int write, Off_t offset, void *buf, Size_t bytes)
+{
+    if (file[fd].stripe)
+        return eaf_stripe_io(file[fd].stripe, write, offset, (char*)buf, bytes);
+    if (write) return elio_write(file[fd].elio_fd, offset, buf, bytes);
+    return elio_read(file[fd].elio_fd, offset, buf, bytes);
+}
+
+
+/**
+ * Asynchronous read or write of file fd. Striped files are transferred
+ * in parallel right away and *req is ELIO_DONE.
+ */
+static int eaf_aio(int fd, int write, Off_t offset, void *buf, Size_t bytes,
+        io_request_t *req)
+{
+    Size_t rc;
+
+    if (file[fd].stripe) {
+        *req = ELIO_DONE;
+        rc = eaf_stripe_io(file[fd].stripe, write, offset, (char*)buf, bytes);
+        if (rc == bytes) return ELIO_OK;
+        return (rc < 0) ? (int)rc : (write ? EAF_ERR_AWRITE : EAF_ERR_AREAD);
+    }
+    if (write) return elio_awrite(file[fd].elio_fd, offset, buf, bytes, req);
+    return elio_aread(file[fd].elio_fd, offset, buf, bytes, req);
+}
+
+
+/**
+ * Length of file fd on disk, striped or not
+ */
+static int eaf_file_length(int fd, Off_t *length)
+{
+    if (file[fd].stripe) {
+        *length = file[fd].stripe->end;
+        return ELIO_OK;
+    }
+    return elio_length(file[fd].elio_fd, length);
+}
+
+
+/**
+ * Create the page cache of a regular file if EAF_CACHE_MB, the cache size
+ * per file in megabytes, is set. EAF_CACHE_PAGE_KB sets the page size.
+ * Returns NULL if there is to be no cache.
+ */
+static eaf_cache_t *eaf_cache_create(int fd)
+{
+    eaf_cache_t *c;
+    char *str;
+    long mb, kb = EAF_CACHE_PAGE_KB;
+    int i;
+
+    if (!(str = getenv("EAF_CACHE_MB")) || (mb = atol(str)) <= 0) return NULL;
+    if ((str = getenv("EAF_CACHE_PAGE_KB")) && atol(str) > 0) kb = atol(str);
+
+    if (!(c = (eaf_cache_t*)calloc(1, sizeof(eaf_cache_t)))) return NULL;
+    c->psize  = (size_t)kb*1024;
+    c->npages = (int)((mb*1024)/kb);
+    if (c->npages < 2) c->npages = 2;
+    c->readahead = c->npages/2;
+    if (c->readahead > EAF_CACHE_READAHEAD) c->readahead = EAF_CACHE_READAHEAD;
+    c->page = (eaf_page_t*)calloc(c->npages, sizeof(eaf_page_t));
+    if (c->page) c->page[0].data = (char*)malloc(c->npages*c->psize);
+    if (!c->page || !c->page[0].data) {
+        free(c->page);
+        free(c);
+        return NULL;
+    }
+    for (i=0; i<c->npages; i++) {
+        c->page[i].data = c->page[0].data + i*c->psize;
+        c->page[i].pageno = -1;
+    }
+    if (eaf_file_length(fd, &c->disk_len) != ELIO_OK) c->disk_len = 0;
+    c->end = c->disk_len;
+    c->next_seq = -1;
+    return c;
+}
+
+
+/**
+ * Wait for I/O in flight on page p. The dirty range of a page that was
+ * being written back is cleared only if the write succeeded. A page whose
+ * read failed is dropped from the cache, so that the next access reads it
+ * again instead of returning what the buffer happens to hold.
+ */
+static int eaf_page_complete(eaf_cache_t *c, eaf_page_t *p)
+{
+    int rc = ELIO_OK;
+    Off_t end;
+
+    if (p->pending == EAF_PAGE_IDLE) return rc;
+    rc = elio_wait(&p->req);
+    if (p->pending == EAF_PAGE_READ) {
+        if (rc == ELIO_OK) {
+            p->valid = 1;
+        } else {
+            p->pageno = -1;
+            p->valid = 0;
+        }
+    } else if (rc == ELIO_OK) {
+        end = (Off_t)p->pageno*c->psize + p->wend;
+        if (end > c->disk_len) c->disk_len = end;
+        p->dlo = p->dhi = 0;
+    }
+    p->pending = EAF_PAGE_IDLE;
+    return rc;
+}
+
+
+/**
+ * Write the dirty range of page p to disk, in background if async is set.
+ * The page stays dirty until the write has succeeded, so a failed write is
+ * reported and retried by the next write-back rather than losing the data.
+ */
+static int eaf_page_writeback(eaf_cache_t *c, int fd, eaf_page_t *p,
+        int async)
+{
+    Off_t offset = (Off_t)p->pageno*c->psize + p->dlo;
+    Size_t bytes = (Size_t)(p->dhi - p->dlo), rc;
+    int err;
+
+    if (!bytes) return ELIO_OK;
+    c->nwriteback++;
+    c->nb_writeback += bytes;
+    p->wend = p->dhi;
+    if (async) {
+        err = eaf_aio(fd, 1, offset, p->data + p->dlo, bytes, &p->req);
+        if (err) return err;
+        p->pending = EAF_PAGE_WRITE;
+        if (p->req == ELIO_DONE) return eaf_page_complete(c, p);
+        return ELIO_OK;
+    }
+    rc = eaf_io(fd, 1, offset, p->data + p->dlo, bytes);
+    if (rc != bytes) return (rc < 0) ? (int)rc : EAF_ERR_WRITE;
+    if (offset + bytes > c->disk_len) c->disk_len = offset + bytes;
+    p->dlo = p->dhi = 0;
+    return ELIO_OK;
+}
+
+
+/**
+ * Read page p from disk, in background if async is set. Bytes beyond the
+ * end of the file on disk read as zeros.
+ */
+static int eaf_page_load(eaf_cache_t *c, int fd, eaf_page_t *p, int async)
+{
+    Off_t offset = (Off_t)p->pageno*c->psize;
+    Size_t bytes = 0;
+    int rc;
+
+    if (c->disk_len > offset) bytes = (Size_t)(c->disk_len - offset);
+    if (bytes > (Size_t)c->psize) bytes = (Size_t)c->psize;
+    if ((size_t)bytes < c->psize)
+        memset(p->data + bytes, 0, c->psize - (size_t)bytes);
+    p->valid = 1;
+    if (!bytes) return ELIO_OK;
+
+    if (async) {
+        p->valid = 0;
+        if ((rc = eaf_aio(fd, 0, offset, p->data, bytes, &p->req))) return rc;
+        p->pending = EAF_PAGE_READ;
+        if (p->req == ELIO_DONE) return eaf_page_complete(c, p);
+        return ELIO_OK;
+    }
+    if (eaf_io(fd, 0, offset, p->data, bytes) != bytes) {
+        p->valid = 0;
+        return EAF_ERR_READ;
+    }
+    return ELIO_OK;
+}
+
+
+/**
+ * Return the resident page pageno or NULL
+ */
+static eaf_page_t *eaf_page_find(eaf_cache_t *c, long pageno)
+{
+    int i;
+
+    for (i=0; i<c->npages; i++)
+        if (c->page[i].pageno == pageno) return c->page + i;
+    return NULL;
+}
+
+
+/**
+ * Make room for page pageno by evicting the least recently used page.
+ * Only that page is written back, the rest of the cache stays intact.
+ */
+static eaf_page_t *eaf_page_evict(eaf_cache_t *c, int fd, long pageno,
+        int *rc)
+{
+    eaf_page_t *p = c->page;
+    int i;
+
+    for (i=1; i<c->npages && p->pageno != -1; i++)
+        if (c->page[i].pageno == -1 || c->page[i].stamp < p->stamp)
+            p = c->page + i;
+    *rc = EAF_OK;
+    if (p->pageno != -1) {
+        /* a failed background write leaves the page dirty, retry it */
+        (void) eaf_page_complete(c, p);
+        if ((*rc = eaf_page_writeback(c, fd, p, 0))) return NULL;
+    }
+    p->pageno = pageno;
+    p->valid = 0;
+    p->dlo = p->dhi = 0;
+    p->stamp = ++c->clock;
+    return p;
+}
+
+
+/**
+ * Return page pageno with no I/O in flight, evicting another one if it is
+ * not resident. Returns NULL and sets *rc if I/O on either page failed.
+ */
+static eaf_page_t *eaf_page_get(eaf_cache_t *c, int fd, long pageno, int *rc)
+{
+    eaf_page_t *p = eaf_page_find(c, pageno);
+
+    if (p) {
+        if ((*rc = eaf_page_complete(c, p))) return NULL;
+        p->stamp = ++c->clock;
+        c->hits++;
+        return p;
+    }
+    c->misses++;
+    return eaf_page_evict(c, fd, pageno, rc);
+}
+
+
+/**
+ * Start reading the pages following the one that contains offset
+ */
+static void eaf_cache_readahead(eaf_cache_t *c, int fd, eaf_off_t offset)
+{
+    long pageno = (long)(offset/c->psize), q;
+    eaf_page_t *p;
+    int rc;
+
+    for (q=pageno+1; q<=pageno+c->readahead; q++) {
+        if ((Off_t)q*c->psize >= c->disk_len) break;
+        if (eaf_page_find(c, q)) continue;
+        if (!(p = eaf_page_evict(c, fd, q, &rc))) return;
+        if (eaf_page_load(c, fd, p, 1)) {
+            p->pageno = -1;
+            return;
+        }
+        c->prefetch++;
+    }
+}
+
+
+/**
+ * Write bytes at offset through the cache of file fd
+ */
+static int eaf_cache_write(int fd, eaf_off_t offset, const void *buf,
+        size_t bytes)
+{
+    eaf_cache_t *c = file[fd].cache;
+    eaf_page_t *p;
+    size_t off, n;
+    int rc;
+
+    while (bytes) {
+        if (!(p = eaf_page_get(c, fd, (long)(offset/c->psize), &rc)))
+            return rc;
+        off = (size_t)(offset - (eaf_off_t)p->pageno*c->psize);
+        n = c->psize - off;
+        if (n > bytes) n = bytes;
+
+        /* without the page contents only one dirty range can be kept */
+        if (!p->valid && p->dhi > p->dlo && (off > p->dhi || off+n < p->dlo))
+            if ((rc = eaf_page_writeback(c, fd, p, 0))) return rc;
+
+        memcpy(p->data + off, buf, n);
+        if (p->dhi == p->dlo) {
+            p->dlo = off;
+            p->dhi = off + n;
+        } else {
+            if (off < p->dlo) p->dlo = off;
+            if (off + n > p->dhi) p->dhi = off + n;
+        }
+
+        /* write-behind of full pages */
+        if (p->dlo == 0 && p->dhi == c->psize)
+            if ((rc = eaf_page_writeback(c, fd, p, 1))) return rc;
+
+        offset += n;
+        buf = (const char*)buf + n;
+        bytes -= n;
+    }
+    if (offset > c->end) c->end = offset;
+    return EAF_OK;
+}
+
+
+/**
+ * Write all dirty pages of file fd back to disk
+ */
+static int eaf_cache_flush(int fd)
+{
+    eaf_cache_t *c = file[fd].cache;
+    int i, rc, err = EAF_OK;
+
+    for (i=0; i<c->npages; i++) {
+        if (c->page[i].pageno == -1) continue;
+        if ((rc = eaf_page_complete(c, c->page+i))) err = rc;
+        if ((rc = eaf_page_writeback(c, fd, c->page+i, 0)))
+            err = rc;
+    }
+    return err;
+}
+
+
+/**
+ * Flush the cache of file fd and drop all its pages, except those whose
+ * dirty data could not be written
+ */
+static int eaf_cache_invalidate(int fd)
+{
+    eaf_cache_t *c = file[fd].cache;
+    int i, rc;
+
+    rc = eaf_cache_flush(fd);
+    for (i=0; i<c->npages; i++)
+        if (c->page[i].dhi == c->page[i].dlo) c->page[i].pageno = -1;
+    c->next_seq = -1;
+    return rc;
+}
+
+
+/**
+ * Read bytes at offset through the cache of file fd
+ */
+static int eaf_cache_read(int fd, eaf_off_t offset, void *buf, size_t bytes)
+{
+    eaf_cache_t *c = file[fd].cache;
+    eaf_off_t start = offset;
+    eaf_page_t *p;
+    size_t off, n;
+    Size_t rc;
+    int err;
+
+    if (offset + bytes > c->end) {
+        /* let ELIO report reading past the end of file */
+        if (eaf_cache_invalidate(fd)) return EAF_ERR_READ;
+        rc = eaf_io(fd, 0, (Off_t)offset, buf, (Size_t)bytes);
+        if (rc < 0) return (int)rc;
+        return (rc == (Size_t)bytes) ? EAF_OK : EAF_ERR_READ;
+    }
+
+    while (bytes) {
+        if (!(p = eaf_page_get(c, fd, (long)(offset/c->psize), &err)))
+            return err;
+        off = (size_t)(offset - (eaf_off_t)p->pageno*c->psize);
+        n = c->psize - off;
+        if (n > bytes) n = bytes;
+
+        if (!p->valid && !(off >= p->dlo && off+n <= p->dhi)) {
+            if (eaf_page_writeback(c, fd, p, 0)) return EAF_ERR_READ;
+            if (eaf_page_load(c, fd, p, 0)) return EAF_ERR_READ;
+        }
+        memcpy(buf, p->data + off, n);
+
+        offset += n;
+        buf = (char*)buf + n;
+        bytes -= n;
+    }
+
+    if (start == c->next_seq) eaf_cache_readahead(c, fd, offset - 1);
+    c->next_seq = offset;
+    return EAF_OK;
+}
+
+
+/**
+ * Release the cache of file fd, writing dirty pages back first
+ */
+static int eaf_cache_destroy(int fd)
+{
+    eaf_cache_t *c = file[fd].cache;
+    int rc;
+
+    if (!c) return EAF_OK;
+    rc = eaf_cache_flush(fd);
+    free(c->page[0].data);
+    free(c->page);
+    free(c);
+    file[fd].cache = NULL;
+    return rc;
+}
+
+
 /**
  * Open the named file returning the EAF file descriptor in fd.
  * Return 0 on success, non-zero on failure
  */
 int EAF_Open(const char *fname, int type, int *fd)
 {
-  int i=0, j=0, found=0;
+  int i=0, j=0, found=0, rc;
   char *ptr;
   long handle, index;
     while ((i<EAF_MAX_FILES) && file[i].fname) /* Find first empty slot */
@@ -201,11 +840,20 @@ int EAF_Open(const char *fname, int type, int *fd)
       printf(" opening regular %d eaf %s \n", i, fname);
 #endif
 
-      if (!(file[i].elio_fd = elio_open(fname, type, ELIO_PRIVATE))) {
+      file[i].stripe = eaf_stripe_open(fname, type, &rc);
+      if (rc) {
+            free(file[i].fname);
+            file[i].fname = 0;
+            return rc;
+      }
+      if (file[i].stripe) {
+            file[i].elio_fd = file[i].stripe->fd[0];
+      } else if (!(file[i].elio_fd = elio_open(fname, type, ELIO_PRIVATE))) {
             free(file[i].fname);
             file[i].fname = 0;
             return ELIO_PENDING_ERR;
       }
+      file[i].cache = eaf_cache_create(i);
     }
 
     file[i].nwait = file[i].nread = file[i].nwrite = 
@@ -225,6 +873,8 @@ int EAF_Open(const char *fname, int type, int *fd)
  */
 int EAF_Close(int fd)
 {
+    int rc;
+
     if (!valid_fd(fd)) return EAF_ERR_INVALID_FD;
     
     if (file[fd].size > 0) {
@@ -237,9 +887,22 @@ int EAF_Close(int fd)
 #ifdef DEBUG
       printf(" closing regular file %s fd %d \n", file[fd].fname, fd);
 #endif
+    rc = eaf_cache_destroy(fd);
     free(file[fd].fname);
     file[fd].fname = 0;
 
+    if (file[fd].stripe) {
+        int s, code;
+        for (s=0; s<file[fd].stripe->n; s++)
+            if ((code = elio_close(file[fd].stripe->fd[s])) && !rc) rc = code;
+        free(file[fd].stripe);
+        file[fd].stripe = NULL;
+        return rc;
+    }
+    if (rc) {
+        (void) elio_close(file[fd].elio_fd);
+        return rc;
+    }
     return elio_close(file[fd].elio_fd);
     }
 }
@@ -271,8 +934,12 @@ int EAF_Write(int fd, eaf_off_t offset, const void *buf, size_t bytes)
       memcpy(((char*)file[fd].pointer)+(long)offset, buf, bytes);
       rc=bytes;
       }
+    }else if (file[fd].cache) {
+      int code = eaf_cache_write(fd, offset, buf, bytes);
+      if (code) return code;
+      rc = bytes;
     }else{
-    rc = elio_write(file[fd].elio_fd, (Off_t) offset, buf, (Size_t) bytes);
+    rc = eaf_io(fd, 1, (Off_t) offset, (void*)buf, (Size_t) bytes);
     }
     if (rc != ((Size_t)bytes)){
 	printf("eaf_write: rc ne bytes %ld bytes %ld\n ", rc, (long)bytes);
@@ -313,8 +980,11 @@ int EAF_Awrite(
       memcpy(((char*)file[fd].pointer)+(long)offset, buf, bytes);
       rc=bytes;
       }
+    }else if (file[fd].cache) {
+      rc = eaf_cache_write(fd, offset, buf, bytes);
+      req = ELIO_DONE;
     }else{
-    rc = elio_awrite(file[fd].elio_fd, (Off_t)offset, buf, (Size_t)bytes, &req);
+    rc = eaf_aio(fd, 1, (Off_t)offset, (void*)buf, (Size_t)bytes, &req);
     }
     if(!rc){
         *req_id = req;
@@ -345,8 +1015,12 @@ int EAF_Read(int fd, eaf_off_t offset, void *buf, size_t bytes)
       memcpy(buf, ((char*)file[fd].pointer)+(long)offset,  bytes);
       rc=bytes;
       }
+    }else if (file[fd].cache) {
+      int code = eaf_cache_read(fd, offset, buf, bytes);
+      if (code) return code;
+      rc = bytes;
     }else{
-    rc = elio_read(file[fd].elio_fd, (Off_t) offset, buf, (Size_t) bytes);
+    rc = eaf_io(fd, 0, (Off_t) offset, buf, (Size_t) bytes);
     }
     if (rc != ((Size_t)bytes)){
         if(rc < 0) return((int)rc); /* rc<0 means ELIO detected error */
@@ -384,8 +1058,11 @@ int EAF_Aread(int fd, eaf_off_t offset, void *buf, size_t bytes, int *req_id)
       memcpy(file[fd].pointer, buf, bytes);
       rc=0;
       }
+    }else if (file[fd].cache) {
+      rc = eaf_cache_read(fd, offset, buf, bytes);
+      req = ELIO_DONE;
     }else{
-    rc = elio_aread(file[fd].elio_fd, (Off_t) offset, buf, (Size_t)bytes, &req);
+    rc = eaf_aio(fd, 0, (Off_t) offset, buf, (Size_t)bytes, &req);
     }
 
     if(!rc){
@@ -484,10 +1161,14 @@ int EAF_Delete(const char *fname)
     /* Now that ELIO files can have extents must call its
        routine to delete files */
 
-  if (elio_delete(fname) == ELIO_OK)
-    return EAF_OK;
-  else
-    return EAF_ERR_UNLINK;
+  int s, n = eaf_stripe_name(fname, 0, NULL), rc = EAF_OK;
+  char name[PATH_MAX];
+  for (s=0; s<n; s++)
+    if (eaf_stripe_name(fname, s, name) && elio_delete(name) != ELIO_OK)
+      rc = EAF_ERR_UNLINK;
+  if (elio_delete(fname) != ELIO_OK)
+    rc = EAF_ERR_UNLINK;
+  return rc;
     }
 }
 
@@ -598,6 +1279,22 @@ int EAF_Truncate(int fd, eaf_off_t length)
 
     if (!valid_fd(fd)) return EAF_ERR_INVALID_FD;
 
+    if (file[fd].cache) {
+        if (eaf_cache_invalidate(fd)) return EAF_ERR_TRUNCATE;
+        file[fd].cache->disk_len = file[fd].cache->end = (Off_t)length;
+    }
+
+    if (file[fd].stripe) {
+        eaf_stripe_t *st = file[fd].stripe;
+        int s;
+        for (s=0; s<st->n; s++) {
+            st->len[s] = eaf_stripe_len(st, s, (Off_t)length);
+            if (elio_truncate(st->fd[s], st->len[s])) return EAF_ERR_TRUNCATE;
+        }
+        st->end = (Off_t)length;
+        return EAF_OK;
+    }
+
 #ifdef CRAY 
     /* ftruncate does not work with Cray FFIO, we need to implement it
      * as a sequence of generic close, truncate, open calls 
@@ -636,8 +1333,11 @@ int EAF_Length(int fd, eaf_off_t *length)
       if(file[fd].openma == 0)  return EAF_ERR_INVALID_FD;
       len=file[fd].size;
       rc=0;
+    }else if (file[fd].cache) {
+      len = file[fd].cache->end;
+      rc = 0;
     }else{
-    rc = elio_length(file[fd].elio_fd, &len);
+    rc = eaf_file_length(fd, &len);
     }
     if(!rc) *length = (eaf_off_t) len;
     return rc;
@@ -693,6 +1393,15 @@ void EAF_Print_stats(int fd)
     /* Note that wait time does not distinguish between read/write completion 
        so that entire wait time is counted 
        in computing effective speed for async read & write */
+    if (file[fd].cache) {
+        eaf_cache_t *c = file[fd].cache;
+        printf("     cache: %d pages of %ld kb, read-ahead %d pages\n",
+                c->npages, (long)(c->psize/1024), c->readahead);
+        printf("            %ld hits  %ld misses  %ld read-ahead\n",
+                c->hits, c->misses, c->prefetch);
+        printf("            %ld write-backs  %.2e bytes\n",
+                c->nwriteback, c->nb_writeback);
+    }
     if (mbwa+mbra) {
         printf("rate(mb/s): %.2e  %.2e  %.2e* %.2e*\n", mbw, mbr, mbwa, mbra);
         printf("------------------------------------------------------------\n");
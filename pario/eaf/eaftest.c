@@ -0,0 +1,33 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "eaf.h"
+#include "eaftest.h"
+
+void eaf_test_check(int ok, const char *what)
+{
+    if (!ok) {
+        printf("%s: failure detected\n", what);
+        exit(1);
+    }
+}
+
+/* rc is the return code of an EAF call, printed with its message if set */
+void eaf_test_rc(int rc, const char *what)
+{
+    char msg[80];
+
+    if (rc) {
+        EAF_Errmsg(rc, msg);
+        printf("%s: %s\n", what, msg);
+        eaf_test_check(0, what);
+    }
+}
@@ -0,0 +1,9 @@
+#ifndef EAFTEST_H
+#define EAFTEST_H
+
+/* checks shared by the serial EAF tests: a failure is reported and the test
+ * exits with status 1 */
+extern void eaf_test_check(int ok, const char *what);
+extern void eaf_test_rc(int rc, const char *what);
+
+#endif /* EAFTEST_H */
@@ -0,0 +1,169 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* EAF files striped over several files: EAF_STRIPES stripes next to the
+ * file, then EAF_STRIPE_DIRS stripes in two directories, where files of
+ * the same name in different directories must not share stripes. Records
+ * that straddle stripe units are written and read back, with and without
+ * the page cache, and Length, Truncate and Delete are checked on the
+ * stripes. */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#if HAVE_STRING_H
+#   include <string.h>
+#endif
+#if HAVE_UNISTD_H
+#   include <unistd.h>
+#endif
+#include <sys/stat.h>
+#include <dirent.h>
+
+#include "eaf.h"
+#include "eaftest.h"
+
+#define LEN   (300*1024)        /* ints per file, about 1.2 MB */
+#define REC   1000              /* ints per record, not a divisor of a unit */
+
+static int *ref, *buf;
+
+static int exists(const char *name)
+{
+    struct stat st;
+
+    return stat(name, &st) == 0;
+}
+
+/* number of entries of dir other than . and .. */
+static int entries(const char *dir)
+{
+    DIR *d = opendir(dir);
+    struct dirent *e;
+    int n = 0;
+
+    eaf_test_check(d != NULL, "opendir");
+    while ((e = readdir(d)))
+        if (strcmp(e->d_name, ".") && strcmp(e->d_name, "..")) n++;
+    closedir(d);
+    return n;
+}
+
+/* write LEN ints of seed in records of REC, check the length */
+static void write_file(const char *fname, int seed)
+{
+    eaf_off_t len;
+    int fd, i, n;
+
+    for (i=0; i<LEN; i++) ref[i] = seed*LEN + i;
+    eaf_test_rc(EAF_Open(fname, EAF_RW, &fd), "open");
+    for (i=0; i<LEN; i+=REC) {
+        n = (LEN - i < REC) ? LEN - i : REC;
+        eaf_test_rc(EAF_Write(fd, (eaf_off_t)i*sizeof(int), ref + i,
+                    n*sizeof(int)), "write");
+    }
+    eaf_test_rc(EAF_Length(fd, &len), "length");
+    eaf_test_check(len == (eaf_off_t)LEN*sizeof(int), "length");
+    eaf_test_rc(EAF_Close(fd), "close");
+}
+
+/* read the first len ints of fname and compare them with seed */
+static void read_file(const char *fname, int seed, int len)
+{
+    eaf_off_t flen;
+    int fd, i, n;
+
+    eaf_test_rc(EAF_Open(fname, EAF_R, &fd), "reopen");
+    eaf_test_rc(EAF_Length(fd, &flen), "length");
+    eaf_test_check(flen == (eaf_off_t)len*sizeof(int), "length after reopen");
+    for (i=0; i<len; i+=REC) {
+        n = (len - i < REC) ? len - i : REC;
+        eaf_test_rc(EAF_Read(fd, (eaf_off_t)i*sizeof(int), buf + i,
+                    n*sizeof(int)), "read");
+    }
+    for (i=0; i<len; i++) eaf_test_check(buf[i] == seed*LEN + i, "contents");
+    eaf_test_rc(EAF_Close(fd), "close");
+}
+
+/* stripes next to the file, truncated to the middle of a stripe unit */
+static void test_stripes(void)
+{
+    const int cut = 3*4096/sizeof(int) + 100;
+    int fd;
+
+    setenv("EAF_STRIPES", "3", 1);
+    write_file("eaf_stripe", 1);
+    eaf_test_check(exists("eaf_stripe.s0") && exists("eaf_stripe.s1")
+            && exists("eaf_stripe.s2") && !exists("eaf_stripe.s3"),
+            "stripe files");
+    read_file("eaf_stripe", 1, LEN);
+
+    eaf_test_rc(EAF_Open("eaf_stripe", EAF_RW, &fd), "open");
+    eaf_test_rc(EAF_Truncate(fd, (eaf_off_t)cut*sizeof(int)), "truncate");
+    eaf_test_rc(EAF_Close(fd), "close");
+    read_file("eaf_stripe", 1, cut);
+
+    eaf_test_rc(EAF_Delete("eaf_stripe"), "delete");
+    eaf_test_check(!exists("eaf_stripe.s0") && !exists("eaf_stripe.s1")
+            && !exists("eaf_stripe.s2"), "delete stripes");
+    unsetenv("EAF_STRIPES");
+}
+
+/* stripes in two directories, for two files of the same name */
+static void test_stripe_dirs(void)
+{
+    mkdir("eaf_stripe_a", 0755);
+    mkdir("eaf_stripe_b", 0755);
+    mkdir("eaf_stripe_x", 0755);
+    mkdir("eaf_stripe_y", 0755);
+    setenv("EAF_STRIPE_DIRS", "eaf_stripe_a::eaf_stripe_b", 1);
+
+    write_file("eaf_stripe_x/f", 2);
+    write_file("eaf_stripe_y/f", 3);
+    eaf_test_check(entries("eaf_stripe_a") == 2 && entries("eaf_stripe_b") == 2,
+            "stripes of files of the same name");
+    eaf_test_check(entries("eaf_stripe_x") == 0 && entries("eaf_stripe_y") == 0,
+            "nothing next to the files");
+    read_file("eaf_stripe_x/f", 2, LEN);
+    read_file("eaf_stripe_y/f", 3, LEN);
+
+    /* the same through the page cache */
+    setenv("EAF_CACHE_MB", "1", 1);
+    setenv("EAF_CACHE_PAGE_KB", "4", 1);
+    write_file("eaf_stripe_y/f", 4);
+    read_file("eaf_stripe_y/f", 4, LEN);
+    unsetenv("EAF_CACHE_MB");
+    read_file("eaf_stripe_y/f", 4, LEN);
+    read_file("eaf_stripe_x/f", 2, LEN);
+
+    eaf_test_rc(EAF_Delete("eaf_stripe_x/f"), "delete");
+    eaf_test_check(entries("eaf_stripe_a") == 1 && entries("eaf_stripe_b") == 1,
+            "delete of one file");
+    eaf_test_rc(EAF_Delete("eaf_stripe_y/f"), "delete");
+    eaf_test_check(entries("eaf_stripe_a") == 0 && entries("eaf_stripe_b") == 0,
+            "delete stripes");
+    unsetenv("EAF_STRIPE_DIRS");
+    rmdir("eaf_stripe_a");
+    rmdir("eaf_stripe_b");
+    rmdir("eaf_stripe_x");
+    rmdir("eaf_stripe_y");
+}
+
+int main(int argc, char **argv)
+{
+    setenv("EAF_STRIPE_KB", "4", 1);
+    ref = (int*)malloc(sizeof(int)*LEN);
+    buf = (int*)malloc(sizeof(int)*LEN);
+
+    test_stripes();
+    test_stripe_dirs();
+
+    free(buf);
+    free(ref);
+    printf("No errors detected\n");
+    return 0;
+}
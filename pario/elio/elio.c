@@ -48,6 +48,9 @@
 
 #if  defined(AIX) || defined(DECOSF) || defined(SGI64) || defined(CRAY) || defined(LINUXAIO)
      /* systems with Asynchronous I/O */
+#elif (defined(LINUX) || defined(__linux__)) && !defined(NOAIO) && !defined(NOTHREADAIO)
+     /* no Posix AIO on Linux: serve requests from a pool of I/O threads */
+#    define THREADAIO
 #else
 #    ifndef NOAIO
 #      define NOAIO
@@ -56,7 +59,12 @@
 
 /****************** Internal Constants and Parameters **********************/
 
-#define  MAX_AIO_REQ  4
+#if defined(THREADAIO) || defined(LINUXAIO)
+#  define  MAX_AIO_REQ  128
+#else
+#  define  MAX_AIO_REQ  4
+#endif
+#define  AIO_THREADS_DEFAULT 4
 #define  NULL_AIO    -123456
 #define  FOPEN_MODE 0644
 #define  MAX_ATTEMPTS 10
@@ -106,6 +114,27 @@
     io_status_t cb_fout[MAX_AIO_REQ];
     io_status_t *cb_fout_arr[MAX_AIO_REQ];
 
+#elif defined(THREADAIO)
+#   include <pthread.h>
+#   define INPROGRESS EINPROGRESS
+    typedef struct {
+      int    filedes;
+      off_t  offset;
+      char   *buf;
+      Size_t bytes;
+      int    write;   /* 1 for write, 0 for read */
+      int    errval;  /* INPROGRESS, 0 when done or ELIO error code */
+    } io_status_t;
+    io_status_t cb_fout[MAX_AIO_REQ];
+
+    /* FIFO of submitted requests; never holds more than MAX_AIO_REQ */
+    static int             tp_queue[MAX_AIO_REQ];
+    static unsigned long   tp_head = 0, tp_tail = 0;
+    static int             tp_threads = 0;
+    static pthread_mutex_t tp_mutex = PTHREAD_MUTEX_INITIALIZER;
+    static pthread_cond_t  tp_work = PTHREAD_COND_INITIALIZER;
+    static pthread_cond_t  tp_done = PTHREAD_COND_INITIALIZER;
+
 #elif defined(AIO)
 #   include <aio.h>
 #   if defined(AIX)
@@ -133,7 +162,7 @@ int                   _elio_Errors_Fatal=0; /* sets mode of handling errors */
 #if defined(AIO)
 #  define AIO_LOOKUP(aio_i) {\
       aio_i = 0;\
-      while(aio_req[aio_i] != NULL_AIO && aio_i < MAX_AIO_REQ) aio_i++;\
+      while(aio_i < MAX_AIO_REQ && aio_req[aio_i] != NULL_AIO) aio_i++;\
 }
 #else
 #  define AIO_LOOKUP(aio_i) aio_i = MAX_AIO_REQ
@@ -167,6 +196,118 @@ int                   _elio_Errors_Fatal=0; /* sets mode of handling errors */
 
 /*****************************************************************************/
 
+#if defined(THREADAIO)
+/*\ Move one request to or from disk with pread/pwrite, which leave the
+ *  file offset alone so the blocking calls can share the descriptor
+\*/
+static int elio_tp_transfer(io_status_t *cb)
+{
+  char   *buf = cb->buf;
+  off_t  offset = cb->offset;
+  Size_t left = cb->bytes;
+  Size_t stat;
+
+  while (left) {
+    if (cb->write) stat = pwrite(cb->filedes, buf, left, offset);
+    else           stat = pread(cb->filedes, buf, left, offset);
+    if ((stat == -1) && ((errno == EINTR) || (errno == EAGAIN))) {
+      ; /* interrupted transfer should be restarted */
+    } else if (stat > 0) {
+      left -= stat;
+      buf += stat;
+      offset += stat;
+    } else if (stat == 0 && !cb->write) {
+      return EOFFAIL;
+    } else {
+      return cb->write ? AWRITFAIL : AREADFAIL;
+    }
+  }
+  return 0;
+}
+
+
+/*\ I/O thread: take the oldest queued request, complete it, repeat
+\*/
+static void *elio_tp_worker(void *arg)
+{
+  int reqn, errval;
+
+  while (1) {
+    pthread_mutex_lock(&tp_mutex);
+    while (tp_head == tp_tail) pthread_cond_wait(&tp_work, &tp_mutex);
+    reqn = tp_queue[tp_head % MAX_AIO_REQ];
+    tp_head++;
+    pthread_mutex_unlock(&tp_mutex);
+
+    errval = elio_tp_transfer(cb_fout + reqn);
+
+    pthread_mutex_lock(&tp_mutex);
+    cb_fout[reqn].errval = errval;
+    pthread_cond_broadcast(&tp_done);
+    pthread_mutex_unlock(&tp_mutex);
+  }
+  return NULL;
+}
+
+
+/*\ Start the I/O threads on first use. Their number is taken from
+ *  ELIO_AIO_THREADS. Returns the number of running threads.
+\*/
+static int elio_tp_start(void)
+{
+  pthread_attr_t attr;
+  pthread_t      thread;
+  char           *value;
+  int            i, nthreads = AIO_THREADS_DEFAULT;
+
+  value = getenv("ELIO_AIO_THREADS");
+  if (value != NULL && atoi(value) > 0) nthreads = atoi(value);
+
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  for (i = 0; i < nthreads; i++) {
+    if (pthread_create(&thread, &attr, elio_tp_worker, NULL)) break;
+  }
+  pthread_attr_destroy(&attr);
+  tp_threads = i;
+  return tp_threads;
+}
+
+
+/*\ Queue request reqn for the I/O threads: returns 0 or -1 if no thread
+\*/
+static int elio_tp_submit(int reqn)
+{
+  if (tp_threads == 0 && elio_tp_start() == 0) return -1;
+
+  pthread_mutex_lock(&tp_mutex);
+  cb_fout[reqn].errval = INPROGRESS;
+  tp_queue[tp_tail % MAX_AIO_REQ] = reqn;
+  tp_tail++;
+  pthread_cond_signal(&tp_work);
+  pthread_mutex_unlock(&tp_mutex);
+  return 0;
+}
+
+
+/*\ Status of request reqn: INPROGRESS, 0 or ELIO error code. With block
+ *  set, waits until the request is no longer in progress.
+\*/
+static int elio_tp_status(int reqn, int block)
+{
+  int errval;
+
+  pthread_mutex_lock(&tp_mutex);
+  if (block) {
+    while (cb_fout[reqn].errval == INPROGRESS)
+      pthread_cond_wait(&tp_done, &tp_mutex);
+  }
+  errval = cb_fout[reqn].errval;
+  pthread_mutex_unlock(&tp_mutex);
+  return errval;
+}
+#endif
+
 static Off_t elio_max_file_size(Fd_t fd)
      /* 
       * Return the maximum size permitted for this PHYSICAL file.
@@ -295,6 +436,11 @@ int elio_set_cb(Fd_t fd, Off_t doffset, int reqn, void *buf, Size_t bytes)
        if(offset != SEEK(fd->fd, offset, SEEK_SET))return (SEEKFAIL);
        cb_fout_arr[reqn] = cb_fout+reqn;
        cb_fout[reqn].filedes    = fd->fd;
+#   elif defined(THREADAIO)
+       cb_fout[reqn].filedes = fd->fd;
+       cb_fout[reqn].offset  = offset;
+       cb_fout[reqn].buf     = (char*) buf;
+       cb_fout[reqn].bytes   = bytes;
 #   else
        cb_fout[reqn].aio_offset = offset;
        cb_fout_arr[reqn] = cb_fout+reqn;
@@ -373,6 +519,9 @@ int elio_awrite(Fd_t fd, Off_t doffset, const void* buf, Size_t bytes, io_reques
 #    if defined(CRAY)
        rc = WRITEA(fd->fd, (char*)buf, bytes, &cb_fout[aio_i].stat, DEFARG);
        stat = (rc < 0)? -1 : 0; 
+#    elif defined(THREADAIO)
+       cb_fout[aio_i].write = 1;
+       stat = elio_tp_submit(aio_i);
 #    elif defined(AIX) 
 #       if !defined(AIX52) && !defined(_AIO_AIX_SOURCE)
        stat = aio_write(fd->fd, cb_fout + aio_i);
@@ -606,6 +755,9 @@ int elio_aread(Fd_t fd, Off_t doffset, void* buf, Size_t bytes, io_request_t * r
 #       if defined(CRAY)
           rc = READA(fd->fd, buf, bytes, &cb_fout[aio_i].stat, DEFARG);
           stat = (rc < 0)? -1 : 0;
+#       elif defined(THREADAIO)
+          cb_fout[aio_i].write = 0;
+          stat = elio_tp_submit(aio_i);
 #       elif defined(AIX)
 #if    !defined(AIX52) && !defined(_AIO_AIX_SOURCE)
           stat = aio_read(fd->fd, cb_fout+aio_i);
@@ -664,6 +816,13 @@ int elio_wait(io_request_t *req_id)
          }
 #        endif
 
+#      elif defined(THREADAIO)
+      if((rc = elio_tp_status((int)*req_id, 1)) != 0) {
+          aio_req[(int)*req_id] = NULL_AIO;
+          *req_id = ELIO_DONE;
+          ELIO_ERROR(rc,0);
+      }
+
 #      elif defined(AIX) 
 #         if    !defined(AIX52) && !defined(_AIO_AIX_SOURCE)
               do {    /* I/O can be interrupted on SP through rcvncall ! */
@@ -682,7 +841,7 @@ int elio_wait(io_request_t *req_id)
 #  endif
 #endif
 
-      while(aio_req[aio_i] != *req_id && aio_i < MAX_AIO_REQ) aio_i++;
+      while(aio_i < MAX_AIO_REQ && aio_req[aio_i] != *req_id) aio_i++;
       if(aio_i >= MAX_AIO_REQ) ELIO_ERROR(HANDFAIL, aio_i);
 
       aio_req[aio_i] = NULL_AIO;
@@ -729,6 +888,8 @@ int elio_probe(io_request_t *req_id, int* status)
 
 #     endif
 
+#   elif defined(THREADAIO)
+      errval = elio_tp_status((int)*req_id, 0);
 #   elif defined(AIX)
       errval = aio_error(cb_fout[(int)*req_id].aio_handle);
 #   else
@@ -737,7 +898,7 @@ int elio_probe(io_request_t *req_id, int* status)
 #endif
       switch (errval) {
       case 0: 
-          while(aio_req[aio_i] != *req_id && aio_i < MAX_AIO_REQ) aio_i++;
+          while(aio_i < MAX_AIO_REQ && aio_req[aio_i] != *req_id) aio_i++;
           if(aio_i >= MAX_AIO_REQ) ELIO_ERROR(HANDFAIL, aio_i);
 
       *req_id = ELIO_DONE; 
@@ -748,6 +909,11 @@ int elio_probe(io_request_t *req_id, int* status)
       *status = ELIO_PENDING; 
       break;
       default:
+          /* the request has ended in error, release it as elio_wait does */
+          while(aio_i < MAX_AIO_REQ && aio_req[aio_i] != *req_id) aio_i++;
+          if(aio_i < MAX_AIO_REQ) aio_req[aio_i] = NULL_AIO;
+          *req_id = ELIO_DONE;
+          *status = ELIO_DONE;
           return PROBFAIL;
       }
   }
@@ -1035,7 +1201,7 @@ int elio_delete(const char* filename)
 void elio_init(void)
 {
   if(first_elio_init) {
-#     if defined(ASYNC)
+#     if defined(AIO)
            int i;
            for(i=0; i < MAX_AIO_REQ; i++)
          aio_req[i] = NULL_AIO;
@@ -32,6 +32,7 @@ typedef unsigned long avail_t;
 typedef struct{
   int   fs;
   avail_t  avail;
+  avail_t  blksize;  /* preferred I/O size in bytes, e.g. the stripe size */
 } stat_t;
 typedef long io_request_t;   /* asynchronous I/O request type */
 
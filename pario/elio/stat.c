@@ -107,8 +107,12 @@ int  elio_stat(char *fname, stat_t *statinfo)
 #   if defined(WIN32)
 
        get_avail_space(ufs_statfs.st_dev, &(statinfo->avail), &bsize);
+       statinfo->blksize = (avail_t) bsize;
       
 #   else
+      /* striped file systems report the stripe size as st_blksize */
+      statinfo->blksize = (avail_t) ufs_stat.st_blksize;
+
       /* get number of available blocks */
 #     if defined(CRAY) || defined(NEC)
           /* f_bfree == f_bavail -- naming changes */
@@ -30,6 +30,12 @@
 #if HAVE_STRING_H
 #   include <string.h>
 #endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+#ifdef MSG_COMMS_MPI
+#   include <mpi.h>
+#endif
 #include "ga.h"
 #include "elio.h"
 #include "sf.h"
@@ -38,6 +44,7 @@
 #define _max_shared_files 100
 #define SF_OFFSET 3000
 #define SF_FAIL (Integer)1
+#define SF_MPIIO_MAX_BYTES (1<<30) /**< largest single MPI-IO transfer */
 
 typedef struct{
     Integer handle;
@@ -46,6 +53,10 @@ typedef struct{
     SFsize_t hard_size; 
     Fd_t fd;
     char fname[200];
+    int mpiio;           /**< file accessed through MPI-IO ? */
+#ifdef MSG_COMMS_MPI
+    MPI_File fh;
+#endif
 } SF_t;
 
 SF_t SF[_max_shared_files];
@@ -90,6 +101,82 @@ void sfi_release_handle(Integer *handle)
 }
 
 
+/**
+ * shared files are accessed through MPI-IO instead of ELIO if optional
+ * environmental variable SF_MPIIO is set to a nonzero value
+ */
+static int sfi_get_mpiio()
+{
+#ifdef MSG_COMMS_MPI
+    char *str = getenv("SF_MPIIO");
+    if(str==NULL)return 0;
+    return atoi(str) != 0;
+#else
+    return 0;
+#endif
+}
+
+
+/**
+ * open file of SF handle hndl in ELIO mode emode. Shared file operations are
+ * not collective, so with MPI-IO every process opens the file on its own and
+ * uses independent I/O; the hints of the MPI library still apply.
+ */
+static void sfi_open(Integer hndl, int emode, char *msg)
+{
+#ifdef MSG_COMMS_MPI
+    if(SF[hndl].mpiio){
+        int amode = (emode == ELIO_R) ? MPI_MODE_RDONLY
+                                      : MPI_MODE_RDWR|MPI_MODE_CREATE;
+        if(MPI_File_open(MPI_COMM_SELF, SF[hndl].fname, amode, MPI_INFO_NULL,
+                    &SF[hndl].fh) != MPI_SUCCESS) ERROR(msg,0);
+        return;
+    }
+#endif
+    SF[hndl].fd = elio_open(SF[hndl].fname, emode, ELIO_SHARED);
+    if(SF[hndl].fd==NULL) ERROR(msg,0);
+    if(SF[hndl].fd->fd==-1) ERROR(msg,-1);
+}
+
+
+static void sfi_close(Integer hndl)
+{
+#ifdef MSG_COMMS_MPI
+    if(SF[hndl].mpiio){
+        MPI_File_close(&SF[hndl].fh);
+        return;
+    }
+#endif
+    elio_close(SF[hndl].fd);
+}
+
+
+#ifdef MSG_COMMS_MPI
+/**
+ * blocking independent MPI-IO transfer, split into pieces that fit an int
+ */
+static Integer sfi_mpiio_rw(Integer hndl, int write, SFsize_t offset,
+        SFsize_t bytes, char *buffer)
+{
+    MPI_Status status;
+    int rc, len;
+
+    while(bytes > 0){
+        len = (bytes > SF_MPIIO_MAX_BYTES) ? SF_MPIIO_MAX_BYTES : (int)bytes;
+        if(write) rc = MPI_File_write_at(SF[hndl].fh, (MPI_Offset)offset,
+                buffer, len, MPI_BYTE, &status);
+        else      rc = MPI_File_read_at(SF[hndl].fh, (MPI_Offset)offset,
+                buffer, len, MPI_BYTE, &status);
+        if(rc != MPI_SUCCESS) return(SF_FAIL);
+        offset += len;
+        buffer += len;
+        bytes  -= len;
+    }
+    return((Integer)ELIO_OK);
+}
+#endif
+
+
 Integer sfi_create(char *fname, SFsize_t *size_hard_limit,
         SFsize_t *size_soft_limit, SFsize_t *req_size, Integer *handle)
 {
@@ -104,12 +191,10 @@ Integer sfi_create(char *fname, SFsize_t *size_hard_limit,
     /*generate file name(s) */
     sprintf(SF[hndl].fname,"%s.%d",fname, (int)hndl);
 
-    if (ME() == 0) SF[hndl].fd = elio_open(SF[hndl].fname,ELIO_RW, ELIO_SHARED);
+    SF[hndl].mpiio = sfi_get_mpiio();
+    if (ME() == 0) sfi_open(hndl, ELIO_RW, "sf_create: could not open file");
     SYNC();
-    if (ME() != 0) SF[hndl].fd = elio_open(SF[hndl].fname,ELIO_RW, ELIO_SHARED);
-
-    if(SF[hndl].fd==NULL) ERROR("sf_create: could not open file",0);
-    if(SF[hndl].fd->fd==-1) ERROR("sf_create: descriptor -1",0);
+    if (ME() != 0) sfi_open(hndl, ELIO_RW, "sf_create: could not open file");
 
     SF[hndl].soft_size = *size_soft_limit;
     SF[hndl].hard_size = *size_hard_limit;
@@ -143,12 +228,10 @@ Integer sfi_create_suffix(char *fname, SFsize_t *size_hard_limit,
     /*generate file name(s) */
     sprintf(SF[hndl].fname,"%s.%d",fname, (int) *suffix);
 
-    if (ME() == 0) SF[hndl].fd = elio_open(SF[hndl].fname,ELIO_RW, ELIO_SHARED);
+    SF[hndl].mpiio = sfi_get_mpiio();
+    if (ME() == 0) sfi_open(hndl, ELIO_RW, "sf_create_suffix: could not open file");
     SYNC();
-    if (ME() != 0) SF[hndl].fd = elio_open(SF[hndl].fname,ELIO_RW, ELIO_SHARED);
-
-    if(SF[hndl].fd==NULL) ERROR("sf_create_suffix: could not open file",0);
-    if(SF[hndl].fd->fd==-1) ERROR("sf_create_suffix: descriptor -1",0);
+    if (ME() != 0) sfi_open(hndl, ELIO_RW, "sf_create_suffix: could not open file");
 
     SF[hndl].soft_size = *size_soft_limit;
     SF[hndl].hard_size = *size_hard_limit;
@@ -167,7 +250,7 @@ Integer FATR sf_destroy_(Integer *s_a /**< [in] SF handle */)
 
     sfi_check_handleM(*s_a,"sf_delete");
 
-    elio_close(SF[handle].fd); /* fix from Peter Knowles */
+    sfi_close(handle); /* fix from Peter Knowles */
 
     SYNC(); /* this sync is unnecessary under Unix */
 
@@ -187,11 +270,8 @@ Integer FATR sf_rwtor_(Integer *s_a /**< [in] SF handle */)
 {
     Integer handle = *s_a+SF_OFFSET;
 
-    elio_close(SF[handle].fd);
-    SF[handle].fd = elio_open(SF[handle].fname,ELIO_R, ELIO_SHARED);
-
-    if(SF[handle].fd==NULL) ERROR("sf_open: could not open file",0);
-    if(SF[handle].fd->fd==-1) ERROR("sf_open: descriptor -1",0);
+    sfi_close(handle);
+    sfi_open(handle, ELIO_R, "sf_rwtor: could not open file");
 
     return(ELIO_OK);
 }
@@ -204,10 +284,7 @@ Integer FATR sf_open_(Integer *s_a /**< [in] SF handle */)
 {
     Integer handle = *s_a+SF_OFFSET;
 
-    SF[handle].fd = elio_open(SF[handle].fname,ELIO_RW, ELIO_SHARED);
-
-    if(SF[handle].fd==NULL) ERROR("sf_open: could not open file",0);
-    if(SF[handle].fd->fd==-1) ERROR("sf_open: descriptor -1",0);
+    sfi_open(handle, ELIO_RW, "sf_open: could not open file");
 
     return(ELIO_OK);
 }
@@ -220,7 +297,7 @@ Integer FATR sf_close_(Integer *s_a)
 {
     Integer handle = *s_a+SF_OFFSET;
 
-    elio_close(SF[handle].fd);
+    sfi_close(handle);
     return(ELIO_OK);
 }
 
@@ -231,6 +308,12 @@ Integer FATR sf_fsync_(Integer *s_a)
 {
     Integer handle = *s_a+SF_OFFSET;
 
+#ifdef MSG_COMMS_MPI
+    if(SF[handle].mpiio){
+        MPI_File_sync(SF[handle].fh);
+        return(ELIO_OK);
+    }
+#endif
     elio_fsync(SF[handle].fd);
     return(ELIO_OK);
 }
@@ -247,6 +330,12 @@ Integer FATR sf_write_(Integer *s_a, SFsize_t *offset, SFsize_t *bytes,
     io_request_t id;
 
     sfi_check_handleM(*s_a,"sf_write");
+#ifdef MSG_COMMS_MPI
+    if(SF[handle].mpiio){
+        *req_id = (Integer)ELIO_DONE;
+        return(sfi_mpiio_rw(handle, 1, *offset, *bytes, buffer));
+    }
+#endif
     status = elio_awrite(SF[handle].fd, (Off_t)*offset, buffer, 
             (Size_t)*bytes, &id);
     *req_id = (Integer)id;
@@ -273,6 +362,12 @@ Integer FATR sf_read_(Integer *s_a, SFsize_t *offset, SFsize_t *bytes,
     io_request_t id;
 
     sfi_check_handleM(*s_a,"sf_read");
+#ifdef MSG_COMMS_MPI
+    if(SF[handle].mpiio){
+        *req_id = (Integer)ELIO_DONE;
+        return(sfi_mpiio_rw(handle, 0, *offset, *bytes, buffer));
+    }
+#endif
     status = elio_aread(SF[handle].fd, (Off_t)*offset, buffer, 
             (Size_t)*bytes, &id);
     *req_id = (Integer)id;
@@ -0,0 +1,102 @@
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+/* shared files through ELIO and, with SF_MPIIO set, through MPI-IO: every
+ * process writes its chunk of the file with several outstanding requests,
+ * then reads back the chunk of another process after switching the file to
+ * read only, with requests that straddle the chunks */
+
+#if HAVE_STDIO_H
+#   include <stdio.h>
+#endif
+#if HAVE_STDLIB_H
+#   include <stdlib.h>
+#endif
+
+#include "ga.h"
+#include "macdecls.h"
+#include "sf.h"
+#include "testutil.h"
+
+#define FNAME "sf_testc"
+#define REC   8192              /* doubles per request */
+#define NREQ  5                 /* outstanding requests */
+#define CHUNK (NREQ*REC + 1000) /* doubles per process */
+
+static int me, nproc;
+
+static void check_rc(int rc, const char *what)
+{
+    char msg[80];
+
+    if (rc) {
+        SF_Errmsg(rc, msg);
+        printf("%d: %s: %s\n", me, what, msg);
+        test_check(0, what);
+    }
+}
+
+static void test(const char *what)
+{
+    double size = (double)CHUNK*nproc*sizeof(double);
+    double *buf;
+    int handle, ids[NREQ], nid = 0, i, j, n, lo, hi;
+
+    if (me == 0) printf("%s\n", what);
+    buf = (double*)malloc(sizeof(double)*REC*NREQ);
+    check_rc(SF_Create(FNAME, 2*size, size, (double)REC*sizeof(double),
+                &handle), "SF_Create");
+
+    /* this process's chunk, the last request shorter than the others */
+    lo = me*CHUNK;
+    hi = lo + CHUNK;
+    for (i=lo; i<hi; i+=REC) {
+        if (nid == NREQ) {
+            check_rc(SF_Waitall(ids, nid), "SF_Waitall");
+            nid = 0;
+        }
+        n = (hi - i < REC) ? hi - i : REC;
+        for (j=0; j<n; j++) buf[nid*REC + j] = (double)(i + j);
+        check_rc(SF_Write(handle, (double)i*sizeof(double),
+                    (double)n*sizeof(double), (char*)(buf + nid*REC),
+                    &ids[nid]), "SF_Write");
+        nid++;
+    }
+    check_rc(SF_Waitall(ids, nid), "SF_Waitall");
+    check_rc(SF_Fsync(handle), "SF_Fsync");
+    GA_Sync();
+    check_rc(SF_Rwtor(handle), "SF_Rwtor");
+
+    /* the chunk of the next process, shifted by half a request */
+    lo = ((me + 1) % nproc)*CHUNK + REC/2;
+    hi = lo + CHUNK;
+    if (hi > nproc*CHUNK) hi = nproc*CHUNK;
+    for (i=lo; i<hi; i+=REC) {
+        n = (hi - i < REC) ? hi - i : REC;
+        for (j=0; j<n; j++) buf[j] = -1.0;
+        check_rc(SF_Read(handle, (double)i*sizeof(double),
+                    (double)n*sizeof(double), (char*)buf, &ids[0]), "SF_Read");
+        check_rc(SF_Wait(&ids[0]), "SF_Wait");
+        for (j=0; j<n; j++) test_check(buf[j] == (double)(i + j), what);
+    }
+    GA_Sync();
+
+    check_rc(SF_Destroy(handle), "SF_Destroy");
+    free(buf);
+}
+
+int main(int argc, char **argv)
+{
+    test_init(&argc, &argv);
+    me = GA_Nodeid();
+    nproc = GA_Nnodes();
+
+    test("shared file through ELIO");
+    /* read by each SF_Create */
+    setenv("SF_MPIIO", "1", 1);
+    test("shared file through MPI-IO");
+
+    test_finalize();
+    return 0;
+}
@@ -0,0 +1,175 @@
+#!/usr/bin/env python
+
+'''Merge the per-process profiles written by the wapigen_hist.py wrappers.
+
+usage: ga_prof_report.py [-n top] gaprof.0 gaprof.1 ...
+
+Prints, over all processes,
+  - for every GA call: calls, total time and the mean, median, 90th and
+    99th percentile and maximum latency;
+  - the bytes moved by get, put and accumulate to the calling process
+    itself, to other processes on the same node and to other nodes;
+  - the process pairs and the target processes that moved the most bytes;
+  - the arrays that moved the most bytes.
+'''
+
+import struct
+import sys
+
+SUB_BITS = 3
+SUB = 1 << SUB_BITS
+OPS = ['get', 'put', 'acc']
+CLASSES = ['local', 'node', 'remote', 'other']
+
+class Reader(object):
+    def __init__(self, fname):
+        self.data = open(fname, 'rb').read()
+        self.pos = 0
+        self.fname = fname
+
+    def read(self, fmt, n=1):
+        size = struct.calcsize('=%d%s' % (n, fmt))
+        vals = struct.unpack_from('=%d%s' % (n, fmt), self.data, self.pos)
+        self.pos += size
+        return list(vals)
+
+    def name(self):
+        n = self.read('i')[0]
+        s = self.data[self.pos:self.pos+n].decode('ascii', 'replace')
+        self.pos += n
+        return s
+
+def bucket_low(b):
+    '''smallest latency in ns that falls into bucket b'''
+    if b < SUB:
+        return b
+    e = b // SUB + SUB_BITS - 1
+    return (SUB + b % SUB) << (e - SUB_BITS)
+
+def percentile(hist, count, q):
+    want = q * count
+    seen = 0
+    for b, n in enumerate(hist):
+        seen += n
+        if n and seen >= want:
+            return bucket_low(b)
+    return 0
+
+def fmt_ns(ns):
+    if ns < 1e3:
+        return '%.0fns' % ns
+    if ns < 1e6:
+        return '%.1fus' % (ns / 1e3)
+    if ns < 1e9:
+        return '%.1fms' % (ns / 1e6)
+    return '%.2fs' % (ns / 1e9)
+
+def fmt_bytes(b):
+    for unit in ['B', 'KB', 'MB', 'GB']:
+        if b < 1024:
+            return '%.1f%s' % (b, unit)
+        b /= 1024.0
+    return '%.1fTB' % b
+
+def main(args):
+    top = 10
+    if len(args) > 1 and args[0] == '-n':
+        top = int(args[1])
+        args = args[2:]
+    if not args:
+        print(__doc__)
+        return 1
+
+    apis = {}
+    class_bytes = [[0] * len(CLASSES) for op in OPS]
+    class_calls = [[0] * len(CLASSES) for op in OPS]
+    pairs = {}
+    targets = {}
+    arrays = {}
+    nodes = {}
+    nproc = 0
+    for fname in args:
+        r = Reader(fname)
+        if r.data[:8] != b'GAPROF01':
+            sys.stderr.write('%s: not a GA profile\n' % fname)
+            return 1
+        r.pos = 8
+        me, nproc, node, nbuckets, napi, narray = r.read('i', 6)
+        nodes[me] = node
+        for i in range(napi):
+            name = r.name()
+            count, total, tmin, tmax = r.read('q', 4)
+            hist = r.read('q', nbuckets)
+            if name not in apis:
+                apis[name] = [0, 0, tmin, 0, [0] * nbuckets]
+            a = apis[name]
+            a[0] += count
+            a[1] += total
+            a[2] = min(a[2], tmin)
+            a[3] = max(a[3], tmax)
+            a[4] = [x + y for x, y in zip(a[4], hist)]
+        cb = r.read('q', len(OPS) * len(CLASSES))
+        cc = r.read('q', len(OPS) * len(CLASSES))
+        for o in range(len(OPS)):
+            for c in range(len(CLASSES)):
+                class_bytes[o][c] += cb[o * len(CLASSES) + c]
+                class_calls[o][c] += cc[o * len(CLASSES) + c]
+        r.read('i', nproc)
+        tb = r.read('q', len(OPS) * nproc)
+        for o in range(len(OPS)):
+            for p in range(nproc):
+                b = tb[o * nproc + p]
+                if b:
+                    key = (me, p, OPS[o])
+                    pairs[key] = pairs.get(key, 0) + b
+                    targets[p] = targets.get(p, 0) + b
+        for i in range(narray):
+            name = r.name()
+            calls, nbytes = r.read('q', 2)
+            a = arrays.setdefault(name, [0, 0])
+            a[0] += calls
+            a[1] += nbytes
+
+    print('GA profile of %d of %d processes on %d nodes' %
+          (len(nodes), nproc, len(set(nodes.values()))))
+    print('')
+    print('%-32s %10s %10s %9s %9s %9s %9s %9s' %
+          ('call', 'calls', 'total', 'mean', 'p50', 'p90', 'p99', 'max'))
+    for name in sorted(apis, key=lambda n: -apis[n][1]):
+        count, total, tmin, tmax, hist = apis[name]
+        print('%-32s %10d %10s %9s %9s %9s %9s %9s' %
+              (name, count, fmt_ns(total), fmt_ns(float(total) / count),
+               fmt_ns(percentile(hist, count, 0.5)),
+               fmt_ns(percentile(hist, count, 0.9)),
+               fmt_ns(percentile(hist, count, 0.99)), fmt_ns(tmax)))
+
+    print('')
+    print('%-6s' % 'bytes' + ''.join(['%18s' % c for c in CLASSES]))
+    for o in range(len(OPS)):
+        print('%-6s' % OPS[o] + ''.join(
+            ['%18s' % ('%s/%d' % (fmt_bytes(class_bytes[o][c]),
+                                  class_calls[o][c]))
+             for c in range(len(CLASSES))]))
+
+    if pairs:
+        print('')
+        print('top process pairs (origin -> target)')
+        for key in sorted(pairs, key=lambda k: -pairs[k])[:top]:
+            print('  %6d -> %-6d %-4s %12s' %
+                  (key[0], key[1], key[2], fmt_bytes(pairs[key])))
+        print('')
+        print('top targets')
+        for p in sorted(targets, key=lambda k: -targets[k])[:top]:
+            print('  %6d (node %s) %12s' %
+                  (p, nodes.get(p, '?'), fmt_bytes(targets[p])))
+
+    if arrays:
+        print('')
+        print('top arrays')
+        for name in sorted(arrays, key=lambda n: -arrays[n][1])[:top]:
+            print('  %-32s %10d calls %12s' %
+                  (name, arrays[name][0], fmt_bytes(arrays[name][1])))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
@@ -0,0 +1,86 @@
+#!/usr/bin/env python
+
+'''Merge the Chrome trace files of GA calls and ComEx operations.
+
+usage: ga_trace_merge.py [-o merged.json] [-n top] files...
+
+The files are those written by the wapigen_chrome.py wrappers
+(<prefix>.ga.<rank>.json) and by ComEx when COMEX_TRACE is set
+(<prefix>.comex.<rank>.json). The merged timeline, written to
+merged.json (default gatrace.json), loads in chrome://tracing or
+Perfetto. Timestamps are shifted so that the first event starts at 0.
+
+Also prints the longest synchronization events (sync, fence, barrier and
+wait calls and the fence handler of the progress servers), which is where
+processes wait for each other.
+'''
+
+import json
+import sys
+
+SYNC = ('sync', 'fence', 'barrier', 'wait')
+
+def main(args):
+    out = 'gatrace.json'
+    top = 10
+    while len(args) > 1 and args[0] in ('-o', '-n'):
+        if args[0] == '-o':
+            out = args[1]
+        else:
+            top = int(args[1])
+        args = args[2:]
+    if not args:
+        print(__doc__)
+        return 1
+
+    events = []
+    meta = {}
+    for fname in args:
+        try:
+            trace = json.load(open(fname))
+        except ValueError:
+            sys.stderr.write('%s: not a Chrome trace file\n' % fname)
+            return 1
+        for e in trace['traceEvents']:
+            if e['ph'] == 'M':
+                # both files of a process name it, keep the first name
+                key = (e['name'], e['pid'], e['tid'])
+                if key not in meta:
+                    meta[key] = e
+                elif e['name'] == 'process_labels':
+                    meta[key]['args']['labels'] += ', ' + e['args']['labels']
+            else:
+                events.append(e)
+
+    if events:
+        t0 = min([e['ts'] for e in events])
+        for e in events:
+            e['ts'] = round(e['ts'] - t0, 3)
+    merged = {'traceEvents': list(meta.values()) + events,
+              'displayTimeUnit': 'ns'}
+    json.dump(merged, open(out, 'w'))
+
+    names = dict([(e['pid'], e['args']['name']) for e in meta.values()
+                  if e['name'] == 'process_name'])
+    print('%d events of %d processes written to %s' %
+          (len(events), len(names), out))
+    for e in meta.values():
+        if e['name'] == 'process_labels':
+            print('  %s: %s' % (names.get(e['pid'], e['pid']),
+                                e['args']['labels']))
+
+    sync = [e for e in events
+            if [w for w in SYNC if w in e['name']]]
+    if sync:
+        print('')
+        print('longest synchronization events')
+        print('  %-24s %-22s %12s %12s' % ('process', 'call', 'start(us)',
+                                           'dur(us)'))
+        for e in sorted(sync, key=lambda e: -e['dur'])[:top]:
+            print('  %-24s %-22s %12.1f %12.1f' %
+                  (names.get(e['pid'], e['pid']), e['name'], e['ts'],
+                   e['dur']))
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
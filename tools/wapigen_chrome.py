@@ -0,0 +1,341 @@
+#!/usr/bin/env python
+
+'''Generate the wapi_chrome.c source from the ga-papi.h header.
+
+The generated wrappers record every wnga_* call as an event with its start
+time and duration, and for calls on an array its handle and, for get, put
+and accumulate, the bytes moved. Events go to a ring buffer of
+GA_TRACE_EVENTS events per process (default 65536); once it is full the
+oldest events are overwritten. At GA_Terminate each process writes its
+events in Chrome trace format to <prefix>.ga.<rank>.json, where the prefix
+is GA_TRACE_PREFIX (default "gatrace") and rank is the MPI_COMM_WORLD rank.
+
+Setting COMEX_TRACE to the same prefix also traces the ComEx operations
+underneath, see comex/src-common/trace.h. tools/ga_trace_merge.py combines
+the files of all processes into one timeline for chrome://tracing or
+Perfetto, where each process shows its GA calls and ComEx operations as two
+threads.
+
+usage:
+  wapigen_chrome.py ga-papi.h > tools/ga-wapi.c
+then configure with --enable-profiling.
+
+Calls that only inquire about arrays or processes are not traced. Both
+traces take their timestamps from CLOCK_REALTIME, so that the events of
+processes on different nodes line up as well as their clocks agree.
+'''
+
+import sys
+
+def get_signatures(header):
+    # first, gather all function signatures from ga-papi.h aka argv[1]
+    accumulating = False
+    signatures = []
+    current_signature = ''
+    EXTERN = 'extern'
+    SEMICOLON = ';'
+    for line in open(header):
+        line = line.strip() # remove whitespace before and after line
+        if not line:
+            continue # skip blank lines
+        if EXTERN in line and SEMICOLON in line:
+            signatures.append(line)
+        elif EXTERN in line:
+            current_signature = line
+            accumulating = True
+        elif SEMICOLON in line and accumulating:
+            current_signature += line
+            signatures.append(current_signature)
+            accumulating = False
+        elif accumulating:
+            current_signature += line
+    return signatures
+
+class FunctionArgument(object):
+    def __init__(self, signature):
+        self.pointer = signature.count('*')
+        self.array = '[' in signature
+        signature = signature.replace('*','').strip()
+        signature = signature.replace('[','').strip()
+        signature = signature.replace(']','').strip()
+        self.type,self.name = signature.split()
+
+    def __str__(self):
+        ret = self.type[:]
+        ret += ' '
+        for p in range(self.pointer):
+            ret += '*'
+        ret += self.name
+        if self.array:
+            ret += '[]'
+        return ret
+
+class Function(object):
+    def __init__(self, signature):
+        signature = signature.replace('extern','').strip()
+        self.return_type,signature = signature.split(None,1)
+        self.return_type = self.return_type.strip()
+        signature = signature.strip()
+        self.name,signature = signature.split('(',1)
+        self.name = self.name.strip()
+        signature = signature.replace(')','').strip()
+        signature = signature.replace(';','').strip()
+        self.args = []
+        if signature:
+            for arg in signature.split(','):
+                self.args.append(FunctionArgument(arg.strip()))
+
+    def get_call(self, name=None):
+        sig = ''
+        if not name:
+            sig += self.name
+        else:
+            sig += name
+        sig += '('
+        if self.args:
+            for arg in self.args:
+                sig += arg.name
+                sig += ', '
+            sig = sig[:-2] # remove last ', '
+        sig += ')'
+        return sig
+
+    def get_signature(self, name=None):
+        sig = self.return_type[:]
+        sig += ' '
+        if not name:
+            sig += self.name
+        else:
+            sig += name
+        sig += '('
+        if self.args:
+            for arg in self.args:
+                sig += str(arg)
+                sig += ', '
+            sig = sig[:-2] # remove last ', '
+        sig += ')'
+        return sig
+
+    def __str__(self):
+        return self.get_signature()
+
+# calls that move data
+MOVES = ['pnga_get', 'pnga_nbget', 'pnga_put', 'pnga_nbput',
+         'pnga_acc', 'pnga_nbacc']
+
+# frequent calls without communication that would crowd out the others
+QUIET = ('pnga_inquire', 'pnga_nodeid', 'pnga_nnodes', 'pnga_cluster_',
+         'pnga_pgroup_nodeid', 'pnga_pgroup_nnodes', 'pnga_get_pgroup',
+         'pnga_type_', 'pnga_distribution', 'pnga_locate', 'pnga_valid_handle',
+         'pnga_initialized', 'pnga_total_blocks', 'pnga_get_debug',
+         'pnga_ndim', 'pnga_uses_', 'pnga_timer', 'pnga_wtime')
+
+HEADER = '''
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ga-papi.h"
+#include "macdecls.h"
+#include "typesf2c.h"
+
+#define TRACE_DEFAULT_EVENTS 65536
+#define TRACE_TID 0                     /* ComEx uses thread 1 */
+
+typedef struct {
+    int id;
+    long long start;                    /* ns */
+    long long dur;                      /* ns */
+    long long g_a;                      /* 0 if none */
+    long long bytes;                    /* -1 if none */
+} trace_event_t;
+
+static trace_event_t *trace_ring = NULL;
+static long trace_size = 0;
+static long long trace_count = 0;       /* including overwritten events */
+static int trace_me = -1;
+static int trace_pid = 0;
+'''
+
+RUNTIME = '''
+static long long trace_now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+}
+
+static long long trace_begin()
+{
+    return trace_ring ? trace_now() : 0;
+}
+
+static trace_event_t* trace_end(int id, long long start)
+{
+    trace_event_t *e;
+
+    if (!trace_ring) return NULL;
+    e = &trace_ring[trace_count++ % trace_size];
+    e->id = id;
+    e->start = start;
+    e->dur = trace_now() - start;
+    e->g_a = 0;
+    e->bytes = -1;
+    return e;
+}
+
+/* bytes in patch lo:hi of g_a */
+static long long trace_bytes(Integer g_a, Integer *lo, Integer *hi)
+{
+    Integer type, ndim, dims[GA_MAX_DIM], d;
+    long long elems = 1;
+
+    pnga_inquire(g_a, &type, &ndim, dims);
+    for (d = 0; d < ndim; d++) elems *= hi[d] - lo[d] + 1;
+    return elems*MA_sizeof(type, 1, MT_C_CHAR);
+}
+
+static void trace_init()
+{
+    char *val = getenv("GA_TRACE_EVENTS");
+
+    if (trace_ring) return;
+    trace_me = (int)pnga_nodeid();
+    MPI_Comm_rank(MPI_COMM_WORLD, &trace_pid);
+    trace_size = val ? atol(val) : TRACE_DEFAULT_EVENTS;
+    if (trace_size <= 0) return;
+    trace_ring = (trace_event_t*)malloc(trace_size*sizeof(trace_event_t));
+    if (!trace_ring)
+        fprintf(stderr, "%d: wapi tracing: out of memory\\n", trace_me);
+    trace_count = 0;
+}
+
+/* Chrome trace format, merged by tools/ga_trace_merge.py */
+static void trace_dump()
+{
+    char fname[1024], *prefix = getenv("GA_TRACE_PREFIX");
+    long long i, first = 0;
+    trace_event_t *e;
+    FILE *fp;
+
+    if (!trace_ring) return;
+    sprintf(fname, "%.1000s.ga.%d.json", prefix ? prefix : "gatrace",
+            trace_pid);
+    if ((fp = fopen(fname, "w")) == NULL) {
+        fprintf(stderr, "%d: wapi tracing: cannot open %s\\n", trace_me, fname);
+    } else {
+        fprintf(fp, "{\\"traceEvents\\":[\\n");
+        fprintf(fp, "{\\"name\\":\\"process_name\\",\\"ph\\":\\"M\\","
+                "\\"pid\\":%d,\\"tid\\":0,\\"args\\":{\\"name\\":\\"rank %d\\"}},\\n",
+                trace_pid, trace_me);
+        fprintf(fp, "{\\"name\\":\\"thread_name\\",\\"ph\\":\\"M\\","
+                "\\"pid\\":%d,\\"tid\\":%d,\\"args\\":{\\"name\\":\\"GA\\"}}",
+                trace_pid, TRACE_TID);
+        if (trace_count > trace_size) {
+            first = trace_count - trace_size;
+            fprintf(fp, ",\\n{\\"name\\":\\"process_labels\\",\\"ph\\":\\"M\\","
+                    "\\"pid\\":%d,\\"tid\\":0,\\"args\\":{\\"labels\\":"
+                    "\\"%lld GA events dropped\\"}}", trace_pid, first);
+        }
+        for (i = first; i < trace_count; i++) {
+            e = &trace_ring[i % trace_size];
+            fprintf(fp, ",\\n{\\"name\\":\\"%s\\",\\"cat\\":\\"ga\\",\\"ph\\":\\"X\\","
+                    "\\"pid\\":%d,\\"tid\\":%d,\\"ts\\":%lld.%03lld,"
+                    "\\"dur\\":%lld.%03lld", trace_name[e->id], trace_pid,
+                    TRACE_TID, e->start/1000, e->start%1000,
+                    e->dur/1000, e->dur%1000);
+            if (e->bytes >= 0)
+                fprintf(fp, ",\\"args\\":{\\"g_a\\":%lld,\\"bytes\\":%lld}}",
+                        e->g_a, e->bytes);
+            else if (e->g_a)
+                fprintf(fp, ",\\"args\\":{\\"g_a\\":%lld}}", e->g_a);
+            else
+                fprintf(fp, "}");
+        }
+        fprintf(fp, "\\n],\\"displayTimeUnit\\":\\"ns\\"}\\n");
+        fclose(fp);
+    }
+    free(trace_ring);
+    trace_ring = NULL;
+}
+'''
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('incorrect number of arguments')
+        print('usage: wapigen_chrome.py <ga-papi.h> > <wapi_chrome.c>')
+        sys.exit(len(sys.argv))
+
+    # print headers
+    print(HEADER)
+
+    functions = {}
+    # parse signatures into the Function class
+    for sig in get_signatures(sys.argv[1]):
+        function = Function(sig)
+        functions[function.name] = function
+    names = sorted(functions)
+
+    # for each function, generate an id and a name
+    print('#define TRACE_N %d' % len(names))
+    print('')
+    for i,name in enumerate(names):
+        print('#define TRACE_ID_%s %d' % (name, i))
+    print('')
+    print('static const char *trace_name[TRACE_N] = {')
+    for name in names:
+        print('    "%s",' % name.replace('pnga_','ga_'))
+    print('};')
+
+    print(RUNTIME)
+
+    # now process the functions
+    for name in names:
+        func = functions[name]
+        wnga_name = name.replace('pnga_','wnga_')
+        arg_names = [arg.name for arg in func.args]
+        decl = ''
+        before = ''
+        after = ''
+        if name in ('pnga_initialize', 'pnga_initialize_ltd'):
+            after = '    trace_init();\n'
+        elif name == 'pnga_terminate':
+            before = '    trace_dump();\n'
+        elif not name.startswith(QUIET):
+            decl = '    long long local_start;\n'
+            before = '    local_start = trace_begin();\n'
+            if 'g_a' in arg_names and not func.args[
+                    arg_names.index('g_a')].pointer:
+                decl = '    trace_event_t *e;\n' + decl
+                after = ('    if ((e = trace_end(TRACE_ID_%s, local_start))'
+                         ' != NULL) {\n' % name)
+                after += '        e->g_a = g_a;\n'
+                if name in MOVES:
+                    after += '        e->bytes = trace_bytes(g_a, lo, hi);\n'
+                after += '    }\n'
+            else:
+                after = ('    (void)trace_end(TRACE_ID_%s, local_start);\n'
+                         % name)
+        if 'void' not in func.return_type:
+            print('''
+%s
+{
+    %s return_value;
+%s%s    return_value = %s;
+%s    return return_value;
+}
+''' % (func.get_signature(wnga_name), func.return_type, decl, before,
+        func.get_call(), after))
+        else:
+            print('''
+%s
+{
+%s%s    %s;
+%s}
+''' % (func.get_signature(wnga_name), decl, before,
+        func.get_call(), after))
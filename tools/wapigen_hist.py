@@ -0,0 +1,419 @@
+#!/usr/bin/env python
+
+'''Generate the wapi_hist.c source from the ga-papi.h header.
+
+The generated wrappers record, per process,
+  - a latency histogram for every wnga_* call, in log-linear buckets of
+    8 sub-buckets per power of two nanoseconds (at most 12.5% error);
+  - the bytes moved by get, put and accumulate calls, per target process,
+    and classified as local, same node or remote;
+  - the calls and bytes moved per array name.
+Each process writes them at GA_Terminate to the binary file
+<prefix>.<rank>, where the prefix is GA_PROF_PREFIX (default "gaprof").
+tools/ga_prof_report.py merges the files of all processes into a report.
+
+usage:
+  wapigen_hist.py ga-papi.h > tools/ga-wapi.c
+then configure with --enable-profiling.
+
+Non-blocking calls are timed until they return, not until they complete.
+Bytes are only split by target for arrays with a regular distribution;
+other arrays are counted under "other".
+'''
+
+import sys
+
+def get_signatures(header):
+    # first, gather all function signatures from ga-papi.h aka argv[1]
+    accumulating = False
+    signatures = []
+    current_signature = ''
+    EXTERN = 'extern'
+    SEMICOLON = ';'
+    for line in open(header):
+        line = line.strip() # remove whitespace before and after line
+        if not line:
+            continue # skip blank lines
+        if EXTERN in line and SEMICOLON in line:
+            signatures.append(line)
+        elif EXTERN in line:
+            current_signature = line
+            accumulating = True
+        elif SEMICOLON in line and accumulating:
+            current_signature += line
+            signatures.append(current_signature)
+            accumulating = False
+        elif accumulating:
+            current_signature += line
+    return signatures
+
+class FunctionArgument(object):
+    def __init__(self, signature):
+        self.pointer = signature.count('*')
+        self.array = '[' in signature
+        signature = signature.replace('*','').strip()
+        signature = signature.replace('[','').strip()
+        signature = signature.replace(']','').strip()
+        self.type,self.name = signature.split()
+
+    def __str__(self):
+        ret = self.type[:]
+        ret += ' '
+        for p in range(self.pointer):
+            ret += '*'
+        ret += self.name
+        if self.array:
+            ret += '[]'
+        return ret
+
+class Function(object):
+    def __init__(self, signature):
+        signature = signature.replace('extern','').strip()
+        self.return_type,signature = signature.split(None,1)
+        self.return_type = self.return_type.strip()
+        signature = signature.strip()
+        self.name,signature = signature.split('(',1)
+        self.name = self.name.strip()
+        signature = signature.replace(')','').strip()
+        signature = signature.replace(';','').strip()
+        self.args = []
+        if signature:
+            for arg in signature.split(','):
+                self.args.append(FunctionArgument(arg.strip()))
+
+    def get_call(self, name=None):
+        sig = ''
+        if not name:
+            sig += self.name
+        else:
+            sig += name
+        sig += '('
+        if self.args:
+            for arg in self.args:
+                sig += arg.name
+                sig += ', '
+            sig = sig[:-2] # remove last ', '
+        sig += ')'
+        return sig
+
+    def get_signature(self, name=None):
+        sig = self.return_type[:]
+        sig += ' '
+        if not name:
+            sig += self.name
+        else:
+            sig += name
+        sig += '('
+        if self.args:
+            for arg in self.args:
+                sig += str(arg)
+                sig += ', '
+            sig = sig[:-2] # remove last ', '
+        sig += ')'
+        return sig
+
+    def __str__(self):
+        return self.get_signature()
+
+# calls that move data, and the kind of transfer
+MOVES = {
+    'pnga_get':   'PROF_GET',
+    'pnga_nbget': 'PROF_GET',
+    'pnga_put':   'PROF_PUT',
+    'pnga_nbput': 'PROF_PUT',
+    'pnga_acc':   'PROF_ACC',
+    'pnga_nbacc': 'PROF_ACC',
+}
+
+HEADER = '''
+#if HAVE_CONFIG_H
+#   include "config.h"
+#endif
+
+#include <mpi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "ga-papi.h"
+#include "macdecls.h"
+#include "typesf2c.h"
+
+#define PROF_SUB_BITS 3                 /* sub-buckets per power of two */
+#define PROF_SUB      (1<<PROF_SUB_BITS)
+#define PROF_MAX_EXP  47                /* about 39 hours in ns */
+#define PROF_BUCKETS  ((PROF_MAX_EXP-PROF_SUB_BITS+2)*PROF_SUB)
+#define PROF_ARRAYS   256               /* slots of the array name table */
+#define PROF_NAME     256
+
+enum { PROF_GET, PROF_PUT, PROF_ACC, PROF_NOPS };
+enum { PROF_LOCAL, PROF_NODE, PROF_REMOTE, PROF_OTHER, PROF_NCLASSES };
+
+typedef struct {
+    long long count;
+    long long total;
+    long long min;
+    long long max;
+    long long hist[PROF_BUCKETS];
+} prof_api_t;
+
+typedef struct {
+    char name[PROF_NAME];
+    long long calls;
+    long long bytes;
+} prof_array_t;
+
+static int me = -1;
+static int nproc = 0;
+static int mynode = 0;
+static int *prof_node = NULL;           /* node of each process */
+static long long *prof_target = NULL;   /* [PROF_NOPS][nproc] bytes */
+static long long prof_class_bytes[PROF_NOPS][PROF_NCLASSES];
+static long long prof_class_calls[PROF_NOPS][PROF_NCLASSES];
+static prof_array_t prof_array[PROF_ARRAYS];
+'''
+
+RUNTIME = '''
+static long long prof_now()
+{
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec*1000000000LL + ts.tv_nsec;
+#else
+    return (long long)(MPI_Wtime()*1e9);
+#endif
+}
+
+static int prof_bucket(long long ns)
+{
+    int e = 0;
+    unsigned long long v = (unsigned long long)ns;
+
+    if (ns < PROF_SUB) return ns < 0 ? 0 : (int)ns;
+#ifdef __GNUC__
+    e = 63 - __builtin_clzll(v);
+#else
+    while (v >> (e+1)) e++;
+#endif
+    if (e > PROF_MAX_EXP) return PROF_BUCKETS-1;
+    return (e-PROF_SUB_BITS+1)*PROF_SUB
+        + (int)((v >> (e-PROF_SUB_BITS)) & (PROF_SUB-1));
+}
+
+static void prof_record(int id, long long start)
+{
+    long long ns = prof_now() - start;
+    prof_api_t *a = &prof_api[id];
+
+    if (a->count == 0 || ns < a->min) a->min = ns;
+    if (ns > a->max) a->max = ns;
+    a->count++;
+    a->total += ns;
+    a->hist[prof_bucket(ns)]++;
+}
+
+static prof_array_t* prof_lookup(Integer g_a)
+{
+    char *name = NULL;
+    unsigned long h = 5381;
+    int i, n;
+
+    pnga_inquire_name(g_a, &name);
+    if (!name || !name[0]) name = "?";
+    for (i = 0; name[i]; i++) h = h*33 + (unsigned char)name[i];
+    for (n = 0, i = (int)(h % PROF_ARRAYS); n < PROF_ARRAYS;
+         n++, i = (i+1) % PROF_ARRAYS) {
+        if (prof_array[i].name[0] == '\\0') {
+            strncpy(prof_array[i].name, name, PROF_NAME-1);
+            return &prof_array[i];
+        }
+        if (strncmp(prof_array[i].name, name, PROF_NAME-1) == 0)
+            return &prof_array[i];
+    }
+    return NULL;
+}
+
+/* account the bytes of a transfer of patch lo:hi of g_a to their owners */
+static void prof_move(int op, Integer g_a, Integer *lo, Integer *hi)
+{
+    Integer type, ndim, dims[GA_MAX_DIM], np = 0, grp, i, d, p;
+    Integer map_s[2*GA_MAX_DIM*16], proc_s[16], *map = map_s, *proc = proc_s;
+    long long elems, size, bytes = 0;
+    int cls;
+    prof_array_t *arr;
+
+    if (me < 0) return;
+    pnga_inquire(g_a, &type, &ndim, dims);
+    size = MA_sizeof(type, 1, MT_C_CHAR);
+    if (pnga_total_blocks(g_a) < 0 && pnga_locate_nnodes(g_a, lo, hi, &np)
+        && np > 0) {
+        if (np > 16) {
+            map = (Integer*)malloc(2*ndim*np*sizeof(Integer));
+            proc = (Integer*)malloc(np*sizeof(Integer));
+        }
+        if (map && proc && pnga_locate_region(g_a, lo, hi, map, proc, &np)) {
+            grp = pnga_get_pgroup(g_a);
+            for (i = 0; i < np; i++) {
+                for (d = 0, elems = 1; d < ndim; d++)
+                    elems *= map[2*ndim*i+ndim+d] - map[2*ndim*i+d] + 1;
+                p = grp > 0 ? pnga_pgroup_absolute_id(grp, proc[i]) : proc[i];
+                if (p == me) cls = PROF_LOCAL;
+                else if (prof_node[p] == mynode) cls = PROF_NODE;
+                else cls = PROF_REMOTE;
+                prof_class_bytes[op][cls] += elems*size;
+                prof_class_calls[op][cls]++;
+                prof_target[op*nproc+p] += elems*size;
+                bytes += elems*size;
+            }
+        } else {
+            np = 0;
+        }
+        if (map != map_s) free(map);
+        if (proc != proc_s) free(proc);
+    } else {
+        np = 0;
+    }
+    if (np == 0) {
+        for (d = 0, elems = 1; d < ndim; d++) elems *= hi[d] - lo[d] + 1;
+        bytes = elems*size;
+        prof_class_bytes[op][PROF_OTHER] += bytes;
+        prof_class_calls[op][PROF_OTHER]++;
+    }
+    if ((arr = prof_lookup(g_a)) != NULL) {
+        arr->calls++;
+        arr->bytes += bytes;
+    }
+}
+
+static void prof_init()
+{
+    Integer i;
+
+    me = (int)pnga_nodeid();
+    nproc = (int)pnga_nnodes();
+    mynode = (int)pnga_cluster_nodeid();
+    prof_node = (int*)malloc(nproc*sizeof(int));
+    prof_target = (long long*)calloc(PROF_NOPS*nproc, sizeof(long long));
+    if (!prof_node || !prof_target) {
+        fprintf(stderr, "%d: wapi profiling: out of memory\\n", me);
+        me = -1;
+        return;
+    }
+    for (i = 0; i < nproc; i++) prof_node[i] = (int)pnga_cluster_proc_nodeid(i);
+}
+
+static void prof_write_name(FILE *fp, const char *name)
+{
+    int len = (int)strlen(name);
+    fwrite(&len, sizeof(int), 1, fp);
+    fwrite(name, 1, len, fp);
+}
+
+/* binary dump, read by tools/ga_prof_report.py */
+static void prof_dump()
+{
+    char fname[1024], *prefix = getenv("GA_PROF_PREFIX");
+    int i, n, hdr[6];
+    FILE *fp;
+
+    if (me < 0) return;
+    sprintf(fname, "%.1000s.%d", prefix ? prefix : "gaprof", me);
+    if ((fp = fopen(fname, "wb")) == NULL) {
+        fprintf(stderr, "%d: wapi profiling: cannot open %s\\n", me, fname);
+        return;
+    }
+    fwrite("GAPROF01", 1, 8, fp);
+    for (n = 0, i = 0; i < PROF_N; i++) if (prof_api[i].count) n++;
+    hdr[0] = me;
+    hdr[1] = nproc;
+    hdr[2] = mynode;
+    hdr[3] = PROF_BUCKETS;
+    hdr[4] = n;
+    for (n = 0, i = 0; i < PROF_ARRAYS; i++) if (prof_array[i].name[0]) n++;
+    hdr[5] = n;
+    fwrite(hdr, sizeof(int), 6, fp);
+    for (i = 0; i < PROF_N; i++) {
+        if (!prof_api[i].count) continue;
+        prof_write_name(fp, prof_name[i]);
+        fwrite(&prof_api[i], sizeof(long long), 4+PROF_BUCKETS, fp);
+    }
+    fwrite(prof_class_bytes, sizeof(long long), PROF_NOPS*PROF_NCLASSES, fp);
+    fwrite(prof_class_calls, sizeof(long long), PROF_NOPS*PROF_NCLASSES, fp);
+    fwrite(prof_node, sizeof(int), nproc, fp);
+    fwrite(prof_target, sizeof(long long), PROF_NOPS*nproc, fp);
+    for (i = 0; i < PROF_ARRAYS; i++) {
+        if (!prof_array[i].name[0]) continue;
+        prof_write_name(fp, prof_array[i].name);
+        fwrite(&prof_array[i].calls, sizeof(long long), 2, fp);
+    }
+    fclose(fp);
+    free(prof_node);
+    free(prof_target);
+    me = -1;
+}
+'''
+
+if __name__ == '__main__':
+    if len(sys.argv) != 2:
+        print('incorrect number of arguments')
+        print('usage: wapigen_hist.py <ga-papi.h> > <wapi_hist.c>')
+        sys.exit(len(sys.argv))
+
+    # print headers
+    print(HEADER)
+
+    functions = {}
+    # parse signatures into the Function class
+    for sig in get_signatures(sys.argv[1]):
+        function = Function(sig)
+        functions[function.name] = function
+    names = sorted(functions)
+
+    # for each function, generate an id and a name
+    print('#define PROF_N %d' % len(names))
+    print('')
+    for i,name in enumerate(names):
+        print('#define PROF_ID_%s %d' % (name, i))
+    print('')
+    print('static const char *prof_name[PROF_N] = {')
+    for name in names:
+        print('    "%s",' % name.replace('pnga_','ga_'))
+    print('};')
+    print('static prof_api_t prof_api[PROF_N];')
+
+    print(RUNTIME)
+
+    # now process the functions
+    for name in names:
+        func = functions[name]
+        wnga_name = name.replace('pnga_','wnga_')
+        before = ''
+        after = '    prof_record(PROF_ID_%s, local_start);\n' % name
+        if name in MOVES:
+            after += '    prof_move(%s, g_a, lo, hi);\n' % MOVES[name]
+        if name in ('pnga_initialize', 'pnga_initialize_ltd'):
+            after += '    prof_init();\n'
+        if name == 'pnga_terminate':
+            before = '    prof_dump();\n'
+        if 'void' not in func.return_type:
+            print('''
+%s
+{
+    %s return_value;
+    long long local_start;
+%s    local_start = prof_now();
+    return_value = %s;
+%s    return return_value;
+}
+''' % (func.get_signature(wnga_name), func.return_type, before,
+        func.get_call(), after))
+        else:
+            print('''
+%s
+{
+    long long local_start;
+%s    local_start = prof_now();
+    %s;
+%s}
+''' % (func.get_signature(wnga_name), before, func.get_call(), after))